@@ -9,9 +9,16 @@ const std::string SolutionDir = SOLUTION_DIR;
 const std::string RegistryDir = SolutionDir + "WellEngine\\Source\\Game\\";
 const std::string BehavioursDir = RegistryDir + "Behaviours\\";
 const std::string RegistryFile = RegistryDir + "BehaviourRegistry.cpp";
+const std::string TypesFile = RegistryDir + "BehaviourTypes.h";
 const std::string RegisterAttribute = "[[register_behaviour]]";
 const std::string IncludeTag = "%INCLUDE%";
 const std::string RegisterTag = "%REGISTER%";
+const std::string TypeIDTag = "%TYPE_ID%";
+const std::string TypeListTag = "%TYPE_LIST%";
+const std::string TypeNameTag = "%TYPE_NAME%";
+const std::string CountTag = "%COUNT%";
+const std::string DeclareTag = "%DECLARE%";
+const std::string SpecializeTag = "%SPECIALIZE%";
 const std::string RegistryTemplate = "\
 // Automatically generated during build by BehaviourRegistration.\n\
 // Scans for all behaviour definitions and includes them here for the behaviour factory to use.\n\
@@ -20,6 +27,9 @@ const std::string RegistryTemplate = "\
 #include \"BehaviourRegistry.h\"\n\
 #include \"Behaviour.h\"\n\
 " + IncludeTag + "\n\
+#include \"Utils/ObjectPool.h\"\n\
+#include <array>\n\
+#include <typeindex>\n\
 \n\
 #ifdef LEAK_DETECTION\n\
 #define new			DEBUG_NEW\n\
@@ -33,7 +43,102 @@ const std::map<std::string_view, std::function<Behaviour *(void)>> &BehaviourReg
     };\n\
 \n\
     return behaviourMap;\n\
+};\n\
+\n\
+UINT BehaviourRegistry::GetTypeID(const std::type_info &type)\n\
+{\n\
+    static const std::unordered_map<std::type_index, UINT> typeIDs = {\n\
+" + TypeIDTag + "\n\
+    };\n\
+\n\
+    const auto it = typeIDs.find(type);\n\
+    return (it != typeIDs.end()) ? it->second : BEHAVIOUR_TYPE_NULL;\n\
+};\n\
+\n\
+template<class Base, class... Types>\n\
+static BehaviourTypeMask MakeDerivedTypeMask()\n\
+{\n\
+    BehaviourTypeMask mask;\n\
+    ((std::is_base_of_v<Base, Types> ? (void)mask.set(BehaviourType<Types>::ID) : (void)0), ...);\n\
+    return mask;\n\
+}\n\
+template<class... Types>\n\
+static std::array<BehaviourTypeMask, sizeof...(Types)> MakeDerivedTypeMasks()\n\
+{\n\
+    return { MakeDerivedTypeMask<Types, Types...>()... };\n\
+}\n\
+\n\
+const BehaviourTypeMask &BehaviourRegistry::GetDerivedTypes(UINT typeID)\n\
+{\n\
+    static const std::array<BehaviourTypeMask, BEHAVIOUR_TYPE_COUNT> derivedTypes = MakeDerivedTypeMasks<\n\
+" + TypeListTag + "\n\
+    >();\n\
+\n\
+    return derivedTypes[typeID];\n\
+};\n\
+\n\
+const char *BehaviourRegistry::GetTypeName(UINT typeID)\n\
+{\n\
+    static constexpr std::array<const char *, BEHAVIOUR_TYPE_COUNT> typeNames = {\n\
+" + TypeNameTag + "\n\
+    };\n\
+\n\
+    return (typeID < BEHAVIOUR_TYPE_COUNT) ? typeNames[typeID] : \"Unregistered\";\n\
+};\n\
+\n\
+template<class... Types>\n\
+static constexpr std::array<bool, sizeof...(Types)> MakeThreadSafeUpdateFlags()\n\
+{\n\
+    return { IsBehaviourUpdateThreadSafe<Types>::value... };\n\
+}\n\
+\n\
+bool BehaviourRegistry::IsUpdateThreadSafe(UINT typeID)\n\
+{\n\
+    static constexpr std::array<bool, BEHAVIOUR_TYPE_COUNT> threadSafe = MakeThreadSafeUpdateFlags<\n\
+" + TypeListTag + "\n\
+    >();\n\
+\n\
+    return (typeID < BEHAVIOUR_TYPE_COUNT) && threadSafe[typeID];\n\
+};\n\
+\n\
+template<class... Types>\n\
+static constexpr std::array<size_t, sizeof...(Types)> MakeTypeSizes()\n\
+{\n\
+    static_assert(((alignof(Types) <= ObjectPool::SLOT_ALIGNMENT) && ...), \"Behaviours must not be over-aligned to be pooled!\");\n\
+    return { sizeof(Types)... };\n\
+}\n\
+\n\
+size_t BehaviourRegistry::GetTypeSize(UINT typeID)\n\
+{\n\
+    static constexpr std::array<size_t, BEHAVIOUR_TYPE_COUNT> typeSizes = MakeTypeSizes<\n\
+" + TypeListTag + "\n\
+    >();\n\
+\n\
+    return (typeID < BEHAVIOUR_TYPE_COUNT) ? typeSizes[typeID] : 0;\n\
 };\n";
+const std::string TypesTemplate = "\
+// Automatically generated during build by BehaviourRegistration.\n\
+// Gives every registered behaviour a type ID, so entities and scenes can look up behaviours by type without dynamic_cast.\n\
+\n\
+#pragma once\n\
+#include <bitset>\n\
+\n\
+inline constexpr UINT BEHAVIOUR_TYPE_COUNT = " + CountTag + ";\n\
+inline constexpr UINT BEHAVIOUR_TYPE_NULL = UINT_MAX;\n\
+\n\
+// One bit per registered behaviour type.\n\
+using BehaviourTypeMask = std::bitset<BEHAVIOUR_TYPE_COUNT>;\n\
+\n\
+// Type ID of a behaviour class, or BEHAVIOUR_TYPE_NULL if the class is not registered.\n\
+// IDs follow the order the behaviours are found in and are not stable between builds, so they must not be serialized.\n\
+template<class T>\n\
+struct BehaviourType\n\
+{\n\
+    static constexpr UINT ID = BEHAVIOUR_TYPE_NULL;\n\
+};\n\
+\n\
+" + DeclareTag + "\n\
+" + SpecializeTag;
 
 
 static std::vector<std::string> ScanHeaderFileForBehaviours(const std::filesystem::path &filePath)
@@ -174,6 +279,40 @@ static std::string GenerateRegistryCode(const BehaviourInfo &behaviourInfo)
     for (const auto &behaviourInclude : behaviourInfo.includes)
         includeCode += "#include \"Behaviours/" + behaviourInclude + ".h\"\n";
 
+    std::string typeIDCode = "";
+    std::string typeListCode = "";
+    std::string typeNameCode = "";
+    for (size_t i = 0; i < behaviourInfo.classes.size(); i++)
+    {
+        const std::string &behaviourClass = behaviourInfo.classes[i];
+        std::string padding(maxClassNameLength - behaviourClass.length(), ' ');
+
+        typeIDCode += "\t\t{ typeid(" + behaviourClass + "), " + padding + "BehaviourType<" + behaviourClass + ">::ID " + padding + "},\n";
+        typeListCode += "\t\t" + behaviourClass + ((i + 1 < behaviourInfo.classes.size()) ? ",\n" : "\n");
+        typeNameCode += "\t\t\"" + behaviourClass + "\"" + ((i + 1 < behaviourInfo.classes.size()) ? ",\n" : "\n");
+    }
+
+    // Replace the type tags first, the register and include tags come before them.
+    // The type list is used more than once, so replace from the back to keep earlier positions valid.
+    size_t typeListPos = output.rfind(TypeListTag);
+    if (typeListPos == std::string::npos)
+        std::cerr << "Type list tag not found in template!\n";
+    while (typeListPos != std::string::npos)
+    {
+        output.replace(typeListPos, TypeListTag.length(), typeListCode);
+        typeListPos = (typeListPos > 0) ? output.rfind(TypeListTag, typeListPos - 1) : std::string::npos;
+    }
+
+    size_t typeNamePos = output.find(TypeNameTag);
+    if (typeNamePos == std::string::npos)
+        std::cerr << "Type name tag not found in template!\n";
+    output.replace(typeNamePos, TypeNameTag.length(), typeNameCode);
+
+    size_t typeIDPos = output.find(TypeIDTag);
+    if (typeIDPos == std::string::npos)
+        std::cerr << "Type ID tag not found in template!\n";
+    output.replace(typeIDPos, TypeIDTag.length(), typeIDCode);
+
     // Locate register tag
     size_t registerPos = output.find(RegisterTag);
 
@@ -195,17 +334,63 @@ static std::string GenerateRegistryCode(const BehaviourInfo &behaviourInfo)
     return output;
 }
 
-static void WriteRegistryFile(const std::string &code)
+static std::string GenerateTypesCode(const BehaviourInfo &behaviourInfo)
 {
-    std::cout << "Writing Registry File\n";
+    std::string output = TypesTemplate;
+
+    std::string declareCode = "";
+    std::string specializeCode = "";
+    for (size_t i = 0; i < behaviourInfo.classes.size(); i++)
+    {
+        const std::string &behaviourClass = behaviourInfo.classes[i];
+
+        declareCode += "class " + behaviourClass + ";\n";
+        specializeCode += "template<> struct BehaviourType<" + behaviourClass + "> { static constexpr UINT ID = " + std::to_string(i) + "; };\n";
+    }
+
+    size_t countPos = output.find(CountTag);
+    if (countPos == std::string::npos)
+        std::cerr << "Count tag not found in template!\n";
+    output.replace(countPos, CountTag.length(), std::to_string(behaviourInfo.classes.size()));
+
+    size_t declarePos = output.find(DeclareTag);
+    if (declarePos == std::string::npos)
+        std::cerr << "Declare tag not found in template!\n";
+    output.replace(declarePos, DeclareTag.length(), declareCode);
+
+    size_t specializePos = output.find(SpecializeTag);
+    if (specializePos == std::string::npos)
+        std::cerr << "Specialize tag not found in template!\n";
+    output.replace(specializePos, SpecializeTag.length(), specializeCode);
+
+    return output;
+}
+
+// Leaves the file untouched if its contents would not change, so that everything including it is not rebuilt.
+static void WriteGeneratedFile(const std::string &path, const std::string &code)
+{
+    std::ifstream existingReadFile(path);
+    if (existingReadFile.is_open())
+    {
+        std::string existingCode((std::istreambuf_iterator<char>(existingReadFile)), std::istreambuf_iterator<char>());
+        existingReadFile.close();
+
+        if (existingCode == code)
+        {
+            std::cout << "Unchanged '" << path << "'\n";
+            return;
+        }
+    }
+
+    std::cout << "Writing '" << path << "'\n";
 
-    std::ofstream registryWriteFile(RegistryFile);
-    if (!registryWriteFile.is_open())
-        std::cerr << "Failed to open registry file for writing!\n";
+    std::ofstream writeFile(path);
+    if (!writeFile.is_open())
+        std::cerr << "Failed to open '" << path << "' for writing!\n";
 
-    registryWriteFile << code;
+    writeFile << code;
 
-    registryWriteFile.close();
+    writeFile.close();
 }
 
 
@@ -214,8 +399,10 @@ int main()
     const BehaviourInfo behaviours = GatherBehaviours();
 
 	const std::string registryCode = GenerateRegistryCode(behaviours);
+	const std::string typesCode = GenerateTypesCode(behaviours);
 
-	WriteRegistryFile(registryCode);
+	WriteGeneratedFile(TypesFile, typesCode);
+	WriteGeneratedFile(RegistryFile, registryCode);
 
     std::cout << "Behaviour Registration Done.\n";
 }
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
 #include "Game/Entity.h"
+#include "Game/Behaviours/ColliderBehaviour.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace TestUtils;
@@ -22,6 +23,70 @@ namespace T_Game
 
 			TestUtility::EntityTest(&ent);
 		}
+
+		TEST_METHOD(TreeSyncQueued_MarksOnce)
+		{
+			Entity ent((UINT)0, dx::BoundingOrientedBox({ 0,0,0 }, { 1,1,1 }, {0,0,0,1}));
+
+			Assert::IsFalse(ent.IsTreeSyncQueued());
+			Assert::IsTrue(ent.MarkTreeSyncQueued());
+			Assert::IsFalse(ent.MarkTreeSyncQueued());
+			Assert::IsTrue(ent.IsTreeSyncQueued());
+
+			ent.ClearTreeSyncQueued();
+			Assert::IsFalse(ent.IsTreeSyncQueued());
+			Assert::IsTrue(ent.MarkTreeSyncQueued());
+		}
+
+		TEST_METHOD(SceneIndex_UnsetOutsideScene)
+		{
+			Entity ent((UINT)3, dx::BoundingOrientedBox({ 0,0,0 }, { 1,1,1 }, {0,0,0,1}));
+
+			Assert::AreEqual(3u, ent.GetID());
+			Assert::AreEqual(static_cast<UINT>(-1), ent.GetSceneIndex());
+		}
+
+		TEST_METHOD(Handle_InvalidAfterDestruct)
+		{
+			Handle<Entity> handle;
+			Assert::IsFalse(handle.IsValid());
+
+			{
+				Entity ent((UINT)0, dx::BoundingOrientedBox({ 0,0,0 }, { 1,1,1 }, {0,0,0,1}));
+				handle = ent.AsHandle();
+
+				const Handle<Entity> copy = handle;
+				Assert::IsTrue(copy == &ent);
+				Assert::IsTrue(copy == ent.AsHandle());
+			}
+
+			Assert::IsFalse(handle.IsValid());
+
+			// A new entity reusing the slot is not reachable through the old handle.
+			Entity other((UINT)1, dx::BoundingOrientedBox({ 0,0,0 }, { 1,1,1 }, {0,0,0,1}));
+			const Handle<Entity> otherHandle = other.AsHandle();
+			Assert::IsNull(handle.Get());
+			Assert::IsFalse(handle == otherHandle);
+			Assert::IsTrue(otherHandle.Get() == &other);
+		}
+
+		TEST_METHOD(BehaviourType_LookupWithoutBehaviours)
+		{
+			static_assert(BehaviourType<Behaviour>::ID == BEHAVIOUR_TYPE_NULL);
+			static_assert(BehaviourType<ColliderBehaviour>::ID < BEHAVIOUR_TYPE_COUNT);
+
+			// A registered type is at least its own derived type.
+			Assert::IsTrue(BehaviourRegistry::GetDerivedTypes(BehaviourType<ColliderBehaviour>::ID).test(BehaviourType<ColliderBehaviour>::ID));
+			Assert::AreEqual(BehaviourType<ColliderBehaviour>::ID, BehaviourRegistry::GetTypeID(typeid(ColliderBehaviour)));
+			Assert::AreEqual(BEHAVIOUR_TYPE_NULL, BehaviourRegistry::GetTypeID(typeid(Behaviour)));
+
+			Entity ent((UINT)0, dx::BoundingOrientedBox({ 0,0,0 }, { 1,1,1 }, {0,0,0,1}));
+
+			ColliderBehaviour *collider = nullptr;
+			Assert::IsFalse(ent.HasBehaviourOfType<ColliderBehaviour>());
+			Assert::IsFalse(ent.GetBehaviourByType<ColliderBehaviour>(collider));
+			Assert::IsNull(collider);
+		}
 	};
 }
 
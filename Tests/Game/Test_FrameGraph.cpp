@@ -0,0 +1,80 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Utils/FrameGraph.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestUtils;
+
+namespace T_Utils
+{
+	TEST_CLASS(T_FrameGraph)
+	{
+	public:
+		TEST_CLASS_INITIALIZE(StartWorkers)
+		{
+			Assert::IsTrue(JobSystem::Instance().Initialize(3));
+		}
+
+		TEST_CLASS_CLEANUP(StopWorkers)
+		{
+			JobSystem::Instance().Shutdown();
+		}
+
+		TEST_METHOD(Compile_OrdersByResourceAccess)
+		{
+			FrameGraph graph;
+			const FrameGraph::ResourceID
+				a = graph.AddResource("A"),
+				b = graph.AddResource("B");
+
+			graph.AddStage("Write A", {}, { a }, []() { return true; });
+			graph.AddStage("Write B", {}, { b }, []() { return true; });
+			graph.AddStage("Read A", { a }, {}, []() { return true; });
+			graph.AddStage("Read A Again", { a }, {}, []() { return true; });
+			graph.AddStage("Write A Again", {}, { a }, []() { return true; });
+
+			// Independent writers and readers of the same data do not wait for each other.
+			Assert::AreEqual(size_t(0), graph.GetDependencies(1).size());
+			Assert::AreEqual(size_t(1), graph.GetDependencies(2).size());
+			Assert::AreEqual(0u, graph.GetDependencies(3)[0]);
+
+			// A writer waits for the last writer and every reader since.
+			const std::vector<UINT> &lastWrite = graph.GetDependencies(4);
+			Assert::AreEqual(size_t(3), lastWrite.size());
+			Assert::IsTrue(std::ranges::find(lastWrite, 1u) == lastWrite.end());
+		}
+
+		TEST_METHOD(Execute_RunsInDependencyOrder)
+		{
+			for (UINT run = 0; run < 100; run++)
+			{
+				FrameGraph graph;
+				const FrameGraph::ResourceID
+					a = graph.AddResource("A"),
+					b = graph.AddResource("B");
+
+				std::atomic<UINT> counter = 0;
+				UINT order[4] = {};
+				const std::thread::id mainThread = std::this_thread::get_id();
+				bool ranOnMainThread = false;
+
+				graph.AddStage("Write A", {}, { a }, [&]() { order[0] = counter++; return true; }, true);
+				graph.AddStage("Read A", { a }, {}, [&]() { order[1] = counter++; return true; });
+				graph.AddStage("Write B", {}, { b }, [&]() { order[2] = counter++; return true; });
+				graph.AddStage("Read A, B", { a, b }, {}, [&]() {
+					order[3] = counter++;
+					return true;
+				});
+				graph.AddStage("Write A On Main", {}, { a }, [&]() {
+					ranOnMainThread = std::this_thread::get_id() == mainThread;
+					return true;
+				}, true);
+
+				Assert::IsTrue(graph.Execute());
+				Assert::IsTrue(order[0] < order[1]);
+				Assert::IsTrue(order[0] < order[3] && order[2] < order[3]);
+				Assert::IsTrue(ranOnMainThread);
+			}
+		}
+	};
+}
@@ -0,0 +1,54 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Window/Window.h"
+#include "Content/Content.h"
+#include "Rendering/Graphics.h"
+#include "Timing/TimeUtils.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestUtils;
+
+// The null backend only exists when the engine is built with HEADLESS.
+#ifdef HEADLESS
+namespace T_Rendering
+{
+	TEST_CLASS(T_Headless)
+	{
+	public:
+		TEST_METHOD(NullBackend_RunsFrame)
+		{
+			constexpr UINT width = 320, height = 180;
+
+			Window window;
+			Assert::IsTrue(window.Initialize("Headless Test", { width, height }));
+
+			Content content;
+			Graphics graphics;
+
+			ID3D11Device *device = nullptr;
+			ID3D11DeviceContext *immediateContext = nullptr;
+			ID3D11DeviceContext *deferredContext = nullptr;
+
+			Assert::IsTrue(graphics.Setup(false, width, height, window, device, immediateContext, &deferredContext, &content));
+			Assert::IsNull(device);
+			Assert::IsNull(immediateContext);
+
+			TimeUtils time;
+			time.Update(1.0f / 60.0f);
+
+			Assert::IsTrue(graphics.BeginSceneRender());
+			Assert::IsTrue(graphics.EndSceneRender(time));
+			Assert::IsTrue(graphics.ScreenSpaceRender());
+			Assert::IsTrue(graphics.EndFrame());
+
+			const HeadlessFrameStats &stats = graphics.GetHeadlessFrameStats();
+			Assert::AreEqual(1u, stats.frameCount);
+			Assert::AreEqual(0u, stats.viewDrawCount);
+			Assert::AreEqual(0u, stats.shadowDrawCount);
+
+			graphics.Shutdown();
+			content.Shutdown();
+		}
+	};
+}
+#endif
@@ -0,0 +1,94 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Input/InputRecording.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestUtils;
+
+namespace T_Input
+{
+	TEST_CLASS(T_InputRecording)
+	{
+	public:
+		TEST_METHOD(Decompile_RestoresCompiledFrames)
+		{
+			InputRecording recording;
+			recording.Begin(1234);
+			recording.SetStartScene("Cave");
+
+			for (UINT i = 0; i < 4; i++)
+			{
+				RecordedFrame &frame = recording.AddFrame();
+				frame.realDeltaTime = 1.0f / 60.0f;
+				frame.fixedDeltaTime = 1.0f / 20.0f;
+				frame.flags = static_cast<UCHAR>(RecordedFrame::InputFocus | RecordedFrame::CursorLocked);
+				frame.mousePos = { 2.0f * i, -1.0f };
+				frame.keys['W'] = i >= 1;
+				frame.keys[0x1] = i == 2; // Left mouse button
+			}
+			recording.RecordSceneChange("MainMenu");
+
+			std::vector<char> data;
+			recording.Compile(data);
+
+			InputRecording loaded;
+			Assert::IsTrue(loaded.Decompile(data));
+			Assert::AreEqual(1234u, loaded.GetSeed());
+			Assert::AreEqual(std::string("Cave"), loaded.GetStartScene());
+			Assert::AreEqual(recording.GetFrameCount(), loaded.GetFrameCount());
+
+			for (size_t i = 0; i < loaded.GetFrameCount(); i++)
+			{
+				const RecordedFrame &expected = recording.GetFrame(i);
+				const RecordedFrame &actual = loaded.GetFrame(i);
+
+				Assert::AreEqual(expected.realDeltaTime, actual.realDeltaTime);
+				Assert::AreEqual(expected.fixedDeltaTime, actual.fixedDeltaTime);
+				Assert::AreEqual(expected.flags, actual.flags);
+				Assert::AreEqual(expected.mousePos.x, actual.mousePos.x);
+				Assert::AreEqual(expected.mousePos.y, actual.mousePos.y);
+				Assert::IsTrue(expected.keys == actual.keys);
+				Assert::AreEqual(expected.sceneChange, actual.sceneChange);
+			}
+
+			// Playback walks the frames in order, then stops.
+			for (size_t i = 0; i < loaded.GetFrameCount(); i++)
+				Assert::IsTrue(loaded.NextFrame() == &loaded.GetFrame(i));
+			Assert::IsTrue(loaded.NextFrame() == nullptr);
+		}
+
+		TEST_METHOD(Decompile_RejectsTruncatedData)
+		{
+			InputRecording recording;
+			recording.Begin(0);
+			recording.AddFrame().realDeltaTime = 0.1f;
+			recording.AddFrame().scroll = { 0.0f, 1.0f };
+
+			std::vector<char> data;
+			recording.Compile(data);
+			data.pop_back();
+
+			InputRecording loaded;
+			Assert::IsFalse(loaded.Decompile(data));
+			Assert::AreEqual(size_t(0), loaded.GetFrameCount());
+		}
+
+		TEST_METHOD(Decompile_RejectsOversizedFrameCount)
+		{
+			InputRecording recording;
+			recording.Begin(0);
+			recording.AddFrame().realDeltaTime = 0.1f;
+
+			std::vector<char> data;
+			recording.Compile(data);
+
+			// The frame count follows the magic, version and seed.
+			constexpr UINT frameCount = UINT_MAX;
+			memcpy(&data[12], &frameCount, sizeof(frameCount));
+
+			InputRecording loaded;
+			Assert::IsFalse(loaded.Decompile(data));
+			Assert::AreEqual(size_t(0), loaded.GetFrameCount());
+		}
+	};
+}
@@ -0,0 +1,98 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Utils/JobSystem.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestUtils;
+
+namespace T_Utils
+{
+	TEST_CLASS(T_JobSystem)
+	{
+	public:
+		TEST_CLASS_INITIALIZE(StartWorkers)
+		{
+			Assert::IsTrue(JobSystem::Instance().Initialize(3));
+		}
+
+		TEST_CLASS_CLEANUP(StopWorkers)
+		{
+			JobSystem::Instance().Shutdown();
+		}
+
+		TEST_METHOD(ParallelFor_VisitsEveryIndexOnce)
+		{
+			constexpr UINT count = 10000;
+			std::vector<std::atomic<UINT>> visits(count);
+
+			JobSystem::Instance().ParallelFor(count, 16, [&](UINT begin, UINT end) {
+				for (UINT i = begin; i < end; i++)
+					visits[i]++;
+			});
+
+			for (UINT i = 0; i < count; i++)
+				Assert::AreEqual(1u, visits[i].load());
+		}
+
+		TEST_METHOD(Run_WaitsForDependencies)
+		{
+			JobSystem &jobSystem = JobSystem::Instance();
+			JobGroup first, second;
+
+			std::atomic<UINT> firstDone = 0;
+			std::atomic_bool startedEarly = false;
+
+			jobSystem.ParallelFor(first, 64, 1, [&](UINT begin, UINT end) {
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+				firstDone += end - begin;
+			});
+
+			jobSystem.Run(second, [&]() {
+				if (firstDone.load() != 64)
+					startedEarly = true;
+			}, "Dependent", { &first });
+
+			jobSystem.Wait(second);
+
+			Assert::IsTrue(first.IsDone());
+			Assert::IsFalse(startedEarly.load());
+		}
+
+		TEST_METHOD(Wait_NestedInJob)
+		{
+			JobSystem &jobSystem = JobSystem::Instance();
+			JobGroup outer;
+
+			std::atomic<UINT> total = 0;
+			jobSystem.ParallelFor(outer, 8, 1, [&](UINT begin, UINT end) {
+				for (UINT i = begin; i < end; i++)
+				{
+					jobSystem.ParallelFor(100, 1, [&](UINT innerBegin, UINT innerEnd) {
+						total += innerEnd - innerBegin;
+					});
+				}
+			});
+			jobSystem.Wait(outer);
+
+			Assert::AreEqual(800u, total.load());
+		}
+
+		TEST_METHOD(Wait_WakesWhenGroupReleased)
+		{
+			JobSystem &jobSystem = JobSystem::Instance();
+			JobGroup held;
+
+			// Nothing is queued for the waiting thread to run, so it sleeps until the group is released elsewhere.
+			jobSystem.Hold(held);
+			std::thread releaser([&]() {
+				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+				jobSystem.Release(held);
+			});
+
+			jobSystem.Wait(held);
+			Assert::IsTrue(held.IsDone());
+
+			releaser.join();
+		}
+	};
+}
@@ -0,0 +1,60 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Utils/ObjectPool.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestUtils;
+
+namespace T_Utils
+{
+	TEST_CLASS(T_ObjectPool)
+	{
+	public:
+		TEST_METHOD(Allocate_ReusesFreedSlots)
+		{
+			ObjectPool pool("Test", 40, 4);
+
+			void *first = pool.Allocate();
+			void *second = pool.Allocate();
+			Assert::IsTrue(pool.Owns(first) && pool.Owns(second));
+			Assert::AreEqual(size_t(0), reinterpret_cast<uintptr_t>(second) % ObjectPool::SLOT_ALIGNMENT);
+			Assert::AreEqual(2u, pool.GetLiveCount());
+			Assert::AreEqual(4u, pool.GetCapacity());
+
+			Assert::IsTrue(pool.Free(first));
+			Assert::IsTrue(pool.Allocate() == first);
+
+			int notPooled = 0;
+			Assert::IsFalse(pool.Owns(&notPooled));
+			Assert::IsFalse(pool.Free(&notPooled));
+			Assert::AreEqual(2u, pool.GetLiveCount());
+		}
+
+		TEST_METHOD(ReleaseEmptyBlocks_KeepsLiveObjects)
+		{
+			ObjectPool pool("Test", 16, 4);
+
+			std::vector<void *> objects;
+			for (UINT i = 0; i < 12; i++)
+				objects.emplace_back(pool.Allocate());
+			Assert::AreEqual(12u, pool.GetCapacity());
+
+			// Empty the first and last block, keep one object in the middle one.
+			for (UINT i = 0; i < 12; i++)
+			{
+				if (i != 5)
+					pool.Free(objects[i]);
+			}
+
+			const size_t reservedBytes = pool.GetReservedBytes();
+			Assert::AreEqual(reservedBytes * 2 / 3, pool.ReleaseEmptyBlocks());
+			Assert::AreEqual(4u, pool.GetCapacity());
+			Assert::IsTrue(pool.Owns(objects[5]));
+
+			// The free slots left all belong to the remaining block.
+			for (UINT i = 0; i < 3; i++)
+				Assert::IsTrue(pool.Owns(pool.Allocate()));
+			Assert::AreEqual(4u, pool.GetCapacity());
+		}
+	};
+}
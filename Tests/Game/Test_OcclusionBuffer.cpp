@@ -0,0 +1,150 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Rendering/Culling/OcclusionBuffer.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestUtils;
+
+namespace T_Culling
+{
+	// Camera at the origin looking down +z, matching the engine's left-handed projection.
+	static dx::XMFLOAT4X4 CreateViewProj()
+	{
+		dx::XMFLOAT4X4 viewProj;
+		dx::XMStoreFloat4x4(&viewProj, dx::XMMatrixPerspectiveFovLH(80.0f * (dx::XM_PI / 180.0f), 16.0f / 9.0f, 0.1f, 100.0f));
+		return viewProj;
+	}
+
+	static dx::XMFLOAT4X4 CreateWorld(float x, float y, float z)
+	{
+		dx::XMFLOAT4X4 world;
+		dx::XMStoreFloat4x4(&world, dx::XMMatrixTranslation(x, y, z));
+		return world;
+	}
+
+	// Axis-aligned quad facing the camera, centered on the origin.
+	static const float QUAD_VERTICES[] = {
+		-1.0f, -1.0f, 0.0f,
+		 1.0f, -1.0f, 0.0f,
+		 1.0f,  1.0f, 0.0f,
+		-1.0f,  1.0f, 0.0f
+	};
+	static const UINT QUAD_INDICES[] = { 0, 1, 2, 0, 2, 3 };
+
+	static void RasterizeQuad(OcclusionBuffer &buffer, float x, float y, float z, float scale)
+	{
+		dx::XMFLOAT4X4 world;
+		dx::XMStoreFloat4x4(&world, dx::XMMatrixScaling(scale, scale, 1.0f) * dx::XMMatrixTranslation(x, y, z));
+		buffer.RasterizeOccluder(QUAD_VERTICES, sizeof(float) * 3, 4, QUAD_INDICES, 6, world);
+	}
+
+	static UINT CountVisible(const OcclusionBuffer &buffer, const std::vector<dx::BoundingBox> &boxes)
+	{
+		UINT visible = 0;
+		for (const dx::BoundingBox &box : boxes)
+			visible += buffer.IsVisible(box) ? 1 : 0;
+		return visible;
+	}
+
+	TEST_CLASS(T_OcclusionBuffer)
+	{
+	public:
+		TEST_METHOD(Initialize_RejectsUnalignedResolution)
+		{
+			OcclusionBuffer buffer;
+			Assert::IsFalse(buffer.Initialize(OcclusionBuffer::TILE_WIDTH + 1, OcclusionBuffer::TILE_HEIGHT));
+			Assert::IsTrue(buffer.Initialize());
+		}
+
+		TEST_METHOD(EmptyBuffer_EverythingVisible)
+		{
+			OcclusionBuffer buffer;
+			Assert::IsTrue(buffer.Initialize());
+			buffer.Clear(CreateViewProj());
+			buffer.Finalize();
+
+			Assert::IsTrue(buffer.IsVisible(dx::BoundingBox({ 0, 0, 50 }, { 1, 1, 1 })));
+		}
+
+		TEST_METHOD(Wall_CullsOnlyBoxesBehindIt)
+		{
+			OcclusionBuffer buffer;
+			Assert::IsTrue(buffer.Initialize());
+			buffer.Clear(CreateViewProj());
+			RasterizeQuad(buffer, 0, 0, 10, 6);
+			buffer.Finalize();
+
+			Assert::AreEqual(2u, buffer.GetOccluderTriangleCount());
+
+			Assert::IsFalse(buffer.IsVisible(dx::BoundingBox({ 0, 0, 20 }, { 1, 1, 1 })));
+			Assert::IsFalse(buffer.IsVisible(dx::BoundingBox({ 5, 0, 20 }, { 1, 1, 1 })));
+			Assert::IsTrue(buffer.IsVisible(dx::BoundingBox({ 0, 0, 5 }, { 1, 1, 1 })));
+			Assert::IsTrue(buffer.IsVisible(dx::BoundingBox({ 30, 0, 20 }, { 1, 1, 1 })));
+
+			// Boxes poking out past the edge of the wall stay visible.
+			Assert::IsTrue(buffer.IsVisible(dx::BoundingBox({ 12, 0, 20 }, { 1, 1, 1 })));
+		}
+
+		TEST_METHOD(OccluderCrossingNearPlane_IsClipped)
+		{
+			OcclusionBuffer buffer;
+			Assert::IsTrue(buffer.Initialize());
+			buffer.Clear(CreateViewProj());
+
+			// Floor running underneath and behind the camera.
+			const float floorVertices[] = {
+				-50.0f, -1.0f, -50.0f,
+				 50.0f, -1.0f, -50.0f,
+				 50.0f, -1.0f,  50.0f,
+				-50.0f, -1.0f,  50.0f
+			};
+			buffer.RasterizeOccluder(floorVertices, sizeof(float) * 3, 4, QUAD_INDICES, 6, CreateWorld(0, 0, 0));
+			buffer.Finalize();
+
+			Assert::IsTrue(buffer.GetOccluderTriangleCount() > 0);
+			Assert::IsFalse(buffer.IsVisible(dx::BoundingBox({ 0, -3, 10 }, { 1, 1, 1 })));
+			Assert::IsTrue(buffer.IsVisible(dx::BoundingBox({ 0, 1, 10 }, { 1, 1, 1 })));
+		}
+
+		TEST_METHOD(BoundsCrossingNearPlane_AreVisible)
+		{
+			OcclusionBuffer buffer;
+			Assert::IsTrue(buffer.Initialize());
+			buffer.Clear(CreateViewProj());
+			RasterizeQuad(buffer, 0, 0, 1, 20);
+			buffer.Finalize();
+
+			Assert::IsTrue(buffer.IsVisible(dx::BoundingBox({ 0, 0, 0 }, { 2, 2, 2 })));
+		}
+
+		// A cave-like layout: a tunnel segment closed off by a rock face, with props scattered
+		// in front of and behind it. Only the props in front of the rock face may survive.
+		TEST_METHOD(CaveLayout_CulledCounts)
+		{
+			OcclusionBuffer buffer;
+			Assert::IsTrue(buffer.Initialize());
+			buffer.Clear(CreateViewProj());
+
+			RasterizeQuad(buffer, 0, 0, 25, 40);	// Rock face closing the tunnel
+			RasterizeQuad(buffer, -6, 0, 12, 4);	// Pillar on the left side
+
+			buffer.Finalize();
+			Assert::AreEqual(2u, buffer.GetOccluderCount());
+
+			std::vector<dx::BoundingBox> inFront, behindRock, behindPillar;
+			for (int i = 0; i < 8; i++)
+			{
+				const float offset = static_cast<float>(i) - 3.5f;
+				inFront.emplace_back(dx::XMFLOAT3(offset * 2.0f, -1.0f, 8.0f), dx::XMFLOAT3(0.5f, 0.5f, 0.5f));
+				behindRock.emplace_back(dx::XMFLOAT3(offset * 4.0f, offset, 35.0f + i), dx::XMFLOAT3(1.0f, 1.0f, 1.0f));
+			}
+
+			for (int i = 0; i < 4; i++)
+				behindPillar.emplace_back(dx::XMFLOAT3(-7.0f, -1.0f + i * 0.5f, 16.0f + i), dx::XMFLOAT3(0.25f, 0.25f, 0.25f));
+
+			Assert::AreEqual(static_cast<UINT>(inFront.size()), CountVisible(buffer, inFront));
+			Assert::AreEqual(0u, CountVisible(buffer, behindRock));
+			Assert::AreEqual(0u, CountVisible(buffer, behindPillar));
+		}
+	};
+}
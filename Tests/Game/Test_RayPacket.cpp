@@ -0,0 +1,133 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Collision/RayPacket.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestUtils;
+
+namespace T_Collision
+{
+	static float GetLane(dx::FXMVECTOR v, UINT lane)
+	{
+		dx::XMFLOAT4 values;
+		dx::XMStoreFloat4(&values, v);
+		return (&values.x)[lane];
+	}
+
+	// Triangle in the z = 5 plane, facing -z towards rays cast down +z.
+	static const Shape::Tri FACING_TRI = {
+		{ -1.0f, -1.0f, 5.0f },
+		{ -1.0f,  1.0f, 5.0f },
+		{  1.0f, -1.0f, 5.0f }
+	};
+
+	TEST_CLASS(T_RayPacket)
+	{
+	public:
+		TEST_METHOD(PartialPacket_OnlyUsedLanesHit)
+		{
+			const Shape::Ray rays[] = {
+				Shape::Ray({ 0, 0, 0 }, { 0, 0, 1 }),
+				Shape::Ray({ 0, 0, 0 }, { 0, 0, 1 })
+			};
+
+			const RayPacket packet(rays, 2);
+			Assert::AreEqual(0b0011u, packet.laneMask);
+
+			dx::XMVECTOR entry;
+			const UINT mask = packet.Intersects(dx::BoundingBox({ 0, 0, 5 }, { 1, 1, 1 }), RAY_PACKET_FULL_MASK, dx::XMVectorReplicate(FLT_MAX), entry);
+			Assert::AreEqual(0b0011u, mask);
+		}
+
+		TEST_METHOD(BoxSlabs_MatchBoundingBox)
+		{
+			const dx::BoundingBox box({ 2, 0, 10 }, { 1, 2, 1 });
+
+			const Shape::Ray rays[RAY_PACKET_SIZE] = {
+				Shape::Ray({ 2, 0, 0 }, { 0, 0, 1 }),		// Straight through
+				Shape::Ray({ 0, 0, 0 }, { 0, 0, 1 }),		// Passes beside the box
+				Shape::Ray({ 2, 0, 10 }, { 1, 0, 0 }),		// Starts inside
+				Shape::Ray({ 2, 0, 20 }, { 0, 0, 1 })		// Box is behind the origin
+			};
+
+			const RayPacket packet(rays, RAY_PACKET_SIZE);
+
+			dx::XMVECTOR entry;
+			const UINT mask = packet.Intersects(box, packet.laneMask, dx::XMVectorReplicate(FLT_MAX), entry);
+
+			for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+			{
+				float expected = 0.0f;
+				const bool expectHit = box.Contains(dx::XMLoadFloat3(&rays[lane].origin)) ||
+					box.Intersects(dx::XMLoadFloat3(&rays[lane].origin), dx::XMLoadFloat3(&rays[lane].direction), expected);
+
+				Assert::AreEqual(expectHit, (mask & (1u << lane)) != 0);
+
+				if (expectHit)
+					Assert::AreEqual(expected, GetLane(entry, lane), 0.0001f);
+			}
+
+			Assert::AreEqual(9.0f, GetLane(entry, 0), 0.0001f);
+			Assert::AreEqual(0.0f, GetLane(entry, 2), 0.0001f);
+		}
+
+		TEST_METHOD(Box_RespectsMaxLength)
+		{
+			const Shape::Ray rays[] = {
+				Shape::Ray({ 0, 0, 0 }, { 0, 0, 1 }),
+				Shape::Ray({ 0, 0, 0 }, { 0, 0, 1 })
+			};
+
+			const RayPacket packet(rays, 2);
+
+			dx::XMVECTOR entry;
+			const UINT mask = packet.Intersects(dx::BoundingBox({ 0, 0, 10 }, { 1, 1, 1 }), packet.laneMask, dx::XMVectorSet(20.0f, 5.0f, 0.0f, 0.0f), entry);
+			Assert::AreEqual(0b0001u, mask);
+		}
+
+		TEST_METHOD(Tri_HitsFrontAndCullsBack)
+		{
+			const Shape::Ray rays[RAY_PACKET_SIZE] = {
+				Shape::Ray({ -0.5f, -0.5f, 0 }, { 0, 0, 1 }),	// Inside the triangle
+				Shape::Ray({ 0.9f, 0.9f, 0 }, { 0, 0, 1 }),		// Inside the bounds, outside the triangle
+				Shape::Ray({ -0.5f, -0.5f, 10 }, { 0, 0, -1 }),	// Back face
+				Shape::Ray({ -0.5f, -0.5f, 6 }, { 0, 0, 1 })		// Triangle is behind the origin
+			};
+
+			const RayPacket packet(rays, RAY_PACKET_SIZE);
+
+			dx::XMVECTOR length;
+			const UINT mask = packet.Intersects(FACING_TRI, packet.laneMask, dx::XMVectorReplicate(FLT_MAX), length);
+			Assert::AreEqual(0b0001u, mask);
+			Assert::AreEqual(5.0f, GetLane(length, 0), 0.0001f);
+
+			Shape::RayHit hit;
+			packet.GetTriHit(FACING_TRI, 0, GetLane(length, 0), hit);
+			Assert::AreEqual(5.0f, hit.length, 0.0001f);
+			Assert::AreEqual(5.0f, hit.point.z, 0.0001f);
+			Assert::AreEqual(-1.0f, hit.normal.z, 0.0001f);
+		}
+
+		TEST_METHOD(Tri_RespectsMaxLength)
+		{
+			const Shape::Ray rays[] = {
+				Shape::Ray({ -0.5f, -0.5f, 0 }, { 0, 0, 1 }),
+				Shape::Ray({ -0.5f, -0.5f, 0 }, { 0, 0, 1 })
+			};
+
+			const RayPacket packet(rays, 2);
+
+			dx::XMVECTOR length;
+			const UINT mask = packet.Intersects(FACING_TRI, packet.laneMask, dx::XMVectorSet(4.0f, 6.0f, 0.0f, 0.0f), length);
+			Assert::AreEqual(0b0010u, mask);
+		}
+
+		TEST_METHOD(GetOctant_GroupsBySign)
+		{
+			Assert::AreEqual(0u, RayPacket::GetOctant(Shape::Ray({ 0, 0, 0 }, { 1, 1, 1 })));
+			Assert::AreEqual(7u, RayPacket::GetOctant(Shape::Ray({ 0, 0, 0 }, { -1, -1, -1 })));
+			Assert::AreEqual(RayPacket::GetOctant(Shape::Ray({ 5, 0, 0 }, { 0.2f, -1, 0.1f })),
+				RayPacket::GetOctant(Shape::Ray({ -5, 3, 0 }, { 0.8f, -0.3f, 0.5f })));
+		}
+	};
+}
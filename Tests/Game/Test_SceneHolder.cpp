@@ -0,0 +1,78 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Game/Scenes/SceneHolder.h"
+#include "Game/Behaviour.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestUtils;
+
+namespace T_Game
+{
+	// Walks every scene accessor while its entity is being deleted.
+	class SceneProbeBehaviour : public Behaviour
+	{
+	private:
+		SceneHolder *_holder;
+		UINT *_visited;
+
+	public:
+		SceneProbeBehaviour(SceneHolder *holder, UINT *visited) : _holder(holder), _visited(visited) { }
+
+		~SceneProbeBehaviour() override
+		{
+			SceneContents::SceneIterator it = _holder->GetEntities();
+			while (it.Step())
+				(*_visited)++;
+
+			// Unfiltered access hands out null for the detached slots instead of dereferencing them.
+			it.ToBegin();
+			for (UINT i = 0; i < it.size(); i++)
+			{
+				Entity *peeked = it.Peek();
+				Assert::IsTrue(peeked == it.Step(false));
+				Assert::IsTrue(peeked == it[i]);
+				Assert::IsTrue(peeked == _holder->GetEntity(i));
+			}
+
+			Assert::IsNull(_holder->GetEntityByID(0));
+			Assert::IsNull(_holder->GetEntityByDeserializedID(0));
+		}
+
+		[[nodiscard]] bool Start() override
+		{
+			_name = "SceneProbeBehaviour";
+			return true;
+		}
+	};
+
+	TEST_CLASS(T_SceneHolder)
+	{
+	public:
+		TEST_METHOD(RemoveEntity_DestructorIteratesScene)
+		{
+			const dx::BoundingOrientedBox bounds({ 0,0,0 }, { 1,1,1 }, { 0,0,0,1 });
+
+			SceneHolder holder;
+			Assert::IsTrue(holder.Initialize(dx::BoundingBox({ 0,0,0 }, { 10,10,10 })));
+
+			Entity *first = holder.AddEntity(bounds, false);
+			Entity *second = holder.AddEntity(bounds, false);
+			Entity *kept = holder.AddEntity(bounds, false);
+
+			UINT visited = 0;
+			Assert::IsTrue((new SceneProbeBehaviour(&holder, &visited))->Initialize(first));
+			Assert::IsTrue((new SceneProbeBehaviour(&holder, &visited))->Initialize(second));
+
+			// Both removals are flushed in one update, so the second destructor runs with an earlier slot already detached.
+			Assert::IsTrue(holder.RemoveEntity(first));
+			Assert::IsTrue(holder.RemoveEntity(second));
+			Assert::IsTrue(holder.Update());
+
+			// Removed entities are skipped, only the kept one is visited by each destructor.
+			Assert::AreEqual(2u, visited);
+			Assert::AreEqual(1u, holder.GetEntityCount());
+			Assert::IsTrue(holder.GetEntity(0) == kept);
+			Assert::AreEqual(0u, kept->GetSceneIndex());
+		}
+	};
+}
@@ -1,6 +1,8 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
 #include "Game/Transform.h"
+#include "Game/TransformHierarchy.h"
+#include "Game/TransformChangeLog.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace TestUtils;
@@ -22,5 +24,68 @@ namespace T_Game
 			Transform t{};
 			TestUtility::TransformTest(&t);
 		}
+
+		TEST_METHOD(Hierarchy_MatchesLazyWorldMatrix)
+		{
+			Transform parent{}, child{};
+			child.SetParent(&parent);
+			parent.SetPosition(dx::XMFLOAT3A(1.0f, 2.0f, 3.0f));
+			child.SetPosition(dx::XMFLOAT3A(0.0f, 0.0f, 5.0f));
+			child.SetScale(dx::XMFLOAT3A(2.0f, 2.0f, 2.0f));
+
+			const dx::XMFLOAT4X4A expected = child.GetWorldMatrix();
+
+			TransformHierarchy hierarchy;
+			hierarchy.Add(&child);
+			hierarchy.Add(&parent);
+			hierarchy.Update();
+
+			Assert::AreEqual(2u, hierarchy.GetCount());
+			Assert::AreEqual(2u, hierarchy.GetLevelCount());
+
+			const dx::XMFLOAT4X4A &world = child.GetWorldMatrix();
+			for (int row = 0; row < 4; row++)
+				for (int col = 0; col < 4; col++)
+					Assert::AreEqual(expected.m[row][col], world.m[row][col], 0.0001f);
+
+			// Changes after the update are still resolved on access.
+			parent.SetPosition(dx::XMFLOAT3A(-1.0f, 0.0f, 0.0f));
+			Assert::AreEqual(-1.0f, child.GetWorldMatrix()._41, 0.0001f);
+
+			hierarchy.Remove(&parent);
+			hierarchy.Remove(&child);
+			Assert::AreEqual(0u, hierarchy.GetCount());
+			Assert::IsNull(child.GetHierarchy());
+			Assert::AreEqual(5.0f, child.GetWorldMatrix()._43, 0.0001f);
+		}
+
+		TEST_METHOD(ChangeLog_RecordsOncePerConsume)
+		{
+			TransformChangeLog log;
+			Transform parent{}, child{};
+			child.SetParent(&parent);
+			parent.SetChangeLog(&log, nullptr);
+			child.SetChangeLog(&log, nullptr);
+
+			parent.SetPosition(dx::XMFLOAT3A(1.0f, 0.0f, 0.0f));
+			parent.SetRotation(dx::XMFLOAT4A(0.0f, 0.0f, 0.0f, 1.0f));
+			parent.SetScale(dx::XMFLOAT3A(2.0f, 2.0f, 2.0f));
+
+			// The child is recorded through its parent, and neither more than once.
+			Assert::AreEqual(2u, log.GetCount());
+			Assert::IsTrue(child.IsChangeLogged());
+
+			std::vector<Transform *> changed;
+			log.Consume(changed);
+			Assert::AreEqual(static_cast<size_t>(2), changed.size());
+			Assert::IsTrue(log.IsEmpty());
+			Assert::IsFalse(parent.IsChangeLogged());
+
+			child.SetPosition(dx::XMFLOAT3A(0.0f, 1.0f, 0.0f));
+			Assert::AreEqual(1u, log.GetCount());
+
+			child.SetChangeLog(nullptr, nullptr);
+			Assert::IsTrue(log.IsEmpty());
+		}
 	};
 }
@@ -18,40 +18,49 @@ bool CollisionHandler::Initialize(Scene *scene)
 {
 	ZoneScopedC(RandomUniqueColor());
 
-	SceneHolder *sh = scene->GetSceneHolder();
+	GatherColliders(scene);
+
+	return true;
+}
+
+void CollisionHandler::GatherColliders(Scene *scene)
+{
+	ZoneScopedC(RandomUniqueColor());
 
-	SceneContents::SceneIterator entIter = sh->GetEntities();
-	_entitiesToCheck.reserve(entIter.size());
-	_collidersToCheck.reserve(entIter.size());
-	_colliderBehavioursToCheck.reserve(entIter.size());
+	std::vector<ColliderBehaviour *> colBehaviours;
+	scene->GetBehavioursDerivedFrom<ColliderBehaviour>(colBehaviours);
 
-	// Check if entities have colliders
-	while (Entity *ent = entIter.Step())
+	_entitiesToCheck.clear();
+	_collidersToCheck.clear();
+	_colliderBehavioursToCheck.clear();
+
+	_entitiesToCheck.reserve(colBehaviours.size());
+	_collidersToCheck.reserve(colBehaviours.size());
+	_colliderBehavioursToCheck.reserve(colBehaviours.size());
+
+	for (ColliderBehaviour *colBehaviour : colBehaviours)
 	{
-		ColliderBehaviour *colBehaviour;
+		Entity *ent = colBehaviour->GetEntity();
 
-		if (ent->GetBehaviourByType<ColliderBehaviour>(colBehaviour))
-		{
-			const Collider *col = colBehaviour->GetCollider();
-			if (col)
-			{
-				if (col->colliderType != NULL_COLLIDER)
-				{
-					// Reset Intersecting status
+		// Only entities held by the scene holder are checked, not global or removed ones.
+		if (ent->IsRemoved() || ent->GetSceneIndex() == CONTENT_NULL)
+			continue;
 
-					// Add collider and entity to be checked
-					_collidersToCheck.emplace_back(col);
-					_entitiesToCheck.emplace_back(ent);
-					_colliderBehavioursToCheck.emplace_back(colBehaviour);
-				}
-			}
-		}
-	}
+		const Collider *col = colBehaviour->GetCollider();
+		if (!col)
+			continue;
 
-	return true;
+		if (col->colliderType == NULL_COLLIDER)
+			continue;
+
+		// Add collider and entity to be checked
+		_collidersToCheck.emplace_back(col);
+		_entitiesToCheck.emplace_back(ent);
+		_colliderBehavioursToCheck.emplace_back(colBehaviour);
+	}
 }
 
-bool CollisionHandler::CheckCollisions(TimeUtils &time, Scene *scene, ID3D11DeviceContext *context)
+bool CollisionHandler::CheckCollisions(TimeUtils &time, Scene *scene)
 {
 	ZoneScopedC(RandomUniqueColor());
 
@@ -67,43 +76,7 @@ bool CollisionHandler::CheckCollisions(TimeUtils &time, Scene *scene, ID3D11Devi
 	{
 		ZoneNamedNC(tracyRecalculateCollidersZone, "Recalculate Colliders", RandomUniqueColor(), true);
 
-		SceneContents::SceneIterator entIter = sh->GetEntities();
-
-		size_t prevEntToCheckSize = _entitiesToCheck.size();
-		size_t prevColToCheckSize = _collidersToCheck.size();
-		size_t prevColBehToCheckSize = _colliderBehavioursToCheck.size();
-
-		_entitiesToCheck.clear();
-		_collidersToCheck.clear();
-		_colliderBehavioursToCheck.clear();
-
-		_entitiesToCheck.reserve(entIter.size());
-		_collidersToCheck.reserve(entIter.size());
-		_colliderBehavioursToCheck.reserve(entIter.size());
-
-		// Check if entities have colliders
-		while (Entity *ent = entIter.Step())
-		{
-			std::vector<ColliderBehaviour*> colBehaviours;
-
-			if (ent->GetBehavioursByType<ColliderBehaviour>(colBehaviours))
-			{
-				for (auto colBehaviour : colBehaviours)
-				{
-					const Collider *col = colBehaviour->GetCollider();
-					if (col)
-					{
-						if (col->colliderType != NULL_COLLIDER)
-						{
-							// Add collider and entity to be checked
-							_collidersToCheck.emplace_back(col);
-							_entitiesToCheck.emplace_back(ent);
-							_colliderBehavioursToCheck.emplace_back(colBehaviour);
-						}
-					}
-				}
-			}
-		}
+		GatherColliders(scene);
 	}
 
 	std::vector<bool> wasIntersecting(_entitiesToCheck.size());
@@ -255,43 +228,7 @@ bool CollisionHandler::CheckCollision(const Collider *col, Scene *scene, Collisi
 	{
 		ZoneNamedNC(tracyRecalculateCollidersZone, "Recalculate Colliders", RandomUniqueColor(), true);
 
-		SceneContents::SceneIterator entIter = sh->GetEntities();
-
-		size_t prevEntToCheckSize = _entitiesToCheck.size();
-		size_t prevColToCheckSize = _collidersToCheck.size();
-		size_t prevColBehToCheckSize = _colliderBehavioursToCheck.size();
-
-		_entitiesToCheck.clear();
-		_collidersToCheck.clear();
-		_colliderBehavioursToCheck.clear();
-
-		_entitiesToCheck.reserve(entIter.size());
-		_collidersToCheck.reserve(entIter.size());
-		_colliderBehavioursToCheck.reserve(entIter.size());
-
-		// Check if entities have colliders
-		while (Entity *ent = entIter.Step())
-		{
-			std::vector<ColliderBehaviour*> colBehaviours;
-
-			if (ent->GetBehavioursByType<ColliderBehaviour>(colBehaviours))
-			{
-				for (auto colBehaviour : colBehaviours)
-				{
-					const Collider *col = colBehaviour->GetCollider();
-					if (col)
-					{
-						if (col->colliderType != NULL_COLLIDER)
-						{
-							// Add collider and entity to be checked
-							_collidersToCheck.emplace_back(col);
-							_entitiesToCheck.emplace_back(ent);
-							_colliderBehavioursToCheck.emplace_back(colBehaviour);
-						}
-					}
-				}
-			}
-		}
+		GatherColliders(scene);
 	}
 
 	for (int j = 0; j < _collidersToCheck.size(); j++)
@@ -12,7 +12,8 @@ public:
 	~CollisionHandler() = default;
 
 	bool Initialize(Scene *scene);
-	bool CheckCollisions(TimeUtils &time, Scene *scene, ID3D11DeviceContext *context);
+	// Runs the collision callbacks, which may only change entities. The scene updates sound and graphics alongside it.
+	bool CheckCollisions(TimeUtils &time, Scene *scene);
 
 	bool CheckCollision(const Collisions::Collider *col, Scene *scene, Collisions::CollisionData &data);
 
@@ -21,6 +22,9 @@ private:
 	std::vector<Entity *> _entitiesToCheck;
 	std::vector<ColliderBehaviour *> _colliderBehavioursToCheck;
 
+	// Rebuilds the lists of colliders to check from the scene's collider behaviours.
+	void GatherColliders(Scene *scene);
+
 	TESTABLE()
 };
 
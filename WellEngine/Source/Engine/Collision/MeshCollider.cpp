@@ -51,13 +51,13 @@ void MeshCollider::Node::CalculateCompactBounds()
 	{
 		for (int i = 0; i < CHILD_COUNT; i++)
 		{
-			if (!children[i])
+			if (children[i] == NULL_POOL_NODE)
 				continue;
 
-			if (children[i]->isEmpty)
+			if (GetChild(i)->isEmpty)
 				continue;
 
-			dx::BoundingBox &childCompactBounds = children[i]->compactBounds;
+			dx::BoundingBox &childCompactBounds = GetChild(i)->compactBounds;
 
 			dx::XMFLOAT3 childMin = {
 				childCompactBounds.Center.x - childCompactBounds.Extents.x, 
@@ -166,31 +166,28 @@ void MeshCollider::Node::Bake(const std::vector<UINT> *allTriIndices, const UINT
 		min = { center.x - extents.x, center.y - extents.y, center.z - extents.z },
 		max = { center.x + extents.x, center.y + extents.y, center.z + extents.z };
 
-	children[0] = std::make_unique<Node>();
-	children[1] = std::make_unique<Node>();
-	children[2] = std::make_unique<Node>();
-	children[3] = std::make_unique<Node>();
-	children[4] = std::make_unique<Node>();
-	children[5] = std::make_unique<Node>();
-	children[6] = std::make_unique<Node>();
-	children[7] = std::make_unique<Node>();
-
-	dx::BoundingBox::CreateFromPoints(children[0]->bounds, { min.x,	   min.y,	 min.z,    0 }, { center.x, center.y, center.z,	0 });
-	dx::BoundingBox::CreateFromPoints(children[1]->bounds, { center.x, min.y,	 min.z,	   0 }, { max.x,	center.y, center.z,	0 });
-	dx::BoundingBox::CreateFromPoints(children[2]->bounds, { min.x,	   min.y,	 center.z, 0 }, { center.x, center.y, max.z,	0 });
-	dx::BoundingBox::CreateFromPoints(children[3]->bounds, { center.x, min.y,	 center.z, 0 }, { max.x,	center.y, max.z,	0 });
-	dx::BoundingBox::CreateFromPoints(children[4]->bounds, { min.x,	   center.y, min.z,	   0 }, { center.x, max.y,	  center.z,	0 });
-	dx::BoundingBox::CreateFromPoints(children[5]->bounds, { center.x, center.y, min.z,	   0 }, { max.x,	max.y,	  center.z,	0 });
-	dx::BoundingBox::CreateFromPoints(children[6]->bounds, { min.x,	   center.y, center.z, 0 }, { center.x, max.y,	  max.z,	0 });
-	dx::BoundingBox::CreateFromPoints(children[7]->bounds, { center.x, center.y, center.z, 0 }, { max.x,	max.y,	  max.z,	0 });
+	for (int i = 0; i < CHILD_COUNT; i++)
+	{
+		children[i] = pool->Allocate();
+		GetChild(i)->pool = pool;
+	}
+
+	dx::BoundingBox::CreateFromPoints(GetChild(0)->bounds, { min.x,	   min.y,	 min.z,    0 }, { center.x, center.y, center.z,	0 });
+	dx::BoundingBox::CreateFromPoints(GetChild(1)->bounds, { center.x, min.y,	 min.z,	   0 }, { max.x,	center.y, center.z,	0 });
+	dx::BoundingBox::CreateFromPoints(GetChild(2)->bounds, { min.x,	   min.y,	 center.z, 0 }, { center.x, center.y, max.z,	0 });
+	dx::BoundingBox::CreateFromPoints(GetChild(3)->bounds, { center.x, min.y,	 center.z, 0 }, { max.x,	center.y, max.z,	0 });
+	dx::BoundingBox::CreateFromPoints(GetChild(4)->bounds, { min.x,	   center.y, min.z,	   0 }, { center.x, max.y,	  center.z,	0 });
+	dx::BoundingBox::CreateFromPoints(GetChild(5)->bounds, { center.x, center.y, min.z,	   0 }, { max.x,	max.y,	  center.z,	0 });
+	dx::BoundingBox::CreateFromPoints(GetChild(6)->bounds, { min.x,	   center.y, center.z, 0 }, { center.x, max.y,	  max.z,	0 });
+	dx::BoundingBox::CreateFromPoints(GetChild(7)->bounds, { center.x, center.y, center.z, 0 }, { max.x,	max.y,	  max.z,	0 });
 	
 	// Distribute triangles to children
 	for (int i = 0; i < 8; i++)
 	{
-		children[i]->triBufferPtr = triBufferPtr;
-		children[i]->Bake(&triIndices, depth + 1);
+		GetChild(i)->triBufferPtr = triBufferPtr;
+		GetChild(i)->Bake(&triIndices, depth + 1);
 
-		if (!children[i]->isEmpty)
+		if (!GetChild(i)->isEmpty)
 			isEmpty = false;
 	}
 
@@ -263,7 +260,7 @@ bool MeshCollider::Node::RaycastNode(const Shape::Ray &ray, Shape::RayHit &hit)
 	int childHitCount = CHILD_COUNT;
 	for (int i = 0; i < childHitCount; i++)
 	{
-		const Node *child = children[childHits[i].index].get();
+		const Node *child = GetChild(childHits[i].index);
 		if (Raycast(ray.origin, ray.direction, child->compactBounds, childHits[i].length))
 		{
 			if (childHits[i].length <= hit.length)
@@ -296,7 +293,7 @@ bool MeshCollider::Node::RaycastNode(const Shape::Ray &ray, Shape::RayHit &hit)
 
 	for (int i = 0; i < childHitCount; i++)
 	{
-		if (children[childHits[i].index]->RaycastNode(ray, newHit))
+		if (GetChild(childHits[i].index)->RaycastNode(ray, newHit))
 		{
 			if (newHit.length >= hit.length)
 				continue;
@@ -309,6 +306,115 @@ bool MeshCollider::Node::RaycastNode(const Shape::Ray &ray, Shape::RayHit &hit)
 	return hasHit;
 }
 
+UINT MeshCollider::Node::RaycastPacket(const RayPacket &packet, UINT mask, Shape::RayHit *hits) const
+{
+	if (isEmpty)
+		return 0;
+
+	// Too few rays left for SIMD to pay off, trace them one at a time.
+	if (RayPacket::GetLaneCount(mask) < RAY_PACKET_MIN_LANES)
+	{
+		UINT hitMask = 0;
+		for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+		{
+			if (!(mask & (1u << lane)))
+				continue;
+
+			if (RaycastNode(packet.rays[lane], hits[lane]))
+				hitMask |= 1u << lane;
+		}
+		return hitMask;
+	}
+
+	ZoneScopedXC(RandomUniqueColor());
+
+	if (isLeaf)
+	{
+		UINT hitMask = 0;
+
+		for (UINT index : triIndices)
+		{
+			const Shape::Tri &tri = (*triBufferPtr)[index];
+
+			dx::XMVECTOR lengths;
+			UINT triMask = packet.Intersects(tri, mask, RayPacket::LoadLengths(hits), lengths);
+			if (!triMask)
+				continue;
+
+			dx::XMFLOAT4 triLengths;
+			dx::XMStoreFloat4(&triLengths, lengths);
+
+			for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+			{
+				if (triMask & (1u << lane))
+					packet.GetTriHit(tri, lane, (&triLengths.x)[lane], hits[lane]);
+			}
+
+			hitMask |= triMask;
+		}
+
+		return hitMask;
+	}
+
+	struct ChildHit { int index; UINT mask; float length; dx::XMFLOAT4 entry; };
+	ChildHit childHits[CHILD_COUNT];
+	int childHitCount = 0;
+
+	const dx::XMVECTOR maxLengths = RayPacket::LoadLengths(hits);
+	for (int i = 0; i < CHILD_COUNT; i++)
+	{
+		const Node *child = GetChild(i);
+		if (!child || child->isEmpty)
+			continue;
+
+		dx::XMVECTOR entry;
+		UINT childMask = packet.Intersects(child->compactBounds, mask, maxLengths, entry);
+		if (!childMask)
+			continue;
+
+		ChildHit &childHit = childHits[childHitCount++];
+		childHit.index = i;
+		childHit.mask = childMask;
+		dx::XMStoreFloat4(&childHit.entry, entry);
+
+		childHit.length = FLT_MAX;
+		for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+		{
+			if (childMask & (1u << lane))
+				childHit.length = std::min<float>(childHit.length, (&childHit.entry.x)[lane]);
+		}
+	}
+
+	// Insertion sort by the closest entry of any lane.
+	for (int i = 1; i < childHitCount; i++)
+	{
+		int j = i;
+		while (childHits[j].length < childHits[j - 1].length)
+		{
+			std::swap(childHits[j], childHits[j - 1]);
+			if (--j <= 0)
+				break;
+		}
+	}
+
+	// Check children in order of closest to furthest, dropping lanes that have since hit something closer.
+	UINT hitMask = 0;
+	for (int i = 0; i < childHitCount; i++)
+	{
+		UINT childMask = childHits[i].mask;
+		for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+		{
+			if ((childMask & (1u << lane)) && (&childHits[i].entry.x)[lane] > hits[lane].length)
+				childMask &= ~(1u << lane);
+		}
+
+		if (childMask)
+			hitMask |= GetChild(childHits[i].index)->RaycastPacket(packet, childMask, hits);
+	}
+
+	return hitMask;
+}
+
 
 [[nodiscard]] bool MeshCollider::Initialize(const MeshData &mesh, UINT submeshToUse)
 {
@@ -320,7 +426,13 @@ bool MeshCollider::Node::RaycastNode(const Shape::Ray &ray, Shape::RayHit &hit)
 		return false;
 	}
 
-	_root = std::make_unique<Node>();
+	if (_nodePool)
+		_nodePool->Clear();
+	else
+		_nodePool = std::make_unique<NodePool<Node>>("MeshCollider Nodes");
+
+	_root = &(*_nodePool)[_nodePool->Allocate()];
+	_root->pool = _nodePool.get();
 
 	dx::XMFLOAT3 corners[8];
 	mesh.boundingBox.GetCorners(corners);
@@ -374,7 +486,7 @@ bool MeshCollider::Node::RaycastNode(const Shape::Ray &ray, Shape::RayHit &hit)
 	for (UINT i = 0; i < triBuffer.size(); i++)
 		allTriIndices.push_back(i);
 
-	_root.get()->triBufferPtr = &triBuffer;
+	_root->triBufferPtr = &triBuffer;
 	_root->Bake(&allTriIndices, 0);
 
 	return true;
@@ -425,6 +537,40 @@ bool MeshCollider::RaycastMesh(const Shape::Ray &ray, Shape::RayHit &hit) const
 	return hasHit;
 }
 
+UINT MeshCollider::RaycastMesh(const RayPacket &packet, UINT mask, Shape::RayHit *hits) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	mask &= packet.laneMask;
+
+#if defined(DEBUG_DRAW_RAYCAST) || (MESH_COLLISION_DETAIL_REDUCTION == 3)
+	// Keep the per-ray path, which draws each ray and handles reduced detail.
+	UINT hitMask = 0;
+	for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+	{
+		if ((mask & (1u << lane)) && RaycastMesh(packet.rays[lane], hits[lane]))
+			hitMask |= 1u << lane;
+	}
+	return hitMask;
+#else
+	if (_root == nullptr)
+		return 0;
+
+	for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+	{
+		if (mask & (1u << lane))
+			hits[lane].length = packet.rays[lane].length > 0.0f ? packet.rays[lane].length : FLT_MAX;
+	}
+
+	dx::XMVECTOR entry;
+	mask = packet.Intersects(_root->bounds, mask, RayPacket::LoadLengths(hits), entry);
+	if (!mask)
+		return 0;
+
+	return _root->RaycastPacket(packet, mask, hits);
+#endif
+}
+
 
 #ifdef DEBUG_BUILD
 void MeshCollider::Node::VisualizeTreeDepth(const dx::XMFLOAT4X4 &worldMatrix, UINT depthLeft, bool compact, const dx::XMFLOAT4 &color, bool drawTris, bool overlay, bool recursive) const
@@ -465,10 +611,10 @@ void MeshCollider::Node::VisualizeTreeDepth(const dx::XMFLOAT4X4 &worldMatrix, U
 			{
 				for (int i = 0; i < CHILD_COUNT; i++)
 				{
-					if (!children[i])
+					if (children[i] == NULL_POOL_NODE)
 						continue;
 
-					children[i]->VisualizeTreeDepth(worldMatrix, depthLeft, compact, {0,0,0,0}, drawTris, overlay, recursive);
+					GetChild(i)->VisualizeTreeDepth(worldMatrix, depthLeft, compact, {0,0,0,0}, drawTris, overlay, recursive);
 				}
 			}
 
@@ -482,10 +628,10 @@ void MeshCollider::Node::VisualizeTreeDepth(const dx::XMFLOAT4X4 &worldMatrix, U
 
 	for (int i = 0; i < CHILD_COUNT; i++)
 	{
-		if (!children[i])
+		if (children[i] == NULL_POOL_NODE)
 			continue;
 
-		children[i]->VisualizeTreeDepth(worldMatrix, depthLeft - 1, compact, color, drawTris, overlay, recursive);
+		GetChild(i)->VisualizeTreeDepth(worldMatrix, depthLeft - 1, compact, color, drawTris, overlay, recursive);
 	}
 }
 
@@ -4,6 +4,8 @@
 #include <DirectXCollision.h>
 #include "Collision/ColliderShapes.h"
 #include "Collision/Raycast.h"
+#include "Collision/RayPacket.h"
+#include "Utils/NodePool.h"
 
 // Forward declaration
 struct MeshData;
@@ -19,7 +21,11 @@ private:
 		const std::vector<Shape::Tri> *triBufferPtr = nullptr;
 		std::vector<UINT> triIndices;
 
-		std::unique_ptr<Node> children[CHILD_COUNT];
+		NodePool<Node> *pool = nullptr;
+		UINT children[CHILD_COUNT] = {
+			NULL_POOL_NODE, NULL_POOL_NODE, NULL_POOL_NODE, NULL_POOL_NODE,
+			NULL_POOL_NODE, NULL_POOL_NODE, NULL_POOL_NODE, NULL_POOL_NODE
+		};
 		bool isLeaf = true, isEmpty = true;
 
 		dx::BoundingBox bounds, compactBounds;
@@ -28,6 +34,12 @@ private:
 		void Bake(const std::vector<UINT> *allTriIndices, const UINT depth);
 
 		bool RaycastNode(const Shape::Ray &ray, Shape::RayHit &hit) const;
+		UINT RaycastPacket(const RayPacket &packet, UINT mask, Shape::RayHit *hits) const;
+
+		[[nodiscard]] inline Node *GetChild(UINT i) const
+		{
+			return children[i] == NULL_POOL_NODE ? nullptr : &(*pool)[children[i]];
+		}
 
 #ifdef DEBUG_BUILD
 		void VisualizeTreeDepth(const dx::XMFLOAT4X4 &worldMatrix, UINT depthLeft, bool compact, const dx::XMFLOAT4 &color, bool drawTris, bool overlay, bool recursive) const;
@@ -36,7 +48,8 @@ private:
 		void CalculateCompactBounds();
 	};
 
-	std::unique_ptr<Node> _root;
+	std::unique_ptr<NodePool<Node>> _nodePool;
+	Node *_root = nullptr;
 	std::vector<Shape::Tri> triBuffer;
 
 public:
@@ -54,6 +67,10 @@ public:
 
 	bool RaycastMesh(const Shape::Ray &ray, Shape::RayHit &hit) const;
 
+	// Traces the lanes in mask of a packet of local space rays. hits must hold RAY_PACKET_SIZE entries,
+	// each lane's hit starts at its ray length like in RaycastMesh(). Returns the lanes that hit.
+	UINT RaycastMesh(const RayPacket &packet, UINT mask, Shape::RayHit *hits) const;
+
 #ifdef DEBUG_BUILD
 	void VisualizeTreeDepth(const dx::XMFLOAT4X4 &worldMatrix, UINT depth, bool compact, const dx::XMFLOAT4 &color, bool drawTris = false, bool overlay = false, bool recursive = false) const;
 #endif
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include "ColliderShapes.h"
+
+namespace dx = DirectX;
+
+constexpr UINT RAY_PACKET_SIZE = 4;
+constexpr UINT RAY_PACKET_FULL_MASK = (1u << RAY_PACKET_SIZE) - 1;
+
+// Packets narrower than this are traced one ray at a time, since the SIMD tests no longer pay off.
+constexpr UINT RAY_PACKET_MIN_LANES = 2;
+
+// Up to RAY_PACKET_SIZE rays traced together. Each component is stored in its own register with one
+// lane per ray, so a box or triangle is tested against every ray in the packet at once. Lanes are
+// selected with bit masks, where bit i refers to rays[i].
+struct RayPacket
+{
+	Shape::Ray rays[RAY_PACKET_SIZE];
+	UINT laneMask = 0; // Lanes holding a ray.
+
+	dx::XMVECTOR originX, originY, originZ;
+	dx::XMVECTOR dirX, dirY, dirZ;
+	dx::XMVECTOR invDirX, invDirY, invDirZ;
+
+	RayPacket(const Shape::Ray *packetRays, UINT count)
+	{
+		if (count > RAY_PACKET_SIZE)
+			count = RAY_PACKET_SIZE;
+
+		dx::XMFLOAT4 o[3] = {}, d[3] = {}, inv[3] = {};
+
+		for (UINT i = 0; i < RAY_PACKET_SIZE; i++)
+		{
+			// Unused lanes repeat the first ray so they never produce NaNs, the tests mask them out with laneMask.
+			const Shape::Ray &ray = packetRays[i < count ? i : 0];
+			rays[i] = ray;
+
+			const float origin[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+			const float direction[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+
+			for (UINT a = 0; a < 3; a++)
+			{
+				// Avoid infinite inverses, which turn into NaNs when a ray starts exactly on a slab.
+				float dirComponent = direction[a];
+				if (fabsf(dirComponent) < 1e-20f)
+					dirComponent = dirComponent < 0.0f ? -1e-20f : 1e-20f;
+
+				(&o[a].x)[i] = origin[a];
+				(&d[a].x)[i] = direction[a];
+				(&inv[a].x)[i] = 1.0f / dirComponent;
+			}
+		}
+
+		laneMask = (1u << count) - 1;
+
+		originX = dx::XMLoadFloat4(&o[0]);	originY = dx::XMLoadFloat4(&o[1]);	originZ = dx::XMLoadFloat4(&o[2]);
+		dirX = dx::XMLoadFloat4(&d[0]);		dirY = dx::XMLoadFloat4(&d[1]);		dirZ = dx::XMLoadFloat4(&d[2]);
+		invDirX = dx::XMLoadFloat4(&inv[0]);	invDirY = dx::XMLoadFloat4(&inv[1]);	invDirZ = dx::XMLoadFloat4(&inv[2]);
+	}
+
+	// Direction octant of a ray, rays sharing an octant traverse trees in similar order.
+	[[nodiscard]] static inline UINT GetOctant(const Shape::Ray &ray)
+	{
+		return (ray.direction.x < 0.0f ? 1 : 0) | (ray.direction.y < 0.0f ? 2 : 0) | (ray.direction.z < 0.0f ? 4 : 0);
+	}
+
+	[[nodiscard]] static inline UINT GetLaneCount(UINT mask)
+	{
+		UINT count = 0;
+		for (; mask; mask &= mask - 1)
+			count++;
+		return count;
+	}
+
+	[[nodiscard]] static inline UINT GetMask(dx::FXMVECTOR comparison)
+	{
+#ifdef _XM_SSE_INTRINSICS_
+		return static_cast<UINT>(_mm_movemask_ps(comparison));
+#else
+		dx::XMUINT4 lanes;
+		dx::XMStoreUInt4(&lanes, comparison);
+		return (lanes.x ? 1 : 0) | (lanes.y ? 2 : 0) | (lanes.z ? 4 : 0) | (lanes.w ? 8 : 0);
+#endif
+	}
+
+	// Slab test against an axis-aligned box. Returns the used lanes in mask that hit the box no further than
+	// maxLength, writing the entry distance of each lane to entry. Rays starting inside enter at zero.
+	[[nodiscard]] UINT Intersects(const dx::BoundingBox &box, UINT mask, dx::FXMVECTOR maxLength, dx::XMVECTOR &entry) const
+	{
+		using namespace DirectX;
+
+		const XMVECTOR
+			boxMinX = XMVectorReplicate(box.Center.x - box.Extents.x),
+			boxMinY = XMVectorReplicate(box.Center.y - box.Extents.y),
+			boxMinZ = XMVectorReplicate(box.Center.z - box.Extents.z),
+			boxMaxX = XMVectorReplicate(box.Center.x + box.Extents.x),
+			boxMaxY = XMVectorReplicate(box.Center.y + box.Extents.y),
+			boxMaxZ = XMVectorReplicate(box.Center.z + box.Extents.z);
+
+		const XMVECTOR
+			t1X = XMVectorMultiply(XMVectorSubtract(boxMinX, originX), invDirX),
+			t2X = XMVectorMultiply(XMVectorSubtract(boxMaxX, originX), invDirX),
+			t1Y = XMVectorMultiply(XMVectorSubtract(boxMinY, originY), invDirY),
+			t2Y = XMVectorMultiply(XMVectorSubtract(boxMaxY, originY), invDirY),
+			t1Z = XMVectorMultiply(XMVectorSubtract(boxMinZ, originZ), invDirZ),
+			t2Z = XMVectorMultiply(XMVectorSubtract(boxMaxZ, originZ), invDirZ);
+
+		const XMVECTOR tNear = XMVectorMax(XMVectorMax(XMVectorMin(t1X, t2X), XMVectorMin(t1Y, t2Y)), XMVectorMin(t1Z, t2Z));
+		const XMVECTOR tFar = XMVectorMin(XMVectorMin(XMVectorMax(t1X, t2X), XMVectorMax(t1Y, t2Y)), XMVectorMax(t1Z, t2Z));
+
+		entry = XMVectorMax(tNear, XMVectorZero());
+
+		const XMVECTOR hit = XMVectorAndInt(
+			XMVectorGreaterOrEqual(tFar, entry),
+			XMVectorLessOrEqual(entry, maxLength)
+		);
+
+		return GetMask(hit) & mask & laneMask;
+	}
+
+	// Same test as Raycast(Ray, Tri, RayHit), including its backface culling. Returns the used lanes in mask
+	// that hit the triangle closer than maxLength, writing the distance of each lane to length.
+	[[nodiscard]] UINT Intersects(const Shape::Tri &tri, UINT mask, dx::FXMVECTOR maxLength, dx::XMVECTOR &length) const
+	{
+		using namespace DirectX;
+		constexpr float MINVAL = 0.000025f;
+
+		const XMVECTOR
+			v0 = XMLoadFloat3(&tri.v0),
+			edge1 = XMVectorSubtract(XMLoadFloat3(&tri.v1), v0),
+			edge2 = XMVectorSubtract(XMLoadFloat3(&tri.v2), v0),
+			triNormal = XMVector3Cross(edge1, edge2);
+
+		XMFLOAT3 e1, e2, n, p0;
+		XMStoreFloat3(&e1, edge1);
+		XMStoreFloat3(&e2, edge2);
+		XMStoreFloat3(&n, triNormal);
+		XMStoreFloat3(&p0, v0);
+
+		const XMVECTOR
+			e1X = XMVectorReplicate(e1.x), e1Y = XMVectorReplicate(e1.y), e1Z = XMVectorReplicate(e1.z),
+			e2X = XMVectorReplicate(e2.x), e2Y = XMVectorReplicate(e2.y), e2Z = XMVectorReplicate(e2.z);
+
+		// Backface-culling
+		const XMVECTOR facing = XMVectorAdd(XMVectorAdd(
+			XMVectorScale(dirX, n.x), XMVectorScale(dirY, n.y)), XMVectorScale(dirZ, n.z));
+		mask &= GetMask(XMVectorLess(facing, XMVectorZero()));
+		if (!mask)
+			return 0;
+
+		// h = dir x edge2
+		const XMVECTOR
+			hX = XMVectorSubtract(XMVectorMultiply(dirY, e2Z), XMVectorMultiply(dirZ, e2Y)),
+			hY = XMVectorSubtract(XMVectorMultiply(dirZ, e2X), XMVectorMultiply(dirX, e2Z)),
+			hZ = XMVectorSubtract(XMVectorMultiply(dirX, e2Y), XMVectorMultiply(dirY, e2X));
+
+		const XMVECTOR a = XMVectorAdd(XMVectorAdd(
+			XMVectorMultiply(e1X, hX), XMVectorMultiply(e1Y, hY)), XMVectorMultiply(e1Z, hZ));
+
+		const float edgeLength = std::min<float>(XMVectorGetX(XMVector3Length(edge1)), XMVectorGetX(XMVector3Length(edge2)));
+		const float minA = std::min<float>(MINVAL, MINVAL * edgeLength);
+		mask &= GetMask(XMVectorGreaterOrEqual(XMVectorAbs(a), XMVectorReplicate(minA)));
+		if (!mask)
+			return 0;
+
+		const XMVECTOR f = XMVectorReciprocal(a);
+
+		// s = origin - v0
+		const XMVECTOR
+			sX = XMVectorSubtract(originX, XMVectorReplicate(p0.x)),
+			sY = XMVectorSubtract(originY, XMVectorReplicate(p0.y)),
+			sZ = XMVectorSubtract(originZ, XMVectorReplicate(p0.z));
+
+		const XMVECTOR u = XMVectorMultiply(f, XMVectorAdd(XMVectorAdd(
+			XMVectorMultiply(sX, hX), XMVectorMultiply(sY, hY)), XMVectorMultiply(sZ, hZ)));
+
+		// q = s x edge1
+		const XMVECTOR
+			qX = XMVectorSubtract(XMVectorMultiply(sY, e1Z), XMVectorMultiply(sZ, e1Y)),
+			qY = XMVectorSubtract(XMVectorMultiply(sZ, e1X), XMVectorMultiply(sX, e1Z)),
+			qZ = XMVectorSubtract(XMVectorMultiply(sX, e1Y), XMVectorMultiply(sY, e1X));
+
+		const XMVECTOR v = XMVectorMultiply(f, XMVectorAdd(XMVectorAdd(
+			XMVectorMultiply(dirX, qX), XMVectorMultiply(dirY, qY)), XMVectorMultiply(dirZ, qZ)));
+
+		length = XMVectorMultiply(f, XMVectorAdd(XMVectorAdd(
+			XMVectorMultiply(e2X, qX), XMVectorMultiply(e2Y, qY)), XMVectorMultiply(e2Z, qZ)));
+
+		const XMVECTOR zero = XMVectorZero(), one = XMVectorSplatOne();
+		XMVECTOR hit = XMVectorAndInt(XMVectorGreaterOrEqual(u, zero), XMVectorLessOrEqual(u, one));
+		hit = XMVectorAndInt(hit, XMVectorGreaterOrEqual(v, zero));
+		hit = XMVectorAndInt(hit, XMVectorLessOrEqual(XMVectorAdd(u, v), one));
+		hit = XMVectorAndInt(hit, XMVectorGreater(length, zero));
+		hit = XMVectorAndInt(hit, XMVectorLess(length, maxLength));
+
+		return GetMask(hit) & mask & laneMask;
+	}
+
+	// Writes the hit of one lane at the given distance, in the form Raycast(Ray, Tri, RayHit) reports it.
+	void GetTriHit(const Shape::Tri &tri, UINT lane, float length, Shape::RayHit &hit) const
+	{
+		using namespace DirectX;
+
+		const XMVECTOR
+			v0 = XMLoadFloat3(&tri.v0),
+			edge1 = XMVectorSubtract(XMLoadFloat3(&tri.v1), v0),
+			edge2 = XMVectorSubtract(XMLoadFloat3(&tri.v2), v0);
+
+		const XMVECTOR origin = XMLoadFloat3(&rays[lane].origin);
+		const XMVECTOR direction = XMLoadFloat3(&rays[lane].direction);
+
+		XMStoreFloat3(&hit.point, XMVectorAdd(origin, XMVectorScale(direction, length)));
+		XMStoreFloat3(&hit.normal, XMVector3Normalize(XMVector3Cross(edge1, edge2)));
+		hit.length = length;
+	}
+
+	// Current closest hit length of each lane, for use as maxLength. hits must hold RAY_PACKET_SIZE entries.
+	[[nodiscard]] static inline dx::XMVECTOR LoadLengths(const Shape::RayHit *hits)
+	{
+		return dx::XMVectorSet(hits[0].length, hits[1].length, hits[2].length, hits[3].length);
+	}
+};
@@ -1025,9 +1025,9 @@ UINT Content::AddMesh(ID3D11Device *device, const std::string &name, MeshData **
 
 	UINT id = CONTENT_NULL;
 
-#pragma warning(disable: 6993)
-#pragma omp critical
 	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
 		bool duplicateName = false;
 		id = (UINT)_meshes.size();
 		for (UINT i = 0; i < id; i++)
@@ -1056,7 +1056,6 @@ UINT Content::AddMesh(ID3D11Device *device, const std::string &name, MeshData **
 			}
 		}
 	}
-#pragma warning(default: 6993)
 
 	meshData = nullptr;
 	return id;
@@ -1082,9 +1081,9 @@ UINT Content::AddMesh(ID3D11Device *device, const std::string &name, const char
 
 	UINT id = CONTENT_NULL;
 
-#pragma warning(disable: 6993)
-#pragma omp critical
 	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
 		bool duplicateName = false;
 		id = (UINT)_meshes.size();
 		for (UINT i = 0; i < id; i++)
@@ -1114,7 +1113,6 @@ UINT Content::AddMesh(ID3D11Device *device, const std::string &name, const char
 			}
 		}
 	}
-#pragma warning(default: 6993)
 
 	meshData = nullptr;
 	return id;
@@ -1133,9 +1131,9 @@ UINT Content::AddShader(ID3D11Device *device, const std::string &name, ShaderTyp
 
 	UINT id = CONTENT_NULL;
 
-#pragma warning(disable: 6993)
-#pragma omp critical
 	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
 		bool duplicateName = false;
 		id = (UINT)_shaders.size();
 		for (UINT i = 0; i < id; i++)
@@ -1163,7 +1161,6 @@ UINT Content::AddShader(ID3D11Device *device, const std::string &name, ShaderTyp
 			}
 		}
 	}
-#pragma warning(default: 6993)
 
 	shaderBlob = nullptr;
 	return id;
@@ -1181,9 +1178,9 @@ UINT Content::AddShader(ID3D11Device *device, const std::string &name, const Sha
 
 	UINT id = CONTENT_NULL;
 
-#pragma warning(disable: 6993)
-#pragma omp critical
 	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
 		bool duplicateName = false;
 		id = (UINT)_shaders.size();
 		for (UINT i = 0; i < id; i++)
@@ -1211,7 +1208,6 @@ UINT Content::AddShader(ID3D11Device *device, const std::string &name, const Sha
 			}
 		}
 	}
-#pragma warning(default: 6993)
 
 	return id;
 }
@@ -1228,9 +1224,9 @@ UINT Content::AddShader(ID3D11Device *device, const std::string &name, ShaderTyp
 
 	UINT id = CONTENT_NULL;
 
-#pragma warning(disable: 6993)
-#pragma omp critical
 	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
 		bool duplicateName = false;
 		id = (UINT)_shaders.size();
 		for (UINT i = 0; i < id; i++)
@@ -1258,7 +1254,6 @@ UINT Content::AddShader(ID3D11Device *device, const std::string &name, ShaderTyp
 			}
 		}
 	}
-#pragma warning(default: 6993)
 
 	return id;
 }
@@ -1384,11 +1379,15 @@ UINT Content::AddTexture(ID3D11Device *device, ID3D11DeviceContext *context, con
 	}
 
 	UINT id = CONTENT_NULL;
-#pragma warning(disable: 6993)
-#pragma omp critical
 	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
 		if (!IsNameDuplicate(name, _textures, &id))
 		{
+#ifdef HEADLESS
+			// Textures are only ever read by shaders, so they are registered without being loaded.
+			_textures.emplace_back(new Texture(name, std::string(path), id, useMipmaps));
+#else
 			ComPtr<ID3D11Texture2D> texture;
 			ComPtr<ID3D11ShaderResourceView> srv;
 
@@ -1414,9 +1413,9 @@ UINT Content::AddTexture(ID3D11Device *device, ID3D11DeviceContext *context, con
 					_textures.emplace_back(addedTexture);
 				}
 			}
+#endif
 		}
 	}
-#pragma warning(default: 6993)
 
 	return id;
 }
@@ -1543,9 +1542,9 @@ UINT Content::AddCubemap(ID3D11Device *device, ID3D11DeviceContext *context, con
 
 	UINT id = CONTENT_NULL;
 
-#pragma warning(disable: 6993)
-#pragma omp critical
 	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
 		bool duplicateName = false;
 		id = (UINT)_cubemaps.size();
 		for (UINT i = 0; i < id; i++)
@@ -1573,7 +1572,6 @@ UINT Content::AddCubemap(ID3D11Device *device, ID3D11DeviceContext *context, con
 			}
 		}
 	}
-#pragma warning(default: 6993)
 
 	return id;
 }
@@ -1657,12 +1655,14 @@ UINT Content::AddBlendState(ID3D11Device *device, const std::string &name, const
 	}
 
 	BlendState *addedBlendState = new BlendState(name, id);
+#ifndef HEADLESS
 	if (FAILED(device->CreateBlendState(&blendDesc, addedBlendState->data.ReleaseAndGetAddressOf())))
 	{
 		delete addedBlendState;
 		ErrMsgF("Failed to initialize added blend state '{}'!", name);
 		return CONTENT_NULL;
 	}
+#endif
 	_blendStates.emplace_back(addedBlendState);
 
 	return id;
@@ -1839,8 +1839,9 @@ UINT Content::AddHeightMap(const std::string &name, const std::string &path)
 	}
 
 	UINT id = CONTENT_NULL;
-#pragma omp critical
 	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
 		bool duplicateName = false;
 		id = (UINT)_heightTextures.size();
 		for (UINT i = 0; i < id; i++)
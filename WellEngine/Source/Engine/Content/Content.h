@@ -3,6 +3,7 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <mutex>
 
 #include "D3D/InputLayoutD3D11.h"
 #include "D3D/ShaderD3D11.h"
@@ -213,6 +214,9 @@ private:
 
 	bool _hasShutDown = false;
 
+	// Guards adding content, which may happen from several jobs at once while loading.
+	std::mutex _mutex;
+
 	template <typename C>
 	[[nodiscard]] inline bool IsNameDuplicate(const std::string &name, const std::vector<C *> &contentVec, UINT *id);
 
@@ -24,6 +24,9 @@ ConstantBufferD3D11::ConstantBufferD3D11(ConstantBufferD3D11 &&other) noexcept
 	// TODO: Validate
 	_buffer = other._buffer;
 	_bufferSize = other._bufferSize;
+#ifdef HEADLESS
+	_cpuData = std::move(other._cpuData);
+#endif
 
 	other._buffer = nullptr;
 	other._bufferSize = 0;
@@ -38,6 +41,9 @@ ConstantBufferD3D11 &ConstantBufferD3D11::operator=(ConstantBufferD3D11 &&other)
 	{
 		_buffer = other._buffer;
 		_bufferSize = other._bufferSize;
+#ifdef HEADLESS
+		_cpuData = std::move(other._cpuData);
+#endif
 
 		other._buffer = nullptr;
 		other._bufferSize = 0;
@@ -48,6 +54,21 @@ ConstantBufferD3D11 &ConstantBufferD3D11::operator=(ConstantBufferD3D11 &&other)
 
 bool ConstantBufferD3D11::Initialize(ID3D11Device *device, const size_t byteSize, const void *initialData)
 {
+#ifdef HEADLESS
+	if (!_cpuData.empty())
+	{
+		ErrMsg("Constant buffer is already initialized!");
+		return false;
+	}
+
+	_bufferSize = byteSize;
+	_cpuData.resize(byteSize);
+
+	if (initialData)
+		memcpy(_cpuData.data(), initialData, byteSize);
+
+	return true;
+#else
 	if (_buffer)
 	{
 		ErrMsg("Constant buffer is already initialized!");
@@ -83,14 +104,28 @@ bool ConstantBufferD3D11::Initialize(ID3D11Device *device, const size_t byteSize
 		delete[] static_cast<const char *>(srData.pSysMem);
 
 	return true;
+#endif
 }
 void ConstantBufferD3D11::Reset()
 {
 	_buffer.Reset();
+#ifdef HEADLESS
+	_cpuData.clear();
+#endif
 }
 
 bool ConstantBufferD3D11::UpdateBuffer(ID3D11DeviceContext *context, const void *data) const
 {
+#ifdef HEADLESS
+	if (_cpuData.empty())
+	{
+		ErrMsg("Constant buffer is not initialized!");
+		return false;
+	}
+
+	memcpy(_cpuData.data(), data, _bufferSize);
+	return true;
+#else
 	if (!_buffer)
 	{
 		ErrMsg("Constant buffer is not initialized!");
@@ -107,6 +142,7 @@ bool ConstantBufferD3D11::UpdateBuffer(ID3D11DeviceContext *context, const void
 	memcpy(resource.pData, data, _bufferSize);
 	context->Unmap(_buffer.Get(), 0);
 	return true;
+#endif
 }
 
 size_t ConstantBufferD3D11::GetSize() const
@@ -117,3 +153,9 @@ ID3D11Buffer *ConstantBufferD3D11::GetBuffer() const
 {
 	return _buffer.Get();
 }
+#ifdef HEADLESS
+const void *ConstantBufferD3D11::GetData() const
+{
+	return _cpuData.data();
+}
+#endif
@@ -9,6 +9,11 @@ private:
 	ComPtr<ID3D11Buffer> _buffer = nullptr;
 	size_t _bufferSize = 0;
 
+#ifdef HEADLESS
+	// Stands in for the buffer, holding the last data written to it.
+	mutable std::vector<std::byte> _cpuData;
+#endif
+
 public:
 	ConstantBufferD3D11() = default;
 	ConstantBufferD3D11(ID3D11Device *device, size_t byteSize, const void *initialData = nullptr);
@@ -26,5 +31,9 @@ public:
 
 	[[nodiscard]] bool UpdateBuffer(ID3D11DeviceContext *context, const void *data) const;
 
+#ifdef HEADLESS
+	[[nodiscard]] const void *GetData() const;
+#endif
+
 	TESTABLE()
 };
\ No newline at end of file
@@ -20,6 +20,9 @@ bool DepthBufferD3D11::Initialize(ID3D11Device *device, const UINT width, const
 {
 	_isCube = isCube;
 
+#ifdef HEADLESS
+	// Nothing to create without a device.
+#else
 	DXGI_FORMAT formatTyped = format;
 	DXGI_FORMAT formatTypeless{};
 
@@ -149,6 +152,7 @@ bool DepthBufferD3D11::Initialize(ID3D11Device *device, const UINT width, const
 			return false;
 		}
 	}
+#endif
 
 	return true;
 }
@@ -24,6 +24,9 @@ bool IndexBufferD3D11::Initialize(ID3D11Device *device, const size_t nrOfIndices
 
 	_nrOfIndices = nrOfIndicesInBuffer;
 
+#ifdef HEADLESS
+	// Nothing to create without a device.
+#else
 	D3D11_BUFFER_DESC bufferDesc = { };
 	bufferDesc.ByteWidth = (UINT)sizeof(uint32_t) * (UINT)_nrOfIndices;
 	bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
@@ -42,6 +45,8 @@ bool IndexBufferD3D11::Initialize(ID3D11Device *device, const size_t nrOfIndices
 		ErrMsg("Failed to create index buffer!");
 		return false;
 	}
+#endif
+
 	return true;
 }
 
@@ -40,6 +40,9 @@ bool InputLayoutD3D11::FinalizeInputLayout(ID3D11Device *device, const void *vsD
 		return false;
 	}
 
+#ifdef HEADLESS
+	// Nothing to create without a device.
+#else
 	if (FAILED(device->CreateInputLayout(
 		_elements.data(), static_cast<UINT>(_elements.size()),
 		vsDataPtr,
@@ -49,6 +52,8 @@ bool InputLayoutD3D11::FinalizeInputLayout(ID3D11Device *device, const void *vsD
 		ErrMsg("Failed to finalize input layout!");
 		return false;
 	}
+#endif
+
 	return true;
 }
 
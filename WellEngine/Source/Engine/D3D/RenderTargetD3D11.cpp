@@ -30,6 +30,9 @@ bool RenderTargetD3D11::Initialize(
 
 bool RenderTargetD3D11::Initialize(ID3D11Device *device, D3D11_TEXTURE2D_DESC desc, bool hasSRV, bool hasUAV)
 {
+#ifdef HEADLESS
+	// Nothing to create without a device.
+#else
 	if (hasUAV)
 		desc.BindFlags |= D3D11_BIND_UNORDERED_ACCESS;
 
@@ -64,6 +67,7 @@ bool RenderTargetD3D11::Initialize(ID3D11Device *device, D3D11_TEXTURE2D_DESC de
 			return false;
 		}
 	}
+#endif
 
 	return true;
 }
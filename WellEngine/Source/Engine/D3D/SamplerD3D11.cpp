@@ -21,6 +21,9 @@ SamplerD3D11::SamplerD3D11(ID3D11Device *device, const D3D11_SAMPLER_DESC &desc)
 
 bool SamplerD3D11::Initialize(ID3D11Device *device, D3D11_TEXTURE_ADDRESS_MODE adressMode, D3D11_FILTER filter, D3D11_COMPARISON_FUNC comparisonFunc)
 {
+#ifdef HEADLESS
+	// Nothing to create without a device.
+#else
 	D3D11_SAMPLER_DESC samplerDesc = { };
 	samplerDesc.Filter = filter;
 	samplerDesc.AddressU = adressMode;
@@ -37,17 +40,22 @@ bool SamplerD3D11::Initialize(ID3D11Device *device, D3D11_TEXTURE_ADDRESS_MODE a
 		ErrMsg("Failed to create sampler state!");
 		return false;
 	}
+#endif
 
 	return true;
 }
 bool SamplerD3D11::Initialize(ID3D11Device *device, const D3D11_SAMPLER_DESC &desc)
 {
+#ifdef HEADLESS
+	// Nothing to create without a device.
+#else
 	HRESULT hr = device->CreateSamplerState(&desc, _sampler.ReleaseAndGetAddressOf());
 	if (FAILED(hr))
 	{
 		ErrMsgF("Failed to create sampler state! hr: {}, {}", hr, StringUtils::HResultToString(hr));
 		return false;
 	}
+#endif
 
 	return true;
 }
@@ -67,6 +67,10 @@ bool ShaderD3D11::Initialize(ID3D11Device *device, ShaderType shaderType, ID3DBl
 	const void *shaderData = _shaderBlob->GetBufferPointer();
 
 	_type = shaderType;
+
+#ifdef HEADLESS
+	// Nothing to create without a device.
+#else
 	switch (_type)
 	{
 	case ShaderType::VERTEX_SHADER:
@@ -138,6 +142,7 @@ bool ShaderD3D11::Initialize(ID3D11Device *device, ShaderType shaderType, ID3DBl
 		ErrMsg("Failed to create shader reflector!");
 		return false;
 	}
+#endif
 
 	return true;
 }
@@ -160,6 +165,10 @@ bool ShaderD3D11::Initialize(ID3D11Device *device, ShaderType shaderType, const
 
 bool ShaderD3D11::Initialize(ID3D11Device *device, ShaderType shaderType, const char *csoPath)
 {
+#ifdef HEADLESS
+	// Compiled shaders are not needed without a device, so they are not required to exist.
+	_type = shaderType;
+#else
 	std::string shaderFileData;
 	std::ifstream reader;
 
@@ -187,6 +196,8 @@ bool ShaderD3D11::Initialize(ID3D11Device *device, ShaderType shaderType, const
 
 	shaderFileData.clear();
 	reader.close();
+#endif
+
 	return true;
 }
 
@@ -227,12 +238,12 @@ bool ShaderD3D11::BindShader(ID3D11DeviceContext *context) const
 
 const void *ShaderD3D11::GetShaderByteData() const
 {
-	return _shaderBlob.Get()->GetBufferPointer();
+	return _shaderBlob ? _shaderBlob->GetBufferPointer() : nullptr;
 }
 
 size_t ShaderD3D11::GetShaderByteSize() const
 {
-	return _shaderBlob.Get()->GetBufferSize();
+	return _shaderBlob ? _shaderBlob->GetBufferSize() : 0;
 }
 
 ShaderType ShaderD3D11::GetShaderType() const
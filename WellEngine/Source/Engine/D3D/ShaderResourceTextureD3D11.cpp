@@ -58,6 +58,9 @@ bool ShaderResourceTextureD3D11::Initialize(ID3D11Device* device, ID3D11DeviceCo
 	if (cubemap)
 		_dim = TexDim::Cubemap;
 
+#ifdef HEADLESS
+	// Nothing to create without a device.
+#else
 	D3D11_TEXTURE2D_DESC textureDesc = { };
 	textureDesc.Width = cubemap ? max(1, width / 4) : width;
 	textureDesc.Height = cubemap ? max(1, width / 4) : height;
@@ -160,6 +163,7 @@ bool ShaderResourceTextureD3D11::Initialize(ID3D11Device* device, ID3D11DeviceCo
 
 		context->GenerateMips(_srv.Get());
 	}
+#endif
 
 	return true;
 }
@@ -176,6 +180,9 @@ bool ShaderResourceTextureD3D11::Initialize(ID3D11Device* device, ID3D11DeviceCo
 	if (cubemap)
 		_dim = TexDim::Cubemap;
 
+#ifdef HEADLESS
+	// Nothing to create without a device.
+#else
 	UINT channelCount = (UINT)D3D11FormatData::GetChannelCount(_format);
 	UINT bitsPerPixel = (UINT)D3D11FormatData::GetBitsPerPixel(_format);
 	UINT bytesPerChannel = bitsPerPixel / (channelCount * 8);
@@ -283,6 +290,7 @@ bool ShaderResourceTextureD3D11::Initialize(ID3D11Device* device, ID3D11DeviceCo
 
 		context->GenerateMips(_srv.Get());
 	}
+#endif
 
 	return true;
 }
@@ -299,6 +307,9 @@ bool ShaderResourceTextureD3D11::Initialize(ID3D11Device *device, ID3D11DeviceCo
 	if ((textureDesc.MiscFlags & D3D11_RESOURCE_MISC_TEXTURECUBE) != 0)
 		_dim = TexDim::Cubemap;
 
+#ifdef HEADLESS
+	// Nothing to create without a device.
+#else
 	UINT channelCount = (UINT)D3D11FormatData::GetChannelCount(_format);
 	UINT bitsPerPixel = (UINT)D3D11FormatData::GetBitsPerPixel(_format);
 	UINT bytesPerChannel = bitsPerPixel / (channelCount * 8);
@@ -353,6 +364,7 @@ bool ShaderResourceTextureD3D11::Initialize(ID3D11Device *device, ID3D11DeviceCo
 
 		context->GenerateMips(_srv.Get());
 	}
+#endif
 
 	return true;
 }
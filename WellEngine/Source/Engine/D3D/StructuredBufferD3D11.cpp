@@ -19,6 +19,15 @@ bool StructuredBufferD3D11::Initialize(ID3D11Device *device, const UINT sizeOfEl
 	_elementSize = sizeOfElement;
 	_nrOfElements = nrOfElementsInBuffer;
 
+#ifdef HEADLESS
+	_cpuData.assign(_elementSize * _nrOfElements, std::byte(0));
+
+	if (bufferData)
+		memcpy(_cpuData.data(), bufferData, _cpuData.size());
+
+	return true;
+#else
+
 	D3D11_BUFFER_DESC structuredBufferDesc;
 	structuredBufferDesc.ByteWidth = _elementSize * static_cast<UINT>(_nrOfElements);
 	structuredBufferDesc.Usage = dynamic ? D3D11_USAGE_DYNAMIC : ((hasSRV && hasUAV) ? D3D11_USAGE_DEFAULT : D3D11_USAGE_IMMUTABLE);
@@ -70,6 +79,7 @@ bool StructuredBufferD3D11::Initialize(ID3D11Device *device, const UINT sizeOfEl
 	}
 
 	return true;
+#endif
 }
 
 void StructuredBufferD3D11::Reset()
@@ -79,10 +89,23 @@ void StructuredBufferD3D11::Reset()
 	_buffer.Reset();
 	_elementSize = 0;
 	_nrOfElements = 0;
+#ifdef HEADLESS
+	_cpuData.clear();
+#endif
 }
 
 bool StructuredBufferD3D11::UpdateBuffer(ID3D11DeviceContext *context, const void *data) const
 {
+#ifdef HEADLESS
+	if (_cpuData.empty())
+	{
+		Warn("Structured buffer is not initialized!");
+		return true;
+	}
+
+	memcpy(_cpuData.data(), data, _cpuData.size());
+	return true;
+#else
 	if (_buffer == nullptr)
 	{
 		Warn("Structured buffer is not initialized!");
@@ -96,6 +119,7 @@ bool StructuredBufferD3D11::UpdateBuffer(ID3D11DeviceContext *context, const voi
 	memcpy(resource.pData, data, _elementSize * _nrOfElements);
 	context->Unmap(_buffer.Get(), 0);
 	return true;
+#endif
 }
 
 UINT StructuredBufferD3D11::GetElementSize() const
@@ -114,3 +138,9 @@ ID3D11UnorderedAccessView *StructuredBufferD3D11::GetUAV() const
 {
 	return _uav.Get();
 }
+#ifdef HEADLESS
+const void *StructuredBufferD3D11::GetData() const
+{
+	return _cpuData.data();
+}
+#endif
@@ -12,6 +12,11 @@ private:
 	UINT _elementSize = 0;
 	size_t _nrOfElements = 0;
 
+#ifdef HEADLESS
+	// Stands in for the buffer, holding the last data written to it.
+	mutable std::vector<std::byte> _cpuData;
+#endif
+
 public:
 	StructuredBufferD3D11() = default;
 	StructuredBufferD3D11(ID3D11Device *device, UINT sizeOfElement, size_t nrOfElementsInBuffer, 
@@ -34,5 +39,9 @@ public:
 	[[nodiscard]] ID3D11ShaderResourceView *GetSRV() const;
 	[[nodiscard]] ID3D11UnorderedAccessView *GetUAV() const;
 
+#ifdef HEADLESS
+	[[nodiscard]] const void *GetData() const;
+#endif
+
 	TESTABLE()
 };
\ No newline at end of file
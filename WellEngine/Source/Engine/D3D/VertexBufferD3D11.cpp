@@ -13,6 +13,9 @@ bool VertexBufferD3D11::Initialize(ID3D11Device *device, const size_t sizeOfVert
 	_vertexSize = sizeOfVertex;
 	_nrOfVertices = nrOfVerticesInBuffer;
 
+#ifdef HEADLESS
+	// Nothing to create without a device.
+#else
 	D3D11_BUFFER_DESC bufferDesc = { };
 	bufferDesc.ByteWidth = static_cast<UINT>(_vertexSize * _nrOfVertices);
 	bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
@@ -31,6 +34,7 @@ bool VertexBufferD3D11::Initialize(ID3D11Device *device, const size_t sizeOfVert
 		ErrMsg("Failed to create vertex buffer!");
 		return false;
 	}
+#endif
 
 	return true;
 }
@@ -1011,8 +1011,9 @@ void DebugDrawer::DrawLineThreadSafe(const Line &line, bool useDepth)
 
 	auto &lineList = useDepth ? _sceneLineList : _overlayLineList;
 
-#pragma omp critical
 	{
+		std::lock_guard<std::mutex> lock(_threadSafeMutex);
+
 		lineList.emplace_back(line);
 	}
 }
@@ -1040,8 +1041,9 @@ void DebugDrawer::DrawLinesThreadSafe(const std::vector<Line> &lines, bool useDe
 
 	auto &lineList = useDepth ? _sceneLineList : _overlayLineList;
 
-#pragma omp critical
 	{
+		std::lock_guard<std::mutex> lock(_threadSafeMutex);
+
 		lineList.insert(std::end(lineList), std::begin(lines), std::end(lines));
 	}
 }
@@ -1059,8 +1061,9 @@ void DebugDrawer::DrawLineStripThreadSafe(const std::vector<LineSection> &lineSt
 	Line line;
 	const LineSection *prevLine = &lineStrip[0];
 
-#pragma omp critical
 	{
+		std::lock_guard<std::mutex> lock(_threadSafeMutex);
+
 		for (UINT i = 1; i < lineStrip.size(); i++)
 		{
 			line = { *prevLine, lineStrip[i] };
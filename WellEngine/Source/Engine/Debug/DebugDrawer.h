@@ -110,6 +110,7 @@ private:
 	CameraBehaviour *_camera = nullptr;
 
 	std::vector<DD::Line> _sceneLineList, _overlayLineList;
+	std::mutex _threadSafeMutex; // Guards the line lists in the thread-safe draw functions.
 	SimpleMeshD3D11		  _sceneLineMesh, _overlayLineMesh;
 
 	std::vector<DD::Tri> _sceneTriList, _overlayTriList, _screenTriList;
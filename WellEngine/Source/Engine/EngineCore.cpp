@@ -1,6 +1,8 @@
 #include "stdafx.h"
 #include "EngineCore.h"
 #include "Debug/DebugData.h"
+#include "Input/InputRecording.h"
+#include "Timing/FrameTimingLog.h"
 
 #ifdef LEAK_DETECTION
 #define new			DEBUG_NEW
@@ -15,6 +17,10 @@ EngineCore::EngineCore()
 EngineCore::~EngineCore()
 {
 	ZoneScopedC(RandomUniqueColor());
+
+	// Anything submitted after this runs on the calling thread.
+	JobSystem::Instance().Shutdown();
+
 	DbgMsg("========| Close |==========================================================================\n");
 }
 
@@ -24,18 +30,31 @@ int EngineCore::Init()
 	DbgMsg("========| Initialization |=================================================================");
 
 	// Seed random number generator
-	srand(static_cast<unsigned>(time(0)));
+	unsigned seed = static_cast<unsigned>(time(0));
 
-#ifdef TRACY_ENABLE
-	// Assign names to OMP threads
-	constexpr int threadCount = (PARALLEL_THREADS < 4) ? 4 : PARALLEL_THREADS;
-#pragma omp parallel for num_threads(threadCount)
-	for (int i = 0; i < threadCount; i++)
+#if defined(RECORD_INPUT)
+	InputRecording::Instance().Begin(seed);
+#elif defined(REPLAY_INPUT)
+	DbgMsg("Loading Input Recording..."); LogIndentIncr();
+	if (!InputRecording::Instance().Load(ASSET_FILE_INPUT_RECORDING))
 	{
-		tracy::SetThreadNameWithHint("OpenMP Thread", 983464687);
+		ErrMsg("Failed to load input recording!");
+		return -1;
 	}
+	seed = InputRecording::Instance().GetSeed();
+	LogIndentDecr();
 #endif
 
+	srand(seed);
+
+	DbgMsg("Job System Setup..."); LogIndentIncr();
+	if (!JobSystem::Instance().Initialize())
+	{
+		ErrMsg("Failed to initialize job system!");
+		return -1;
+	}
+	LogIndentDecr();
+
 #ifdef DEBUG_BUILD
 	DbgMsg("Loading Debug Data..."); LogIndentIncr();
 	DebugData::LoadState();
@@ -115,22 +134,43 @@ int EngineCore::Run()
 	Window &window = _game.GetWindow();
 	int returnCode = 0;
 
+#if defined(RECORD_INPUT)
+	InputRecording &recording = InputRecording::Instance();
+#elif defined(REPLAY_INPUT)
+	InputRecording &recording = InputRecording::Instance();
+	FrameTimingLog timingLog({
+		"Frame",
+		"SceneUpdateTime",
+		"SceneFixedUpdateTime",
+		"SceneLateUpdateTime",
+		"CollisionChecks",
+		"FrustumCull",
+		"SceneRenderTime"
+	});
+#endif
+
 	while (!_game.IsExiting())
 	{
 		_frameCount++;
 		ZoneNamedXNC(tracyFrameZone, "Frame", RandomUniqueColor(), true);
 		ZoneNameXVF(tracyFrameZone, "%d", _frameCount);
 
-#ifdef TRACY_ENABLE
-#pragma omp parallel for num_threads(PARALLEL_THREADS)
-		for (int i = 0; i < PARALLEL_THREADS; i++)
+		// Update time
+#ifdef REPLAY_INPUT
+		const RecordedFrame *replayFrame = recording.NextFrame();
+		if (!replayFrame)
 		{
-			tracy::SetThreadNameWithHint("OpenMP Thread", 983464687); // Magic number, who cares
+			DbgMsg("Input recording ended.");
+			_game.Exit();
+			break;
 		}
-#endif
 
-		// Update time
+		time.SetFixedDeltaTime(replayFrame->fixedDeltaTime);
+		time.Update(replayFrame->realDeltaTime);
+		time.TakeSnapshot("Frame");
+#else
 		time.Update();
+#endif
 
 #ifdef TRACY_ENABLE
 		TracyPlot("Frame Time (ns)", (int64_t)(time.GetDeltaTime() * 1000000.0f));
@@ -196,7 +236,12 @@ int EngineCore::Run()
 		if (BindingCollection::IsTriggered(InputBindings::InputAction::LockCursor))
 			input.ToggleLockCursor(window);
 
-		if (!input.Update(window))
+#ifdef REPLAY_INPUT
+		const bool inputUpdated = input.Replay(window, *replayFrame);
+#else
+		const bool inputUpdated = input.Update(window);
+#endif
+		if (!inputUpdated)
 		{
 			ErrMsg("Failed to update input!");
 			returnCode = -1;
@@ -204,6 +249,13 @@ int EngineCore::Run()
 			continue;
 		}
 
+#ifdef RECORD_INPUT
+		RecordedFrame &recordedFrame = recording.AddFrame();
+		recordedFrame.realDeltaTime = time.GetRealDeltaTime();
+		recordedFrame.fixedDeltaTime = time.GetFixedDeltaTime();
+		input.CaptureFrame(recordedFrame);
+#endif
+
 		// Update binding collections
 		{
 			ZoneNamedXNC(updateBindingsZone, "Binding Collection Update", RandomUniqueColor(), true);
@@ -332,8 +384,35 @@ int EngineCore::Run()
 			continue;
 		}
 
+#ifdef REPLAY_INPUT
+		time.TakeSnapshot("Frame");
+		timingLog.AddFrame(time);
+#endif
+
 		FrameMark;
 	}
 
+#if defined(RECORD_INPUT)
+	if (!recording.Save(ASSET_FILE_INPUT_RECORDING))
+	{
+		ErrMsg("Failed to save input recording!");
+		returnCode = -1;
+	}
+	DbgMsgF("Recorded {} frames to '{}'.", recording.GetFrameCount(), ASSET_FILE_INPUT_RECORDING);
+#elif defined(REPLAY_INPUT)
+	if (!timingLog.Save(ASSET_FILE_REPLAY_TIMINGS))
+	{
+		ErrMsg("Failed to save frame timings!");
+		returnCode = -1;
+	}
+	DbgMsgF("Replayed {} frames, {:.3f} ms per frame on average. Timings saved to '{}'.",
+		timingLog.GetFrameCount(), timingLog.GetAverage(0) * 1000.0f, ASSET_FILE_REPLAY_TIMINGS);
+#endif
+
+#ifdef HEADLESS
+	const HeadlessFrameStats &stats = _game.GetGraphics()->GetHeadlessFrameStats();
+	DbgMsgF("Simulated {} frames, {} draws recorded.", stats.frameCount, stats.totalDrawCount);
+#endif
+
 	return returnCode;
 }
@@ -36,7 +36,7 @@
 	/// PARALLEL_UPDATE enables the use of the ParallelUpdate method in entities.
 	#define PARALLEL_UPDATE
 
-	/// PARALLEL_THREADS sets the number of threads to use for parallel updates. This is only used if PARALLEL_UPDATE is enabled.
+	/// PARALLEL_THREADS sets the number of deferred contexts. Parallel work is otherwise sized to the core count by the JobSystem.
 	constexpr auto PARALLEL_THREADS = 3;
 
 	#ifdef PARALLEL_UPDATE
@@ -53,6 +53,10 @@
 
 	/// EXTRA_CULL_CHECK makes culling perform an extra intersection test between the entity's bounds and the frustum before being queued
 	#define EXTRA_CULL_CHECK
+
+	/// TRANSFORM_HIERARCHY stores the transforms of scene entities in a level-sorted TransformHierarchy, which updates
+	/// all world matrices once per frame, in parallel within each hierarchy level, instead of recursively on access.
+	//#define TRANSFORM_HIERARCHY
 #pragma endregion
 
 
@@ -122,6 +126,27 @@
 #pragma endregion
 
 
+#pragma region Headless
+	/// HEADLESS runs the engine without a graphics device or a visible window, for simulating scenes on machines without a GPU.
+	/// The D3D11 wrappers keep their data on the CPU instead of creating resources, and Graphics only records what would have been drawn.
+	/// Everything needing a device or the editor UI is turned off, see the overrides at the end of this file.
+	//#define HEADLESS
+#pragma endregion
+
+
+#pragma region Input Recording
+	/// RECORD_INPUT records the input, timestep and scene changes of every frame, saving them to ASSET_FILE_INPUT_RECORDING on exit.
+	//#define RECORD_INPUT
+
+	#ifndef RECORD_INPUT
+		/// REPLAY_INPUT plays ASSET_FILE_INPUT_RECORDING back instead of reading the mouse, keyboard and clock, and exits when it ends.
+		/// The time spent in each phase of every replayed frame is written to ASSET_FILE_REPLAY_TIMINGS, for comparing performance between builds.
+		/// Replay in the same configuration as the recording was made in, as settings like DEBUG_BUILD change what the game does with the input.
+		//#define REPLAY_INPUT
+	#endif
+#pragma endregion
+
+
 
 #pragma region Path Configuration Defines
 constexpr auto ENGINE_PATH_SHADERS				= "WellEngine\\Source\\Shaders";
@@ -135,6 +160,8 @@ constexpr auto ASSET_PATH_TEXTURES				= "Assets\\Textures";
 constexpr auto ASSET_PATH_SOUNDS				= "Assets\\Sounds";
 constexpr auto ASSET_FILE_BINDINGS				= "Assets\\Bindings.json";
 constexpr auto ASSET_FILE_SEQUENCES				= "Assets\\Sequences.txt";
+constexpr auto ASSET_FILE_INPUT_RECORDING		= "Assets\\Recordings\\Walkthrough.rec";
+constexpr auto ASSET_FILE_REPLAY_TIMINGS		= "Assets\\Recordings\\Timings.csv";
 constexpr auto ASSET_EXT_SCENE					= "scene";
 constexpr auto ASSET_EXT_SAVE					= "save";
 constexpr auto ASSET_EXT_PREFAB					= "prefab";
@@ -204,6 +231,23 @@ constexpr auto ASSETS_EDITOR_PATH_LAYOUTS		= "Assets\\Editor\\Layouts";
 	#undef USE_IMGUI_VIEWPORTS
 	#undef USE_IMGUIZMO
 	#undef DISABLE_MONSTER
+	#undef RECORD_INPUT
+	#undef REPLAY_INPUT
 	#undef LIGHT_CULLING_NEAR_PLANE
 	#define LIGHT_CULLING_NEAR_PLANE 0.00025f
 #endif
+
+/// Override settings if headless
+#ifdef HEADLESS
+	#undef TRACY_GPU
+	#undef TRACY_SCREEN_CAPTURE
+	#undef DEBUG_D3D11_DEVICE
+	#undef DEFERRED_CONTEXTS
+	#undef DEBUG_BUILD
+	#undef EDIT_MODE
+	#undef DEBUG_DRAW
+	#undef DEBUG_DRAW_SORT
+	#undef USE_IMGUI
+	#undef USE_IMGUI_VIEWPORTS
+	#undef USE_IMGUIZMO
+#endif
@@ -28,10 +28,8 @@ Input::Input()
 #endif
 }
 
-bool Input::Update(Window &window)
+void Input::UpdateWindowState(Window &window)
 {
-	ZoneScopedC(RandomUniqueColor());
-	
 	_window = &window;
 	
 	SDL_Window *sdlWindow = _window->GetWindow();
@@ -45,6 +43,28 @@ bool Input::Update(Window &window)
 	SDL_GetDisplayBounds(SDL_GetDisplayForWindow(sdlWindow), &screenRect);
 	_screenPos = { screenRect.x, screenRect.y };
 	_screenSize = { (UINT)screenRect.w, (UINT)screenRect.h };
+}
+void Input::ResetAbsorbed()
+{
+	if (_cursorLocked)
+	{
+		_isKeyboardAbsorbed = false;
+		_isMouseAbsorbed = false;
+	}
+
+	_keyboardWasAbsorbed = _isKeyboardAbsorbed;
+	_isKeyboardAbsorbed = false;
+
+	_mouseWasAbsorbed = _isMouseAbsorbed;
+	_isMouseAbsorbed  = false;
+}
+
+bool Input::Update(Window &window)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	UpdateWindowState(window);
+	SDL_Window *sdlWindow = _window->GetWindow();
 
 	_hasMouseFocus = SDL_GetMouseFocus() == sdlWindow;
 	_hasKeyboardFocus = SDL_GetKeyboardFocus() == sdlWindow;
@@ -101,22 +121,63 @@ bool Input::Update(Window &window)
 		}
 	}
 
-	if (_cursorLocked)
+	ResetAbsorbed();
+
+	if (!_hasMouseFocus)
+		SetMouseScroll({ 0.0f, 0.0f });
+
+	return true;
+}
+bool Input::Replay(Window &window, const RecordedFrame &frame)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	UpdateWindowState(window);
+
+	// Focus is replayed too, so playback does not depend on the window being focused.
+	if (frame.flags & RecordedFrame::InputFocus)
+		_windowFlags |= SDL_WINDOW_INPUT_FOCUS;
+	else
+		_windowFlags &= ~SDL_WINDOW_INPUT_FOCUS;
+
+	_hasMouseFocus = frame.flags & RecordedFrame::MouseFocus;
+	_hasKeyboardFocus = frame.flags & RecordedFrame::KeyboardFocus;
+	_cursorLocked = frame.flags & RecordedFrame::CursorLocked;
+
+	_mousePos = frame.mousePos;
+	_lMousePos = frame.lastMousePos;
+	_localMousePos = frame.localMousePos;
+	_scroll = frame.scroll;
+
+	for (int i = 0; i < 255; i++)
 	{
-		_isKeyboardAbsorbed = false;
-		_isMouseAbsorbed = false;
+		_lvKeys[i] = _vKeys[i];
+		_vKeys[i] = frame.keys[i];
 	}
 
-	_keyboardWasAbsorbed = _isKeyboardAbsorbed;
-	_isKeyboardAbsorbed = false;
+	ResetAbsorbed();
 
-	_mouseWasAbsorbed = _isMouseAbsorbed;
-	_isMouseAbsorbed  = false;
+	return true;
+}
+void Input::CaptureFrame(RecordedFrame &frame) const
+{
+	frame.flags = RecordedFrame::None;
+	if (IsInFocus())
+		frame.flags |= RecordedFrame::InputFocus;
+	if (_hasMouseFocus)
+		frame.flags |= RecordedFrame::MouseFocus;
+	if (_hasKeyboardFocus)
+		frame.flags |= RecordedFrame::KeyboardFocus;
+	if (_cursorLocked)
+		frame.flags |= RecordedFrame::CursorLocked;
 
-	if (!_hasMouseFocus)
-		SetMouseScroll({ 0.0f, 0.0f });
+	frame.mousePos = _mousePos;
+	frame.lastMousePos = _lMousePos;
+	frame.localMousePos = _localMousePos;
+	frame.scroll = _scroll;
 
-	return true;
+	for (int i = 0; i < 255; i++)
+		frame.keys[i] = _vKeys[i];
 }
 
 bool Input::TryWrapMouse()
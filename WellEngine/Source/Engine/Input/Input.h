@@ -5,6 +5,7 @@
 #include <Windows.h>
 #include <SDL3/SDL.h>
 #include "Window/Window.h"
+#include "Input/InputRecording.h"
 
 namespace dx = DirectX;
 
@@ -419,6 +420,9 @@ private:
 	SDL_WindowFlags _windowFlags = 0;
 	Window *_window = nullptr;
 
+	void UpdateWindowState(Window &window);
+	void ResetAbsorbed();
+
 public:
 	Input();
 	~Input() = default;
@@ -431,6 +435,11 @@ public:
 
 	[[nodiscard]] bool Update(Window &window);
 
+	// Takes this frame's input from a recorded frame instead of the mouse and keyboard. Replaces Update() during playback.
+	[[nodiscard]] bool Replay(Window &window, const RecordedFrame &frame);
+	// Stores this frame's input in a recorded frame. Call after Update().
+	void CaptureFrame(RecordedFrame &frame) const;
+
 	bool TryWrapMouse();
 
 	[[nodiscard]] KeyState GetKey(KeyCode keyCode, bool ignoreAbsorb = false) const;
@@ -0,0 +1,306 @@
+#include "stdafx.h"
+#include "Input/InputRecording.h"
+#include <fstream>
+#include <filesystem>
+
+#ifdef LEAK_DETECTION
+#define new			DEBUG_NEW
+#endif
+
+// Which parts of a frame are stored, everything else is the same as in the frame before.
+enum FrameFields : UCHAR
+{
+	FIELD_FIXED_DELTA	= 1 << 0,
+	FIELD_MOUSE			= 1 << 1,
+	FIELD_SCROLL		= 1 << 2,
+	FIELD_KEYS			= 1 << 3,
+	FIELD_SCENE			= 1 << 4,
+};
+
+// Every frame stores at least its fields, flags and real delta time.
+constexpr size_t MIN_FRAME_SIZE = sizeof(UCHAR) + sizeof(RecordedFrame::flags) + sizeof(RecordedFrame::realDeltaTime);
+
+template<class T>
+static void Write(std::vector<char> &data, const T &value)
+{
+	data.insert(data.end(), (const char *)&value, (const char *)&value + sizeof(T));
+}
+template<class T>
+static bool Read(const std::vector<char> &data, size_t &offset, T &value)
+{
+	if (offset + sizeof(T) > data.size())
+		return false;
+
+	memcpy(&value, &data[offset], sizeof(T));
+	offset += sizeof(T);
+	return true;
+}
+
+static void WriteString(std::vector<char> &data, const std::string &str)
+{
+	data.insert(data.end(), str.begin(), str.end());
+	data.emplace_back('\0');
+}
+static bool ReadString(const std::vector<char> &data, size_t &offset, std::string &str)
+{
+	const auto end = std::find(data.begin() + offset, data.end(), '\0');
+	if (end == data.end())
+		return false;
+
+	str.assign(data.begin() + offset, end);
+	offset += str.size() + 1;
+	return true;
+}
+
+static bool IsSamePos(const dx::XMFLOAT2 &a, const dx::XMFLOAT2 &b)
+{
+	return a.x == b.x && a.y == b.y;
+}
+
+void InputRecording::Begin(UINT seed)
+{
+	_seed = seed;
+	_startScene.clear();
+	_frames.clear();
+	_playhead = 0;
+}
+RecordedFrame &InputRecording::AddFrame()
+{
+	return _frames.emplace_back();
+}
+void InputRecording::RecordSceneChange(const std::string &sceneName)
+{
+	if (_frames.empty())
+		return;
+
+	_frames.back().sceneChange = sceneName;
+}
+void InputRecording::SetStartScene(const std::string &sceneName)
+{
+	_startScene = sceneName;
+}
+
+const RecordedFrame *InputRecording::NextFrame()
+{
+	if (_playhead >= _frames.size())
+		return nullptr;
+
+	return &_frames[_playhead++];
+}
+const RecordedFrame *InputRecording::GetCurrentFrame() const
+{
+	if (_playhead == 0)
+		return nullptr;
+
+	return &_frames[_playhead - 1];
+}
+
+UINT InputRecording::GetSeed() const
+{
+	return _seed;
+}
+const std::string &InputRecording::GetStartScene() const
+{
+	return _startScene;
+}
+size_t InputRecording::GetFrameCount() const
+{
+	return _frames.size();
+}
+const RecordedFrame &InputRecording::GetFrame(size_t index) const
+{
+	return _frames[index];
+}
+
+void InputRecording::Compile(std::vector<char> &data) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	data.insert(data.end(), MAGIC, MAGIC + sizeof(MAGIC));
+	Write(data, VERSION);
+	Write(data, _seed);
+	Write(data, static_cast<UINT>(_frames.size()));
+	WriteString(data, _startScene);
+
+	const RecordedFrame empty{};
+	const RecordedFrame *last = &empty;
+
+	for (const RecordedFrame &frame : _frames)
+	{
+		UCHAR fields = 0;
+		if (frame.fixedDeltaTime != last->fixedDeltaTime)
+			fields |= FIELD_FIXED_DELTA;
+		if (!IsSamePos(frame.mousePos, last->mousePos) ||
+			!IsSamePos(frame.lastMousePos, last->lastMousePos) ||
+			!IsSamePos(frame.localMousePos, last->localMousePos))
+			fields |= FIELD_MOUSE;
+		if (!IsSamePos(frame.scroll, { 0, 0 }))
+			fields |= FIELD_SCROLL;
+		if (frame.keys != last->keys)
+			fields |= FIELD_KEYS;
+		if (!frame.sceneChange.empty())
+			fields |= FIELD_SCENE;
+
+		Write(data, fields);
+		Write(data, frame.flags);
+		Write(data, frame.realDeltaTime);
+
+		if (fields & FIELD_FIXED_DELTA)
+			Write(data, frame.fixedDeltaTime);
+
+		if (fields & FIELD_MOUSE)
+		{
+			Write(data, frame.mousePos);
+			Write(data, frame.lastMousePos);
+			Write(data, frame.localMousePos);
+		}
+
+		if (fields & FIELD_SCROLL)
+			Write(data, frame.scroll);
+
+		if (fields & FIELD_KEYS)
+		{
+			// Only the keys that went up or down are stored.
+			const std::bitset<256> changed = frame.keys ^ last->keys;
+
+			Write(data, static_cast<USHORT>(changed.count()));
+			for (UINT i = 0; i < changed.size(); i++)
+			{
+				if (changed[i])
+					Write(data, static_cast<UCHAR>(i));
+			}
+		}
+
+		if (fields & FIELD_SCENE)
+			WriteString(data, frame.sceneChange);
+
+		last = &frame;
+	}
+}
+bool InputRecording::Decompile(const std::vector<char> &data)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	size_t offset = 0;
+
+	if (data.size() < sizeof(MAGIC) || memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0)
+	{
+		DbgMsg("Data is not an input recording!");
+		return false;
+	}
+	offset += sizeof(MAGIC);
+
+	UINT version = 0, seed = 0, frameCount = 0;
+	if (!Read(data, offset, version) || !Read(data, offset, seed) || !Read(data, offset, frameCount))
+	{
+		DbgMsg("Input recording header is truncated!");
+		return false;
+	}
+
+	if (version != VERSION)
+	{
+		DbgMsgF("Input recording version {} is not supported, expected {}!", version, VERSION);
+		return false;
+	}
+
+	Begin(seed);
+
+	if (!ReadString(data, offset, _startScene))
+	{
+		DbgMsg("Input recording header is truncated!");
+		return false;
+	}
+
+	// The header's frame count is not trusted further than the data left could hold.
+	_frames.reserve(std::min<size_t>(frameCount, (data.size() - offset) / MIN_FRAME_SIZE));
+
+	for (UINT i = 0; i < frameCount; i++)
+	{
+		RecordedFrame frame = _frames.empty() ? RecordedFrame() : _frames.back();
+		frame.scroll = { 0, 0 };
+		frame.sceneChange.clear();
+
+		UCHAR fields = 0;
+		bool isValid = Read(data, offset, fields) && Read(data, offset, frame.flags) && Read(data, offset, frame.realDeltaTime);
+
+		if (isValid && (fields & FIELD_FIXED_DELTA))
+			isValid = Read(data, offset, frame.fixedDeltaTime);
+
+		if (isValid && (fields & FIELD_MOUSE))
+			isValid = Read(data, offset, frame.mousePos) && Read(data, offset, frame.lastMousePos) && Read(data, offset, frame.localMousePos);
+
+		if (isValid && (fields & FIELD_SCROLL))
+			isValid = Read(data, offset, frame.scroll);
+
+		if (isValid && (fields & FIELD_KEYS))
+		{
+			USHORT changedCount = 0;
+			isValid = Read(data, offset, changedCount);
+
+			for (USHORT j = 0; isValid && j < changedCount; j++)
+			{
+				UCHAR key = 0;
+				isValid = Read(data, offset, key);
+				if (isValid)
+					frame.keys.flip(key);
+			}
+		}
+
+		if (isValid && (fields & FIELD_SCENE))
+			isValid = ReadString(data, offset, frame.sceneChange);
+
+		if (!isValid)
+		{
+			DbgMsgF("Input recording is truncated at frame {} of {}!", i, frameCount);
+			_frames.clear();
+			return false;
+		}
+
+		_frames.emplace_back(std::move(frame));
+	}
+
+	return true;
+}
+
+bool InputRecording::Save(const std::string &path) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	std::vector<char> data;
+	Compile(data);
+
+	const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+	if (!directory.empty())
+		std::filesystem::create_directories(directory);
+
+	std::ofstream writer(path, std::ios::binary | std::ios::trunc);
+	if (!writer.is_open())
+	{
+		ErrMsgF("Failed to open input recording '{}' for writing!", path);
+		return false;
+	}
+
+	writer.write(data.data(), data.size());
+	writer.close();
+	return true;
+}
+bool InputRecording::Load(const std::string &path)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	std::ifstream reader(path, std::ios::binary | std::ios::in | std::ios::ate);
+	if (!reader.is_open())
+	{
+		ErrMsgF("Failed to open input recording '{}'!", path);
+		return false;
+	}
+
+	const size_t fileSize = reader.tellg();
+	reader.seekg(0, std::ios::beg);
+
+	std::vector<char> data(fileSize);
+	reader.read(data.data(), fileSize);
+	reader.close();
+
+	return Decompile(data);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <bitset>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+
+namespace dx = DirectX;
+
+// Everything the game reads from the player and the clock during one frame.
+struct RecordedFrame
+{
+	enum Flags : UCHAR
+	{
+		None				= 0,
+		InputFocus			= 1 << 0,
+		MouseFocus			= 1 << 1,
+		KeyboardFocus		= 1 << 2,
+		CursorLocked		= 1 << 3,
+	};
+
+	float realDeltaTime = 0.0f;
+	float fixedDeltaTime = 0.0f;
+
+	dx::XMFLOAT2 mousePos{ 0, 0 };
+	dx::XMFLOAT2 lastMousePos{ 0, 0 };
+	dx::XMFLOAT2 localMousePos{ 0, 0 };
+	dx::XMFLOAT2 scroll{ 0, 0 };
+
+	std::bitset<256> keys;
+	UCHAR flags = None;
+
+	// Scene the game switched to this frame, empty if it stayed.
+	std::string sceneChange = "";
+};
+
+// A sequence of recorded frames, along with the random seed and scene the run started from.
+// Frames are stored as changes from the frame before, so a frame where only time passed takes six bytes.
+class InputRecording
+{
+private:
+	UINT _seed = 0;
+	std::string _startScene = "";
+	std::vector<RecordedFrame> _frames;
+	size_t _playhead = 0;
+
+public:
+	static constexpr char MAGIC[4] = { 'W', 'R', 'E', 'C' };
+	static constexpr UINT VERSION = 1;
+
+	InputRecording() = default;
+	~InputRecording() = default;
+	InputRecording(const InputRecording &other) = delete;
+	InputRecording &operator=(const InputRecording &other) = delete;
+	InputRecording(InputRecording &&other) = delete;
+	InputRecording &operator=(InputRecording &&other) = delete;
+
+	static inline InputRecording &Instance()
+	{
+		static InputRecording instance;
+		return instance;
+	}
+
+	// Clears all frames and starts a new recording.
+	void Begin(UINT seed);
+	// Adds an empty frame to the end of the recording and returns it to be filled in.
+	RecordedFrame &AddFrame();
+	// Stores a scene change on the last added frame.
+	void RecordSceneChange(const std::string &sceneName);
+	void SetStartScene(const std::string &sceneName);
+
+	// Advances playback and returns the next frame, or nullptr once every frame has been played.
+	[[nodiscard]] const RecordedFrame *NextFrame();
+	// The frame last returned by NextFrame(), or nullptr before playback starts.
+	[[nodiscard]] const RecordedFrame *GetCurrentFrame() const;
+
+	[[nodiscard]] UINT GetSeed() const;
+	[[nodiscard]] const std::string &GetStartScene() const;
+	[[nodiscard]] size_t GetFrameCount() const;
+	[[nodiscard]] const RecordedFrame &GetFrame(size_t index) const;
+
+	void Compile(std::vector<char> &data) const;
+	[[nodiscard]] bool Decompile(const std::vector<char> &data);
+
+	[[nodiscard]] bool Save(const std::string &path) const;
+	[[nodiscard]] bool Load(const std::string &path);
+
+	TESTABLE()
+};
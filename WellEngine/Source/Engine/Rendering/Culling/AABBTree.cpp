@@ -0,0 +1,1062 @@
+#include "stdafx.h"
+#include "AABBTree.h"
+#include "Scenes/Scene.h"
+
+using namespace DirectX;
+
+#pragma region Helpers
+[[nodiscard]] static inline BoundingBox ToAABB(const BoundingOrientedBox &box)
+{
+	XMFLOAT3 corners[8];
+	box.GetCorners(corners);
+
+	BoundingBox aabb;
+	BoundingBox::CreateFromPoints(aabb, 8, corners, sizeof(XMFLOAT3));
+	return aabb;
+}
+
+[[nodiscard]] static inline BoundingBox Merged(const BoundingBox &a, const BoundingBox &b)
+{
+	BoundingBox merged;
+	BoundingBox::CreateMerged(merged, a, b);
+	return merged;
+}
+
+// Half the surface area, only ever compared against other areas.
+[[nodiscard]] static inline float HalfArea(const BoundingBox &box)
+{
+	const XMFLOAT3 &e = box.Extents;
+	return 4.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+}
+
+static void RaycastItem(Entity *item, const XMFLOAT3 &orig, const XMFLOAT3 &dir, float &length, Entity *&entity, bool cheap)
+{
+	if (item == nullptr)
+		return;
+
+	if (!item->IsEnabled())
+		return;
+
+	if (!item->IsDebugSelectable())
+		return;
+
+	if (!item->IsRaycastTarget())
+		return;
+
+	if (!cheap)
+	{
+		MeshBehaviour *meshBehaviour = nullptr;
+		if (item->GetBehaviourByType<MeshBehaviour>(meshBehaviour))
+		{
+			const Shape::Ray ray(orig, dir);
+
+			MeshD3D11 *mesh = item->GetScene()->GetContent()->GetMesh(meshBehaviour->GetMeshID());
+			const MeshCollider &meshCollider = mesh->GetMeshCollider();
+
+			const XMFLOAT4X4A &meshMatrix = item->GetTransform()->GetMatrix(World);
+			XMFLOAT4X4A meshMatrixInv; Store(meshMatrixInv, XMMatrixInverse(nullptr, Load(meshMatrix)));
+
+			const Shape::Ray localRay = ray.Transformed(meshMatrixInv);
+			Shape::RayHit localHit;
+
+			if (meshCollider.RaycastMesh(localRay, localHit))
+			{
+				localHit.Transform(meshMatrix);
+
+				if (localHit.length < length)
+				{
+					length = localHit.length;
+					entity = item;
+				}
+			}
+
+			return;
+		}
+	}
+
+	BoundingOrientedBox itemBounds;
+	if (!item->HasBounds(false, itemBounds))
+		return;
+
+	float newLength = 0.0f;
+	if (!Raycast(orig, dir, itemBounds, newLength))
+		return;
+
+	if (newLength >= length)
+		return;
+
+	length = newLength;
+	entity = item;
+}
+static void RaycastItem(Entity *item, const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent)
+{
+	if (item == nullptr)
+		return;
+
+	if (!item->IsEnabled())
+		return;
+
+	if (!item->IsDebugSelectable())
+		return;
+
+	if (!item->IsRaycastTarget())
+		return;
+
+	MeshBehaviour *meshBehaviour = nullptr;
+	if (!item->GetBehaviourByType<MeshBehaviour>(meshBehaviour))
+		return;
+
+	MeshD3D11 *mesh = item->GetScene()->GetContent()->GetMesh(meshBehaviour->GetMeshID());
+	const MeshCollider &meshCollider = mesh->GetMeshCollider();
+
+	const XMFLOAT4X4A &meshMatrix = item->GetTransform()->GetMatrix(World);
+	XMFLOAT4X4A meshMatrixInv; Store(meshMatrixInv, XMMatrixInverse(nullptr, Load(meshMatrix)));
+
+	const Shape::Ray localRay = ray.Transformed(meshMatrixInv);
+	Shape::RayHit localHit;
+
+	if (!meshCollider.RaycastMesh(localRay, localHit))
+		return;
+
+	localHit.Transform(meshMatrix);
+
+	if (localHit.length >= hit.length)
+		return;
+
+	hit = localHit;
+	ent = item;
+}
+#pragma endregion
+
+
+#pragma region Structure
+bool AABBTree::Initialize(const BoundingBox &sceneBounds)
+{
+	_bounds = sceneBounds;
+
+	_nodes.clear();
+	_nodes.reserve(256);
+	_root = NULL_NODE;
+	_freeList = NULL_NODE;
+	_leafCount = 0;
+
+	_leafLookup.clear();
+	_refitQueue.clear();
+
+	_isInitialized = true;
+	return true;
+}
+
+int AABBTree::AllocateNode()
+{
+	if (_freeList == NULL_NODE)
+	{
+		_nodes.emplace_back();
+		return static_cast<int>(_nodes.size() - 1);
+	}
+
+	// Free nodes are linked through their parent index.
+	const int node = _freeList;
+	_freeList = _nodes[node].parent;
+	_nodes[node] = {};
+	return node;
+}
+void AABBTree::FreeNode(int node)
+{
+	_nodes[node] = {};
+	_nodes[node].parent = _freeList;
+	_nodes[node].height = -1;
+	_freeList = node;
+}
+
+void AABBTree::RefitNode(int node)
+{
+	Node &n = _nodes[node];
+	const Node &child1 = _nodes[n.child1];
+	const Node &child2 = _nodes[n.child2];
+
+	n.height = 1 + std::max<int>(child1.height, child2.height);
+	BoundingBox::CreateMerged(n.bounds, child1.bounds, child2.bounds);
+}
+
+void AABBTree::InsertLeaf(int leaf)
+{
+	ZoneScopedXC(RandomUniqueColor());
+
+	if (_root == NULL_NODE)
+	{
+		_root = leaf;
+		_nodes[leaf].parent = NULL_NODE;
+		return;
+	}
+
+	// Find the best sibling for the new leaf using the surface area heuristic.
+	const BoundingBox leafBounds = _nodes[leaf].bounds;
+	int index = _root;
+
+	while (!_nodes[index].IsLeaf())
+	{
+		const Node &node = _nodes[index];
+
+		const float area = HalfArea(node.bounds);
+		const float combinedArea = HalfArea(Merged(node.bounds, leafBounds));
+
+		// Cost of creating a new parent for this node and the new leaf.
+		const float cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree.
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto DescendCost = [&](int child) -> float
+		{
+			const Node &childNode = _nodes[child];
+			const float newArea = HalfArea(Merged(childNode.bounds, leafBounds));
+
+			if (childNode.IsLeaf())
+				return newArea + inheritanceCost;
+
+			return (newArea - HalfArea(childNode.bounds)) + inheritanceCost;
+		};
+
+		const float cost1 = DescendCost(node.child1);
+		const float cost2 = DescendCost(node.child2);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = (cost1 < cost2) ? node.child1 : node.child2;
+	}
+
+	const int sibling = index;
+	const int newParent = AllocateNode();
+	const int oldParent = _nodes[sibling].parent;
+
+	Node &parentNode = _nodes[newParent];
+	parentNode.parent = oldParent;
+	parentNode.bounds = Merged(leafBounds, _nodes[sibling].bounds);
+	parentNode.height = _nodes[sibling].height + 1;
+	parentNode.child1 = sibling;
+	parentNode.child2 = leaf;
+
+	_nodes[sibling].parent = newParent;
+	_nodes[leaf].parent = newParent;
+
+	if (oldParent == NULL_NODE)
+		_root = newParent;
+	else if (_nodes[oldParent].child1 == sibling)
+		_nodes[oldParent].child1 = newParent;
+	else
+		_nodes[oldParent].child2 = newParent;
+
+	// Walk back up, rebalancing and fixing heights and bounds.
+	index = _nodes[leaf].parent;
+	while (index != NULL_NODE)
+	{
+		index = Balance(index);
+		RefitNode(index);
+		index = _nodes[index].parent;
+	}
+}
+
+void AABBTree::RemoveLeaf(int leaf)
+{
+	ZoneScopedXC(RandomUniqueColor());
+
+	if (leaf == _root)
+	{
+		_root = NULL_NODE;
+		return;
+	}
+
+	const int parent = _nodes[leaf].parent;
+	const int grandParent = _nodes[parent].parent;
+	const int sibling = (_nodes[parent].child1 == leaf) ? _nodes[parent].child2 : _nodes[parent].child1;
+
+	_nodes[leaf].parent = NULL_NODE;
+
+	if (grandParent == NULL_NODE)
+	{
+		_root = sibling;
+		_nodes[sibling].parent = NULL_NODE;
+		FreeNode(parent);
+		return;
+	}
+
+	// Replace the parent with the sibling.
+	if (_nodes[grandParent].child1 == parent)
+		_nodes[grandParent].child1 = sibling;
+	else
+		_nodes[grandParent].child2 = sibling;
+
+	_nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	int index = grandParent;
+	while (index != NULL_NODE)
+	{
+		index = Balance(index);
+		RefitNode(index);
+		index = _nodes[index].parent;
+	}
+}
+
+// Performs a left or right rotation if the node is imbalanced. Returns the new root of the subtree.
+int AABBTree::Balance(int iA)
+{
+	Node &A = _nodes[iA];
+	if (A.IsLeaf() || A.height < 2)
+		return iA;
+
+	const int iB = A.child1;
+	const int iC = A.child2;
+	Node &B = _nodes[iB];
+	Node &C = _nodes[iC];
+
+	const int balance = C.height - B.height;
+
+	// Rotate C up
+	if (balance > 1)
+	{
+		const int iF = C.child1;
+		const int iG = C.child2;
+		Node &F = _nodes[iF];
+		Node &G = _nodes[iG];
+
+		// Swap A and C
+		C.child1 = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		// A's old parent should point to C
+		if (C.parent == NULL_NODE)
+			_root = iC;
+		else if (_nodes[C.parent].child1 == iA)
+			_nodes[C.parent].child1 = iC;
+		else
+			_nodes[C.parent].child2 = iC;
+
+		if (F.height > G.height)
+		{
+			C.child2 = iF;
+			A.child2 = iG;
+			G.parent = iA;
+			A.bounds = Merged(B.bounds, G.bounds);
+			C.bounds = Merged(A.bounds, F.bounds);
+
+			A.height = 1 + std::max<int>(B.height, G.height);
+			C.height = 1 + std::max<int>(A.height, F.height);
+		}
+		else
+		{
+			C.child2 = iG;
+			A.child2 = iF;
+			F.parent = iA;
+			A.bounds = Merged(B.bounds, F.bounds);
+			C.bounds = Merged(A.bounds, G.bounds);
+
+			A.height = 1 + std::max<int>(B.height, F.height);
+			C.height = 1 + std::max<int>(A.height, G.height);
+		}
+
+		return iC;
+	}
+
+	// Rotate B up
+	if (balance < -1)
+	{
+		const int iD = B.child1;
+		const int iE = B.child2;
+		Node &D = _nodes[iD];
+		Node &E = _nodes[iE];
+
+		// Swap A and B
+		B.child1 = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		// A's old parent should point to B
+		if (B.parent == NULL_NODE)
+			_root = iB;
+		else if (_nodes[B.parent].child1 == iA)
+			_nodes[B.parent].child1 = iB;
+		else
+			_nodes[B.parent].child2 = iB;
+
+		if (D.height > E.height)
+		{
+			B.child2 = iD;
+			A.child1 = iE;
+			E.parent = iA;
+			A.bounds = Merged(C.bounds, E.bounds);
+			B.bounds = Merged(A.bounds, D.bounds);
+
+			A.height = 1 + std::max<int>(C.height, E.height);
+			B.height = 1 + std::max<int>(A.height, D.height);
+		}
+		else
+		{
+			B.child2 = iE;
+			A.child1 = iD;
+			D.parent = iA;
+			A.bounds = Merged(C.bounds, D.bounds);
+			B.bounds = Merged(A.bounds, E.bounds);
+
+			A.height = 1 + std::max<int>(C.height, D.height);
+			B.height = 1 + std::max<int>(A.height, E.height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+void AABBTree::Insert(Entity *data, const BoundingOrientedBox &bounds)
+{
+	ZoneScopedC(RandomUniqueColor());
+	const std::string &name = data->GetName();
+	ZoneText(name.c_str(), name.size());
+
+	if (!_isInitialized)
+		return;
+
+	if (_leafLookup.contains(data))
+	{
+		(void)Move(data, bounds);
+		return;
+	}
+
+	data->UpdateCullingBounds();
+
+	BoundingBox fatBounds = ToAABB(bounds);
+	fatBounds.Extents.x += FAT_MARGIN;
+	fatBounds.Extents.y += FAT_MARGIN;
+	fatBounds.Extents.z += FAT_MARGIN;
+
+	const int leaf = AllocateNode();
+	_nodes[leaf].bounds = fatBounds;
+	_nodes[leaf].item = data;
+	_nodes[leaf].height = 0;
+
+	InsertLeaf(leaf);
+
+	_leafLookup[data] = leaf;
+	_leafCount++;
+}
+
+bool AABBTree::Remove(Entity *data, bool skipIntersectionTests)
+{
+	ZoneScopedC(RandomUniqueColor());
+	const std::string &name = data->GetName();
+	ZoneText(name.c_str(), name.size());
+
+	(void)skipIntersectionTests; // Leaves are tracked per entity, no intersection tests are needed.
+
+	if (!_isInitialized)
+		return false;
+
+	auto lookupIt = _leafLookup.find(data);
+	if (lookupIt == _leafLookup.end())
+		return true;
+
+	const int leaf = lookupIt->second;
+	_leafLookup.erase(lookupIt);
+
+	RemoveLeaf(leaf);
+	FreeNode(leaf);
+	_leafCount--;
+	return true;
+}
+
+bool AABBTree::Move(Entity *data, const BoundingOrientedBox &bounds)
+{
+	ZoneScopedC(RandomUniqueColor());
+	const std::string &name = data->GetName();
+	ZoneText(name.c_str(), name.size());
+
+	if (!_isInitialized)
+		return false;
+
+	auto lookupIt = _leafLookup.find(data);
+	if (lookupIt == _leafLookup.end())
+	{
+		Insert(data, bounds);
+		return true;
+	}
+
+	data->UpdateCullingBounds();
+
+	const int leaf = lookupIt->second;
+	const BoundingBox tightBounds = ToAABB(bounds);
+
+	// Still inside the fattened bounds, nothing to do.
+	if (_nodes[leaf].bounds.Contains(tightBounds) == CONTAINS)
+		return true;
+
+	BoundingBox fatBounds = tightBounds;
+	fatBounds.Extents.x += FAT_MARGIN;
+	fatBounds.Extents.y += FAT_MARGIN;
+	fatBounds.Extents.z += FAT_MARGIN;
+
+	if (!_nodes[leaf].bounds.Intersects(fatBounds))
+	{
+		// Moved far away, refitting would stretch its ancestors. Find it a new place instead.
+		RemoveLeaf(leaf);
+		_nodes[leaf].bounds = fatBounds;
+		InsertLeaf(leaf);
+		return true;
+	}
+
+	// Small move, update the leaf in place and refit its ancestors in bulk later.
+	_nodes[leaf].bounds = fatBounds;
+
+	if (!_nodes[leaf].isDirty)
+	{
+		_nodes[leaf].isDirty = true;
+		_refitQueue.emplace_back(leaf);
+	}
+
+	return true;
+}
+
+void AABBTree::RefitDirty(int node)
+{
+	Node &n = _nodes[node];
+
+	if (!n.isDirty)
+		return;
+
+	n.isDirty = false;
+
+	if (n.IsLeaf())
+		return;
+
+	RefitDirty(n.child1);
+	RefitDirty(n.child2);
+	RefitNode(node);
+}
+
+void AABBTree::RecalculateCullingBounds()
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized)
+		return;
+
+	if (_refitQueue.empty())
+		return;
+
+	// Flag the ancestors of every moved leaf, stopping at branches that are already flagged.
+	for (const int leaf : _refitQueue)
+	{
+		Node &leafNode = _nodes[leaf];
+
+		if (leafNode.height != 0 || !leafNode.isDirty)
+			continue; // Removed or reinserted since it was queued.
+
+		leafNode.isDirty = false;
+
+		int index = leafNode.parent;
+		while (index != NULL_NODE && !_nodes[index].isDirty)
+		{
+			_nodes[index].isDirty = true;
+			index = _nodes[index].parent;
+		}
+	}
+
+	_refitQueue.clear();
+
+	if (_root != NULL_NODE)
+		RefitDirty(_root);
+}
+
+BoundingBox *AABBTree::GetBounds()
+{
+	if (!_isInitialized)
+		return nullptr;
+
+	return &_bounds;
+}
+#pragma endregion
+
+
+#pragma region Queries
+void AABBTree::AddSubtree(int node, std::vector<Entity *> &containingItems) const
+{
+	int stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+	stack[stackSize++] = node;
+
+	while (stackSize > 0)
+	{
+		const Node &current = _nodes[stack[--stackSize]];
+
+		if (!current.IsLeaf())
+		{
+			stack[stackSize++] = current.child1;
+			stack[stackSize++] = current.child2;
+			continue;
+		}
+
+		Entity *item = current.item;
+
+		if (item == nullptr)
+			continue;
+
+		if (!item->IsEnabled())
+			continue;
+
+		containingItems.emplace_back(item);
+	}
+}
+
+template <class VolumeType>
+void AABBTree::CullInternal(const VolumeType &volume, std::vector<Entity *> &containingItems) const
+{
+	ZoneScopedXC(RandomUniqueColor());
+
+	if (_root == NULL_NODE)
+		return;
+
+	// The tree is kept balanced, so its height stays far below the stack size.
+	int stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+	stack[stackSize++] = _root;
+
+	while (stackSize > 0)
+	{
+		const int index = stack[--stackSize];
+		const Node &node = _nodes[index];
+
+		switch (volume.Contains(node.bounds))
+		{
+		case DISJOINT:
+			break;
+
+		case CONTAINS:
+			AddSubtree(index, containingItems);
+			break;
+
+		case INTERSECTS:
+			if (node.IsLeaf())
+			{
+				Entity *item = node.item;
+
+				if (item == nullptr)
+					break;
+
+				if (!item->IsEnabled())
+					break;
+
+#ifdef EXTRA_CULL_CHECK
+				BoundingOrientedBox itemBounds;
+				item->StoreEntityBounds(itemBounds);
+
+				if (!volume.Intersects(itemBounds))
+					break;
+#endif
+
+				containingItems.emplace_back(item);
+				break;
+			}
+
+			stack[stackSize++] = node.child1;
+			stack[stackSize++] = node.child2;
+			break;
+		}
+	}
+}
+
+bool AABBTree::FrustumCull(const BoundingFrustum &frustum, std::vector<Entity *> &containingItems) const
+{
+	if (!_isInitialized)
+		return false;
+
+	CullInternal(frustum, containingItems);
+	return true;
+}
+
+bool AABBTree::FrustumCull(const BoundingFrustum &frustum, std::vector<Entity *> &containingItems, const FrustumCullOptions &options) const
+{
+	return FrustumCull(frustum, containingItems);
+}
+
+bool AABBTree::BoxCull(const BoundingOrientedBox &box, std::vector<Entity *> &containingItems) const
+{
+	if (!_isInitialized)
+		return false;
+
+	CullInternal(box, containingItems);
+	return true;
+}
+
+bool AABBTree::BoxCull(const BoundingBox &box, std::vector<Entity *> &containingItems) const
+{
+	if (!_isInitialized)
+		return false;
+
+	CullInternal(box, containingItems);
+	return true;
+}
+
+bool AABBTree::SphereCull(const BoundingSphere &sphere, std::vector<Entity *> &containingItems) const
+{
+	if (!_isInitialized)
+		return false;
+
+	CullInternal(sphere, containingItems);
+	return true;
+}
+
+bool AABBTree::FindNearest(NearestQuery &query) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized)
+		return false;
+
+	if (_root == NULL_NODE)
+		return true;
+
+	using NodeEntry = std::pair<float, int>;
+	std::priority_queue<NodeEntry, std::vector<NodeEntry>, std::greater<NodeEntry>> queue;
+	queue.emplace(query.DistanceSq(_nodes[_root].bounds), _root);
+
+	while (!queue.empty())
+	{
+		const auto [distanceSq, index] = queue.top();
+		queue.pop();
+
+		if (distanceSq > query.GetBoundSq())
+			break;
+
+		const Node &node = _nodes[index];
+
+		if (node.IsLeaf())
+		{
+			query.Offer(node.item);
+			continue;
+		}
+
+		for (const int child : { node.child1, node.child2 })
+		{
+			const float childDistanceSq = query.DistanceSq(_nodes[child].bounds);
+			if (childDistanceSq <= query.GetBoundSq())
+				queue.emplace(childDistanceSq, child);
+		}
+	}
+
+	return true;
+}
+
+bool AABBTree::MultiCull(const CullView *views, UINT viewCount, std::vector<Entity *> *containingItems) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized)
+		return false;
+
+	if (viewCount > CullView::MAX_BATCH_SIZE)
+		return false;
+
+	if (viewCount == 0 || _root == NULL_NODE)
+		return true;
+
+	struct StackEntry { int node; UINT64 viewMask; };
+	StackEntry stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+	stack[stackSize++] = { _root, CullView::GetViewMask(viewCount) };
+
+	while (stackSize > 0)
+	{
+		const StackEntry current = stack[--stackSize];
+		const Node &node = _nodes[current.node];
+
+		UINT64 intersectMask = 0;
+		for (UINT64 remaining = current.viewMask; remaining != 0; remaining &= remaining - 1)
+		{
+			const UINT view = CullView::NextView(remaining);
+
+			switch (views[view].Contains(node.bounds))
+			{
+			case DISJOINT:
+				break;
+
+			case CONTAINS:
+				AddSubtree(current.node, containingItems[view]);
+				break;
+
+			case INTERSECTS:
+				intersectMask |= 1ull << view;
+				break;
+			}
+		}
+
+		if (intersectMask == 0)
+			continue;
+
+		if (!node.IsLeaf())
+		{
+			stack[stackSize++] = { node.child1, intersectMask };
+			stack[stackSize++] = { node.child2, intersectMask };
+			continue;
+		}
+
+		Entity *item = node.item;
+
+		if (item == nullptr)
+			continue;
+
+		if (!item->IsEnabled())
+			continue;
+
+#ifdef EXTRA_CULL_CHECK
+		BoundingOrientedBox itemBounds;
+		item->StoreEntityBounds(itemBounds);
+#endif
+
+		for (UINT64 remaining = intersectMask; remaining != 0; remaining &= remaining - 1)
+		{
+			const UINT view = CullView::NextView(remaining);
+
+#ifdef EXTRA_CULL_CHECK
+			if (!views[view].Intersects(itemBounds))
+				continue;
+#endif
+
+			containingItems[view].emplace_back(item);
+		}
+	}
+
+	return true;
+}
+
+bool AABBTree::RaycastTree(const XMFLOAT3A &orig, const XMFLOAT3A &dir, float &length, Entity *&entity, bool cheap) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized)
+		return false;
+
+	length = FLT_MAX;
+	entity = nullptr;
+
+	if (_root == NULL_NODE)
+		return false;
+
+	float rootLength = FLT_MAX;
+	if (!Raycast(orig, dir, _nodes[_root].bounds, rootLength))
+		return false;
+
+	struct StackEntry { int node; float length; };
+	StackEntry stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+	stack[stackSize++] = { _root, rootLength };
+
+	while (stackSize > 0)
+	{
+		const StackEntry current = stack[--stackSize];
+
+		// A closer hit was found since this node was pushed.
+		if (current.length > length)
+			continue;
+
+		const Node &node = _nodes[current.node];
+
+		if (node.IsLeaf())
+		{
+			RaycastItem(node.item, orig, dir, length, entity, cheap);
+			continue;
+		}
+
+		float length1 = FLT_MAX, length2 = FLT_MAX;
+		const bool hit1 = Raycast(orig, dir, _nodes[node.child1].bounds, length1) && length1 <= length;
+		const bool hit2 = Raycast(orig, dir, _nodes[node.child2].bounds, length2) && length2 <= length;
+
+		// Push the furthest child first so the closest one is checked first.
+		if (hit1 && hit2)
+		{
+			if (length1 < length2)
+			{
+				stack[stackSize++] = { node.child2, length2 };
+				stack[stackSize++] = { node.child1, length1 };
+			}
+			else
+			{
+				stack[stackSize++] = { node.child1, length1 };
+				stack[stackSize++] = { node.child2, length2 };
+			}
+		}
+		else if (hit1)
+			stack[stackSize++] = { node.child1, length1 };
+		else if (hit2)
+			stack[stackSize++] = { node.child2, length2 };
+	}
+
+	return (entity != nullptr);
+}
+
+bool AABBTree::RaycastTree(const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized)
+		return false;
+
+	hit.length = ray.length > 0.0f ? ray.length : FLT_MAX;
+	ent = nullptr;
+
+	if (_root == NULL_NODE)
+		return false;
+
+	float rootLength = hit.length; // In case Intersects() uses the initial dist value as a maximum. Docs don't specify.
+	if (!Raycast(ray.origin, ray.direction, _nodes[_root].bounds, rootLength))
+		return false;
+
+	if (rootLength > hit.length)
+		return false;
+
+	struct StackEntry { int node; float length; };
+	StackEntry stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+	stack[stackSize++] = { _root, rootLength };
+
+	while (stackSize > 0)
+	{
+		const StackEntry current = stack[--stackSize];
+
+		if (current.length > hit.length)
+			continue;
+
+		const Node &node = _nodes[current.node];
+
+		if (node.IsLeaf())
+		{
+			RaycastItem(node.item, ray, hit, ent);
+			continue;
+		}
+
+		float length1 = FLT_MAX, length2 = FLT_MAX;
+		const bool hit1 = Raycast(ray.origin, ray.direction, _nodes[node.child1].bounds, length1) && length1 <= hit.length;
+		const bool hit2 = Raycast(ray.origin, ray.direction, _nodes[node.child2].bounds, length2) && length2 <= hit.length;
+
+		if (hit1 && hit2)
+		{
+			if (length1 < length2)
+			{
+				stack[stackSize++] = { node.child2, length2 };
+				stack[stackSize++] = { node.child1, length1 };
+			}
+			else
+			{
+				stack[stackSize++] = { node.child1, length1 };
+				stack[stackSize++] = { node.child2, length2 };
+			}
+		}
+		else if (hit1)
+			stack[stackSize++] = { node.child1, length1 };
+		else if (hit2)
+			stack[stackSize++] = { node.child2, length2 };
+	}
+
+	return (ent != nullptr);
+}
+#pragma endregion
+
+
+#pragma region Debug
+void AABBTree::DebugGetStructure(std::vector<BoundingBox> &boxCollection, bool full, bool culling) const
+{
+	if (!_isInitialized || _root == NULL_NODE)
+		return;
+
+	int stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+	stack[stackSize++] = _root;
+
+	while (stackSize > 0)
+	{
+		const Node &node = _nodes[stack[--stackSize]];
+
+		if (node.IsLeaf())
+		{
+			// Without culling bounds, show the tight bounds instead of the fattened ones.
+			if (culling || node.item == nullptr)
+				boxCollection.emplace_back(node.bounds);
+			else
+				boxCollection.emplace_back(ToAABB(node.item->GetLastCullingBounds()));
+
+			continue;
+		}
+
+		if (full)
+			boxCollection.emplace_back(node.bounds);
+
+		stack[stackSize++] = node.child1;
+		stack[stackSize++] = node.child2;
+	}
+}
+void AABBTree::DebugGetStructure(std::vector<BoundingBox> &boxCollection, const BoundingFrustum &frustum, bool full, bool culling) const
+{
+	if (!_isInitialized || _root == NULL_NODE)
+		return;
+
+	int stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+	stack[stackSize++] = _root;
+
+	while (stackSize > 0)
+	{
+		const Node &node = _nodes[stack[--stackSize]];
+
+		if (!frustum.Intersects(node.bounds))
+			continue;
+
+		if (node.IsLeaf())
+		{
+			if (culling || node.item == nullptr)
+				boxCollection.emplace_back(node.bounds);
+			else
+				boxCollection.emplace_back(ToAABB(node.item->GetLastCullingBounds()));
+
+			continue;
+		}
+
+		if (full)
+			boxCollection.emplace_back(node.bounds);
+
+		stack[stackSize++] = node.child1;
+		stack[stackSize++] = node.child2;
+	}
+}
+
+#ifdef USE_IMGUI
+bool AABBTree::RenderUI()
+{
+	if (!_isInitialized)
+		return true;
+
+	ImGui::Text("Leaves: %u", _leafCount);
+	ImGui::Text("Allocated Nodes: %zu", _nodes.size());
+	ImGui::Text("Height: %d", _root == NULL_NODE ? 0 : _nodes[_root].height);
+	ImGui::Text("Pending Refits: %zu", _refitQueue.size());
+
+	ImGui::Separator();
+
+	ImGui::ColorEdit4("Bounds Color", &boundsColor.x, ImGuiColorEditFlags_NoInputs);
+	ImGui::Checkbox("Draw Bounds", &drawBounds);
+	ImGui::Checkbox("Leaves Only", &drawLeavesOnly);
+
+	if (drawBounds)
+	{
+		std::vector<BoundingBox> boxes;
+		DebugGetStructure(boxes, !drawLeavesOnly, true);
+
+		for (const BoundingBox &box : boxes)
+			DebugDrawer::Instance().DrawBoxAABB(box, boundsColor, false, true);
+	}
+
+	return true;
+}
+#endif
+#pragma endregion
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <DirectXCollision.h>
+#include "Entity.h"
+#include "Behaviour.h"
+#include "Collision/Raycast.h"
+#include "CullView.h"
+#include "NearestQuery.h"
+#include "FrustumPlanes.h"
+#include "Behaviours/MeshBehaviour.h"
+
+#ifdef LEAK_DETECTION
+#define new			DEBUG_NEW
+#endif
+
+// Dynamic bounding volume hierarchy. Every entity owns one leaf, whose bounds are fattened
+// by a margin so that small movements need no restructuring. Leaves are inserted where the
+// surface area heuristic finds them cheapest, and the tree is kept balanced with rotations.
+// Leaves that outgrow their fattened bounds are refit in bulk by RecalculateCullingBounds,
+// while entities that teleport far away are reinserted.
+class AABBTree
+{
+private:
+	static constexpr int NULL_NODE = -1;
+	static constexpr UINT MAX_STACK_SIZE = 128;
+	static constexpr float FAT_MARGIN = 0.5f;
+
+	struct Node
+	{
+		dx::BoundingBox bounds = {};
+		Entity *item = nullptr;
+
+		int parent = NULL_NODE;
+		int child1 = NULL_NODE;
+		int child2 = NULL_NODE;
+		int height = 0; // Leaves have height 0, free nodes -1.
+
+		bool isDirty = false;
+
+		[[nodiscard]] inline bool IsLeaf() const { return child1 == NULL_NODE; }
+	};
+
+	dx::BoundingBox _bounds = {};
+	bool _isInitialized = false;
+
+	std::vector<Node> _nodes;
+	int _root = NULL_NODE;
+	int _freeList = NULL_NODE;
+	UINT _leafCount = 0;
+
+	std::unordered_map<const Entity *, int> _leafLookup;
+	std::vector<int> _refitQueue;
+
+	[[nodiscard]] int AllocateNode();
+	void FreeNode(int node);
+
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	[[nodiscard]] int Balance(int node);
+	void RefitNode(int node);
+	void RefitDirty(int node);
+
+	void AddSubtree(int node, std::vector<Entity *> &containingItems) const;
+
+	template <class VolumeType>
+	void CullInternal(const VolumeType &volume, std::vector<Entity *> &containingItems) const;
+
+public:
+	AABBTree() = default;
+	~AABBTree() = default;
+	AABBTree(const AABBTree &other) = default;
+	AABBTree &operator=(const AABBTree &other) = default;
+	AABBTree(AABBTree &&other) = default;
+	AABBTree &operator=(AABBTree &&other) = default;
+
+	[[nodiscard]] bool Initialize(const dx::BoundingBox &sceneBounds);
+
+	void Insert(Entity *data, const dx::BoundingOrientedBox &bounds);
+	[[nodiscard]] bool Remove(Entity *data, bool skipIntersectionTests = false);
+	[[nodiscard]] bool Move(Entity *data, const dx::BoundingOrientedBox &bounds);
+
+	// Refits all nodes above leaves that have outgrown their fattened bounds.
+	void RecalculateCullingBounds();
+
+	[[nodiscard]] dx::BoundingBox *GetBounds();
+
+	[[nodiscard]] bool FrustumCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems) const;
+	// Plane masking and plane caching only apply to Quadtree, other options fall back to a regular cull.
+	[[nodiscard]] bool FrustumCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems, const FrustumCullOptions &options) const;
+	[[nodiscard]] bool BoxCull(const dx::BoundingOrientedBox &box, std::vector<Entity *> &containingItems) const;
+	[[nodiscard]] bool BoxCull(const dx::BoundingBox &box, std::vector<Entity *> &containingItems) const;
+	[[nodiscard]] bool SphereCull(const dx::BoundingSphere &sphere, std::vector<Entity *> &containingItems) const;
+
+	// Best-first search, visiting nodes in order of distance until none can be closer than the k-th candidate.
+	[[nodiscard]] bool FindNearest(NearestQuery &query) const;
+
+	// Culls up to CullView::MAX_BATCH_SIZE views in a single traversal, writing one result list per view.
+	[[nodiscard]] bool MultiCull(const CullView *views, UINT viewCount, std::vector<Entity *> *containingItems) const;
+
+	bool RaycastTree(const dx::XMFLOAT3A &orig, const dx::XMFLOAT3A &dir, float &length, Entity *&entity, bool cheap = false) const;
+	bool RaycastTree(const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent) const;
+
+	void DebugGetStructure(std::vector<dx::BoundingBox> &boxCollection, bool full, bool culling) const;
+	void DebugGetStructure(std::vector<dx::BoundingBox> &boxCollection, const dx::BoundingFrustum &frustum, bool full, bool culling) const;
+
+#ifdef USE_IMGUI
+	bool drawBounds = false;
+	bool drawLeavesOnly = true;
+	dx::XMFLOAT4 boundsColor = { 0.0f, 1.0f, 0.0f, 0.05f };
+
+	bool RenderUI();
+#endif
+
+	TESTABLE()
+};
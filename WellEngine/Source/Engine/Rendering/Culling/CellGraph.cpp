@@ -0,0 +1,450 @@
+#include "stdafx.h"
+#include "CellGraph.h"
+#include "Debug/DebugDrawer.h"
+
+using namespace DirectX;
+
+#pragma region Helpers
+// Enough for a portal rectangle clipped by every plane of a view.
+static constexpr UINT MAX_POLYGON_SIZE = 4 + CellGraph::MAX_VIEW_PLANES;
+
+[[nodiscard]] static inline float PlaneDistance(const XMFLOAT4 &plane, const XMFLOAT3 &point)
+{
+	return plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w;
+}
+
+// Sutherland-Hodgman clip of a convex polygon, keeping the part behind the plane.
+[[nodiscard]] static UINT ClipPolygon(const XMFLOAT3 *in, UINT count, const XMFLOAT4 &plane, XMFLOAT3 *out)
+{
+	UINT outCount = 0;
+
+	for (UINT i = 0; i < count; i++)
+	{
+		const XMFLOAT3 &a = in[i];
+		const XMFLOAT3 &b = in[(i + 1) % count];
+
+		const float da = PlaneDistance(plane, a);
+		const float db = PlaneDistance(plane, b);
+
+		if (da <= 0.0f && outCount < MAX_POLYGON_SIZE)
+			out[outCount++] = a;
+
+		if ((da <= 0.0f) != (db <= 0.0f) && outCount < MAX_POLYGON_SIZE)
+		{
+			const float t = da / (da - db);
+			out[outCount++] = { a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t };
+		}
+	}
+
+	return outCount;
+}
+#pragma endregion
+
+void CellGraph::Portal::GetCorners(XMFLOAT3 corners[4]) const
+{
+	const XMVECTOR rot = XMQuaternionRotationRollPitchYaw(
+		XMConvertToRadians(rotation.x),
+		XMConvertToRadians(rotation.y),
+		XMConvertToRadians(rotation.z)
+	);
+
+	const XMVECTOR centerVec = XMLoadFloat3(&center);
+	const XMVECTOR right = XMVector3Rotate(XMVectorSet(extents.x, 0, 0, 0), rot);
+	const XMVECTOR up = XMVector3Rotate(XMVectorSet(0, extents.y, 0, 0), rot);
+
+	XMStoreFloat3(&corners[0], XMVectorSubtract(XMVectorSubtract(centerVec, right), up));
+	XMStoreFloat3(&corners[1], XMVectorSubtract(XMVectorAdd(centerVec, right), up));
+	XMStoreFloat3(&corners[2], XMVectorAdd(XMVectorAdd(centerVec, right), up));
+	XMStoreFloat3(&corners[3], XMVectorAdd(XMVectorSubtract(centerVec, right), up));
+}
+
+bool CellGraph::CellView::Intersects(const BoundingOrientedBox &box) const
+{
+	const XMVECTOR rot = XMLoadFloat4(&box.Orientation);
+	const XMVECTOR axisX = XMVector3Rotate(g_XMIdentityR0, rot);
+	const XMVECTOR axisY = XMVector3Rotate(g_XMIdentityR1, rot);
+	const XMVECTOR axisZ = XMVector3Rotate(g_XMIdentityR2, rot);
+
+	for (UINT i = 0; i < planeCount; i++)
+	{
+		const XMVECTOR normal = XMLoadFloat4(&planes[i]);
+
+		const float radius =
+			std::abs(XMVectorGetX(XMVector3Dot(normal, axisX))) * box.Extents.x +
+			std::abs(XMVectorGetX(XMVector3Dot(normal, axisY))) * box.Extents.y +
+			std::abs(XMVectorGetX(XMVector3Dot(normal, axisZ))) * box.Extents.z;
+
+		if (PlaneDistance(planes[i], box.Center) > radius)
+			return false;
+	}
+
+	return true;
+}
+bool CellGraph::CellView::Intersects(const BoundingBox &box) const
+{
+	for (UINT i = 0; i < planeCount; i++)
+	{
+		const XMFLOAT4 &plane = planes[i];
+
+		const float radius =
+			std::abs(plane.x) * box.Extents.x +
+			std::abs(plane.y) * box.Extents.y +
+			std::abs(plane.z) * box.Extents.z;
+
+		if (PlaneDistance(plane, box.Center) > radius)
+			return false;
+	}
+
+	return true;
+}
+
+void CellGraph::RebuildLinks()
+{
+	for (Cell &cell : _cells)
+		cell.portals.clear();
+
+	for (UINT i = 0; i < _portals.size(); i++)
+	{
+		const Portal &portal = _portals[i];
+
+		for (UINT side = 0; side < 2; side++)
+		{
+			if (portal.cells[side] < _cells.size())
+				_cells[portal.cells[side]].portals.emplace_back(i);
+		}
+	}
+}
+
+void CellGraph::Clear()
+{
+	_cells.clear();
+	_portals.clear();
+}
+
+UINT CellGraph::AddCell(const std::string &name, const BoundingBox &bounds)
+{
+	_cells.push_back({ name, bounds, {} });
+	return static_cast<UINT>(_cells.size() - 1);
+}
+bool CellGraph::RemoveCell(UINT cell)
+{
+	if (cell >= _cells.size())
+		return false;
+
+	_cells.erase(_cells.begin() + cell);
+
+	// Portals leading into the removed cell are removed with it.
+	std::erase_if(_portals, [cell](const Portal &portal) {
+		return portal.cells[0] == cell || portal.cells[1] == cell;
+	});
+
+	for (Portal &portal : _portals)
+	{
+		for (UINT &portalCell : portal.cells)
+		{
+			if (portalCell != NO_CELL && portalCell > cell)
+				portalCell--;
+		}
+	}
+
+	RebuildLinks();
+	return true;
+}
+
+UINT CellGraph::AddPortal(const Portal &portal)
+{
+	_portals.emplace_back(portal);
+	RebuildLinks();
+	return static_cast<UINT>(_portals.size() - 1);
+}
+bool CellGraph::RemovePortal(UINT portal)
+{
+	if (portal >= _portals.size())
+		return false;
+
+	_portals.erase(_portals.begin() + portal);
+	RebuildLinks();
+	return true;
+}
+
+UINT CellGraph::GetCellCount() const
+{
+	return static_cast<UINT>(_cells.size());
+}
+const CellGraph::Cell &CellGraph::GetCell(UINT cell) const
+{
+	return _cells[cell];
+}
+UINT CellGraph::GetPortalCount() const
+{
+	return static_cast<UINT>(_portals.size());
+}
+const CellGraph::Portal &CellGraph::GetPortal(UINT portal) const
+{
+	return _portals[portal];
+}
+
+bool CellGraph::IsEnabled() const
+{
+	return _isEnabled;
+}
+void CellGraph::SetEnabled(bool state)
+{
+	_isEnabled = state;
+}
+
+UINT CellGraph::FindCell(const XMFLOAT3 &point) const
+{
+	UINT bestCell = NO_CELL;
+	float bestVolume = FLT_MAX;
+
+	for (UINT i = 0; i < _cells.size(); i++)
+	{
+		const BoundingBox &bounds = _cells[i].bounds;
+		if (bounds.Contains(XMLoadFloat3(&point)) == DISJOINT)
+			continue;
+
+		// Prefer the innermost of nested cells.
+		const float volume = bounds.Extents.x * bounds.Extents.y * bounds.Extents.z;
+		if (volume < bestVolume)
+		{
+			bestVolume = volume;
+			bestCell = i;
+		}
+	}
+
+	return bestCell;
+}
+
+void CellGraph::Walk(const CellView &view, const XMFLOAT3 &eye, const XMFLOAT4 &farPlane,
+	std::vector<UINT> &path, std::vector<CellView> &visibleCells) const
+{
+	if (visibleCells.size() >= MAX_VISIBLE_CELLS)
+		return;
+
+	visibleCells.emplace_back(view);
+
+	if (path.size() >= MAX_PORTAL_DEPTH)
+		return;
+
+	path.emplace_back(view.cell);
+
+	const XMVECTOR eyeVec = XMLoadFloat3(&eye);
+
+	for (UINT portalIndex : _cells[view.cell].portals)
+	{
+		const Portal &portal = _portals[portalIndex];
+		const UINT nextCell = (portal.cells[0] == view.cell) ? portal.cells[1] : portal.cells[0];
+
+		if (nextCell >= _cells.size())
+			continue;
+
+		// Cells already on the current path are never re-entered, which also prevents cycles.
+		if (std::find(path.begin(), path.end(), nextCell) != path.end())
+			continue;
+
+		// Clip the portal to the part still visible through the current view.
+		XMFLOAT3 polygon[2][MAX_POLYGON_SIZE];
+		portal.GetCorners(polygon[0]);
+		UINT polygonSize = 4, current = 0;
+
+		for (UINT i = 0; i < view.planeCount && polygonSize >= 3; i++)
+		{
+			polygonSize = ClipPolygon(polygon[current], polygonSize, view.planes[i], polygon[1 - current]);
+			current = 1 - current;
+		}
+
+		if (polygonSize < 3)
+			continue;
+
+		const XMFLOAT3 *clipped = polygon[current];
+
+		XMVECTOR centroid = XMVectorZero();
+		for (UINT i = 0; i < polygonSize; i++)
+			centroid = XMVectorAdd(centroid, XMLoadFloat3(&clipped[i]));
+		centroid = XMVectorScale(centroid, 1.0f / static_cast<float>(polygonSize));
+
+		// The narrowed view is bounded by one plane through the eye and each edge of the clipped portal.
+		CellView nextView;
+		nextView.cell = nextCell;
+
+		for (UINT i = 0; i < polygonSize && nextView.planeCount < MAX_VIEW_PLANES - 1; i++)
+		{
+			const XMVECTOR a = XMVectorSubtract(XMLoadFloat3(&clipped[i]), eyeVec);
+			const XMVECTOR b = XMVectorSubtract(XMLoadFloat3(&clipped[(i + 1) % polygonSize]), eyeVec);
+
+			XMVECTOR normal = XMVector3Cross(a, b);
+			if (XMVectorGetX(XMVector3LengthSq(normal)) < 1e-10f)
+				continue; // Edge is degenerate or aligned with the eye.
+
+			normal = XMVector3Normalize(normal);
+			float d = -XMVectorGetX(XMVector3Dot(normal, eyeVec));
+
+			if (XMVectorGetX(XMVector3Dot(normal, centroid)) + d > 0.0f)
+			{
+				normal = XMVectorNegate(normal);
+				d = -d;
+			}
+
+			XMFLOAT4 &plane = nextView.planes[nextView.planeCount++];
+			XMStoreFloat4(&plane, XMVectorSetW(normal, d));
+		}
+
+		nextView.planes[nextView.planeCount++] = farPlane;
+
+		Walk(nextView, eye, farPlane, path, visibleCells);
+	}
+
+	path.pop_back();
+}
+
+bool CellGraph::GetVisibleCells(const BoundingFrustum &frustum, std::vector<CellView> &visibleCells) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	const UINT startCell = FindCell(frustum.Origin);
+	if (startCell == NO_CELL)
+		return false;
+
+	XMVECTOR planes[6];
+	frustum.GetPlanes(&planes[0], &planes[1], &planes[2], &planes[3], &planes[4], &planes[5]);
+
+	CellView startView;
+	startView.cell = startCell;
+	startView.planeCount = 6;
+	for (UINT i = 0; i < 6; i++)
+		XMStoreFloat4(&startView.planes[i], planes[i]);
+
+	// GetPlanes returns the far plane second.
+	const XMFLOAT4 farPlane = startView.planes[1];
+
+	std::vector<UINT> path;
+	path.reserve(MAX_PORTAL_DEPTH);
+
+	Walk(startView, frustum.Origin, farPlane, path, visibleCells);
+	return true;
+}
+
+#ifdef USE_IMGUI
+bool CellGraph::RenderUI(const XMFLOAT3 &spawnPoint)
+{
+	bool linksChanged = false;
+
+	ImGui::Checkbox("Enabled##CellGraph", &_isEnabled);
+	ImGui::Text("Cells: %u, Portals: %u", GetCellCount(), GetPortalCount());
+
+	ImGui::Checkbox("Draw Cells", &drawCells);
+	ImGui::SameLine();
+	ImGui::ColorEdit4("##CellColor", &cellColor.x, ImGuiColorEditFlags_NoInputs);
+
+	ImGui::Checkbox("Draw Portals", &drawPortals);
+	ImGui::SameLine();
+	ImGui::ColorEdit4("##PortalColor", &portalColor.x, ImGuiColorEditFlags_NoInputs);
+
+	ImGui::Separator();
+
+	if (ImGui::Button("Add Cell"))
+		AddCell(std::format("Cell {}", _cells.size()), BoundingBox(spawnPoint, { 5.0f, 5.0f, 5.0f }));
+
+	UINT cellToRemove = NO_CELL;
+	for (UINT i = 0; i < _cells.size(); i++)
+	{
+		Cell &cell = _cells[i];
+		ImGui::PushID(std::format("Cell{}", i).c_str());
+
+		if (ImGui::TreeNode(std::format("#{}: {}###CellNode", i, cell.name).c_str()))
+		{
+			ImGui::InputText("Name", &cell.name);
+			ImGui::DragFloat3("Center", &cell.bounds.Center.x, 0.1f);
+
+			if (ImGui::DragFloat3("Extents", &cell.bounds.Extents.x, 0.1f))
+			{
+				cell.bounds.Extents.x = std::max<float>(cell.bounds.Extents.x, 0.01f);
+				cell.bounds.Extents.y = std::max<float>(cell.bounds.Extents.y, 0.01f);
+				cell.bounds.Extents.z = std::max<float>(cell.bounds.Extents.z, 0.01f);
+			}
+
+			ImGui::Text("Portals: %zu", cell.portals.size());
+
+			if (ImGui::Button("Remove Cell"))
+				cellToRemove = i;
+
+			ImGui::TreePop();
+		}
+
+		ImGui::PopID();
+	}
+
+	if (cellToRemove != NO_CELL)
+		(void)RemoveCell(cellToRemove);
+
+	ImGui::Separator();
+
+	if (ImGui::Button("Add Portal"))
+	{
+		Portal portal;
+		portal.center = spawnPoint;
+		_portals.emplace_back(portal);
+		linksChanged = true;
+	}
+
+	UINT portalToRemove = NO_CELL;
+	for (UINT i = 0; i < _portals.size(); i++)
+	{
+		Portal &portal = _portals[i];
+		ImGui::PushID(std::format("Portal{}", i).c_str());
+
+		if (ImGui::TreeNode(std::format("Portal #{}###PortalNode", i).c_str()))
+		{
+			ImGui::DragFloat3("Center", &portal.center.x, 0.1f);
+			ImGui::DragFloat2("Extents", &portal.extents.x, 0.05f, 0.01f, 1000.0f);
+			ImGui::DragFloat3("Rotation", &portal.rotation.x, 1.0f);
+
+			for (UINT side = 0; side < 2; side++)
+			{
+				int cell = (portal.cells[side] == NO_CELL) ? -1 : static_cast<int>(portal.cells[side]);
+				if (ImGui::InputInt(side == 0 ? "Cell A" : "Cell B", &cell))
+				{
+					cell = std::clamp<int>(cell, -1, static_cast<int>(_cells.size()) - 1);
+					portal.cells[side] = (cell < 0) ? NO_CELL : static_cast<UINT>(cell);
+					linksChanged = true;
+				}
+			}
+
+			if (ImGui::Button("Remove Portal"))
+				portalToRemove = i;
+
+			ImGui::TreePop();
+		}
+
+		ImGui::PopID();
+	}
+
+	if (portalToRemove != NO_CELL)
+		(void)RemovePortal(portalToRemove);
+	else if (linksChanged)
+		RebuildLinks();
+
+	DebugDrawer &debugDrawer = DebugDrawer::Instance();
+
+	if (drawCells)
+	{
+		for (const Cell &cell : _cells)
+			debugDrawer.DrawBoxAABB(cell.bounds, cellColor, true, true);
+	}
+
+	if (drawPortals)
+	{
+		for (const Portal &portal : _portals)
+		{
+			XMFLOAT3 corners[4];
+			portal.GetCorners(corners);
+
+			debugDrawer.DrawTri(corners[0], corners[1], corners[2], portalColor, true, true);
+			debugDrawer.DrawTri(corners[0], corners[2], corners[3], portalColor, true, true);
+		}
+	}
+
+	return true;
+}
+#endif
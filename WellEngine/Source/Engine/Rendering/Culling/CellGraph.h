@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <DirectXCollision.h>
+
+namespace dx = DirectX;
+
+// Cells and portals for room culling. Cells are axis-aligned volumes, typically one per cave
+// chamber or tunnel section, and portals are rectangles connecting two cells. Starting in the
+// cell containing the camera, the visible set is found by walking through every portal in view,
+// narrowing the view volume to the part of the portal that is still visible at each step.
+class CellGraph
+{
+public:
+	static constexpr UINT NO_CELL = UINT_MAX;
+	static constexpr UINT MAX_PORTAL_DEPTH = 16;
+	static constexpr UINT MAX_VIEW_PLANES = 16;
+	static constexpr UINT MAX_VISIBLE_CELLS = 256;
+
+	struct Cell
+	{
+		std::string name;
+		dx::BoundingBox bounds = { { 0, 0, 0 }, { 1, 1, 1 } };
+		std::vector<UINT> portals; // Rebuilt from the portal list, not serialized.
+	};
+
+	struct Portal
+	{
+		dx::XMFLOAT3 center = { 0, 0, 0 };
+		dx::XMFLOAT2 extents = { 1, 1 }; // Half width and height of the portal rectangle.
+		dx::XMFLOAT3 rotation = { 0, 0, 0 }; // Pitch, yaw and roll in degrees.
+		UINT cells[2] = { NO_CELL, NO_CELL };
+
+		void GetCorners(dx::XMFLOAT3 corners[4]) const;
+	};
+
+	// Convex volume through which one cell is seen. Planes face outward.
+	struct CellView
+	{
+		UINT cell = NO_CELL;
+		UINT planeCount = 0;
+		dx::XMFLOAT4 planes[MAX_VIEW_PLANES] = {};
+
+		[[nodiscard]] bool Intersects(const dx::BoundingOrientedBox &box) const;
+		[[nodiscard]] bool Intersects(const dx::BoundingBox &box) const;
+	};
+
+private:
+	std::vector<Cell> _cells;
+	std::vector<Portal> _portals;
+	bool _isEnabled = true;
+
+	void RebuildLinks();
+	void Walk(const CellView &view, const dx::XMFLOAT3 &eye, const dx::XMFLOAT4 &farPlane,
+		std::vector<UINT> &path, std::vector<CellView> &visibleCells) const;
+
+public:
+	CellGraph() = default;
+	~CellGraph() = default;
+	CellGraph(const CellGraph &other) = default;
+	CellGraph &operator=(const CellGraph &other) = default;
+	CellGraph(CellGraph &&other) = default;
+	CellGraph &operator=(CellGraph &&other) = default;
+
+	void Clear();
+
+	UINT AddCell(const std::string &name, const dx::BoundingBox &bounds);
+	[[nodiscard]] bool RemoveCell(UINT cell);
+
+	UINT AddPortal(const Portal &portal);
+	[[nodiscard]] bool RemovePortal(UINT portal);
+
+	[[nodiscard]] UINT GetCellCount() const;
+	[[nodiscard]] const Cell &GetCell(UINT cell) const;
+	[[nodiscard]] UINT GetPortalCount() const;
+	[[nodiscard]] const Portal &GetPortal(UINT portal) const;
+
+	[[nodiscard]] bool IsEnabled() const;
+	void SetEnabled(bool state);
+
+	// Smallest cell containing the point, or NO_CELL.
+	[[nodiscard]] UINT FindCell(const dx::XMFLOAT3 &point) const;
+
+	// Walks the portals visible from the frustum origin, writing one view per reachable cell path.
+	// Returns false if the origin is outside every cell, in which case no cells can be culled.
+	[[nodiscard]] bool GetVisibleCells(const dx::BoundingFrustum &frustum, std::vector<CellView> &visibleCells) const;
+
+#ifdef USE_IMGUI
+	bool drawCells = false;
+	bool drawPortals = false;
+	dx::XMFLOAT4 cellColor = { 0.0f, 0.6f, 1.0f, 0.05f };
+	dx::XMFLOAT4 portalColor = { 1.0f, 0.6f, 0.0f, 0.3f };
+
+	// New cells and portals are placed at spawnPoint.
+	bool RenderUI(const dx::XMFLOAT3 &spawnPoint);
+#endif
+
+	TESTABLE()
+};
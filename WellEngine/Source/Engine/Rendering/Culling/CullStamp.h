@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "Entity.h"
+
+// Per-query visit stamps, used to de-duplicate entities that are stored in several nodes of a tree.
+// Every query starts a new epoch, after which an entity is accepted only the first time it is visited.
+// Batched queries track up to 64 views at once, each with its own visited bit.
+// Stamps are indexed by entity ID and kept per thread, so queries running in parallel never interfere.
+class CullStamp
+{
+private:
+	struct Stamp
+	{
+		UINT epoch = 0;
+		UINT64 visitedViews = 0;
+	};
+
+	inline static thread_local std::vector<Stamp> _stamps;
+	inline static thread_local UINT _epoch = 0;
+
+public:
+	static void BeginQuery()
+	{
+		if (++_epoch == 0)
+		{
+			// Epoch wrapped around, old stamps could collide with new ones.
+			std::ranges::fill(_stamps, Stamp{});
+			_epoch = 1;
+		}
+	}
+
+	// Returns true the first time the entity is visited by the given view during the current query.
+	[[nodiscard]] static bool Visit(const Entity *entity, UINT view = 0)
+	{
+		const UINT id = entity->GetID();
+
+		if (id >= _stamps.size())
+			_stamps.resize(std::max<size_t>(static_cast<size_t>(id) + 1, _stamps.size() * 2));
+
+		Stamp &stamp = _stamps[id];
+		if (stamp.epoch != _epoch)
+		{
+			stamp.epoch = _epoch;
+			stamp.visitedViews = 0;
+		}
+
+		const UINT64 viewBit = 1ull << view;
+		if (stamp.visitedViews & viewBit)
+			return false;
+
+		stamp.visitedViews |= viewBit;
+		return true;
+	}
+
+	TESTABLE()
+};
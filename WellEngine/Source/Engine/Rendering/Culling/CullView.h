@@ -0,0 +1,64 @@
+#pragma once
+
+#include <bit>
+#include <DirectXCollision.h>
+
+namespace dx = DirectX;
+
+// A single view volume in a batched cull query.
+struct CullView
+{
+	// Views in one tree traversal are tracked with a 64-bit mask.
+	static constexpr UINT MAX_BATCH_SIZE = 64;
+
+	enum class Type : UINT8
+	{
+		Frustum,
+		OrientedBox,
+		Box
+	};
+
+	Type type = Type::Box;
+	union
+	{
+		dx::BoundingFrustum frustum;
+		dx::BoundingOrientedBox orientedBox;
+		dx::BoundingBox box = {};
+	};
+
+	CullView() = default;
+	explicit CullView(const dx::BoundingFrustum &viewFrustum) : type(Type::Frustum), frustum(viewFrustum) {}
+	explicit CullView(const dx::BoundingOrientedBox &viewBox) : type(Type::OrientedBox), orientedBox(viewBox) {}
+	explicit CullView(const dx::BoundingBox &viewBox) : type(Type::Box), box(viewBox) {}
+
+	[[nodiscard]] inline dx::ContainmentType Contains(const dx::BoundingBox &bounds) const
+	{
+		switch (type)
+		{
+		case Type::Frustum:		return frustum.Contains(bounds);
+		case Type::OrientedBox:	return orientedBox.Contains(bounds);
+		default:				return box.Contains(bounds);
+		}
+	}
+
+	[[nodiscard]] inline bool Intersects(const dx::BoundingOrientedBox &bounds) const
+	{
+		switch (type)
+		{
+		case Type::Frustum:		return frustum.Intersects(bounds);
+		case Type::OrientedBox:	return orientedBox.Intersects(bounds);
+		default:				return box.Intersects(bounds);
+		}
+	}
+
+	[[nodiscard]] static constexpr UINT64 GetViewMask(UINT viewCount)
+	{
+		return (viewCount >= MAX_BATCH_SIZE) ? ~0ull : ((1ull << viewCount) - 1);
+	}
+
+	// Index of the lowest set view in the mask.
+	[[nodiscard]] static inline UINT NextView(UINT64 viewMask)
+	{
+		return static_cast<UINT>(std::countr_zero(viewMask));
+	}
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <DirectXCollision.h>
+
+namespace dx = DirectX;
+
+// Optional accelerations for frustum culls. Both leave the culling result unchanged.
+struct FrustumCullOptions
+{
+	static constexpr UINT MAX_CACHE_SLOTS = 8;
+	static constexpr UINT NO_CACHE = UINT_MAX;
+
+	// Cache slot reserved for the main view camera.
+	static constexpr UINT MAIN_CAMERA_SLOT = 0;
+
+	// Children only test the planes their parent straddled.
+	bool planeMasking = false;
+
+	// Nodes remember which plane last rejected them in this slot and test it first next time.
+	// A slot must only be used by one view, and that view should move smoothly between frames.
+	UINT cacheSlot = NO_CACHE;
+
+	[[nodiscard]] inline bool IsDefault() const { return !planeMasking && cacheSlot >= MAX_CACHE_SLOTS; }
+};
+
+// World-space planes of a frustum, tested one at a time against axis-aligned boxes.
+class FrustumPlanes
+{
+public:
+	static constexpr UINT PLANE_COUNT = 6;
+	static constexpr UINT8 ALL_PLANES = (1u << PLANE_COUNT) - 1;
+	static constexpr UINT8 NO_PLANE = 0xFF;
+
+private:
+	// Outward-facing, a point is inside a plane when its signed distance is negative.
+	dx::XMVECTOR _planes[PLANE_COUNT];
+	dx::XMVECTOR _absNormals[PLANE_COUNT];
+
+	// Returns 1 if the box is outside the plane, 0 if it straddles it and -1 if fully inside.
+	[[nodiscard]] inline int TestPlane(const UINT plane, dx::FXMVECTOR center, dx::FXMVECTOR extents) const
+	{
+		const float dist = dx::XMVectorGetX(dx::XMPlaneDotCoord(_planes[plane], center));
+		const float radius = dx::XMVectorGetX(dx::XMVector3Dot(_absNormals[plane], extents));
+
+		if (dist > radius)
+			return 1;
+
+		return (dist > -radius) ? 0 : -1;
+	}
+
+public:
+	explicit FrustumPlanes(const dx::BoundingFrustum &frustum)
+	{
+		frustum.GetPlanes(&_planes[0], &_planes[1], &_planes[2], &_planes[3], &_planes[4], &_planes[5]);
+
+		for (UINT i = 0; i < PLANE_COUNT; i++)
+			_absNormals[i] = dx::XMVectorAbs(_planes[i]);
+	}
+
+	// Tests the box against the planes in planeMask. straddledMask receives the planes the box
+	// intersects, which are the only ones its children need to test. If lastFailPlane is given,
+	// that plane is tested first and is updated to whichever plane rejects the box.
+	[[nodiscard]] inline dx::ContainmentType Test(const dx::BoundingBox &box, const UINT8 planeMask, UINT8 &straddledMask, UINT8 *lastFailPlane = nullptr) const
+	{
+		const dx::XMVECTOR center = dx::XMLoadFloat3(&box.Center);
+		const dx::XMVECTOR extents = dx::XMLoadFloat3(&box.Extents);
+
+		UINT8 remaining = planeMask;
+		straddledMask = 0;
+
+		if (lastFailPlane && *lastFailPlane < PLANE_COUNT && (remaining & (1u << *lastFailPlane)))
+		{
+			const int result = TestPlane(*lastFailPlane, center, extents);
+			if (result > 0)
+				return dx::DISJOINT;
+
+			if (result == 0)
+				straddledMask |= 1u << *lastFailPlane;
+
+			remaining &= ~(1u << *lastFailPlane);
+		}
+
+		for (UINT plane = 0; plane < PLANE_COUNT; plane++)
+		{
+			if (!(remaining & (1u << plane)))
+				continue;
+
+			const int result = TestPlane(plane, center, extents);
+			if (result > 0)
+			{
+				if (lastFailPlane)
+					*lastFailPlane = static_cast<UINT8>(plane);
+
+				return dx::DISJOINT;
+			}
+
+			if (result == 0)
+				straddledMask |= 1u << plane;
+		}
+
+		return straddledMask ? dx::INTERSECTS : dx::CONTAINS;
+	}
+};
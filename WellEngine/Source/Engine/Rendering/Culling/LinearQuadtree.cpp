@@ -0,0 +1,1485 @@
+#include "stdafx.h"
+#include "LinearQuadtree.h"
+#include "Scenes/Scene.h"
+
+using namespace DirectX;
+
+#pragma region Helpers
+[[nodiscard]] static inline UINT SpreadBits(UINT v)
+{
+	v &= 0x0000FFFF;
+	v = (v | (v << 8)) & 0x00FF00FF;
+	v = (v | (v << 4)) & 0x0F0F0F0F;
+	v = (v | (v << 2)) & 0x33333333;
+	v = (v | (v << 1)) & 0x55555555;
+	return v;
+}
+[[nodiscard]] static inline UINT CompactBits(UINT v)
+{
+	v &= 0x55555555;
+	v = (v | (v >> 1)) & 0x33333333;
+	v = (v | (v >> 2)) & 0x0F0F0F0F;
+	v = (v | (v >> 4)) & 0x00FF00FF;
+	v = (v | (v >> 8)) & 0x0000FFFF;
+	return v;
+}
+
+[[nodiscard]] static inline BoundingBox ToAABB(const BoundingOrientedBox &box)
+{
+	XMFLOAT3 corners[8];
+	box.GetCorners(corners);
+
+	BoundingBox aabb;
+	BoundingBox::CreateFromPoints(aabb, 8, corners, sizeof(XMFLOAT3));
+	return aabb;
+}
+
+// Avoids infinities in the slab test for axis-aligned rays.
+[[nodiscard]] static inline XMVECTOR SafeInverse(const XMFLOAT3 &dir)
+{
+	constexpr float minComponent = 1e-8f;
+	const XMFLOAT3 safeDir = {
+		fabsf(dir.x) < minComponent ? copysignf(minComponent, dir.x) : dir.x,
+		fabsf(dir.y) < minComponent ? copysignf(minComponent, dir.y) : dir.y,
+		fabsf(dir.z) < minComponent ? copysignf(minComponent, dir.z) : dir.z
+	};
+
+	return XMVectorReciprocal(XMVectorSet(safeDir.x, safeDir.y, safeDir.z, 1.0f));
+}
+
+static void RaycastItem(Entity *item, const XMFLOAT3 &orig, const XMFLOAT3 &dir, float &length, Entity *&entity, bool cheap)
+{
+	if (item == nullptr)
+		return;
+
+	if (!item->IsEnabled())
+		return;
+
+	if (!item->IsDebugSelectable())
+		return;
+
+	if (!item->IsRaycastTarget())
+		return;
+
+	if (!cheap)
+	{
+		MeshBehaviour *meshBehaviour = nullptr;
+		if (item->GetBehaviourByType<MeshBehaviour>(meshBehaviour))
+		{
+			const Shape::Ray ray(orig, dir);
+
+			MeshD3D11 *mesh = item->GetScene()->GetContent()->GetMesh(meshBehaviour->GetMeshID());
+			const MeshCollider &meshCollider = mesh->GetMeshCollider();
+
+			const XMFLOAT4X4A &meshMatrix = item->GetTransform()->GetMatrix(World);
+			XMFLOAT4X4A meshMatrixInv; Store(meshMatrixInv, XMMatrixInverse(nullptr, Load(meshMatrix)));
+
+			const Shape::Ray localRay = ray.Transformed(meshMatrixInv);
+			Shape::RayHit localHit;
+
+			if (meshCollider.RaycastMesh(localRay, localHit))
+			{
+				localHit.Transform(meshMatrix);
+
+				if (localHit.length < length)
+				{
+					length = localHit.length;
+					entity = item;
+				}
+			}
+
+			return;
+		}
+	}
+
+	BoundingOrientedBox itemBounds;
+	if (!item->HasBounds(false, itemBounds))
+		return;
+
+	float newLength = 0.0f;
+	if (!Raycast(orig, dir, itemBounds, newLength))
+		return;
+
+	if (newLength >= length)
+		return;
+
+	length = newLength;
+	entity = item;
+}
+static void RaycastItem(Entity *item, const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent)
+{
+	if (item == nullptr)
+		return;
+
+	if (!item->IsEnabled())
+		return;
+
+	if (!item->IsDebugSelectable())
+		return;
+
+	if (!item->IsRaycastTarget())
+		return;
+
+	MeshBehaviour *meshBehaviour = nullptr;
+	if (!item->GetBehaviourByType<MeshBehaviour>(meshBehaviour))
+		return;
+
+	MeshD3D11 *mesh = item->GetScene()->GetContent()->GetMesh(meshBehaviour->GetMeshID());
+	const MeshCollider &meshCollider = mesh->GetMeshCollider();
+
+	const XMFLOAT4X4A &meshMatrix = item->GetTransform()->GetMatrix(World);
+	XMFLOAT4X4A meshMatrixInv; Store(meshMatrixInv, XMMatrixInverse(nullptr, Load(meshMatrix)));
+
+	const Shape::Ray localRay = ray.Transformed(meshMatrixInv);
+	Shape::RayHit localHit;
+
+	if (!meshCollider.RaycastMesh(localRay, localHit))
+		return;
+
+	localHit.Transform(meshMatrix);
+
+	if (localHit.length >= hit.length)
+		return;
+
+	hit = localHit;
+	ent = item;
+}
+#pragma endregion
+
+
+#pragma region Cull Planes
+void LinearQuadtree::CullPlanes::AddPlane(FXMVECTOR plane)
+{
+	if (count >= MAX_CULL_PLANES)
+		return;
+
+	nx[count] = XMVectorSplatX(plane);
+	ny[count] = XMVectorSplatY(plane);
+	nz[count] = XMVectorSplatZ(plane);
+	d[count] = XMVectorSplatW(plane);
+
+	ax[count] = XMVectorAbs(nx[count]);
+	ay[count] = XMVectorAbs(ny[count]);
+	az[count] = XMVectorAbs(nz[count]);
+
+	count++;
+}
+void LinearQuadtree::CullPlanes::FromFrustum(const BoundingFrustum &frustum)
+{
+	// DirectX frustum planes point outward, a point is inside when its signed distance is <= 0.
+	XMVECTOR planes[6];
+	frustum.GetPlanes(&planes[0], &planes[1], &planes[2], &planes[3], &planes[4], &planes[5]);
+
+	count = 0;
+	for (UINT i = 0; i < 6; i++)
+		AddPlane(planes[i]);
+}
+void LinearQuadtree::CullPlanes::FromBox(const BoundingOrientedBox &box)
+{
+	const XMVECTOR
+		orientation = Load(box.Orientation),
+		center = Load(box.Center);
+
+	const XMVECTOR axes[3] = {
+		XMVector3Rotate(XMVectorSet(1, 0, 0, 0), orientation),
+		XMVector3Rotate(XMVectorSet(0, 1, 0, 0), orientation),
+		XMVector3Rotate(XMVectorSet(0, 0, 1, 0), orientation)
+	};
+	const float extents[3] = { box.Extents.x, box.Extents.y, box.Extents.z };
+
+	count = 0;
+	for (UINT i = 0; i < 3; i++)
+	{
+		const float centerDist = XMVectorGetX(XMVector3Dot(axes[i], center));
+
+		AddPlane(XMVectorSetW(axes[i], -(centerDist + extents[i])));
+		AddPlane(XMVectorSetW(XMVectorNegate(axes[i]), centerDist - extents[i]));
+	}
+}
+void LinearQuadtree::CullPlanes::FromBox(const BoundingBox &box)
+{
+	const XMFLOAT3 &c = box.Center;
+	const XMFLOAT3 &e = box.Extents;
+
+	count = 0;
+	AddPlane(XMVectorSet( 1,  0,  0, -(c.x + e.x)));
+	AddPlane(XMVectorSet(-1,  0,  0,   c.x - e.x ));
+	AddPlane(XMVectorSet( 0,  1,  0, -(c.y + e.y)));
+	AddPlane(XMVectorSet( 0, -1,  0,   c.y - e.y ));
+	AddPlane(XMVectorSet( 0,  0,  1, -(c.z + e.z)));
+	AddPlane(XMVectorSet( 0,  0, -1,   c.z - e.z ));
+}
+void LinearQuadtree::CullPlanes::FromView(const CullView &view)
+{
+	switch (view.type)
+	{
+	case CullView::Type::Frustum:
+		FromFrustum(view.frustum);
+		break;
+
+	case CullView::Type::OrientedBox:
+		FromBox(view.orientedBox);
+		break;
+
+	case CullView::Type::Box:
+		FromBox(view.box);
+		break;
+	}
+}
+#pragma endregion
+
+
+#pragma region Kernels
+void LinearQuadtree::TestChildren(const ChildBlock &block, const CullPlanes &planes, UINT &intersectMask, UINT &containMask)
+{
+	const XMVECTOR
+		cx = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.centerX)),
+		cy = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.centerY)),
+		cz = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.centerZ)),
+		ex = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.extentsX)),
+		ey = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.extentsY)),
+		ez = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.extentsZ));
+
+	XMVECTOR outside = XMVectorFalseInt();
+	XMVECTOR inside = XMVectorTrueInt();
+
+	for (UINT p = 0; p < planes.count; p++)
+	{
+		// Signed distance from each child center to the plane.
+		XMVECTOR dist = XMVectorMultiplyAdd(planes.nx[p], cx, planes.d[p]);
+		dist = XMVectorMultiplyAdd(planes.ny[p], cy, dist);
+		dist = XMVectorMultiplyAdd(planes.nz[p], cz, dist);
+
+		// Projected radius of each child box onto the plane normal.
+		XMVECTOR radius = XMVectorMultiply(planes.ax[p], ex);
+		radius = XMVectorMultiplyAdd(planes.ay[p], ey, radius);
+		radius = XMVectorMultiplyAdd(planes.az[p], ez, radius);
+
+		outside = XMVectorOrInt(outside, XMVectorGreater(dist, radius));
+		inside = XMVectorAndInt(inside, XMVectorLessOrEqual(dist, XMVectorNegate(radius)));
+	}
+
+	XMUINT4 outsideLanes, insideLanes;
+	XMStoreUInt4(&outsideLanes, outside);
+	XMStoreUInt4(&insideLanes, inside);
+
+	const UINT outsideBits[CHILD_COUNT] = { outsideLanes.x, outsideLanes.y, outsideLanes.z, outsideLanes.w };
+	const UINT insideBits[CHILD_COUNT] = { insideLanes.x, insideLanes.y, insideLanes.z, insideLanes.w };
+
+	intersectMask = 0;
+	containMask = 0;
+
+	for (UINT c = 0; c < CHILD_COUNT; c++)
+	{
+		const UINT bit = 1u << c;
+
+		if (!(block.nonEmptyMask & bit))
+			continue;
+
+		if (outsideBits[c])
+			continue;
+
+		intersectMask |= bit;
+
+		if (insideBits[c])
+			containMask |= bit;
+	}
+}
+
+UINT8 LinearQuadtree::TestChildrenMasked(const ChildBlock &block, const CullPlanes &planes, UINT8 planeMask, UINT8 firstPlane,
+	UINT &intersectMask, UINT &containMask, UINT8 straddledMasks[CHILD_COUNT])
+{
+	const XMVECTOR
+		cx = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.centerX)),
+		cy = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.centerY)),
+		cz = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.centerZ)),
+		ex = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.extentsX)),
+		ey = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.extentsY)),
+		ez = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.extentsZ));
+
+	// Empty children start out rejected, so the test can stop at the first plane rejecting the others.
+	XMVECTOR outside = XMVectorSelectControl(
+		(block.nonEmptyMask & 0b0001) ? 0 : 1,
+		(block.nonEmptyMask & 0b0010) ? 0 : 1,
+		(block.nonEmptyMask & 0b0100) ? 0 : 1,
+		(block.nonEmptyMask & 0b1000) ? 0 : 1);
+	XMVECTOR inside = XMVectorTrueInt();
+
+	intersectMask = 0;
+	containMask = 0;
+
+	for (UINT c = 0; c < CHILD_COUNT; c++)
+		straddledMasks[c] = 0;
+
+	for (UINT i = 0; i < planes.count; i++)
+	{
+		// Test firstPlane before the others, which keep their order.
+		UINT p = i;
+		if (firstPlane < planes.count && i <= firstPlane)
+			p = (i == 0) ? firstPlane : i - 1;
+
+		if (!(planeMask & (1u << p)))
+			continue;
+
+		XMVECTOR dist = XMVectorMultiplyAdd(planes.nx[p], cx, planes.d[p]);
+		dist = XMVectorMultiplyAdd(planes.ny[p], cy, dist);
+		dist = XMVectorMultiplyAdd(planes.nz[p], cz, dist);
+
+		XMVECTOR radius = XMVectorMultiply(planes.ax[p], ex);
+		radius = XMVectorMultiplyAdd(planes.ay[p], ey, radius);
+		radius = XMVectorMultiplyAdd(planes.az[p], ez, radius);
+
+		const XMVECTOR planeOutside = XMVectorGreater(dist, radius);
+		const XMVECTOR planeInside = XMVectorLessOrEqual(dist, XMVectorNegate(radius));
+
+		outside = XMVectorOrInt(outside, planeOutside);
+		inside = XMVectorAndInt(inside, planeInside);
+
+		if (XMVector4EqualInt(outside, XMVectorTrueInt()))
+			return static_cast<UINT8>(p);
+
+		XMUINT4 straddleLanes;
+		XMStoreUInt4(&straddleLanes, XMVectorNorInt(planeOutside, planeInside));
+
+		const UINT straddleBits[CHILD_COUNT] = { straddleLanes.x, straddleLanes.y, straddleLanes.z, straddleLanes.w };
+		for (UINT c = 0; c < CHILD_COUNT; c++)
+		{
+			if (straddleBits[c])
+				straddledMasks[c] |= 1u << p;
+		}
+	}
+
+	XMUINT4 outsideLanes, insideLanes;
+	XMStoreUInt4(&outsideLanes, outside);
+	XMStoreUInt4(&insideLanes, inside);
+
+	const UINT outsideBits[CHILD_COUNT] = { outsideLanes.x, outsideLanes.y, outsideLanes.z, outsideLanes.w };
+	const UINT insideBits[CHILD_COUNT] = { insideLanes.x, insideLanes.y, insideLanes.z, insideLanes.w };
+
+	for (UINT c = 0; c < CHILD_COUNT; c++)
+	{
+		const UINT bit = 1u << c;
+
+		if (outsideBits[c])
+			continue;
+
+		intersectMask |= bit;
+
+		if (insideBits[c])
+			containMask |= bit;
+	}
+
+	return FrustumPlanes::NO_PLANE;
+}
+
+UINT LinearQuadtree::RaycastChildren(const ChildBlock &block, FXMVECTOR origin, FXMVECTOR invDir, float maxLength, float outLengths[CHILD_COUNT])
+{
+	const XMVECTOR
+		cx = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.centerX)),
+		cy = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.centerY)),
+		cz = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.centerZ)),
+		ex = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.extentsX)),
+		ey = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.extentsY)),
+		ez = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A *>(block.extentsZ));
+
+	const XMVECTOR
+		ox = XMVectorSplatX(origin), oy = XMVectorSplatY(origin), oz = XMVectorSplatZ(origin),
+		ix = XMVectorSplatX(invDir), iy = XMVectorSplatY(invDir), iz = XMVectorSplatZ(invDir);
+
+	// Slab test against all four children at once.
+	const XMVECTOR
+		t1x = XMVectorMultiply(XMVectorSubtract(XMVectorSubtract(cx, ex), ox), ix),
+		t2x = XMVectorMultiply(XMVectorSubtract(XMVectorAdd(cx, ex), ox), ix),
+		t1y = XMVectorMultiply(XMVectorSubtract(XMVectorSubtract(cy, ey), oy), iy),
+		t2y = XMVectorMultiply(XMVectorSubtract(XMVectorAdd(cy, ey), oy), iy),
+		t1z = XMVectorMultiply(XMVectorSubtract(XMVectorSubtract(cz, ez), oz), iz),
+		t2z = XMVectorMultiply(XMVectorSubtract(XMVectorAdd(cz, ez), oz), iz);
+
+	XMVECTOR tNear = XMVectorMax(XMVectorMax(XMVectorMin(t1x, t2x), XMVectorMin(t1y, t2y)), XMVectorMin(t1z, t2z));
+	const XMVECTOR tFar = XMVectorMin(XMVectorMin(XMVectorMax(t1x, t2x), XMVectorMax(t1y, t2y)), XMVectorMax(t1z, t2z));
+
+	tNear = XMVectorMax(tNear, XMVectorZero());
+
+	const XMVECTOR hits = XMVectorAndInt(
+		XMVectorLessOrEqual(tNear, tFar),
+		XMVectorLessOrEqual(tNear, XMVectorReplicate(maxLength))
+	);
+
+	XMFLOAT4 lengths;
+	XMStoreFloat4(&lengths, tNear);
+	outLengths[0] = lengths.x;
+	outLengths[1] = lengths.y;
+	outLengths[2] = lengths.z;
+	outLengths[3] = lengths.w;
+
+	XMUINT4 hitLanes;
+	XMStoreUInt4(&hitLanes, hits);
+	const UINT hitBits[CHILD_COUNT] = { hitLanes.x, hitLanes.y, hitLanes.z, hitLanes.w };
+
+	UINT hitMask = 0;
+	for (UINT c = 0; c < CHILD_COUNT; c++)
+	{
+		if (hitBits[c] && (block.nonEmptyMask & (1u << c)))
+			hitMask |= 1u << c;
+	}
+
+	return hitMask;
+}
+#pragma endregion
+
+
+#pragma region Structure
+bool LinearQuadtree::Initialize(const BoundingBox &sceneBounds)
+{
+	_bounds = sceneBounds;
+
+	_cullingBounds.assign(NODE_COUNT, {});
+	_ranges.assign(NODE_COUNT, {});
+	_isDirty.assign(NODE_COUNT, true);
+	_isEmpty.assign(NODE_COUNT, true);
+	_childBlocks.assign(INTERNAL_NODE_COUNT, {});
+
+	std::array<UINT8, FrustumCullOptions::MAX_CACHE_SLOTS> noFailPlanes;
+	noFailPlanes.fill(FrustumPlanes::NO_PLANE);
+	_lastFailPlanes.assign(INTERNAL_NODE_COUNT, noFailPlanes);
+
+	// Precompute the depth-first position of every node, used to sort items so that each subtree owns a contiguous range.
+	_preorder.resize(NODE_COUNT);
+	for (UINT level = 0; level < LEVEL_COUNT; level++)
+	{
+		const UINT levelOffset = LevelOffset(level);
+		const UINT levelSize = 1u << (2 * level);
+
+		for (UINT morton = 0; morton < levelSize; morton++)
+		{
+			UINT order = 0;
+			for (UINT step = 1; step <= level; step++)
+			{
+				const UINT digit = (morton >> (2 * (level - step))) & 0b11u;
+				order += 1 + digit * SubtreeNodeCount(step);
+			}
+
+			_preorder[levelOffset + morton] = order;
+		}
+	}
+
+	_items.clear();
+	_itemSlots.clear();
+	_entries.clear();
+	_freeEntries.clear();
+	_pendingEntries.clear();
+	_entryLookup.clear();
+	_tombstoneCount = 0;
+
+	_isInitialized = true;
+	return true;
+}
+
+UINT LinearQuadtree::FindNode(const BoundingOrientedBox &itemBounds) const
+{
+	const BoundingBox itemBox = ToAABB(itemBounds);
+
+	if (_bounds.Extents.x <= 0.0f || _bounds.Extents.z <= 0.0f)
+		return 0;
+
+	// Descend as long as the item is no larger than a cell. With a looseness of 2, any
+	// item whose center lies within a cell is then fully contained by the cell's loose bounds.
+	UINT level = 0;
+	while (level < MAX_DEPTH)
+	{
+		const float cellExtentsX = _bounds.Extents.x / static_cast<float>(1u << (level + 1));
+		const float cellExtentsZ = _bounds.Extents.z / static_cast<float>(1u << (level + 1));
+
+		if (itemBox.Extents.x > cellExtentsX || itemBox.Extents.z > cellExtentsZ)
+			break;
+
+		level++;
+	}
+
+	const UINT cellsPerAxis = 1u << level;
+	const float
+		cellSizeX = (_bounds.Extents.x * 2.0f) / static_cast<float>(cellsPerAxis),
+		cellSizeZ = (_bounds.Extents.z * 2.0f) / static_cast<float>(cellsPerAxis),
+		minX = _bounds.Center.x - _bounds.Extents.x,
+		minZ = _bounds.Center.z - _bounds.Extents.z;
+
+	const int
+		cellX = std::clamp(static_cast<int>(floorf((itemBox.Center.x - minX) / cellSizeX)), 0, static_cast<int>(cellsPerAxis) - 1),
+		cellZ = std::clamp(static_cast<int>(floorf((itemBox.Center.z - minZ) / cellSizeZ)), 0, static_cast<int>(cellsPerAxis) - 1);
+
+	const UINT morton = SpreadBits(static_cast<UINT>(cellX)) | (SpreadBits(static_cast<UINT>(cellZ)) << 1);
+	return LevelOffset(level) + morton;
+}
+
+BoundingBox LinearQuadtree::GetCellBounds(UINT level, UINT morton) const
+{
+	const UINT cellsPerAxis = 1u << level;
+	const float
+		cellSizeX = (_bounds.Extents.x * 2.0f) / static_cast<float>(cellsPerAxis),
+		cellSizeZ = (_bounds.Extents.z * 2.0f) / static_cast<float>(cellsPerAxis);
+
+	const UINT
+		cellX = CompactBits(morton),
+		cellZ = CompactBits(morton >> 1);
+
+	BoundingBox cell;
+	cell.Center = {
+		_bounds.Center.x - _bounds.Extents.x + (static_cast<float>(cellX) + 0.5f) * cellSizeX,
+		_bounds.Center.y,
+		_bounds.Center.z - _bounds.Extents.z + (static_cast<float>(cellZ) + 0.5f) * cellSizeZ
+	};
+	cell.Extents = { cellSizeX * 0.5f, _bounds.Extents.y, cellSizeZ * 0.5f };
+	return cell;
+}
+
+UINT LinearQuadtree::AllocateEntry()
+{
+	if (!_freeEntries.empty())
+	{
+		const UINT entryIndex = _freeEntries.back();
+		_freeEntries.pop_back();
+		return entryIndex;
+	}
+
+	_entries.emplace_back();
+	return static_cast<UINT>(_entries.size() - 1);
+}
+void LinearQuadtree::FreeEntry(UINT entryIndex)
+{
+	_entries[entryIndex] = {};
+	_freeEntries.emplace_back(entryIndex);
+}
+void LinearQuadtree::MarkDirty(UINT node)
+{
+	_isDirty[node] = true;
+}
+
+void LinearQuadtree::Insert(Entity *data, const BoundingOrientedBox &bounds)
+{
+	ZoneScopedC(RandomUniqueColor());
+	const std::string &name = data->GetName();
+	ZoneText(name.c_str(), name.size());
+
+	if (!_isInitialized)
+		return;
+
+	data->UpdateCullingBounds();
+
+	const UINT node = FindNode(bounds);
+
+	auto lookupIt = _entryLookup.find(data);
+	if (lookupIt != _entryLookup.end() && !_entries[lookupIt->second].removed)
+	{
+		// Already placed, treat as a move.
+		(void)Remove(data);
+		lookupIt = _entryLookup.find(data);
+	}
+
+	if (lookupIt != _entryLookup.end())
+	{
+		// Entity was removed since the last repack. If it ends up in the same node, revive it in place.
+		ItemEntry &entry = _entries[lookupIt->second];
+
+		if (entry.node == node)
+		{
+			_items[entry.packedIndex] = data;
+			entry.removed = false;
+			_tombstoneCount--;
+			MarkDirty(node);
+			return;
+		}
+
+		// Otherwise leave the old entry as an anonymous tombstone until the next repack.
+		entry.entity = nullptr;
+		_entryLookup.erase(lookupIt);
+	}
+
+	const UINT entryIndex = AllocateEntry();
+	ItemEntry &entry = _entries[entryIndex];
+	entry.entity = data;
+	entry.node = node;
+	entry.packedIndex = INVALID_INDEX;
+	entry.removed = false;
+
+	_entryLookup[data] = entryIndex;
+	_pendingEntries.emplace_back(entryIndex);
+}
+
+bool LinearQuadtree::Remove(Entity *data, bool skipIntersectionTests)
+{
+	ZoneScopedC(RandomUniqueColor());
+	const std::string &name = data->GetName();
+	ZoneText(name.c_str(), name.size());
+
+	(void)skipIntersectionTests; // Placement is tracked per entity, no intersection tests are needed.
+
+	if (!_isInitialized)
+		return false;
+
+	auto lookupIt = _entryLookup.find(data);
+	if (lookupIt == _entryLookup.end())
+		return true;
+
+	const UINT entryIndex = lookupIt->second;
+	ItemEntry &entry = _entries[entryIndex];
+
+	if (entry.removed)
+		return true;
+
+	if (entry.packedIndex == INVALID_INDEX)
+	{
+		// Never packed, simply forget it.
+		std::erase(_pendingEntries, entryIndex);
+		_entryLookup.erase(lookupIt);
+		FreeEntry(entryIndex);
+		return true;
+	}
+
+	_items[entry.packedIndex] = nullptr;
+	entry.removed = true;
+	_tombstoneCount++;
+	MarkDirty(entry.node);
+	return true;
+}
+
+bool LinearQuadtree::Move(Entity *data, const BoundingOrientedBox &bounds)
+{
+	if (!_isInitialized)
+		return false;
+
+	// Insert already handles entities that are placed, reviving them in place if their node is unchanged.
+	Insert(data, bounds);
+	return true;
+}
+
+void LinearQuadtree::Repack()
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	// Counting sort of all live entries by the depth-first position of their node.
+	std::vector<UINT> starts(NODE_COUNT + 1, 0);
+	const UINT entryCount = static_cast<UINT>(_entries.size());
+
+	for (UINT i = 0; i < entryCount; i++)
+	{
+		ItemEntry &entry = _entries[i];
+
+		if (entry.node == INVALID_INDEX)
+			continue; // Free entry
+
+		if (entry.removed)
+		{
+			if (entry.entity)
+			{
+				auto lookupIt = _entryLookup.find(entry.entity);
+				if (lookupIt != _entryLookup.end() && lookupIt->second == i)
+					_entryLookup.erase(lookupIt);
+			}
+
+			FreeEntry(i);
+			continue;
+		}
+
+		starts[_preorder[entry.node] + 1]++;
+	}
+
+	for (UINT p = 1; p <= NODE_COUNT; p++)
+		starts[p] += starts[p - 1];
+
+	const UINT itemCount = starts[NODE_COUNT];
+	_items.assign(itemCount, nullptr);
+	_itemSlots.assign(itemCount, INVALID_INDEX);
+
+	std::vector<UINT> cursors(starts.begin(), starts.end() - 1);
+	for (UINT i = 0; i < entryCount; i++)
+	{
+		ItemEntry &entry = _entries[i];
+
+		if (entry.node == INVALID_INDEX)
+			continue;
+
+		const UINT packedIndex = cursors[_preorder[entry.node]]++;
+		_items[packedIndex] = entry.entity;
+		_itemSlots[packedIndex] = i;
+		entry.packedIndex = packedIndex;
+	}
+
+	for (UINT level = 0; level < LEVEL_COUNT; level++)
+	{
+		const UINT levelOffset = LevelOffset(level);
+		const UINT levelSize = 1u << (2 * level);
+		const UINT subtreeSize = SubtreeNodeCount(level);
+
+		for (UINT morton = 0; morton < levelSize; morton++)
+		{
+			const UINT node = levelOffset + morton;
+			const UINT order = _preorder[node];
+
+			NodeRange &range = _ranges[node];
+			range.itemOffset = starts[order];
+			range.itemCount = starts[order + 1] - starts[order];
+			range.subtreeEnd = starts[order + subtreeSize];
+		}
+	}
+
+	_pendingEntries.clear();
+	_tombstoneCount = 0;
+	_isDirty.assign(NODE_COUNT, true);
+}
+
+void LinearQuadtree::RefitNode(UINT level, UINT morton)
+{
+	const UINT node = LevelOffset(level) + morton;
+	_isDirty[node] = false;
+
+	bool hasBounds = false;
+	BoundingBox merged;
+
+	const NodeRange &range = _ranges[node];
+	const UINT itemEnd = range.itemOffset + range.itemCount;
+	for (UINT i = range.itemOffset; i < itemEnd; i++)
+	{
+		Entity *item = _items[i];
+
+		if (item == nullptr || !item->IsEnabled())
+			continue;
+
+		BoundingOrientedBox itemBounds;
+		item->StoreEntityBounds(itemBounds);
+		const BoundingBox itemBox = ToAABB(itemBounds);
+
+		if (hasBounds)
+			BoundingBox::CreateMerged(merged, merged, itemBox);
+		else
+			merged = itemBox;
+
+		hasBounds = true;
+	}
+
+	if (level < MAX_DEPTH)
+	{
+		const ChildBlock &block = _childBlocks[node];
+
+		for (UINT c = 0; c < CHILD_COUNT; c++)
+		{
+			if (!(block.nonEmptyMask & (1u << c)))
+				continue;
+
+			const BoundingBox childBox(
+				{ block.centerX[c], block.centerY[c], block.centerZ[c] },
+				{ block.extentsX[c], block.extentsY[c], block.extentsZ[c] }
+			);
+
+			if (hasBounds)
+				BoundingBox::CreateMerged(merged, merged, childBox);
+			else
+				merged = childBox;
+
+			hasBounds = true;
+		}
+	}
+
+	_isEmpty[node] = !hasBounds;
+	if (hasBounds)
+		_cullingBounds[node] = merged;
+
+	if (level == 0)
+		return;
+
+	// Publish the result into the parent's SoA block.
+	const UINT parent = LevelOffset(level - 1) + (morton >> 2);
+	const UINT c = morton & 0b11u;
+	ChildBlock &parentBlock = _childBlocks[parent];
+
+	if (hasBounds)
+	{
+		parentBlock.centerX[c] = merged.Center.x;
+		parentBlock.centerY[c] = merged.Center.y;
+		parentBlock.centerZ[c] = merged.Center.z;
+		parentBlock.extentsX[c] = merged.Extents.x;
+		parentBlock.extentsY[c] = merged.Extents.y;
+		parentBlock.extentsZ[c] = merged.Extents.z;
+		parentBlock.nonEmptyMask |= (1u << c);
+	}
+	else
+	{
+		parentBlock.nonEmptyMask &= ~(1u << c);
+	}
+
+	_isDirty[parent] = true;
+}
+
+void LinearQuadtree::RecalculateCullingBounds()
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized)
+		return;
+
+	if (!_pendingEntries.empty() || (_tombstoneCount * 4 > _items.size()))
+		Repack();
+
+	// Refit bottom-up so every parent sees the final bounds of its children.
+	for (int level = MAX_DEPTH; level >= 0; level--)
+	{
+		const UINT levelOffset = LevelOffset(level);
+		const UINT levelSize = 1u << (2 * level);
+
+		for (UINT morton = 0; morton < levelSize; morton++)
+		{
+			if (_isDirty[levelOffset + morton])
+				RefitNode(level, morton);
+		}
+	}
+}
+
+BoundingBox *LinearQuadtree::GetBounds()
+{
+	if (!_isInitialized)
+		return nullptr;
+
+	return &_bounds;
+}
+#pragma endregion
+
+
+#pragma region Queries
+void LinearQuadtree::AddRange(UINT begin, UINT end, std::vector<Entity *> &containingItems) const
+{
+	for (UINT i = begin; i < end; i++)
+	{
+		Entity *item = _items[i];
+
+		if (item == nullptr)
+			continue;
+
+		if (!item->IsEnabled())
+			continue;
+
+		containingItems.emplace_back(item);
+	}
+}
+
+template <class VolumeType>
+void LinearQuadtree::CullInternal(const VolumeType &volume, const CullPlanes &planes, std::vector<Entity *> &containingItems, const FrustumCullOptions &options) const
+{
+	ZoneScopedXC(RandomUniqueColor());
+
+	// Pending insertions have not been placed in the packed array yet, test them individually.
+	for (const UINT entryIndex : _pendingEntries)
+	{
+		Entity *item = _entries[entryIndex].entity;
+
+		if (item == nullptr || !item->IsEnabled())
+			continue;
+
+		BoundingOrientedBox itemBounds;
+		item->StoreEntityBounds(itemBounds);
+
+		if (volume.Intersects(itemBounds))
+			containingItems.emplace_back(item);
+	}
+
+	if (_isEmpty[0])
+		return;
+
+	switch (volume.Contains(_cullingBounds[0]))
+	{
+	case DISJOINT:
+		return;
+
+	case CONTAINS:
+		AddRange(_ranges[0].itemOffset, _ranges[0].subtreeEnd, containingItems);
+		return;
+
+	default:
+		break;
+	}
+
+	struct StackEntry { UINT level, morton; UINT8 planeMask; };
+	StackEntry stack[(CHILD_COUNT - 1) * MAX_DEPTH + 1];
+	UINT stackSize = 0;
+
+	const bool useOptions = !options.IsDefault();
+	const UINT cacheSlot = options.cacheSlot;
+
+	stack[stackSize++] = { 0, 0, static_cast<UINT8>((1u << planes.count) - 1) };
+
+	while (stackSize > 0)
+	{
+		const StackEntry current = stack[--stackSize];
+		const UINT node = LevelOffset(current.level) + current.morton;
+		const NodeRange &range = _ranges[node];
+
+		// Items placed directly in an intersecting node.
+		const UINT itemEnd = range.itemOffset + range.itemCount;
+		for (UINT i = range.itemOffset; i < itemEnd; i++)
+		{
+			Entity *item = _items[i];
+
+			if (item == nullptr)
+				continue;
+
+			if (!item->IsEnabled())
+				continue;
+
+#ifdef EXTRA_CULL_CHECK
+			BoundingOrientedBox itemBounds;
+			item->StoreEntityBounds(itemBounds);
+
+			if (!volume.Intersects(itemBounds))
+				continue;
+#endif
+
+			containingItems.emplace_back(item);
+		}
+
+		if (current.level >= MAX_DEPTH)
+			continue;
+
+		const ChildBlock &block = _childBlocks[node];
+		if (block.nonEmptyMask == 0)
+			continue;
+
+		UINT intersectMask, containMask;
+		UINT8 straddledMasks[CHILD_COUNT] = { };
+
+		if (useOptions)
+		{
+			UINT8 *lastFail = (cacheSlot < FrustumCullOptions::MAX_CACHE_SLOTS) ? &_lastFailPlanes[node][cacheSlot] : nullptr;
+			const UINT8 failPlane = TestChildrenMasked(block, planes, current.planeMask, lastFail ? *lastFail : FrustumPlanes::NO_PLANE,
+				intersectMask, containMask, straddledMasks);
+
+			if (lastFail && failPlane != FrustumPlanes::NO_PLANE)
+				*lastFail = failPlane;
+		}
+		else
+		{
+			TestChildren(block, planes, intersectMask, containMask);
+		}
+
+		const UINT childLevel = current.level + 1;
+		const UINT childMortonBase = current.morton << 2;
+
+		for (UINT c = 0; c < CHILD_COUNT; c++)
+		{
+			const UINT bit = 1u << c;
+
+			if (!(intersectMask & bit))
+				continue;
+
+			if (containMask & bit)
+			{
+				// Entire subtree is inside, its items form one contiguous range.
+				const NodeRange &childRange = _ranges[LevelOffset(childLevel) + childMortonBase + c];
+				AddRange(childRange.itemOffset, childRange.subtreeEnd, containingItems);
+				continue;
+			}
+
+			const UINT8 childPlaneMask = options.planeMasking ? straddledMasks[c] : current.planeMask;
+			stack[stackSize++] = { childLevel, childMortonBase + c, childPlaneMask };
+		}
+	}
+}
+
+bool LinearQuadtree::FrustumCull(const BoundingFrustum &frustum, std::vector<Entity *> &containingItems) const
+{
+	if (!_isInitialized)
+		return false;
+
+	CullPlanes planes;
+	planes.FromFrustum(frustum);
+
+	CullInternal(frustum, planes, containingItems);
+	return true;
+}
+
+bool LinearQuadtree::FrustumCull(const BoundingFrustum &frustum, std::vector<Entity *> &containingItems, const FrustumCullOptions &options) const
+{
+	if (!_isInitialized)
+		return false;
+
+	CullPlanes planes;
+	planes.FromFrustum(frustum);
+
+	CullInternal(frustum, planes, containingItems, options);
+	return true;
+}
+
+bool LinearQuadtree::BoxCull(const BoundingOrientedBox &box, std::vector<Entity *> &containingItems) const
+{
+	if (!_isInitialized)
+		return false;
+
+	CullPlanes planes;
+	planes.FromBox(box);
+
+	CullInternal(box, planes, containingItems);
+	return true;
+}
+
+bool LinearQuadtree::BoxCull(const BoundingBox &box, std::vector<Entity *> &containingItems) const
+{
+	if (!_isInitialized)
+		return false;
+
+	CullPlanes planes;
+	planes.FromBox(box);
+
+	CullInternal(box, planes, containingItems);
+	return true;
+}
+
+bool LinearQuadtree::SphereCull(const BoundingSphere &sphere, std::vector<Entity *> &containingItems) const
+{
+	if (!_isInitialized)
+		return false;
+
+	// Children are tested against the bounding box of the sphere, the sphere itself is only used for items.
+	BoundingBox sphereBox;
+	BoundingBox::CreateFromSphere(sphereBox, sphere);
+
+	CullPlanes planes;
+	planes.FromBox(sphereBox);
+
+	CullInternal(sphere, planes, containingItems);
+	return true;
+}
+
+bool LinearQuadtree::FindNearest(NearestQuery &query) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized)
+		return false;
+
+	// Pending insertions have not been placed in the packed array yet, offer them individually.
+	for (const UINT entryIndex : _pendingEntries)
+		query.Offer(_entries[entryIndex].entity);
+
+	if (_isEmpty[0])
+		return true;
+
+	struct NodeEntry
+	{
+		float distanceSq;
+		UINT level, morton;
+
+		[[nodiscard]] inline bool operator>(const NodeEntry &other) const { return distanceSq > other.distanceSq; }
+	};
+
+	std::priority_queue<NodeEntry, std::vector<NodeEntry>, std::greater<NodeEntry>> queue;
+	queue.push({ query.DistanceSq(_cullingBounds[0]), 0, 0 });
+
+	while (!queue.empty())
+	{
+		const NodeEntry current = queue.top();
+		queue.pop();
+
+		if (current.distanceSq > query.GetBoundSq())
+			break;
+
+		// Items placed directly in the node.
+		const NodeRange &range = _ranges[LevelOffset(current.level) + current.morton];
+		for (UINT i = range.itemOffset; i < range.itemOffset + range.itemCount; i++)
+			query.Offer(_items[i]);
+
+		if (current.level >= MAX_DEPTH)
+			continue;
+
+		const UINT childLevel = current.level + 1;
+		const UINT childMortonBase = current.morton << 2;
+
+		for (UINT c = 0; c < CHILD_COUNT; c++)
+		{
+			const UINT child = LevelOffset(childLevel) + childMortonBase + c;
+			if (_isEmpty[child])
+				continue;
+
+			const float childDistanceSq = query.DistanceSq(_cullingBounds[child]);
+			if (childDistanceSq <= query.GetBoundSq())
+				queue.push({ childDistanceSq, childLevel, childMortonBase + c });
+		}
+	}
+
+	return true;
+}
+
+bool LinearQuadtree::MultiCull(const CullView *views, UINT viewCount, std::vector<Entity *> *containingItems) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized)
+		return false;
+
+	if (viewCount > CullView::MAX_BATCH_SIZE)
+		return false;
+
+	if (viewCount == 0)
+		return true;
+
+	std::vector<CullPlanes> viewPlanes(viewCount);
+	for (UINT view = 0; view < viewCount; view++)
+		viewPlanes[view].FromView(views[view]);
+
+	// Pending insertions have not been placed in the packed array yet, test them individually.
+	for (const UINT entryIndex : _pendingEntries)
+	{
+		Entity *item = _entries[entryIndex].entity;
+
+		if (item == nullptr || !item->IsEnabled())
+			continue;
+
+		BoundingOrientedBox itemBounds;
+		item->StoreEntityBounds(itemBounds);
+
+		for (UINT view = 0; view < viewCount; view++)
+		{
+			if (views[view].Intersects(itemBounds))
+				containingItems[view].emplace_back(item);
+		}
+	}
+
+	if (_isEmpty[0])
+		return true;
+
+	UINT64 rootMask = 0;
+	for (UINT view = 0; view < viewCount; view++)
+	{
+		switch (views[view].Contains(_cullingBounds[0]))
+		{
+		case DISJOINT:
+			break;
+
+		case CONTAINS:
+			AddRange(_ranges[0].itemOffset, _ranges[0].subtreeEnd, containingItems[view]);
+			break;
+
+		default:
+			rootMask |= 1ull << view;
+			break;
+		}
+	}
+
+	if (rootMask == 0)
+		return true;
+
+	struct StackEntry { UINT level, morton; UINT64 viewMask; };
+	StackEntry stack[(CHILD_COUNT - 1) * MAX_DEPTH + 1];
+	UINT stackSize = 0;
+
+	stack[stackSize++] = { 0, 0, rootMask };
+
+	while (stackSize > 0)
+	{
+		const StackEntry current = stack[--stackSize];
+		const UINT node = LevelOffset(current.level) + current.morton;
+		const NodeRange &range = _ranges[node];
+
+		const UINT itemEnd = range.itemOffset + range.itemCount;
+		for (UINT i = range.itemOffset; i < itemEnd; i++)
+		{
+			Entity *item = _items[i];
+
+			if (item == nullptr)
+				continue;
+
+			if (!item->IsEnabled())
+				continue;
+
+#ifdef EXTRA_CULL_CHECK
+			BoundingOrientedBox itemBounds;
+			item->StoreEntityBounds(itemBounds);
+#endif
+
+			for (UINT64 remaining = current.viewMask; remaining != 0; remaining &= remaining - 1)
+			{
+				const UINT view = CullView::NextView(remaining);
+
+#ifdef EXTRA_CULL_CHECK
+				if (!views[view].Intersects(itemBounds))
+					continue;
+#endif
+
+				containingItems[view].emplace_back(item);
+			}
+		}
+
+		if (current.level >= MAX_DEPTH)
+			continue;
+
+		const ChildBlock &block = _childBlocks[node];
+		if (block.nonEmptyMask == 0)
+			continue;
+
+		const UINT childLevel = current.level + 1;
+		const UINT childMortonBase = current.morton << 2;
+
+		UINT64 childMasks[CHILD_COUNT] = { 0, 0, 0, 0 };
+
+		for (UINT64 remaining = current.viewMask; remaining != 0; remaining &= remaining - 1)
+		{
+			const UINT view = CullView::NextView(remaining);
+
+			UINT intersectMask, containMask;
+			TestChildren(block, viewPlanes[view], intersectMask, containMask);
+
+			for (UINT c = 0; c < CHILD_COUNT; c++)
+			{
+				const UINT bit = 1u << c;
+
+				if (!(intersectMask & bit))
+					continue;
+
+				if (containMask & bit)
+				{
+					const NodeRange &childRange = _ranges[LevelOffset(childLevel) + childMortonBase + c];
+					AddRange(childRange.itemOffset, childRange.subtreeEnd, containingItems[view]);
+					continue;
+				}
+
+				childMasks[c] |= 1ull << view;
+			}
+		}
+
+		for (UINT c = 0; c < CHILD_COUNT; c++)
+		{
+			if (childMasks[c] != 0)
+				stack[stackSize++] = { childLevel, childMortonBase + c, childMasks[c] };
+		}
+	}
+
+	return true;
+}
+
+bool LinearQuadtree::RaycastNode(UINT level, UINT morton, const XMFLOAT3 &orig, const XMFLOAT3 &dir, FXMVECTOR invDir, float &length, Entity *&entity, bool cheap) const
+{
+	ZoneScopedXC(RandomUniqueColor());
+
+	const UINT node = LevelOffset(level) + morton;
+	const NodeRange &range = _ranges[node];
+
+	const UINT itemEnd = range.itemOffset + range.itemCount;
+	for (UINT i = range.itemOffset; i < itemEnd; i++)
+		RaycastItem(_items[i], orig, dir, length, entity, cheap);
+
+	if (level >= MAX_DEPTH)
+		return (entity != nullptr);
+
+	const ChildBlock &block = _childBlocks[node];
+	if (block.nonEmptyMask == 0)
+		return (entity != nullptr);
+
+	float childLengths[CHILD_COUNT];
+	const UINT hitMask = RaycastChildren(block, Load(orig), invDir, length, childLengths);
+
+	UINT order[CHILD_COUNT];
+	UINT hitCount = 0;
+	for (UINT c = 0; c < CHILD_COUNT; c++)
+	{
+		if (hitMask & (1u << c))
+			order[hitCount++] = c;
+	}
+
+	// Insertion sort by entry distance.
+	for (UINT i = 1; i < hitCount; i++)
+	{
+		for (UINT j = i; j > 0 && childLengths[order[j]] < childLengths[order[j - 1]]; j--)
+			std::swap(order[j], order[j - 1]);
+	}
+
+	// Check children in order of closest to furthest.
+	for (UINT i = 0; i < hitCount; i++)
+	{
+		if (childLengths[order[i]] > length)
+			break;
+
+		RaycastNode(level + 1, (morton << 2) + order[i], orig, dir, invDir, length, entity, cheap);
+	}
+
+	return (entity != nullptr);
+}
+
+bool LinearQuadtree::RaycastNode(UINT level, UINT morton, const Shape::Ray &ray, FXMVECTOR invDir, Shape::RayHit &hit, Entity *&ent) const
+{
+	ZoneScopedXC(RandomUniqueColor());
+
+	const UINT node = LevelOffset(level) + morton;
+	const NodeRange &range = _ranges[node];
+
+	const UINT itemEnd = range.itemOffset + range.itemCount;
+	for (UINT i = range.itemOffset; i < itemEnd; i++)
+		RaycastItem(_items[i], ray, hit, ent);
+
+	if (level >= MAX_DEPTH)
+		return (ent != nullptr);
+
+	const ChildBlock &block = _childBlocks[node];
+	if (block.nonEmptyMask == 0)
+		return (ent != nullptr);
+
+	float childLengths[CHILD_COUNT];
+	const UINT hitMask = RaycastChildren(block, Load(ray.origin), invDir, hit.length, childLengths);
+
+	UINT order[CHILD_COUNT];
+	UINT hitCount = 0;
+	for (UINT c = 0; c < CHILD_COUNT; c++)
+	{
+		if (hitMask & (1u << c))
+			order[hitCount++] = c;
+	}
+
+	for (UINT i = 1; i < hitCount; i++)
+	{
+		for (UINT j = i; j > 0 && childLengths[order[j]] < childLengths[order[j - 1]]; j--)
+			std::swap(order[j], order[j - 1]);
+	}
+
+	for (UINT i = 0; i < hitCount; i++)
+	{
+		if (childLengths[order[i]] > hit.length)
+			break;
+
+		RaycastNode(level + 1, (morton << 2) + order[i], ray, invDir, hit, ent);
+	}
+
+	return (ent != nullptr);
+}
+
+bool LinearQuadtree::RaycastTree(const XMFLOAT3A &orig, const XMFLOAT3A &dir, float &length, Entity *&entity, bool cheap) const
+{
+	if (!_isInitialized)
+		return false;
+
+	length = FLT_MAX;
+	entity = nullptr;
+
+	for (const UINT entryIndex : _pendingEntries)
+		RaycastItem(_entries[entryIndex].entity, orig, dir, length, entity, cheap);
+
+	if (_isEmpty[0])
+		return (entity != nullptr);
+
+	float rootLength = FLT_MAX; // In case Intersects() uses the initial dist value as a maximum. Docs don't specify.
+	if (!Raycast(orig, dir, _cullingBounds[0], rootLength))
+		return (entity != nullptr);
+
+	if (rootLength > length)
+		return (entity != nullptr);
+
+	RaycastNode(0, 0, orig, dir, SafeInverse(dir), length, entity, cheap);
+	return (entity != nullptr);
+}
+
+bool LinearQuadtree::RaycastTree(const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent) const
+{
+	if (!_isInitialized)
+		return false;
+
+	hit.length = ray.length > 0.0f ? ray.length : FLT_MAX;
+	ent = nullptr;
+
+	for (const UINT entryIndex : _pendingEntries)
+		RaycastItem(_entries[entryIndex].entity, ray, hit, ent);
+
+	if (_isEmpty[0])
+		return (ent != nullptr);
+
+	float len = hit.length; // In case Intersects() uses the initial dist value as a maximum. Docs don't specify.
+	if (!Raycast(ray.origin, ray.direction, _cullingBounds[0], len))
+		return (ent != nullptr);
+
+	if (len > hit.length)
+		return (ent != nullptr);
+
+	RaycastNode(0, 0, ray, SafeInverse(ray.direction), hit, ent);
+	return (ent != nullptr);
+}
+#pragma endregion
+
+
+#pragma region Debug
+void LinearQuadtree::DebugGetStructure(std::vector<BoundingBox> &boxCollection, bool full, bool culling) const
+{
+	if (!_isInitialized)
+		return;
+
+	for (UINT level = 0; level < LEVEL_COUNT; level++)
+	{
+		const UINT levelOffset = LevelOffset(level);
+		const UINT levelSize = 1u << (2 * level);
+
+		for (UINT morton = 0; morton < levelSize; morton++)
+		{
+			const UINT node = levelOffset + morton;
+
+			if (_isEmpty[node])
+				continue;
+
+			const bool isLeaf = (level >= MAX_DEPTH) || (_childBlocks[node].nonEmptyMask == 0);
+			if (!full && !isLeaf)
+				continue;
+
+			boxCollection.emplace_back(culling ? _cullingBounds[node] : GetCellBounds(level, morton));
+		}
+	}
+}
+void LinearQuadtree::DebugGetStructure(std::vector<BoundingBox> &boxCollection, const BoundingFrustum &frustum, bool full, bool culling) const
+{
+	if (!_isInitialized)
+		return;
+
+	for (UINT level = 0; level < LEVEL_COUNT; level++)
+	{
+		const UINT levelOffset = LevelOffset(level);
+		const UINT levelSize = 1u << (2 * level);
+
+		for (UINT morton = 0; morton < levelSize; morton++)
+		{
+			const UINT node = levelOffset + morton;
+
+			if (_isEmpty[node])
+				continue;
+
+			const bool isLeaf = (level >= MAX_DEPTH) || (_childBlocks[node].nonEmptyMask == 0);
+			if (!full && !isLeaf)
+				continue;
+
+			if (!frustum.Intersects(_cullingBounds[node]))
+				continue;
+
+			boxCollection.emplace_back(culling ? _cullingBounds[node] : GetCellBounds(level, morton));
+		}
+	}
+}
+
+#ifdef USE_IMGUI
+bool LinearQuadtree::RenderUI()
+{
+	if (!_isInitialized)
+		return true;
+
+	ImGui::Text("Nodes: %u", NODE_COUNT);
+	ImGui::Text("Packed Items: %zu", _items.size());
+	ImGui::Text("Pending Items: %zu", _pendingEntries.size());
+	ImGui::Text("Tombstones: %u", _tombstoneCount);
+
+	ImGui::Separator();
+
+	ImGui::ColorEdit4("Bounds Color", &boundsColor.x, ImGuiColorEditFlags_NoInputs);
+	ImGui::Checkbox("Draw Culling Bounds", &drawCullingBounds);
+	ImGui::Checkbox("Leaves Only", &drawLeavesOnly);
+
+	if (drawCullingBounds)
+	{
+		std::vector<BoundingBox> boxes;
+		DebugGetStructure(boxes, !drawLeavesOnly, true);
+
+		for (const BoundingBox &box : boxes)
+			DebugDrawer::Instance().DrawBoxAABB(box, boundsColor, false, true);
+	}
+
+	return true;
+}
+#endif
+#pragma endregion
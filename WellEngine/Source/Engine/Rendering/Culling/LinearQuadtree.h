@@ -0,0 +1,181 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <DirectXCollision.h>
+#include "Entity.h"
+#include "Behaviour.h"
+#include "Collision/Raycast.h"
+#include "CullView.h"
+#include "NearestQuery.h"
+#include "FrustumPlanes.h"
+#include "Behaviours/MeshBehaviour.h"
+
+#ifdef LEAK_DETECTION
+#define new			DEBUG_NEW
+#endif
+
+// Pointer-free quadtree. All nodes of a complete tree live in one contiguous array,
+// stored level by level with each level in Morton order. The four children of a node
+// are therefore always adjacent, and their culling bounds are kept as SoA blocks so a
+// single SIMD kernel can test all of them against a set of planes at once.
+//
+// Entities are placed in exactly one node (loose quadtree, looseness 2) and packed into
+// a shared item array sorted in depth-first order. Every subtree thus owns one contiguous
+// range of items, and query results never contain duplicates.
+class LinearQuadtree
+{
+public:
+	static constexpr UINT MAX_DEPTH = 5;
+
+private:
+	static constexpr UINT CHILD_COUNT = 4;
+	static constexpr UINT LEVEL_COUNT = MAX_DEPTH + 1;
+	static constexpr UINT NODE_COUNT = ((1u << (2 * LEVEL_COUNT)) - 1) / 3;
+	static constexpr UINT INTERNAL_NODE_COUNT = ((1u << (2 * MAX_DEPTH)) - 1) / 3;
+	static constexpr UINT MAX_CULL_PLANES = 6;
+	static constexpr UINT INVALID_INDEX = UINT_MAX;
+
+	[[nodiscard]] static constexpr UINT LevelOffset(const UINT level) { return ((1u << (2 * level)) - 1) / 3; }
+	[[nodiscard]] static constexpr UINT SubtreeNodeCount(const UINT level) { return LevelOffset(LEVEL_COUNT - level); }
+
+	// Culling bounds of the four children of one node. Each array is one XMVECTOR.
+	struct alignas(16) ChildBlock
+	{
+		float centerX[CHILD_COUNT] = { 0, 0, 0, 0 };
+		float centerY[CHILD_COUNT] = { 0, 0, 0, 0 };
+		float centerZ[CHILD_COUNT] = { 0, 0, 0, 0 };
+		float extentsX[CHILD_COUNT] = { 0, 0, 0, 0 };
+		float extentsY[CHILD_COUNT] = { 0, 0, 0, 0 };
+		float extentsZ[CHILD_COUNT] = { 0, 0, 0, 0 };
+		UINT nonEmptyMask = 0;
+	};
+
+	// Range of packed items owned by a node. [itemOffset, itemOffset + itemCount) are
+	// placed in the node itself, [itemOffset, subtreeEnd) covers its entire subtree.
+	struct NodeRange
+	{
+		UINT itemOffset = 0;
+		UINT itemCount = 0;
+		UINT subtreeEnd = 0;
+	};
+
+	struct ItemEntry
+	{
+		Entity *entity = nullptr;
+		UINT node = INVALID_INDEX;
+		UINT packedIndex = INVALID_INDEX;
+		bool removed = false;
+	};
+
+	// Replicated plane coefficients, ready to be tested against a ChildBlock.
+	struct CullPlanes
+	{
+		dx::XMVECTOR nx[MAX_CULL_PLANES], ny[MAX_CULL_PLANES], nz[MAX_CULL_PLANES], d[MAX_CULL_PLANES];
+		dx::XMVECTOR ax[MAX_CULL_PLANES], ay[MAX_CULL_PLANES], az[MAX_CULL_PLANES];
+		UINT count = 0;
+
+		void AddPlane(dx::FXMVECTOR plane);
+		void FromFrustum(const dx::BoundingFrustum &frustum);
+		void FromBox(const dx::BoundingOrientedBox &box);
+		void FromBox(const dx::BoundingBox &box);
+		void FromView(const CullView &view);
+	};
+
+	dx::BoundingBox _bounds = {};
+	bool _isInitialized = false;
+
+	// Node data, indexed by LevelOffset(level) + morton.
+	std::vector<dx::BoundingBox> _cullingBounds;
+	std::vector<NodeRange> _ranges;
+	std::vector<UINT> _preorder;
+	std::vector<bool> _isDirty;
+	std::vector<bool> _isEmpty;
+
+	// Indexed by node index. Only internal nodes own a child block.
+	std::vector<ChildBlock> _childBlocks;
+	// Plane that last rejected every child of a node, per frustum cull cache slot. Indexed like _childBlocks.
+	mutable std::vector<std::array<UINT8, FrustumCullOptions::MAX_CACHE_SLOTS>> _lastFailPlanes;
+
+	// Shared item storage, sorted by the depth-first order of the owning node.
+	std::vector<Entity *> _items;
+	std::vector<UINT> _itemSlots;
+
+	std::vector<ItemEntry> _entries;
+	std::vector<UINT> _freeEntries;
+	std::vector<UINT> _pendingEntries;
+	std::unordered_map<const Entity *, UINT> _entryLookup;
+	UINT _tombstoneCount = 0;
+
+	[[nodiscard]] UINT FindNode(const dx::BoundingOrientedBox &itemBounds) const;
+	[[nodiscard]] dx::BoundingBox GetCellBounds(UINT level, UINT morton) const;
+
+	[[nodiscard]] UINT AllocateEntry();
+	void FreeEntry(UINT entryIndex);
+	void MarkDirty(UINT node);
+
+	void Repack();
+	void RefitNode(UINT level, UINT morton);
+
+	static void TestChildren(const ChildBlock &block, const CullPlanes &planes, UINT &intersectMask, UINT &containMask);
+	// Like TestChildren, but only tests the planes in planeMask, starting with firstPlane. straddledMasks receives the planes
+	// each child intersects. Returns the plane that rejected every child, or FrustumPlanes::NO_PLANE if any child remains.
+	static UINT8 TestChildrenMasked(const ChildBlock &block, const CullPlanes &planes, UINT8 planeMask, UINT8 firstPlane,
+		UINT &intersectMask, UINT &containMask, UINT8 straddledMasks[CHILD_COUNT]);
+	static UINT RaycastChildren(const ChildBlock &block, dx::FXMVECTOR origin, dx::FXMVECTOR invDir, float maxLength, float outLengths[CHILD_COUNT]);
+
+	template <class VolumeType>
+	void CullInternal(const VolumeType &volume, const CullPlanes &planes, std::vector<Entity *> &containingItems, const FrustumCullOptions &options = {}) const;
+	void AddRange(UINT begin, UINT end, std::vector<Entity *> &containingItems) const;
+
+	bool RaycastNode(UINT level, UINT morton, const dx::XMFLOAT3 &orig, const dx::XMFLOAT3 &dir, dx::FXMVECTOR invDir, float &length, Entity *&entity, bool cheap) const;
+	bool RaycastNode(UINT level, UINT morton, const Shape::Ray &ray, dx::FXMVECTOR invDir, Shape::RayHit &hit, Entity *&ent) const;
+
+public:
+	LinearQuadtree() = default;
+	~LinearQuadtree() = default;
+	LinearQuadtree(const LinearQuadtree &other) = default;
+	LinearQuadtree &operator=(const LinearQuadtree &other) = default;
+	LinearQuadtree(LinearQuadtree &&other) = default;
+	LinearQuadtree &operator=(LinearQuadtree &&other) = default;
+
+	[[nodiscard]] bool Initialize(const dx::BoundingBox &sceneBounds);
+
+	void Insert(Entity *data, const dx::BoundingOrientedBox &bounds);
+	[[nodiscard]] bool Remove(Entity *data, bool skipIntersectionTests = false);
+	[[nodiscard]] bool Move(Entity *data, const dx::BoundingOrientedBox &bounds);
+
+	// Packs pending insertions and refits the culling bounds of all dirty nodes.
+	void RecalculateCullingBounds();
+
+	[[nodiscard]] dx::BoundingBox *GetBounds();
+
+	[[nodiscard]] bool FrustumCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems) const;
+	[[nodiscard]] bool FrustumCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems, const FrustumCullOptions &options) const;
+	[[nodiscard]] bool BoxCull(const dx::BoundingOrientedBox &box, std::vector<Entity *> &containingItems) const;
+	[[nodiscard]] bool BoxCull(const dx::BoundingBox &box, std::vector<Entity *> &containingItems) const;
+	[[nodiscard]] bool SphereCull(const dx::BoundingSphere &sphere, std::vector<Entity *> &containingItems) const;
+
+	// Best-first search, visiting nodes in order of distance until none can be closer than the k-th candidate.
+	[[nodiscard]] bool FindNearest(NearestQuery &query) const;
+
+	// Culls up to CullView::MAX_BATCH_SIZE views in a single traversal, writing one result list per view.
+	[[nodiscard]] bool MultiCull(const CullView *views, UINT viewCount, std::vector<Entity *> *containingItems) const;
+
+	bool RaycastTree(const dx::XMFLOAT3A &orig, const dx::XMFLOAT3A &dir, float &length, Entity *&entity, bool cheap = false) const;
+	bool RaycastTree(const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent) const;
+
+	void DebugGetStructure(std::vector<dx::BoundingBox> &boxCollection, bool full, bool culling) const;
+	void DebugGetStructure(std::vector<dx::BoundingBox> &boxCollection, const dx::BoundingFrustum &frustum, bool full, bool culling) const;
+
+#ifdef USE_IMGUI
+	bool drawCullingBounds = false;
+	bool drawLeavesOnly = true;
+	dx::XMFLOAT4 boundsColor = { 1.0f, 0.0f, 0.0f, 0.05f };
+
+	bool RenderUI();
+#endif
+
+	TESTABLE()
+};
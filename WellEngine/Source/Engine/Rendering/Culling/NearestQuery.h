@@ -0,0 +1,131 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <DirectXCollision.h>
+#include "Entity.h"
+#include "CullStamp.h"
+
+namespace dx = DirectX;
+
+// State of a k-nearest-neighbour search, shared by the best-first traversals of every tree so that
+// several trees can be searched as one. The best candidates so far are kept in a max-heap of at most
+// k entries, and the distance of the worst one bounds how far a traversal still has to look.
+// Distances are measured to the culling bounds of each entity, and are zero inside them.
+class NearestQuery
+{
+public:
+	using Filter = std::function<bool(const Entity *)>;
+
+	struct Candidate
+	{
+		float distanceSq;
+		Entity *entity;
+
+		[[nodiscard]] inline bool operator<(const Candidate &other) const { return distanceSq < other.distanceSq; }
+	};
+
+private:
+	dx::XMFLOAT3 _point;
+	UINT _count;
+	float _maxDistanceSq;
+	const Filter &_filter;
+
+	std::vector<Candidate> _heap;
+
+public:
+	// Starts a new CullStamp query, so entities stored in several nodes are only offered once.
+	NearestQuery(const dx::XMFLOAT3 &point, UINT count, const Filter &filter, float maxDistance = FLT_MAX)
+		: _point(point), _count(count), _filter(filter)
+	{
+		_maxDistanceSq = (maxDistance < FLT_MAX) ? maxDistance * maxDistance : FLT_MAX;
+		_heap.reserve(count);
+		CullStamp::BeginQuery();
+	}
+	~NearestQuery() = default;
+	NearestQuery(const NearestQuery &other) = delete;
+	NearestQuery &operator=(const NearestQuery &other) = delete;
+	NearestQuery(NearestQuery &&other) = delete;
+	NearestQuery &operator=(NearestQuery &&other) = delete;
+
+	[[nodiscard]] inline const dx::XMFLOAT3 &GetPoint() const { return _point; }
+
+	// Nodes and entities further away than this can no longer change the result.
+	[[nodiscard]] inline float GetBoundSq() const
+	{
+		if (_count == 0)
+			return -1.0f;
+
+		return (_heap.size() < _count) ? _maxDistanceSq : _heap.front().distanceSq;
+	}
+
+	[[nodiscard]] float DistanceSq(const dx::BoundingBox &box) const
+	{
+		float distanceSq = 0.0f;
+		for (UINT axis = 0; axis < 3; axis++)
+		{
+			const float offset = fabsf((&_point.x)[axis] - (&box.Center.x)[axis]) - (&box.Extents.x)[axis];
+			if (offset > 0.0f)
+				distanceSq += offset * offset;
+		}
+		return distanceSq;
+	}
+
+	[[nodiscard]] float DistanceSq(const dx::BoundingOrientedBox &box) const
+	{
+		using namespace DirectX;
+
+		// Measure in the space of the box, where it is axis-aligned around the origin.
+		const XMVECTOR localPoint = XMVector3InverseRotate(
+			XMVectorSubtract(XMLoadFloat3(&_point), XMLoadFloat3(&box.Center)),
+			XMLoadFloat4(&box.Orientation)
+		);
+
+		const XMVECTOR extents = XMLoadFloat3(&box.Extents);
+		const XMVECTOR outside = XMVectorMax(XMVectorSubtract(XMVectorAbs(localPoint), extents), XMVectorZero());
+		return XMVectorGetX(XMVector3LengthSq(outside));
+	}
+
+	// Considers an entity found by a traversal, keeping it if it is among the k closest so far.
+	void Offer(Entity *entity)
+	{
+		if (entity == nullptr)
+			return;
+
+		if (!entity->IsEnabled())
+			return;
+
+		const float distanceSq = DistanceSq(entity->GetLastCullingBounds());
+		if (distanceSq > GetBoundSq())
+			return;
+
+		if (!CullStamp::Visit(entity))
+			return;
+
+		if (_filter && !_filter(entity))
+			return;
+
+		if (_heap.size() >= _count)
+		{
+			std::ranges::pop_heap(_heap);
+			_heap.pop_back();
+		}
+
+		_heap.push_back({ distanceSq, entity });
+		std::ranges::push_heap(_heap);
+	}
+
+	// Appends the found entities, nearest first.
+	void GetResults(std::vector<Entity *> &nearest) const
+	{
+		std::vector<Candidate> sorted = _heap;
+		std::ranges::sort(sorted);
+
+		nearest.reserve(nearest.size() + sorted.size());
+		for (const Candidate &candidate : sorted)
+			nearest.emplace_back(candidate.entity);
+	}
+
+	TESTABLE()
+};
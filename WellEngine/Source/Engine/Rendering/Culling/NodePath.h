@@ -3,17 +3,73 @@
 
 struct TreePath
 {
-	// TODO: Implement
-
-	// Each step in the tree can be represented by 2 bits, denoting the index of the 
-	// node that was stepped to. However, we must also be able to specify where the 
-	// path ends. Due to this, every depth is represented by 3 bits, with the first 
+	// Each step in the tree can be represented by 2 bits, denoting the index of the
+	// node that was stepped to. However, we must also be able to specify where the
+	// path ends. Due to this, every depth is represented by 3 bits, with the first
 	// bit indicating if the end of path has been reached. The leftover bit is unused.
-	// 
+	//
 	// Ex: (We will format the flag in pairs of 3, instead of the more common 4-pair)
 	//   [0 000 000 000 000 000] -> root[0][0][0][0][0]
 	//   [0 000 000 001 010 110] -> root[3][1]
 	//   [0 011 101 010 000 100] -> root[2][0][1]
 
+	static constexpr uint32_t BITS_PER_STEP = 3;
+	static constexpr uint32_t MAX_STEPS = 5;
+
 	uint16_t bitPath = 0b001u; // Default is end at root
+
+	// Number of steps taken from the root.
+	[[nodiscard]] constexpr uint32_t GetDepth() const
+	{
+		for (uint32_t depth = 0; depth < MAX_STEPS; depth++)
+		{
+			if (bitPath & (1u << (depth * BITS_PER_STEP)))
+				return depth;
+		}
+
+		return MAX_STEPS;
+	}
+
+	// Index of the child stepped to at the given depth.
+	[[nodiscard]] constexpr uint32_t GetStep(uint32_t depth) const
+	{
+		return (bitPath >> (depth * BITS_PER_STEP + 1)) & 0b11u;
+	}
+
+	// Path to the given child of the node at the end of this path.
+	[[nodiscard]] constexpr TreePath GetChild(uint32_t childIndex) const
+	{
+		const uint32_t depth = GetDepth();
+		if (depth >= MAX_STEPS)
+			return *this;
+
+		uint32_t newPath = bitPath & ~(0b111u << (depth * BITS_PER_STEP));
+		newPath |= (childIndex & 0b11u) << (depth * BITS_PER_STEP + 1);
+
+		if (depth + 1 < MAX_STEPS)
+			newPath |= 1u << ((depth + 1) * BITS_PER_STEP);
+
+		return { static_cast<uint16_t>(newPath) };
+	}
+
+	// Deepest path shared by both paths.
+	[[nodiscard]] static constexpr TreePath GetCommonAncestor(const TreePath &a, const TreePath &b)
+	{
+		const uint32_t aDepth = a.GetDepth(), bDepth = b.GetDepth();
+		const uint32_t depth = aDepth < bDepth ? aDepth : bDepth;
+
+		TreePath common;
+		for (uint32_t i = 0; i < depth; i++)
+		{
+			const uint32_t step = a.GetStep(i);
+			if (step != b.GetStep(i))
+				break;
+
+			common = common.GetChild(step);
+		}
+
+		return common;
+	}
+
+	[[nodiscard]] constexpr bool operator==(const TreePath &other) const = default;
 };
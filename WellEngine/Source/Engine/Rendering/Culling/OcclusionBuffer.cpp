@@ -0,0 +1,370 @@
+#include "stdafx.h"
+#include "OcclusionBuffer.h"
+
+using namespace DirectX;
+
+#pragma region Helpers
+// Clip-space w below which a vertex is treated as lying on the eye plane.
+static constexpr float MIN_CLIP_W = 1e-5f;
+
+[[nodiscard]] static inline XMFLOAT4 LerpClip(const XMFLOAT4 &a, const XMFLOAT4 &b, float t)
+{
+	return {
+		a.x + (b.x - a.x) * t,
+		a.y + (b.y - a.y) * t,
+		a.z + (b.z - a.z) * t,
+		a.w + (b.w - a.w) * t
+	};
+}
+
+// Coefficients of E(x, y) = a * x + b * y + c, positive to the left of the edge from p to q.
+struct EdgeFunction
+{
+	float a, b, c;
+
+	EdgeFunction(const XMFLOAT3 &p, const XMFLOAT3 &q) :
+		a(p.y - q.y), b(q.x - p.x), c((q.y - p.y) * p.x - (q.x - p.x) * p.y) { }
+};
+#pragma endregion
+
+bool OcclusionBuffer::Initialize(UINT width, UINT height)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (width == 0 || height == 0 || width % TILE_WIDTH != 0 || height % TILE_HEIGHT != 0)
+	{
+		ErrMsgF("Occlusion buffer resolution {}x{} is not a multiple of the tile size!", width, height);
+		return false;
+	}
+
+	_width = width;
+	_height = height;
+	_tilesX = width / TILE_WIDTH;
+	_tilesY = height / TILE_HEIGHT;
+
+	_depth.assign(static_cast<size_t>(_width) * _height, 1.0f);
+	_tileMaxDepth.assign(static_cast<size_t>(_tilesX) * _tilesY, 1.0f);
+	_isFinalized = false;
+	return true;
+}
+
+void OcclusionBuffer::Clear(const XMFLOAT4X4 &viewProj)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	XMStoreFloat4x4A(&_viewProj, XMLoadFloat4x4(&viewProj));
+
+	std::fill(_depth.begin(), _depth.end(), 1.0f);
+	std::fill(_tileMaxDepth.begin(), _tileMaxDepth.end(), 1.0f);
+
+	_isFinalized = false;
+	_occluderCount = 0;
+	_occluderTriCount = 0;
+}
+
+UINT OcclusionBuffer::ClipNear(const XMFLOAT4 *in[3], XMFLOAT4 out[4])
+{
+	// D3D clip space puts the near plane at z = 0.
+	UINT count = 0;
+
+	for (UINT i = 0; i < 3; i++)
+	{
+		const XMFLOAT4 &a = *in[i];
+		const XMFLOAT4 &b = *in[(i + 1) % 3];
+
+		const bool aInside = a.z >= 0.0f && a.w > MIN_CLIP_W;
+		const bool bInside = b.z >= 0.0f && b.w > MIN_CLIP_W;
+
+		if (aInside)
+			out[count++] = a;
+
+		if (aInside != bInside)
+		{
+			const float t = a.z / (a.z - b.z);
+			XMFLOAT4 clipped = LerpClip(a, b, t);
+			clipped.w = std::max<float>(clipped.w, MIN_CLIP_W);
+			out[count++] = clipped;
+		}
+	}
+
+	return count;
+}
+
+void OcclusionBuffer::RasterizeClipped(const XMFLOAT4 &c0, const XMFLOAT4 &c1, const XMFLOAT4 &c2)
+{
+	const XMFLOAT4 *clip[3] = { &c0, &c1, &c2 };
+	XMFLOAT3 v[3];
+
+	for (UINT i = 0; i < 3; i++)
+	{
+		const float invW = 1.0f / clip[i]->w;
+		v[i].x = (clip[i]->x * invW * 0.5f + 0.5f) * static_cast<float>(_width);
+		v[i].y = (0.5f - clip[i]->y * invW * 0.5f) * static_cast<float>(_height);
+		v[i].z = clip[i]->z * invW;
+	}
+
+	float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+	if (std::abs(area) < 1e-6f)
+		return;
+
+	// Occluders are rasterized double-sided, so flip clockwise triangles instead of rejecting them.
+	if (area < 0.0f)
+	{
+		std::swap(v[1], v[2]);
+		area = -area;
+	}
+
+	// Clamp before converting, vertices near the eye plane can project far outside the buffer.
+	const float width = static_cast<float>(_width), height = static_cast<float>(_height);
+	const int minX = static_cast<int>(std::floor(std::clamp(std::min<float>({ v[0].x, v[1].x, v[2].x }), 0.0f, width)));
+	const int minY = static_cast<int>(std::floor(std::clamp(std::min<float>({ v[0].y, v[1].y, v[2].y }), 0.0f, height)));
+	const int maxX = static_cast<int>(std::ceil(std::clamp(std::max<float>({ v[0].x, v[1].x, v[2].x }), -1.0f, width - 1.0f)));
+	const int maxY = static_cast<int>(std::ceil(std::clamp(std::max<float>({ v[0].y, v[1].y, v[2].y }), -1.0f, height - 1.0f)));
+
+	if (minX > maxX || minY > maxY)
+		return;
+
+	const EdgeFunction e01(v[0], v[1]), e12(v[1], v[2]), e20(v[2], v[0]);
+
+	// Depth is linear in screen space. Interpolate it as a plane through the barycentrics.
+	const float invArea = 1.0f / area;
+	const float dz1 = (v[1].z - v[0].z) * invArea, dz2 = (v[2].z - v[0].z) * invArea;
+	const float za = e20.a * dz1 + e01.a * dz2;
+	const float zb = e20.b * dz1 + e01.b * dz2;
+	const float zc = v[0].z + e20.c * dz1 + e01.c * dz2;
+
+	const XMVECTOR laneOffsets = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+	const XMVECTOR zero = XMVectorZero(), one = XMVectorSplatOne();
+	const XMVECTOR a01 = XMVectorReplicate(e01.a), a12 = XMVectorReplicate(e12.a), a20 = XMVectorReplicate(e20.a);
+	const XMVECTOR aZ = XMVectorReplicate(za);
+
+	const int startX = minX & ~static_cast<int>(SIMD_WIDTH - 1);
+
+	for (int y = minY; y <= maxY; y++)
+	{
+		const float py = static_cast<float>(y) + 0.5f;
+		const XMVECTOR row01 = XMVectorReplicate(e01.b * py + e01.c);
+		const XMVECTOR row12 = XMVectorReplicate(e12.b * py + e12.c);
+		const XMVECTOR row20 = XMVectorReplicate(e20.b * py + e20.c);
+		const XMVECTOR rowZ = XMVectorReplicate(zb * py + zc);
+
+		float *depthRow = &_depth[static_cast<size_t>(y) * _width];
+
+		for (int x = startX; x <= maxX; x += SIMD_WIDTH)
+		{
+			const XMVECTOR px = XMVectorAdd(XMVectorReplicate(static_cast<float>(x)), laneOffsets);
+
+			const XMVECTOR inside = XMVectorAndInt(
+				XMVectorAndInt(
+					XMVectorGreaterOrEqual(XMVectorMultiplyAdd(a01, px, row01), zero),
+					XMVectorGreaterOrEqual(XMVectorMultiplyAdd(a12, px, row12), zero)),
+				XMVectorGreaterOrEqual(XMVectorMultiplyAdd(a20, px, row20), zero));
+
+			if (XMVector4EqualInt(inside, XMVectorFalseInt()))
+				continue;
+
+			const XMVECTOR z = XMVectorClamp(XMVectorMultiplyAdd(aZ, px, rowZ), zero, one);
+
+			XMFLOAT4 *dst = reinterpret_cast<XMFLOAT4 *>(&depthRow[x]);
+			const XMVECTOR depth = XMLoadFloat4(dst);
+			XMStoreFloat4(dst, XMVectorSelect(depth, XMVectorMin(depth, z), inside));
+		}
+	}
+
+	_occluderTriCount++;
+}
+
+void OcclusionBuffer::RasterizeOccluder(const float *vertexData, UINT vertexStride, UINT vertexCount,
+	const UINT *indices, UINT indexCount, const XMFLOAT4X4 &worldMatrix)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (vertexData == nullptr || indices == nullptr || vertexCount == 0)
+		return;
+
+	const XMMATRIX worldViewProj = XMMatrixMultiply(XMLoadFloat4x4(&worldMatrix), XMLoadFloat4x4A(&_viewProj));
+	const char *vertexBytes = reinterpret_cast<const char *>(vertexData);
+
+	_clipVertices.resize(vertexCount);
+	for (UINT i = 0; i < vertexCount; i++)
+	{
+		const float *pos = reinterpret_cast<const float *>(vertexBytes + static_cast<size_t>(i) * vertexStride);
+		XMStoreFloat4(&_clipVertices[i], XMVector4Transform(XMVectorSet(pos[0], pos[1], pos[2], 1.0f), worldViewProj));
+	}
+
+	for (UINT i = 0; i + 2 < indexCount; i += 3)
+	{
+		const UINT i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+		if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+			continue; // Invalid index, skip this triangle.
+
+		const XMFLOAT4 &c0 = _clipVertices[i0], &c1 = _clipVertices[i1], &c2 = _clipVertices[i2];
+
+		// Trivially reject triangles entirely outside one of the side or far planes.
+		if ((c0.x > c0.w && c1.x > c1.w && c2.x > c2.w) ||
+			(c0.x < -c0.w && c1.x < -c1.w && c2.x < -c2.w) ||
+			(c0.y > c0.w && c1.y > c1.w && c2.y > c2.w) ||
+			(c0.y < -c0.w && c1.y < -c1.w && c2.y < -c2.w) ||
+			(c0.z > c0.w && c1.z > c1.w && c2.z > c2.w))
+			continue;
+
+		const XMFLOAT4 *tri[3] = { &c0, &c1, &c2 };
+		XMFLOAT4 clipped[4];
+		const UINT clippedCount = ClipNear(tri, clipped);
+
+		for (UINT j = 2; j < clippedCount; j++)
+			RasterizeClipped(clipped[0], clipped[j - 1], clipped[j]);
+	}
+
+	_occluderCount++;
+	_isFinalized = false;
+}
+
+void OcclusionBuffer::Finalize()
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	for (UINT ty = 0; ty < _tilesY; ty++)
+	{
+		for (UINT tx = 0; tx < _tilesX; tx++)
+		{
+			XMVECTOR maxDepth = XMVectorZero();
+
+			for (UINT y = 0; y < TILE_HEIGHT; y++)
+			{
+				const float *depthRow = &_depth[static_cast<size_t>(ty * TILE_HEIGHT + y) * _width + tx * TILE_WIDTH];
+
+				for (UINT x = 0; x < TILE_WIDTH; x += SIMD_WIDTH)
+					maxDepth = XMVectorMax(maxDepth, XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(&depthRow[x])));
+			}
+
+			XMFLOAT4 lanes;
+			XMStoreFloat4(&lanes, maxDepth);
+			_tileMaxDepth[static_cast<size_t>(ty) * _tilesX + tx] = std::max<float>({ lanes.x, lanes.y, lanes.z, lanes.w });
+		}
+	}
+
+	_isFinalized = true;
+}
+
+bool OcclusionBuffer::IsRectVisible(float minX, float minY, float maxX, float maxY, float minDepth) const
+{
+	const float width = static_cast<float>(_width), height = static_cast<float>(_height);
+	const int x0 = static_cast<int>(std::floor(std::clamp(minX, 0.0f, width)));
+	const int y0 = static_cast<int>(std::floor(std::clamp(minY, 0.0f, height)));
+	const int x1 = static_cast<int>(std::floor(std::clamp(maxX, -1.0f, width - 1.0f)));
+	const int y1 = static_cast<int>(std::floor(std::clamp(maxY, -1.0f, height - 1.0f)));
+
+	if (x0 > x1 || y0 > y1)
+		return false; // Entirely off-screen.
+
+	const XMVECTOR laneIndices = XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+	const XMVECTOR nearest = XMVectorReplicate(minDepth);
+
+	for (int ty = y0 / static_cast<int>(TILE_HEIGHT); ty <= y1 / static_cast<int>(TILE_HEIGHT); ty++)
+	{
+		for (int tx = x0 / static_cast<int>(TILE_WIDTH); tx <= x1 / static_cast<int>(TILE_WIDTH); tx++)
+		{
+			// Every pixel in the tile is nearer than the rectangle, the tile occludes it entirely.
+			if (_tileMaxDepth[static_cast<size_t>(ty) * _tilesX + tx] < minDepth)
+				continue;
+
+			const int px0 = std::max<int>(x0, tx * static_cast<int>(TILE_WIDTH));
+			const int px1 = std::min<int>(x1, (tx + 1) * static_cast<int>(TILE_WIDTH) - 1);
+			const int py0 = std::max<int>(y0, ty * static_cast<int>(TILE_HEIGHT));
+			const int py1 = std::min<int>(y1, (ty + 1) * static_cast<int>(TILE_HEIGHT) - 1);
+
+			const XMVECTOR colMin = XMVectorReplicate(static_cast<float>(px0));
+			const XMVECTOR colMax = XMVectorReplicate(static_cast<float>(px1));
+
+			for (int y = py0; y <= py1; y++)
+			{
+				const float *depthRow = &_depth[static_cast<size_t>(y) * _width];
+
+				for (int x = px0 & ~static_cast<int>(SIMD_WIDTH - 1); x <= px1; x += SIMD_WIDTH)
+				{
+					const XMVECTOR cols = XMVectorAdd(XMVectorReplicate(static_cast<float>(x)), laneIndices);
+					const XMVECTOR inRect = XMVectorAndInt(XMVectorGreaterOrEqual(cols, colMin), XMVectorLessOrEqual(cols, colMax));
+
+					const XMVECTOR depth = XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(&depthRow[x]));
+					const XMVECTOR visible = XMVectorAndInt(XMVectorGreaterOrEqual(depth, nearest), inRect);
+
+					if (XMVector4NotEqualInt(visible, XMVectorFalseInt()))
+						return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+bool OcclusionBuffer::IsVisible(const XMFLOAT3 corners[8]) const
+{
+	if (!_isFinalized)
+		return true;
+
+	const XMMATRIX viewProj = XMLoadFloat4x4A(&_viewProj);
+
+	float minX = FLT_MAX, minY = FLT_MAX, minDepth = FLT_MAX;
+	float maxX = -FLT_MAX, maxY = -FLT_MAX;
+
+	for (UINT i = 0; i < 8; i++)
+	{
+		XMFLOAT4 clip;
+		XMStoreFloat4(&clip, XMVector4Transform(XMVectorSet(corners[i].x, corners[i].y, corners[i].z, 1.0f), viewProj));
+
+		// Bounds crossing the near plane cover the camera and cannot be occluded.
+		if (clip.w <= MIN_CLIP_W || clip.z < 0.0f)
+			return true;
+
+		const float invW = 1.0f / clip.w;
+		const float x = (clip.x * invW * 0.5f + 0.5f) * static_cast<float>(_width);
+		const float y = (0.5f - clip.y * invW * 0.5f) * static_cast<float>(_height);
+
+		minX = std::min<float>(minX, x);
+		maxX = std::max<float>(maxX, x);
+		minY = std::min<float>(minY, y);
+		maxY = std::max<float>(maxY, y);
+		minDepth = std::min<float>(minDepth, clip.z * invW);
+	}
+
+	return IsRectVisible(minX, minY, maxX, maxY, minDepth);
+}
+
+bool OcclusionBuffer::IsVisible(const BoundingOrientedBox &bounds) const
+{
+	XMFLOAT3 corners[8];
+	bounds.GetCorners(corners);
+	return IsVisible(corners);
+}
+bool OcclusionBuffer::IsVisible(const BoundingBox &bounds) const
+{
+	XMFLOAT3 corners[8];
+	bounds.GetCorners(corners);
+	return IsVisible(corners);
+}
+
+UINT OcclusionBuffer::GetWidth() const
+{
+	return _width;
+}
+UINT OcclusionBuffer::GetHeight() const
+{
+	return _height;
+}
+float OcclusionBuffer::GetDepth(UINT x, UINT y) const
+{
+	if (x >= _width || y >= _height)
+		return 1.0f;
+
+	return _depth[static_cast<size_t>(y) * _width + x];
+}
+UINT OcclusionBuffer::GetOccluderCount() const
+{
+	return _occluderCount;
+}
+UINT OcclusionBuffer::GetOccluderTriangleCount() const
+{
+	return _occluderTriCount;
+}
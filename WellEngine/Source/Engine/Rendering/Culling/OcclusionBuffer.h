@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <DirectXCollision.h>
+
+namespace dx = DirectX;
+
+// Low-resolution software depth buffer used to cull entities hidden behind large occluders.
+// Occluders are rasterized four pixels at a time, after which every tile of the buffer stores
+// the farthest depth it contains. Occludees are tested by their screen-space rectangle and
+// nearest depth, first against whole tiles and then against pixels where a tile is inconclusive.
+// Depth is post-projection z in [0, 1], with 1 at the far plane.
+class OcclusionBuffer
+{
+public:
+	static constexpr UINT DEFAULT_WIDTH = 256;
+	static constexpr UINT DEFAULT_HEIGHT = 128;
+	static constexpr UINT SIMD_WIDTH = 4;
+	static constexpr UINT TILE_WIDTH = 8;
+	static constexpr UINT TILE_HEIGHT = 4;
+
+	static_assert(TILE_WIDTH % SIMD_WIDTH == 0, "Tiles must be a whole number of SIMD lanes wide.");
+
+private:
+	UINT _width = 0, _height = 0;
+	UINT _tilesX = 0, _tilesY = 0;
+
+	dx::XMFLOAT4X4A _viewProj = {};
+	std::vector<float> _depth;
+	std::vector<float> _tileMaxDepth;
+	std::vector<dx::XMFLOAT4> _clipVertices;
+	bool _isFinalized = false;
+
+	UINT _occluderCount = 0;
+	UINT _occluderTriCount = 0;
+
+	// Clips a clip-space triangle against the near plane, writing up to four vertices.
+	[[nodiscard]] static UINT ClipNear(const dx::XMFLOAT4 *in[3], dx::XMFLOAT4 out[4]);
+	void RasterizeClipped(const dx::XMFLOAT4 &c0, const dx::XMFLOAT4 &c1, const dx::XMFLOAT4 &c2);
+
+	[[nodiscard]] bool IsVisible(const dx::XMFLOAT3 corners[8]) const;
+
+public:
+	OcclusionBuffer() = default;
+	~OcclusionBuffer() = default;
+	OcclusionBuffer(const OcclusionBuffer &other) = default;
+	OcclusionBuffer &operator=(const OcclusionBuffer &other) = default;
+	OcclusionBuffer(OcclusionBuffer &&other) = default;
+	OcclusionBuffer &operator=(OcclusionBuffer &&other) = default;
+
+	// Width and height must be multiples of TILE_WIDTH and TILE_HEIGHT.
+	[[nodiscard]] bool Initialize(UINT width = DEFAULT_WIDTH, UINT height = DEFAULT_HEIGHT);
+
+	// Clears the buffer to the far plane and sets the view-projection used by all following calls.
+	void Clear(const dx::XMFLOAT4X4 &viewProj);
+
+	// Rasterizes an indexed triangle mesh. Positions are read as the first three floats of every vertex.
+	void RasterizeOccluder(const float *vertexData, UINT vertexStride, UINT vertexCount,
+		const UINT *indices, UINT indexCount, const dx::XMFLOAT4X4 &worldMatrix);
+
+	// Builds the tile hierarchy. Must be called after the last occluder and before any visibility test.
+	void Finalize();
+
+	[[nodiscard]] bool IsVisible(const dx::BoundingOrientedBox &bounds) const;
+	[[nodiscard]] bool IsVisible(const dx::BoundingBox &bounds) const;
+
+	// Tests a screen-space rectangle in pixels against the buffer, given the nearest depth inside it.
+	[[nodiscard]] bool IsRectVisible(float minX, float minY, float maxX, float maxY, float minDepth) const;
+
+	[[nodiscard]] UINT GetWidth() const;
+	[[nodiscard]] UINT GetHeight() const;
+	[[nodiscard]] float GetDepth(UINT x, UINT y) const;
+	[[nodiscard]] UINT GetOccluderCount() const;
+	[[nodiscard]] UINT GetOccluderTriangleCount() const;
+
+	TESTABLE()
+};
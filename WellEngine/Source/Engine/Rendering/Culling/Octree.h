@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <queue>
 #include <utility>
 #include <vector>
 #include <DirectXCollision.h>
@@ -8,6 +9,11 @@
 #include "Behaviour.h"
 #include "Collision/Raycast.h"
 #include "Behaviours/MeshBehaviour.h"
+#include "CullStamp.h"
+#include "CullView.h"
+#include "FrustumPlanes.h"
+#include "NearestQuery.h"
+#include "Utils/NodePool.h"
 
 namespace dx = DirectX;
 
@@ -26,9 +32,18 @@ private:
 	{
 		std::vector<Entity *> data;
 		dx::BoundingBox bounds;
-		std::unique_ptr<Node> children[CHILD_COUNT];
+		NodePool<Node> *pool = nullptr;
+		UINT children[CHILD_COUNT] = {
+			NULL_POOL_NODE, NULL_POOL_NODE, NULL_POOL_NODE, NULL_POOL_NODE,
+			NULL_POOL_NODE, NULL_POOL_NODE, NULL_POOL_NODE, NULL_POOL_NODE
+		};
 		bool isLeaf = true;
 
+		[[nodiscard]] inline Node *GetChild(UINT i) const
+		{
+			return (children[i] == NULL_POOL_NODE) ? nullptr : &(*pool)[children[i]];
+		}
+
 
 		void Split(const UINT depth)
 		{
@@ -39,16 +54,19 @@ private:
 				max = { center.x + extents.x, center.y + extents.y, center.z + extents.z };
 
 			for (int i = 0; i < CHILD_COUNT; i++)
-				children[i] = std::make_unique<Node>();
+			{
+				children[i] = pool->Allocate();
+				GetChild(i)->pool = pool;
+			}
 
-			dx::BoundingBox::CreateFromPoints(children[0]->bounds, { min.x, min.y, min.z, 0 }, { center.x, center.y, center.z, 0 });
-			dx::BoundingBox::CreateFromPoints(children[1]->bounds, { center.x, min.y, min.z, 0 }, { max.x, center.y, center.z, 0 });
-			dx::BoundingBox::CreateFromPoints(children[2]->bounds, { min.x, min.y, center.z, 0 }, { center.x, center.y, max.z, 0 });
-			dx::BoundingBox::CreateFromPoints(children[3]->bounds, { center.x, min.y, center.z, 0 }, { max.x, center.y, max.z, 0 });
-			dx::BoundingBox::CreateFromPoints(children[4]->bounds, { min.x, center.y, min.z, 0 }, { center.x, max.y, center.z, 0 });
-			dx::BoundingBox::CreateFromPoints(children[5]->bounds, { center.x, center.y, min.z, 0 }, { max.x, max.y, center.z, 0 });
-			dx::BoundingBox::CreateFromPoints(children[6]->bounds, { min.x, center.y, center.z, 0 }, { center.x, max.y, max.z, 0 });
-			dx::BoundingBox::CreateFromPoints(children[7]->bounds, { center.x, center.y, center.z, 0 }, { max.x, max.y, max.z, 0 });
+			dx::BoundingBox::CreateFromPoints(GetChild(0)->bounds, { min.x, min.y, min.z, 0 }, { center.x, center.y, center.z, 0 });
+			dx::BoundingBox::CreateFromPoints(GetChild(1)->bounds, { center.x, min.y, min.z, 0 }, { max.x, center.y, center.z, 0 });
+			dx::BoundingBox::CreateFromPoints(GetChild(2)->bounds, { min.x, min.y, center.z, 0 }, { center.x, center.y, max.z, 0 });
+			dx::BoundingBox::CreateFromPoints(GetChild(3)->bounds, { center.x, min.y, center.z, 0 }, { max.x, center.y, max.z, 0 });
+			dx::BoundingBox::CreateFromPoints(GetChild(4)->bounds, { min.x, center.y, min.z, 0 }, { center.x, max.y, center.z, 0 });
+			dx::BoundingBox::CreateFromPoints(GetChild(5)->bounds, { center.x, center.y, min.z, 0 }, { max.x, max.y, center.z, 0 });
+			dx::BoundingBox::CreateFromPoints(GetChild(6)->bounds, { min.x, center.y, center.z, 0 }, { center.x, max.y, max.z, 0 });
+			dx::BoundingBox::CreateFromPoints(GetChild(7)->bounds, { center.x, center.y, center.z, 0 }, { max.x, max.y, max.z, 0 });
 
 			for (int i = 0; i < data.size(); i++)
 			{
@@ -64,7 +82,7 @@ private:
 					}
 
 					for (int j = 0; j < CHILD_COUNT; j++)
-						children[j]->Insert(data[i], itemBounds, depth + 1);
+						GetChild(j)->Insert(data[i], itemBounds, depth + 1);
 				}
 			}
 
@@ -91,8 +109,8 @@ private:
 
 			for (int i = 0; i < CHILD_COUNT; i++)
 			{
-				if (children[i] != nullptr)
-					children[i]->Insert(item, itemBounds, depth + 1);
+				if (children[i] != NULL_POOL_NODE)
+					GetChild(i)->Insert(item, itemBounds, depth + 1);
 			}
 
 			return true;
@@ -112,22 +130,22 @@ private:
 
 			for (int i = 0; i < CHILD_COUNT; i++)
 			{
-				if (children[i] != nullptr)
-					children[i]->Remove(item, itemBounds, depth + 1, skipIntersection);
+				if (children[i] != NULL_POOL_NODE)
+					GetChild(i)->Remove(item, itemBounds, depth + 1, skipIntersection);
 			}
 
 			std::vector<Entity *> containingItems;
 			containingItems.reserve(MAX_ITEMS_IN_NODE);
 			for (int i = 0; i < CHILD_COUNT; i++)
 			{
-				if (children[i] != nullptr)
+				if (children[i] != NULL_POOL_NODE)
 				{
-					if (!children[i]->isLeaf)
+					if (!GetChild(i)->isLeaf)
 						return;
 
-					if (!children[i]->data.empty())
+					if (!GetChild(i)->data.empty())
 					{
-						for (Entity *childItem : children[i]->data)
+						for (Entity *childItem : GetChild(i)->data)
 						{
 							if (childItem == nullptr)
 								continue;
@@ -144,10 +162,11 @@ private:
 				}
 			}
 
+			// Children are all leaves at this point, so freeing them releases the whole subtree.
 			for (int i = 0; i < CHILD_COUNT; i++)
 			{
-				children[i].release();
-				children[i] = nullptr;
+				pool->Free(children[i]);
+				children[i] = NULL_POOL_NODE;
 			}
 
 			isLeaf = true;
@@ -166,7 +185,7 @@ private:
 					if (item == nullptr)
 						continue;
 
-					if (std::ranges::find(containingItems, item) == containingItems.end())
+					if (CullStamp::Visit(item))
 						containingItems.emplace_back(item);
 				}
 
@@ -175,10 +194,10 @@ private:
 
 			for (int i = 0; i < CHILD_COUNT; i++)
 			{
-				if (children[i] == nullptr)
+				if (children[i] == NULL_POOL_NODE)
 					continue;
 
-				children[i]->AddToVector(containingItems, depth + 1);
+				GetChild(i)->AddToVector(containingItems, depth + 1);
 			}
 		}
 
@@ -201,7 +220,7 @@ private:
 						if (item == nullptr)
 							continue;
 
-						if (std::ranges::find(containingItems, item) == containingItems.end())
+						if (CullStamp::Visit(item))
 							containingItems.emplace_back(item);
 					}
 
@@ -210,10 +229,10 @@ private:
 
 				for (int i = 0; i < CHILD_COUNT; i++)
 				{
-					if (children[i] == nullptr)
+					if (children[i] == NULL_POOL_NODE)
 						continue;
 
-					children[i]->FrustumCull(frustum, containingItems, depth + 1);
+					GetChild(i)->FrustumCull(frustum, containingItems, depth + 1);
 				}
 				break;
 			}
@@ -238,7 +257,7 @@ private:
 						if (item == nullptr)
 							continue;
 
-						if (std::ranges::find(containingItems, item) == containingItems.end())
+						if (CullStamp::Visit(item))
 							containingItems.emplace_back(item);
 					}
 
@@ -247,10 +266,10 @@ private:
 
 				for (int i = 0; i < CHILD_COUNT; i++)
 				{
-					if (children[i] == nullptr)
+					if (children[i] == NULL_POOL_NODE)
 						continue;
 
-					children[i]->BoxCull(box, containingItems, depth + 1);
+					GetChild(i)->BoxCull(box, containingItems, depth + 1);
 				}
 				break;
 			}
@@ -275,7 +294,7 @@ private:
 						if (item == nullptr)
 							continue;
 
-						if (std::ranges::find(containingItems, item) == containingItems.end())
+						if (CullStamp::Visit(item))
 							containingItems.emplace_back(item);
 					}
 
@@ -284,10 +303,47 @@ private:
 
 				for (int i = 0; i < CHILD_COUNT; i++)
 				{
-					if (children[i] == nullptr)
+					if (children[i] == NULL_POOL_NODE)
 						continue;
 
-					children[i]->BoxCull(box, containingItems, depth + 1);
+					GetChild(i)->BoxCull(box, containingItems, depth + 1);
+				}
+				break;
+			}
+		}
+
+		void SphereCull(const dx::BoundingSphere &sphere, std::vector<Entity *> &containingItems, const UINT depth = 0) const
+		{
+			switch (sphere.Contains(bounds))
+			{
+			case dx::DISJOINT:
+				return;
+
+			case dx::CONTAINS:
+				AddToVector(containingItems, depth + 1);
+				break;
+
+			case dx::INTERSECTS:
+				if (isLeaf)
+				{
+					for (Entity *item : data)
+					{
+						if (item == nullptr)
+							continue;
+
+						if (CullStamp::Visit(item))
+							containingItems.emplace_back(item);
+					}
+
+					return;
+				}
+
+				for (int i = 0; i < CHILD_COUNT; i++)
+				{
+					if (children[i] == NULL_POOL_NODE)
+						continue;
+
+					GetChild(i)->SphereCull(sphere, containingItems, depth + 1);
 				}
 				break;
 			}
@@ -330,7 +386,7 @@ private:
 			int childHitCount = CHILD_COUNT;
 			for (int i = 0; i < childHitCount; i++)
 			{
-				const Node *child = children[childHits[i].index].get();
+				const Node *child = GetChild(childHits[i].index);
 				if (Raycast(orig, dir, child->bounds, childHits[i].length))
 					continue;
 
@@ -361,7 +417,7 @@ private:
 				if (length < childHits[i].length)
 					return true;
 
-				if (!children[childHits[i].index]->RaycastNode(orig, dir, length, entity))
+				if (!GetChild(childHits[i].index)->RaycastNode(orig, dir, length, entity))
 				{
 					length = FLT_MAX;
 					entity = nullptr;
@@ -380,11 +436,12 @@ private:
 			}
 
 			for (int i = 0; i < CHILD_COUNT; i++)
-				children[i]->DebugGetStructure(boxCollection);
+				GetChild(i)->DebugGetStructure(boxCollection);
 		}
 	};
 
-	std::unique_ptr<Node> _root;
+	std::unique_ptr<NodePool<Node>> _nodePool;
+	Node *_root = nullptr;
 
 
 public:
@@ -397,7 +454,10 @@ public:
 
 	[[nodiscard]] bool Initialize(const dx::BoundingBox &sceneBounds)
 	{
-		_root = std::make_unique<Node>();
+		_nodePool = std::make_unique<NodePool<Node>>("Octree Nodes");
+
+		_root = &(*_nodePool)[_nodePool->Allocate()];
+		_root->pool = _nodePool.get();
 		_root->bounds = sceneBounds;
 
 		return true;
@@ -431,21 +491,38 @@ public:
 		return true;
 	}
 
+	[[nodiscard]] bool Move(Entity *data, const dx::BoundingOrientedBox &bounds) const
+	{
+		if (!Remove(data))
+			return false;
+
+		Insert(data, bounds);
+		return true;
+	}
+
 
 	[[nodiscard]] bool FrustumCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems) const
 	{
 		if (_root == nullptr)
 			return false;
 
+		CullStamp::BeginQuery();
 		_root->FrustumCull(frustum, containingItems);
 		return true;
 	}
 
+	// Plane masking and plane caching only apply to Quadtree, other options fall back to a regular cull.
+	[[nodiscard]] bool FrustumCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems, const FrustumCullOptions &options) const
+	{
+		return FrustumCull(frustum, containingItems);
+	}
+
 	[[nodiscard]] bool BoxCull(const dx::BoundingOrientedBox &box, std::vector<Entity *> &containingItems) const
 	{
 		if (_root == nullptr)
 			return false;
 
+		CullStamp::BeginQuery();
 		_root->BoxCull(box, containingItems);
 		return true;
 	}
@@ -455,10 +532,90 @@ public:
 		if (_root == nullptr)
 			return false;
 
+		CullStamp::BeginQuery();
 		_root->BoxCull(box, containingItems);
 		return true;
 	}
 
+	[[nodiscard]] bool SphereCull(const dx::BoundingSphere &sphere, std::vector<Entity *> &containingItems) const
+	{
+		if (_root == nullptr)
+			return false;
+
+		CullStamp::BeginQuery();
+		_root->SphereCull(sphere, containingItems);
+		return true;
+	}
+
+	// Best-first search, visiting nodes in order of distance until none can be closer than the k-th candidate.
+	[[nodiscard]] bool FindNearest(NearestQuery &query) const
+	{
+		if (_root == nullptr)
+			return false;
+
+		using NodeEntry = std::pair<float, const Node *>;
+		std::priority_queue<NodeEntry, std::vector<NodeEntry>, std::greater<NodeEntry>> queue;
+		queue.emplace(query.DistanceSq(_root->bounds), _root);
+
+		while (!queue.empty())
+		{
+			const auto [distanceSq, node] = queue.top();
+			queue.pop();
+
+			if (distanceSq > query.GetBoundSq())
+				break;
+
+			if (node->isLeaf)
+			{
+				for (Entity *item : node->data)
+					query.Offer(item);
+				continue;
+			}
+
+			for (int i = 0; i < CHILD_COUNT; i++)
+			{
+				const Node *child = node->GetChild(i);
+				if (!child)
+					continue;
+
+				const float childDistanceSq = query.DistanceSq(child->bounds);
+				if (childDistanceSq <= query.GetBoundSq())
+					queue.emplace(childDistanceSq, child);
+			}
+		}
+
+		return true;
+	}
+
+	// No batched traversal, each view is culled separately.
+	[[nodiscard]] bool MultiCull(const CullView *views, UINT viewCount, std::vector<Entity *> *containingItems) const
+	{
+		if (_root == nullptr)
+			return false;
+
+		for (UINT i = 0; i < viewCount; i++)
+		{
+			CullStamp::BeginQuery();
+
+			switch (views[i].type)
+			{
+			case CullView::Type::Frustum:
+				_root->FrustumCull(views[i].frustum, containingItems[i]);
+				break;
+
+			case CullView::Type::OrientedBox:
+				_root->BoxCull(views[i].orientedBox, containingItems[i]);
+				break;
+
+			case CullView::Type::Box:
+				_root->BoxCull(views[i].box, containingItems[i]);
+				break;
+			}
+		}
+
+		return true;
+	}
+
 
 	bool RaycastTree(const dx::XMFLOAT3A &orig, const dx::XMFLOAT3A &dir, float &length, Entity *&entity) const
 	{
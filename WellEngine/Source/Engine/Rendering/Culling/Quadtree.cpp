@@ -89,7 +89,7 @@ bool Quadtree::Node::RaycastNode(const dx::XMFLOAT3 &orig, const dx::XMFLOAT3 &d
 	int childHitCount = CHILD_COUNT;
 	for (int i = 0; i < childHitCount; i++)
 	{
-		const Node *child = children[childHits[i].index].get();
+		const Node *child = GetChild(childHits[i].index);
 		if (Raycast(orig, dir, child->bounds, childHits[i].length))
 			continue;
 
@@ -120,7 +120,7 @@ bool Quadtree::Node::RaycastNode(const dx::XMFLOAT3 &orig, const dx::XMFLOAT3 &d
 		if (length < childHits[i].length)
 			return true;
 
-		if (!children[childHits[i].index]->RaycastNode(orig, dir, length, entity, cheap))
+		if (!GetChild(childHits[i].index)->RaycastNode(orig, dir, length, entity, cheap))
 		{
 			length = FLT_MAX;
 			entity = nullptr;
@@ -191,7 +191,7 @@ bool Quadtree::Node::RaycastNode(const Shape::Ray &ray, Shape::RayHit &hit, Enti
 	int childHitCount = CHILD_COUNT;
 	for (int i = 0; i < childHitCount; i++)
 	{
-		const Node *child = children[childHits[i].index].get();
+		const Node *child = GetChild(childHits[i].index);
 		if (Raycast(ray.origin, ray.direction, child->bounds, childHits[i].length))
 			continue;
 
@@ -220,7 +220,7 @@ bool Quadtree::Node::RaycastNode(const Shape::Ray &ray, Shape::RayHit &hit, Enti
 	// Check children in order of closest to furthest.
 	for (int i = 0; i < childHitCount; i++)
 	{
-		if (children[childHits[i].index]->RaycastNode(ray, newHit, newEnt))
+		if (GetChild(childHits[i].index)->RaycastNode(ray, newHit, newEnt))
 		{
 			if (newHit.length >= hit.length)
 				continue;
@@ -234,6 +234,264 @@ bool Quadtree::Node::RaycastNode(const Shape::Ray &ray, Shape::RayHit &hit, Enti
 	return (ent != nullptr);
 }
 
+UINT Quadtree::Node::RaycastPacket(const RayPacket &packet, UINT mask, Shape::RayHit *hits, Entity **ents) const
+{
+	if (isEmpty)
+		return 0;
+
+	// Too few rays left for SIMD to pay off, trace them one at a time.
+	if (RayPacket::GetLaneCount(mask) < RAY_PACKET_MIN_LANES)
+	{
+		UINT hitMask = 0;
+		for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+		{
+			if (!(mask & (1u << lane)))
+				continue;
+
+			Entity *newEnt = nullptr;
+			Shape::RayHit newHit = hits[lane];
+
+			if (!RaycastNode(packet.rays[lane], newHit, newEnt))
+				continue;
+
+			hits[lane] = newHit;
+			ents[lane] = newEnt;
+			hitMask |= 1u << lane;
+		}
+		return hitMask;
+	}
+
+	ZoneScopedXC(RandomUniqueColor());
+
+	if (isLeaf)
+	{
+		UINT hitMask = 0;
+
+		// Check all items in leaf for intersection & return result.
+		for (Entity *item : data)
+		{
+			if (item == nullptr)
+				continue;
+
+			if (!item->IsEnabled())
+				continue;
+
+			if (!item->IsDebugSelectable())
+				continue;
+
+			if (!item->IsRaycastTarget())
+				continue;
+
+			MeshBehaviour *meshBehaviour = nullptr;
+			if (!item->GetBehaviourByType<MeshBehaviour>(meshBehaviour))
+				continue;
+
+			MeshD3D11 *mesh = item->GetScene()->GetContent()->GetMesh(meshBehaviour->GetMeshID());
+			const MeshCollider &meshCollider = mesh->GetMeshCollider();
+
+			const dx::XMFLOAT4X4A &meshMatrix = item->GetTransform()->GetMatrix(World);
+			dx::XMFLOAT4X4A meshMatrixInv; Store(meshMatrixInv, XMMatrixInverse(nullptr, Load(meshMatrix)));
+
+			// The inverse is shared by every ray in the packet.
+			Shape::Ray localRays[RAY_PACKET_SIZE];
+			for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+				localRays[lane] = packet.rays[lane].Transformed(meshMatrixInv);
+
+			const RayPacket localPacket(localRays, RAY_PACKET_SIZE);
+			Shape::RayHit localHits[RAY_PACKET_SIZE];
+
+			UINT localMask = meshCollider.RaycastMesh(localPacket, mask, localHits);
+			for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+			{
+				if (!(localMask & (1u << lane)))
+					continue;
+
+				localHits[lane].Transform(meshMatrix);
+
+				if (localHits[lane].length >= hits[lane].length)
+					continue;
+
+				hits[lane] = localHits[lane];
+				ents[lane] = item;
+				hitMask |= 1u << lane;
+			}
+		}
+
+		return hitMask;
+	}
+
+	struct ChildHit { int index; UINT mask; float length; dx::XMFLOAT4 entry; };
+	ChildHit childHits[CHILD_COUNT];
+	int childHitCount = 0;
+
+	const dx::XMVECTOR maxLengths = RayPacket::LoadLengths(hits);
+	for (int i = 0; i < CHILD_COUNT; i++)
+	{
+		const Node *child = GetChild(i);
+		if (!child || child->isEmpty)
+			continue;
+
+		dx::XMVECTOR entry;
+		UINT childMask = packet.Intersects(child->bounds, mask, maxLengths, entry);
+		if (!childMask)
+			continue;
+
+		ChildHit &childHit = childHits[childHitCount++];
+		childHit.index = i;
+		childHit.mask = childMask;
+		dx::XMStoreFloat4(&childHit.entry, entry);
+
+		childHit.length = FLT_MAX;
+		for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+		{
+			if (childMask & (1u << lane))
+				childHit.length = std::min<float>(childHit.length, (&childHit.entry.x)[lane]);
+		}
+	}
+
+	// Insertion sort by the closest entry of any lane.
+	for (int i = 1; i < childHitCount; i++)
+	{
+		int j = i;
+		while (childHits[j].length < childHits[j - 1].length)
+		{
+			std::swap(childHits[j], childHits[j - 1]);
+			if (--j <= 0)
+				break;
+		}
+	}
+
+	// Check children in order of closest to furthest, dropping lanes that have since hit something closer.
+	UINT hitMask = 0;
+	for (int i = 0; i < childHitCount; i++)
+	{
+		UINT childMask = childHits[i].mask;
+		for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+		{
+			if ((childMask & (1u << lane)) && (&childHits[i].entry.x)[lane] > hits[lane].length)
+				childMask &= ~(1u << lane);
+		}
+
+		if (childMask)
+			hitMask |= GetChild(childHits[i].index)->RaycastPacket(packet, childMask, hits, ents);
+	}
+
+	return hitMask;
+}
+
+void Quadtree::Node::Build(const BuildItem *items, const std::vector<UINT> &itemIndices, const UINT depth, std::vector<BuildTask> *deferredTasks)
+{
+	ZoneScopedXC(RandomUniqueColor());
+
+	isDirty = true;
+	isEmpty = itemIndices.empty();
+
+	if (depth >= MAX_DEPTH || itemIndices.size() <= MAX_ITEMS_IN_NODE)
+	{
+		isLeaf = true;
+		data.reserve(itemIndices.size());
+
+		for (UINT index : itemIndices)
+			data.emplace_back(items[index].entity);
+
+		return;
+	}
+
+	// The pool is shared with the other subtrees being built. Its blocks are preallocated by Quadtree::Build(),
+	// so only the free list and counters need the lock.
+	{
+		static std::mutex allocateMutex;
+		std::lock_guard<std::mutex> lock(allocateMutex);
+
+		for (UINT i = 0; i < CHILD_COUNT; i++)
+			children[i] = pool->Allocate();
+	}
+
+	const dx::XMFLOAT3
+		center = bounds.Center,
+		extents = bounds.Extents,
+		min = { center.x - extents.x, center.y - extents.y, center.z - extents.z },
+		max = { center.x + extents.x, center.y + extents.y, center.z + extents.z };
+
+	for (UINT i = 0; i < CHILD_COUNT; i++)
+	{
+		Node *child = GetChild(i);
+		child->pool = pool;
+		child->path = path.GetChild(i);
+	}
+
+	dx::BoundingBox::CreateFromPoints(GetChild(0)->bounds, { min.x, min.y, min.z, 0 }, { center.x, max.y, center.z, 0 });
+	dx::BoundingBox::CreateFromPoints(GetChild(1)->bounds, { center.x, min.y, min.z, 0 }, { max.x, max.y, center.z, 0 });
+	dx::BoundingBox::CreateFromPoints(GetChild(2)->bounds, { min.x, min.y, center.z, 0 }, { center.x, max.y, max.z, 0 });
+	dx::BoundingBox::CreateFromPoints(GetChild(3)->bounds, { center.x, min.y, center.z, 0 }, { max.x, max.y, max.z, 0 });
+
+	isLeaf = false;
+
+	for (UINT i = 0; i < CHILD_COUNT; i++)
+	{
+		Node *child = GetChild(i);
+
+		// Like Insert(), items go into every child they overlap.
+		std::vector<UINT> childIndices;
+		childIndices.reserve(itemIndices.size());
+
+		for (UINT index : itemIndices)
+		{
+			if (child->bounds.Intersects(items[index].bounds))
+				childIndices.emplace_back(index);
+		}
+
+		if (deferredTasks && depth + 1 >= PARALLEL_BUILD_DEPTH)
+			deferredTasks->push_back({ child, std::move(childIndices), depth + 1 });
+		else
+			child->Build(items, childIndices, depth + 1, deferredTasks);
+	}
+}
+
+void Quadtree::Build(const std::vector<BuildItem> &items)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (_root == nullptr)
+		return;
+
+	_root->SetItemPaths(false);
+
+	const dx::BoundingBox sceneBounds = _root->bounds;
+
+	// Reserving the largest possible tree allocates every block up front, so subtrees built in parallel never grow the pool.
+	_nodePool->Clear();
+	_nodePool->Reserve(MAX_NODE_COUNT);
+
+	_root = &(*_nodePool)[_nodePool->Allocate()];
+	_root->pool = _nodePool.get();
+	_root->bounds = sceneBounds;
+
+	std::vector<UINT> itemIndices;
+	itemIndices.reserve(items.size());
+
+	for (UINT i = 0; i < static_cast<UINT>(items.size()); i++)
+	{
+		items[i].entity->UpdateCullingBounds();
+
+		if (!sceneBounds.Intersects(items[i].bounds))
+			continue;
+
+		itemIndices.emplace_back(i);
+	}
+
+	// Build the upper levels, then the subtrees below them in parallel.
+	std::vector<BuildTask> tasks;
+	_root->Build(items.data(), itemIndices, 0, &tasks);
+
+	JobSystem::Instance().ParallelFor(static_cast<UINT>(tasks.size()), 1, [&](UINT begin, UINT end) {
+		for (UINT i = begin; i < end; i++)
+			tasks[i].node->Build(items.data(), tasks[i].items, tasks[i].depth, nullptr);
+	}, "Build Subtrees");
+
+	_root->SetItemPaths(true);
+}
+
 #ifdef USE_IMGUI
 #include "Scenes/Scene.h"
 #include "Behaviours/DebugPlayerBehaviour.h"
@@ -333,7 +591,7 @@ bool Quadtree::Node::RenderUI(std::string &path, bool drawFullPath, bool drawDat
 
 		path = std::format("{}->{}", path, selectedChildName);
 
-		if (!children[selectedChild]->RenderUI(path, 
+		if (!GetChild(selectedChild)->RenderUI(path, 
 			drawFullPath || (recursiveDraw && drawBounds), 
 			drawDataRec || (recursiveDraw && drawData), 
 			depth + 1))
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <queue>
 #include <utility>
 #include <vector>
 #include <DirectXCollision.h>
@@ -8,7 +9,13 @@
 #include "Entity.h"
 #include "Behaviour.h"
 #include "Collision/Raycast.h"
+#include "Collision/RayPacket.h"
 #include "Behaviours/MeshBehaviour.h"
+#include "CullStamp.h"
+#include "CullView.h"
+#include "FrustumPlanes.h"
+#include "NearestQuery.h"
+#include "Utils/NodePool.h"
 
 #ifdef LEAK_DETECTION
 #define new			DEBUG_NEW
@@ -19,17 +26,52 @@ class Quadtree
 public:
 	static constexpr UINT MAX_DEPTH = 5;
 
+	struct BuildItem
+	{
+		Entity *entity;
+		dx::BoundingOrientedBox bounds;
+	};
+
 private:
 	static constexpr UINT MAX_ITEMS_IN_NODE = 16;
 	static constexpr UINT CHILD_COUNT = 4;
 
+	// Node count of a tree split down to MAX_DEPTH everywhere.
+	static constexpr UINT MAX_NODE_COUNT = ((1u << (2 * (MAX_DEPTH + 1))) - 1) / 3;
+
+	// Subtrees below this depth are built in parallel by Build().
+	static constexpr UINT PARALLEL_BUILD_DEPTH = 2;
+
+	struct Node;
+	struct BuildTask
+	{
+		Node *node;
+		std::vector<UINT> items;
+		UINT depth;
+	};
+
+	static_assert(MAX_DEPTH <= TreePath::MAX_STEPS, "TreePath cannot represent the full depth of the tree.");
+
 	struct Node
 	{
 		std::vector<Entity *> data;
 		dx::BoundingBox bounds, cullingBounds;
-		std::unique_ptr<Node> children[CHILD_COUNT];
+		TreePath path;
+		NodePool<Node> *pool = nullptr;
+		UINT children[CHILD_COUNT] = { NULL_POOL_NODE, NULL_POOL_NODE, NULL_POOL_NODE, NULL_POOL_NODE };
 		bool isLeaf = true, isDirty = true, isEmpty = true;
 
+		// Plane that last rejected this node, per frustum cull cache slot.
+		mutable UINT8 lastFailPlane[FrustumCullOptions::MAX_CACHE_SLOTS] = {
+			FrustumPlanes::NO_PLANE, FrustumPlanes::NO_PLANE, FrustumPlanes::NO_PLANE, FrustumPlanes::NO_PLANE,
+			FrustumPlanes::NO_PLANE, FrustumPlanes::NO_PLANE, FrustumPlanes::NO_PLANE, FrustumPlanes::NO_PLANE
+		};
+
+		[[nodiscard]] inline Node *GetChild(UINT i) const
+		{
+			return (children[i] == NULL_POOL_NODE) ? nullptr : &(*pool)[children[i]];
+		}
+
 #ifdef USE_IMGUI
 		bool drawBounds = false;
 		bool recursiveDraw = false;
@@ -49,20 +91,26 @@ private:
 				min = { center.x - extents.x, center.y - extents.y, center.z - extents.z },
 				max = { center.x + extents.x, center.y + extents.y, center.z + extents.z };
 
-			children[0] = std::make_unique<Node>();
-			children[1] = std::make_unique<Node>();
-			children[2] = std::make_unique<Node>();
-			children[3] = std::make_unique<Node>();
+			for (UINT i = 0; i < CHILD_COUNT; i++)
+			{
+				children[i] = pool->Allocate();
+
+				Node *child = GetChild(i);
+				child->pool = pool;
+				child->path = path.GetChild(i);
+			}
 
-			dx::BoundingBox::CreateFromPoints(children[0]->bounds, { min.x, min.y, min.z, 0 }, { center.x, max.y, center.z, 0 });
-			dx::BoundingBox::CreateFromPoints(children[1]->bounds, { center.x, min.y, min.z, 0 }, { max.x, max.y, center.z, 0 });
-			dx::BoundingBox::CreateFromPoints(children[2]->bounds, { min.x, min.y, center.z, 0 }, { center.x, max.y, max.z, 0 });
-			dx::BoundingBox::CreateFromPoints(children[3]->bounds, { center.x, min.y, center.z, 0 }, { max.x, max.y, max.z, 0 });
+			dx::BoundingBox::CreateFromPoints(GetChild(0)->bounds, { min.x, min.y, min.z, 0 }, { center.x, max.y, center.z, 0 });
+			dx::BoundingBox::CreateFromPoints(GetChild(1)->bounds, { center.x, min.y, min.z, 0 }, { max.x, max.y, center.z, 0 });
+			dx::BoundingBox::CreateFromPoints(GetChild(2)->bounds, { min.x, min.y, center.z, 0 }, { center.x, max.y, max.z, 0 });
+			dx::BoundingBox::CreateFromPoints(GetChild(3)->bounds, { center.x, min.y, center.z, 0 }, { max.x, max.y, max.z, 0 });
 
 			for (int i = 0; i < data.size(); i++)
 			{
 				if (data[i] != nullptr)
 				{
+					data[i]->RemoveCullingTreePath(path);
+
 					bool hasBounds = false;
 					dx::BoundingOrientedBox itemBounds;
 					if (!data[i]->HasBounds(false, itemBounds))
@@ -73,7 +121,7 @@ private:
 					}
 
 					for (int j = 0; j < CHILD_COUNT; j++)
-						children[j]->Insert(data[i], itemBounds, depth + 1);
+						GetChild(j)->Insert(data[i], itemBounds, depth + 1);
 				}
 			}
 
@@ -98,6 +146,7 @@ private:
 				if (depth >= MAX_DEPTH || data.size() < MAX_ITEMS_IN_NODE)
 				{
 					data.emplace_back(item);
+					item->AddCullingTreePath(path);
 					return true;
 				}
 
@@ -106,8 +155,8 @@ private:
 
 			for (int i = 0; i < CHILD_COUNT; i++)
 			{
-				if (children[i])
-					children[i]->Insert(item, itemBounds, depth + 1);
+				if (children[i] != NULL_POOL_NODE)
+					GetChild(i)->Insert(item, itemBounds, depth + 1);
 			}
 
 			return true;
@@ -126,7 +175,10 @@ private:
 				size_t num = std::erase_if(data, [item](const Entity *otherItem) { return item == otherItem; });
 
 				if (num > 0)
+				{
+					item->RemoveCullingTreePath(path);
 					isDirty = true;
+				}
 
 				return;
 			}
@@ -135,22 +187,66 @@ private:
 
 			for (int i = 0; i < CHILD_COUNT; i++)
 			{
-				if (children[i])
-					children[i]->Remove(item, itemBounds, depth + 1, skipIntersection);
+				if (children[i] != NULL_POOL_NODE)
+					GetChild(i)->Remove(item, itemBounds, depth + 1, skipIntersection);
+			}
+
+			TryMerge();
+		}
+
+		// Follows the given path straight to the leaf holding the item. Returns false if the path does not match the tree.
+		bool RemoveAlongPath(Entity *item, const TreePath &itemPath, const UINT depth = 0)
+		{
+			ZoneScopedXC(RandomUniqueColor());
+
+			if (isLeaf)
+			{
+				if (depth != itemPath.GetDepth())
+					return false;
+
+				size_t num = std::erase_if(data, [item](const Entity *otherItem) { return item == otherItem; });
+				item->RemoveCullingTreePath(itemPath);
+
+				if (num == 0)
+					return false;
+
+				isDirty = true;
+				return true;
 			}
 
+			if (depth >= itemPath.GetDepth())
+				return false;
+
+			Node *child = GetChild(itemPath.GetStep(depth));
+			if (child == nullptr)
+				return false;
+
+			const bool removed = child->RemoveAlongPath(item, itemPath, depth + 1);
+
+			isDirty = true;
+			TryMerge();
+
+			return removed;
+		}
+
+		// Collapses the children into this node if their combined items fit in a single leaf.
+		void TryMerge()
+		{
+			if (isLeaf)
+				return;
+
 			std::vector<Entity *> containingItems;
 			containingItems.reserve(MAX_ITEMS_IN_NODE);
 
 			for (int i = 0; i < CHILD_COUNT; i++)
-				if (children[i])
+				if (children[i] != NULL_POOL_NODE)
 				{
-					if (!children[i]->isLeaf)
+					if (!GetChild(i)->isLeaf)
 						return;
 
-					if (!children[i]->data.empty())
+					if (!GetChild(i)->data.empty())
 					{
-						for (Entity *childItem : children[i]->data)
+						for (Entity *childItem : GetChild(i)->data)
 						{
 							if (!childItem)
 								continue;
@@ -167,12 +263,76 @@ private:
 				}
 
 			for (int i = 0; i < CHILD_COUNT; i++)
-				children[i] = nullptr;
+			{
+				if (children[i] == NULL_POOL_NODE)
+					continue;
+
+				for (Entity *childItem : GetChild(i)->data)
+				{
+					if (childItem)
+						childItem->RemoveCullingTreePath(GetChild(i)->path);
+				}
+
+				pool->Free(children[i]);
+				children[i] = NULL_POOL_NODE;
+			}
 
 			isLeaf = true;
 			data.clear();
 			for (Entity *newItem : containingItems)
+			{
 				data.emplace_back(newItem);
+				newItem->AddCullingTreePath(path);
+			}
+		}
+
+		// Builds the subtree top-down from the given indices into items, splitting wherever they do not fit in one leaf.
+		// If deferredTasks is set, subtrees at PARALLEL_BUILD_DEPTH are added to it instead of being built.
+		// Item paths are not registered, as several threads may share an item. See SetItemPaths().
+		void Build(const BuildItem *items, const std::vector<UINT> &itemIndices, const UINT depth, std::vector<BuildTask> *deferredTasks);
+
+		void SetItemPaths(bool add) const
+		{
+			if (isLeaf)
+			{
+				for (Entity *item : data)
+				{
+					if (item == nullptr)
+						continue;
+
+					if (add)
+						item->AddCullingTreePath(path);
+					else
+						item->RemoveCullingTreePath(path);
+				}
+
+				return;
+			}
+
+			for (int i = 0; i < CHILD_COUNT; i++)
+			{
+				if (children[i] != NULL_POOL_NODE)
+					GetChild(i)->SetItemPaths(add);
+			}
+		}
+
+		// Counts the leaves below this node that would receive an item with the given bounds.
+		[[nodiscard]] UINT CountIntersectingLeaves(const dx::BoundingOrientedBox &itemBounds) const
+		{
+			if (!bounds.Intersects(itemBounds))
+				return 0;
+
+			if (isLeaf)
+				return 1;
+
+			UINT count = 0;
+			for (int i = 0; i < CHILD_COUNT; i++)
+			{
+				if (children[i] != NULL_POOL_NODE)
+					count += GetChild(i)->CountIntersectingLeaves(itemBounds);
+			}
+
+			return count;
 		}
 
 
@@ -249,14 +409,14 @@ private:
 			else
 			{
 				for (int i = 0; i < CHILD_COUNT; i++)
-					children[i].get()->RecalculateCullingBounds();
+					GetChild(i)->RecalculateCullingBounds();
 
 				// Combine all children bounds into this node's culling bounds
 				dx::BoundingBox *nonEmpty[CHILD_COUNT]{};
 				UINT added = 0;
 				for (int i = 0; i < CHILD_COUNT; i++)
 				{
-					auto child = children[i].get();
+					auto child = GetChild(i);
 					if (child->isEmpty)
 						continue;
 
@@ -281,7 +441,7 @@ private:
 			}
 		}
 
-		void AddToVector(std::vector<Entity *> &containingItems, const UINT depth) const
+		void AddToVector(std::vector<Entity *> &containingItems, const UINT depth, const UINT view = 0) const
 		{
 			if (isEmpty)
 				return;
@@ -296,7 +456,7 @@ private:
 					if (!item->IsEnabled())
 						continue;
 
-					if (std::ranges::find(containingItems, item) == containingItems.end())
+					if (CullStamp::Visit(item, view))
 						containingItems.emplace_back(item);
 				}
 
@@ -305,10 +465,84 @@ private:
 
 			for (int i = 0; i < CHILD_COUNT; i++)
 			{
-				if (children[i] == nullptr)
+				if (children[i] == NULL_POOL_NODE)
+					continue;
+
+				GetChild(i)->AddToVector(containingItems, depth + 1, view);
+			}
+		}
+
+		// Culls several views in one traversal. viewMask holds the views that still intersect this node.
+		void MultiCull(const CullView *views, UINT64 viewMask, std::vector<Entity *> *containingItems, const UINT depth = 0) const
+		{
+			if (isEmpty)
+				return;
+
+			ZoneScopedXC(RandomUniqueColor());
+
+			UINT64 intersectMask = 0;
+			for (UINT64 remaining = viewMask; remaining != 0; remaining &= remaining - 1)
+			{
+				const UINT view = CullView::NextView(remaining);
+
+				switch (views[view].Contains(cullingBounds))
+				{
+				case dx::DISJOINT:
+					break;
+
+				case dx::CONTAINS:
+					AddToVector(containingItems[view], depth + 1, view);
+					break;
+
+				case dx::INTERSECTS:
+					intersectMask |= 1ull << view;
+					break;
+				}
+			}
+
+			if (intersectMask == 0)
+				return;
+
+			if (isLeaf)
+			{
+				for (Entity *item : data)
+				{
+					if (item == nullptr)
+						continue;
+
+					if (!item->IsEnabled())
+						continue;
+
+#ifdef EXTRA_CULL_CHECK
+					dx::BoundingOrientedBox itemBounds;
+					item->StoreEntityBounds(itemBounds);
+#endif
+
+					for (UINT64 remaining = intersectMask; remaining != 0; remaining &= remaining - 1)
+					{
+						const UINT view = CullView::NextView(remaining);
+
+						if (!CullStamp::Visit(item, view))
+							continue;
+
+#ifdef EXTRA_CULL_CHECK
+						if (!views[view].Intersects(itemBounds))
+							continue;
+#endif
+
+						containingItems[view].emplace_back(item);
+					}
+				}
+
+				return;
+			}
+
+			for (int i = 0; i < CHILD_COUNT; i++)
+			{
+				if (children[i] == NULL_POOL_NODE)
 					continue;
 
-				children[i]->AddToVector(containingItems, depth + 1);
+				GetChild(i)->MultiCull(views, intersectMask, containingItems, depth + 1);
 			}
 		}
 
@@ -339,7 +573,68 @@ private:
 						if (!item->IsEnabled())
 							continue;
 
-						if (std::ranges::find(containingItems, item) == containingItems.end())
+						if (CullStamp::Visit(item))
+						{
+#ifdef EXTRA_CULL_CHECK
+							dx::BoundingOrientedBox itemBounds;
+							item->StoreEntityBounds(itemBounds);
+
+							if (frustum.Intersects(itemBounds))
+								containingItems.emplace_back(item);
+#else
+							containingItems.emplace_back(item);
+#endif
+						}
+					}
+
+					return;
+				}
+
+				for (int i = 0; i < CHILD_COUNT; i++)
+				{
+					if (children[i] == NULL_POOL_NODE)
+						continue;
+
+					GetChild(i)->FrustumCull(frustum, containingItems, depth + 1);
+				}
+				break;
+			}
+		}
+
+		void FrustumCull(const dx::BoundingFrustum &frustum, const FrustumPlanes &planes, const FrustumCullOptions &options,
+			UINT8 planeMask, std::vector<Entity *> &containingItems, const UINT depth = 0) const
+		{
+			if (isEmpty)
+				return;
+
+			ZoneScopedXC(RandomUniqueColor());
+
+			UINT8 *lastFail = nullptr;
+			if (options.cacheSlot < FrustumCullOptions::MAX_CACHE_SLOTS)
+				lastFail = &lastFailPlane[options.cacheSlot];
+
+			UINT8 straddledMask;
+			switch (planes.Test(cullingBounds, planeMask, straddledMask, lastFail))
+			{
+			case dx::DISJOINT:
+				return;
+
+			case dx::CONTAINS:
+				AddToVector(containingItems, depth + 1);
+				break;
+
+			case dx::INTERSECTS:
+				if (isLeaf)
+				{
+					for (Entity *item : data)
+					{
+						if (item == nullptr)
+							continue;
+
+						if (!item->IsEnabled())
+							continue;
+
+						if (CullStamp::Visit(item))
 						{
 #ifdef EXTRA_CULL_CHECK
 							dx::BoundingOrientedBox itemBounds;
@@ -356,12 +651,15 @@ private:
 					return;
 				}
 
+				if (options.planeMasking)
+					planeMask = straddledMask;
+
 				for (int i = 0; i < CHILD_COUNT; i++)
 				{
-					if (children[i] == nullptr)
+					if (children[i] == NULL_POOL_NODE)
 						continue;
 
-					children[i]->FrustumCull(frustum, containingItems, depth + 1);
+					GetChild(i)->FrustumCull(frustum, planes, options, planeMask, containingItems, depth + 1);
 				}
 				break;
 			}
@@ -394,7 +692,7 @@ private:
 						if (!item->IsEnabled())
 							continue;
 
-						if (std::ranges::find(containingItems, item) == containingItems.end())
+						if (CullStamp::Visit(item))
 						{
 #ifdef EXTRA_CULL_CHECK
 							dx::BoundingOrientedBox itemBounds;
@@ -413,10 +711,10 @@ private:
 
 				for (int i = 0; i < CHILD_COUNT; i++)
 				{
-					if (children[i] == nullptr)
+					if (children[i] == NULL_POOL_NODE)
 						continue;
 
-					children[i]->BoxCull(box, containingItems, depth + 1);
+					GetChild(i)->BoxCull(box, containingItems, depth + 1);
 				}
 				break;
 			}
@@ -449,7 +747,7 @@ private:
 						if (!item->IsEnabled())
 							continue;
 						
-						if (std::ranges::find(containingItems, item) == containingItems.end())
+						if (CullStamp::Visit(item))
 						{
 #ifdef EXTRA_CULL_CHECK
 							dx::BoundingOrientedBox itemBounds;
@@ -468,10 +766,65 @@ private:
 
 				for (int i = 0; i < CHILD_COUNT; i++)
 				{
-					if (children[i] == nullptr)
+					if (children[i] == NULL_POOL_NODE)
 						continue;
 
-					children[i]->BoxCull(box, containingItems, depth + 1);
+					GetChild(i)->BoxCull(box, containingItems, depth + 1);
+				}
+				break;
+			}
+		}
+
+		void SphereCull(const dx::BoundingSphere &sphere, std::vector<Entity *> &containingItems, const UINT depth = 0) const
+		{
+			if (isEmpty)
+				return;
+
+			ZoneScopedXC(RandomUniqueColor());
+
+			switch (sphere.Contains(cullingBounds))
+			{
+			case dx::DISJOINT:
+				return;
+
+			case dx::CONTAINS:
+				AddToVector(containingItems, depth + 1);
+				break;
+
+			case dx::INTERSECTS:
+				if (isLeaf)
+				{
+					for (Entity *item : data)
+					{
+						if (item == nullptr)
+							continue;
+
+						if (!item->IsEnabled())
+							continue;
+						
+						if (CullStamp::Visit(item))
+						{
+#ifdef EXTRA_CULL_CHECK
+							dx::BoundingOrientedBox itemBounds;
+							item->StoreEntityBounds(itemBounds);
+
+							if (sphere.Intersects(itemBounds))
+								containingItems.emplace_back(item);
+#else
+							containingItems.emplace_back(item);
+#endif
+						}
+					}
+
+					return;
+				}
+
+				for (int i = 0; i < CHILD_COUNT; i++)
+				{
+					if (children[i] == NULL_POOL_NODE)
+						continue;
+
+					GetChild(i)->SphereCull(sphere, containingItems, depth + 1);
 				}
 				break;
 			}
@@ -479,6 +832,7 @@ private:
 
 		bool RaycastNode(const dx::XMFLOAT3 &orig, const dx::XMFLOAT3 &dir, float &length, Entity *&entity, bool cheap) const;
 		bool RaycastNode(const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent) const;
+		UINT RaycastPacket(const RayPacket &packet, UINT mask, Shape::RayHit *hits, Entity **ents) const;
 
 		void DebugGetStructure(std::vector<dx::BoundingBox> &boxCollection, bool full, bool culling) const
 		{
@@ -494,7 +848,7 @@ private:
 			}
 
 			for (int i = 0; i < CHILD_COUNT; i++)
-				children[i]->DebugGetStructure(boxCollection, full, culling);
+				GetChild(i)->DebugGetStructure(boxCollection, full, culling);
 		}
 		void DebugGetStructure(std::vector<dx::BoundingBox> &boxCollection, const dx::BoundingFrustum &frustum, bool full, bool culling) const
 		{
@@ -516,7 +870,7 @@ private:
 				}
 
 				for (int i = 0; i < CHILD_COUNT; i++)
-					children[i]->DebugGetStructure(boxCollection, full, culling);
+					GetChild(i)->DebugGetStructure(boxCollection, full, culling);
 				break;
 
 			case dx::INTERSECTS:
@@ -529,7 +883,7 @@ private:
 				}
 
 				for (int i = 0; i < CHILD_COUNT; i++)
-					children[i]->DebugGetStructure(boxCollection, frustum, full, culling);
+					GetChild(i)->DebugGetStructure(boxCollection, frustum, full, culling);
 				break;
 			}
 		}
@@ -539,7 +893,41 @@ private:
 #endif
 	};
 
-	std::unique_ptr<Node> _root;
+	std::unique_ptr<NodePool<Node>> _nodePool;
+	Node *_root = nullptr;
+
+	// Returns the node at the end of the path, or nullptr if the tree no longer has that shape.
+	[[nodiscard]] Node *GetNode(const TreePath &path) const
+	{
+		Node *node = _root;
+		const UINT depth = path.GetDepth();
+
+		for (UINT i = 0; i < depth && node != nullptr; i++)
+		{
+			if (node->isLeaf)
+				return nullptr;
+
+			node = node->GetChild(path.GetStep(i));
+		}
+
+		return node;
+	}
+
+	void MarkPathDirty(const TreePath &path) const
+	{
+		Node *node = _root;
+		const UINT depth = path.GetDepth();
+
+		for (UINT i = 0; node != nullptr; i++)
+		{
+			node->isDirty = true;
+
+			if (i >= depth || node->isLeaf)
+				break;
+
+			node = node->GetChild(path.GetStep(i));
+		}
+	}
 
 public:
 	Quadtree() = default;
@@ -551,13 +939,25 @@ public:
 
 	[[nodiscard]] bool Initialize(const dx::BoundingBox &sceneBounds)
 	{
-		_root = std::make_unique<Node>();
+		_nodePool = std::make_unique<NodePool<Node>>("Quadtree Nodes");
+
+		_root = &(*_nodePool)[_nodePool->Allocate()];
+		_root->pool = _nodePool.get();
 		_root->bounds = sceneBounds;
 
 		return true;
 	}
 
 
+	[[nodiscard]] bool IsEmpty() const
+	{
+		return _root == nullptr || (_root->isLeaf && _root->data.empty());
+	}
+
+	// Replaces the contents of the tree in a single top-down pass, which is far cheaper than inserting the
+	// items one by one when many are added at once, such as when a scene is loaded.
+	void Build(const std::vector<BuildItem> &items);
+
 	void Insert(Entity *data, const dx::BoundingOrientedBox &bounds) const
 	{
 		ZoneScopedC(RandomUniqueColor());
@@ -572,10 +972,39 @@ public:
 
 	[[nodiscard]] bool Remove(Entity *data, bool skipIntersectionTests = false) const
 	{
-		// TODO: This could be optimized by tracking how many leaf nodes an entity has been inserted into (stored in Entity)
-		// These values would be updated by the leaf nodes upon insertion/removal.
-		// After this is done, removal could be exited early as soon as the entity being removed counts 0 containing nodes.
+		ZoneScopedC(RandomUniqueColor());
+		const std::string &name = data->GetName();
+		ZoneText(name.c_str(), name.size());
 
+		if (_root == nullptr)
+			return false;
+
+		// Every leaf holding the entity is recorded in its tree paths, so removal goes straight to them.
+		// Merging a node may move the entity up into a new leaf, which updates its paths, so always re-read them.
+		bool pathsValid = true;
+		const std::vector<TreePath> &paths = data->GetCullingTreePaths();
+		while (!paths.empty())
+		{
+			const TreePath path = paths.back();
+
+			if (!_root->RemoveAlongPath(data, path))
+			{
+				data->RemoveCullingTreePath(path);
+				pathsValid = false;
+			}
+		}
+
+		// Paths did not match the tree, fall back to searching it.
+		if (!pathsValid)
+			_root->Remove(data, data->GetLastCullingBounds(), 0, skipIntersectionTests);
+
+		return true;
+	}
+
+	// Updates the placement of an entity that has moved. If it still overlaps exactly 
+	// the same leaves, only the culling bounds along its paths are invalidated.
+	[[nodiscard]] bool Move(Entity *data, const dx::BoundingOrientedBox &bounds) const
+	{
 		ZoneScopedC(RandomUniqueColor());
 		const std::string &name = data->GetName();
 		ZoneText(name.c_str(), name.size());
@@ -583,7 +1012,43 @@ public:
 		if (_root == nullptr)
 			return false;
 
-		_root->Remove(data, data->GetLastCullingBounds(), 0, skipIntersectionTests); // TODO: Is this enough?
+		const std::vector<TreePath> &paths = data->GetCullingTreePaths();
+		if (!paths.empty())
+		{
+			TreePath common = paths[0];
+			for (size_t i = 1; i < paths.size(); i++)
+				common = TreePath::GetCommonAncestor(common, paths[i]);
+
+			const Node *ancestor = GetNode(common);
+			bool stillFits = ancestor != nullptr;
+
+			// Leaves outside the common ancestor can only be reached if the entity has left it.
+			if (stillFits && common.GetDepth() > 0)
+				stillFits = ancestor->bounds.Contains(bounds) == dx::CONTAINS;
+
+			for (size_t i = 0; stillFits && i < paths.size(); i++)
+			{
+				const Node *leaf = GetNode(paths[i]);
+				stillFits = leaf != nullptr && leaf->isLeaf && leaf->bounds.Intersects(bounds);
+			}
+
+			if (stillFits)
+				stillFits = ancestor->CountIntersectingLeaves(bounds) == paths.size();
+
+			if (stillFits)
+			{
+				for (const TreePath &path : paths)
+					MarkPathDirty(path);
+
+				data->UpdateCullingBounds();
+				return true;
+			}
+		}
+
+		if (!Remove(data))
+			return false;
+
+		Insert(data, bounds);
 		return true;
 	}
 
@@ -608,15 +1073,32 @@ public:
 		if (_root == nullptr)
 			return false;
 
+		CullStamp::BeginQuery();
 		_root->FrustumCull(frustum, containingItems);
 		return true;
 	}
 
+	[[nodiscard]] bool FrustumCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems, const FrustumCullOptions &options) const
+	{
+		if (options.IsDefault())
+			return FrustumCull(frustum, containingItems);
+
+		if (_root == nullptr)
+			return false;
+
+		const FrustumPlanes planes(frustum);
+
+		CullStamp::BeginQuery();
+		_root->FrustumCull(frustum, planes, options, FrustumPlanes::ALL_PLANES, containingItems);
+		return true;
+	}
+
 	[[nodiscard]] bool BoxCull(const dx::BoundingOrientedBox &box, std::vector<Entity *> &containingItems) const
 	{
 		if (_root == nullptr)
 			return false;
 
+		CullStamp::BeginQuery();
 		_root->BoxCull(box, containingItems);
 		return true;
 	}
@@ -626,10 +1108,83 @@ public:
 		if (_root == nullptr)
 			return false;
 
+		CullStamp::BeginQuery();
 		_root->BoxCull(box, containingItems);
 		return true;
 	}
 
+	[[nodiscard]] bool SphereCull(const dx::BoundingSphere &sphere, std::vector<Entity *> &containingItems) const
+	{
+		if (_root == nullptr)
+			return false;
+
+		CullStamp::BeginQuery();
+		_root->SphereCull(sphere, containingItems);
+		return true;
+	}
+
+	// Best-first search, visiting nodes in order of distance until none can be closer than the k-th candidate.
+	[[nodiscard]] bool FindNearest(NearestQuery &query) const
+	{
+		ZoneScopedC(RandomUniqueColor());
+
+		if (_root == nullptr)
+			return false;
+
+		using NodeEntry = std::pair<float, const Node *>;
+		std::priority_queue<NodeEntry, std::vector<NodeEntry>, std::greater<NodeEntry>> queue;
+		queue.emplace(query.DistanceSq(_root->cullingBounds), _root);
+
+		while (!queue.empty())
+		{
+			const auto [distanceSq, node] = queue.top();
+			queue.pop();
+
+			if (distanceSq > query.GetBoundSq())
+				break;
+
+			if (node->isEmpty)
+				continue;
+
+			if (node->isLeaf)
+			{
+				for (Entity *item : node->data)
+					query.Offer(item);
+				continue;
+			}
+
+			for (int i = 0; i < CHILD_COUNT; i++)
+			{
+				const Node *child = node->GetChild(i);
+				if (!child || child->isEmpty)
+					continue;
+
+				const float childDistanceSq = query.DistanceSq(child->cullingBounds);
+				if (childDistanceSq <= query.GetBoundSq())
+					queue.emplace(childDistanceSq, child);
+			}
+		}
+
+		return true;
+	}
+
+	// Culls up to CullView::MAX_BATCH_SIZE views in a single traversal, writing one result list per view.
+	[[nodiscard]] bool MultiCull(const CullView *views, UINT viewCount, std::vector<Entity *> *containingItems) const
+	{
+		if (_root == nullptr)
+			return false;
+
+		if (viewCount > CullView::MAX_BATCH_SIZE)
+			return false;
+
+		if (viewCount == 0)
+			return true;
+
+		CullStamp::BeginQuery();
+		_root->MultiCull(views, CullView::GetViewMask(viewCount), containingItems);
+		return true;
+	}
+
 	bool RaycastTree(const dx::XMFLOAT3A &orig, const dx::XMFLOAT3A &dir, float &length, Entity *&entity, bool cheap = false) const
 	{
 		if (_root == nullptr)
@@ -662,6 +1217,22 @@ public:
 		return _root->RaycastNode(ray, hit, ent);
 	}
 
+	// Traces a packet of rays. Unlike the single ray overloads, the hit of a lane is only replaced if
+	// something closer than its current length is found. hits and ents must hold RAY_PACKET_SIZE
+	// entries. Returns the lanes that were replaced.
+	UINT RaycastTree(const RayPacket &packet, Shape::RayHit *hits, Entity **ents) const
+	{
+		if (_root == nullptr)
+			return 0;
+
+		dx::XMVECTOR entry;
+		UINT mask = packet.Intersects(_root->bounds, packet.laneMask, RayPacket::LoadLengths(hits), entry);
+		if (!mask)
+			return 0;
+
+		return _root->RaycastPacket(packet, mask, hits, ents);
+	}
+
 
 	void DebugGetStructure(std::vector<dx::BoundingBox> &boxCollection, bool full, bool culling) const
 	{
@@ -687,6 +1258,7 @@ public:
 		if (!_root)
 			return true;
 
+		ImGui::Text("Nodes: %u (%u free)", _nodePool->GetLiveCount(), _nodePool->GetFreeCount());
 		ImGui::Checkbox("Draw full path", &drawFullPath);
 
 		ImGui::PushID("QuadtreeUI");
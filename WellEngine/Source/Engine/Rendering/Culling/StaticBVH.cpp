@@ -0,0 +1,990 @@
+#include "stdafx.h"
+#include "StaticBVH.h"
+#include "Scenes/Scene.h"
+
+using namespace DirectX;
+
+#pragma region Helpers
+[[nodiscard]] static inline BoundingBox ToAABB(const BoundingOrientedBox &box)
+{
+	XMFLOAT3 corners[8];
+	box.GetCorners(corners);
+
+	BoundingBox aabb;
+	BoundingBox::CreateFromPoints(aabb, 8, corners, sizeof(XMFLOAT3));
+	return aabb;
+}
+
+// Half the surface area, only ever compared against other areas.
+[[nodiscard]] static inline float HalfArea(const XMFLOAT3 &min, const XMFLOAT3 &max)
+{
+	const float x = max.x - min.x, y = max.y - min.y, z = max.z - min.z;
+	return x * y + y * z + z * x;
+}
+
+[[nodiscard]] static inline float GetAxis(const XMFLOAT3 &v, UINT axis)
+{
+	return (&v.x)[axis];
+}
+
+static inline void GrowMinMax(XMFLOAT3 &min, XMFLOAT3 &max, const XMFLOAT3 &otherMin, const XMFLOAT3 &otherMax)
+{
+	min = { std::min<float>(min.x, otherMin.x), std::min<float>(min.y, otherMin.y), std::min<float>(min.z, otherMin.z) };
+	max = { std::max<float>(max.x, otherMax.x), std::max<float>(max.y, otherMax.y), std::max<float>(max.z, otherMax.z) };
+}
+static inline void GrowMinMax(XMFLOAT3 &min, XMFLOAT3 &max, const BoundingBox &box)
+{
+	const XMFLOAT3 &c = box.Center, &e = box.Extents;
+	GrowMinMax(min, max, { c.x - e.x, c.y - e.y, c.z - e.z }, { c.x + e.x, c.y + e.y, c.z + e.z });
+}
+
+static void RaycastItem(Entity *item, const XMFLOAT3 &orig, const XMFLOAT3 &dir, float &length, Entity *&entity, bool cheap)
+{
+	if (item == nullptr)
+		return;
+
+	if (!item->IsEnabled())
+		return;
+
+	if (!item->IsDebugSelectable())
+		return;
+
+	if (!item->IsRaycastTarget())
+		return;
+
+	if (!cheap)
+	{
+		MeshBehaviour *meshBehaviour = nullptr;
+		if (item->GetBehaviourByType<MeshBehaviour>(meshBehaviour))
+		{
+			const Shape::Ray ray(orig, dir);
+
+			MeshD3D11 *mesh = item->GetScene()->GetContent()->GetMesh(meshBehaviour->GetMeshID());
+			const MeshCollider &meshCollider = mesh->GetMeshCollider();
+
+			const XMFLOAT4X4A &meshMatrix = item->GetTransform()->GetMatrix(World);
+			XMFLOAT4X4A meshMatrixInv; Store(meshMatrixInv, XMMatrixInverse(nullptr, Load(meshMatrix)));
+
+			const Shape::Ray localRay = ray.Transformed(meshMatrixInv);
+			Shape::RayHit localHit;
+
+			if (meshCollider.RaycastMesh(localRay, localHit))
+			{
+				localHit.Transform(meshMatrix);
+
+				if (localHit.length < length)
+				{
+					length = localHit.length;
+					entity = item;
+				}
+			}
+
+			return;
+		}
+	}
+
+	BoundingOrientedBox itemBounds;
+	if (!item->HasBounds(false, itemBounds))
+		return;
+
+	float newLength = 0.0f;
+	if (!Raycast(orig, dir, itemBounds, newLength))
+		return;
+
+	if (newLength >= length)
+		return;
+
+	length = newLength;
+	entity = item;
+}
+static void RaycastItem(Entity *item, const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent)
+{
+	if (item == nullptr)
+		return;
+
+	if (!item->IsEnabled())
+		return;
+
+	if (!item->IsDebugSelectable())
+		return;
+
+	if (!item->IsRaycastTarget())
+		return;
+
+	MeshBehaviour *meshBehaviour = nullptr;
+	if (!item->GetBehaviourByType<MeshBehaviour>(meshBehaviour))
+		return;
+
+	MeshD3D11 *mesh = item->GetScene()->GetContent()->GetMesh(meshBehaviour->GetMeshID());
+	const MeshCollider &meshCollider = mesh->GetMeshCollider();
+
+	const XMFLOAT4X4A &meshMatrix = item->GetTransform()->GetMatrix(World);
+	XMFLOAT4X4A meshMatrixInv; Store(meshMatrixInv, XMMatrixInverse(nullptr, Load(meshMatrix)));
+
+	const Shape::Ray localRay = ray.Transformed(meshMatrixInv);
+	Shape::RayHit localHit;
+
+	if (!meshCollider.RaycastMesh(localRay, localHit))
+		return;
+
+	localHit.Transform(meshMatrix);
+
+	if (localHit.length >= hit.length)
+		return;
+
+	hit = localHit;
+	ent = item;
+}
+static UINT RaycastItem(Entity *item, const RayPacket &packet, UINT mask, Shape::RayHit *hits, Entity **ents)
+{
+	if (item == nullptr)
+		return 0;
+
+	if (!item->IsEnabled())
+		return 0;
+
+	if (!item->IsDebugSelectable())
+		return 0;
+
+	if (!item->IsRaycastTarget())
+		return 0;
+
+	MeshBehaviour *meshBehaviour = nullptr;
+	if (!item->GetBehaviourByType<MeshBehaviour>(meshBehaviour))
+		return 0;
+
+	MeshD3D11 *mesh = item->GetScene()->GetContent()->GetMesh(meshBehaviour->GetMeshID());
+	const MeshCollider &meshCollider = mesh->GetMeshCollider();
+
+	const XMFLOAT4X4A &meshMatrix = item->GetTransform()->GetMatrix(World);
+	XMFLOAT4X4A meshMatrixInv; Store(meshMatrixInv, XMMatrixInverse(nullptr, Load(meshMatrix)));
+
+	// The inverse is shared by every ray in the packet.
+	Shape::Ray localRays[RAY_PACKET_SIZE];
+	for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+		localRays[lane] = packet.rays[lane].Transformed(meshMatrixInv);
+
+	const RayPacket localPacket(localRays, RAY_PACKET_SIZE);
+	Shape::RayHit localHits[RAY_PACKET_SIZE];
+
+	const UINT localMask = meshCollider.RaycastMesh(localPacket, mask, localHits);
+
+	UINT hitMask = 0;
+	for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+	{
+		if (!(localMask & (1u << lane)))
+			continue;
+
+		localHits[lane].Transform(meshMatrix);
+
+		if (localHits[lane].length >= hits[lane].length)
+			continue;
+
+		hits[lane] = localHits[lane];
+		ents[lane] = item;
+		hitMask |= 1u << lane;
+	}
+
+	return hitMask;
+}
+#pragma endregion
+
+
+#pragma region Structure
+bool StaticBVH::Initialize()
+{
+	Clear();
+	_isInitialized = true;
+	return true;
+}
+
+void StaticBVH::Clear()
+{
+	_nodes.clear();
+	_items.clear();
+	_itemLookup.clear();
+	_removedCount = 0;
+	_depth = 0;
+}
+
+bool StaticBVH::Build(const std::vector<Entity *> &entities)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized)
+		return false;
+
+	Clear();
+
+	_items.reserve(entities.size());
+	for (Entity *entity : entities)
+	{
+		if (entity == nullptr)
+			continue;
+
+		entity->UpdateCullingBounds();
+
+		BoundingOrientedBox entityBounds;
+		entity->StoreEntityBounds(entityBounds);
+
+		_items.push_back({ entity, ToAABB(entityBounds) });
+	}
+
+	if (_items.empty())
+		return true;
+
+	// A binary tree with at least one item per leaf never needs more than twice as many nodes.
+	_nodes.reserve(2 * _items.size());
+	(void)BuildNode(0, static_cast<UINT>(_items.size()), 0);
+
+	for (UINT i = 0; i < _items.size(); i++)
+		_itemLookup[_items[i].entity] = i;
+
+	return true;
+}
+
+UINT StaticBVH::BuildNode(UINT begin, UINT end, UINT depth)
+{
+	const UINT nodeIndex = static_cast<UINT>(_nodes.size());
+	_nodes.emplace_back();
+
+	_depth = std::max<UINT>(_depth, depth + 1);
+
+	XMFLOAT3 boundsMin = { FLT_MAX, FLT_MAX, FLT_MAX }, boundsMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	XMFLOAT3 centerMin = boundsMin, centerMax = boundsMax;
+
+	for (UINT i = begin; i < end; i++)
+	{
+		const BoundingBox &itemBounds = _items[i].bounds;
+		GrowMinMax(boundsMin, boundsMax, itemBounds);
+		GrowMinMax(centerMin, centerMax, itemBounds.Center, itemBounds.Center);
+	}
+
+	{
+		Node &node = _nodes[nodeIndex];
+		BoundingBox::CreateFromPoints(node.bounds, XMLoadFloat3(&boundsMin), XMLoadFloat3(&boundsMax));
+		node.firstItem = begin;
+		node.itemCount = end - begin;
+	}
+
+	const UINT count = end - begin;
+	if (count <= MAX_LEAF_ITEMS || depth + 1 >= MAX_DEPTH)
+		return nodeIndex;
+
+	// Split along the axis where item centers are spread the furthest.
+	UINT axis = 0;
+	const XMFLOAT3 centerSpread = { centerMax.x - centerMin.x, centerMax.y - centerMin.y, centerMax.z - centerMin.z };
+	if (centerSpread.y > GetAxis(centerSpread, axis)) axis = 1;
+	if (centerSpread.z > GetAxis(centerSpread, axis)) axis = 2;
+
+	const float axisMin = GetAxis(centerMin, axis);
+	const float axisSpread = GetAxis(centerSpread, axis);
+
+	UINT mid = begin + count / 2;
+
+	if (axisSpread > 0.0f)
+	{
+		struct Bin
+		{
+			XMFLOAT3 min = { FLT_MAX, FLT_MAX, FLT_MAX };
+			XMFLOAT3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			UINT count = 0;
+		} bins[SAH_BIN_COUNT];
+
+		const float binScale = static_cast<float>(SAH_BIN_COUNT) / axisSpread;
+		auto GetBin = [&](const BoundingBox &box) -> UINT
+		{
+			const UINT bin = static_cast<UINT>((GetAxis(box.Center, axis) - axisMin) * binScale);
+			return std::min<UINT>(bin, SAH_BIN_COUNT - 1);
+		};
+
+		for (UINT i = begin; i < end; i++)
+		{
+			Bin &bin = bins[GetBin(_items[i].bounds)];
+			GrowMinMax(bin.min, bin.max, _items[i].bounds);
+			bin.count++;
+		}
+
+		// Sweep from the right to get the cost of every right-hand partition.
+		float rightCosts[SAH_BIN_COUNT] = {};
+		{
+			Bin right;
+			for (UINT b = SAH_BIN_COUNT - 1; b > 0; b--)
+			{
+				if (bins[b].count > 0)
+				{
+					GrowMinMax(right.min, right.max, bins[b].min, bins[b].max);
+					right.count += bins[b].count;
+				}
+
+				rightCosts[b] = (right.count > 0) ? HalfArea(right.min, right.max) * right.count : 0.0f;
+			}
+		}
+
+		float bestCost = FLT_MAX;
+		UINT bestSplit = 0;
+		{
+			Bin left;
+			for (UINT b = 0; b < SAH_BIN_COUNT - 1; b++)
+			{
+				if (bins[b].count > 0)
+				{
+					GrowMinMax(left.min, left.max, bins[b].min, bins[b].max);
+					left.count += bins[b].count;
+				}
+
+				if (left.count == 0 || left.count == count)
+					continue;
+
+				const float cost = HalfArea(left.min, left.max) * left.count + rightCosts[b + 1];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestSplit = b;
+				}
+			}
+		}
+
+		if (bestCost < FLT_MAX)
+		{
+			auto splitIt = std::partition(_items.begin() + begin, _items.begin() + end, [&](const Item &item) {
+				return GetBin(item.bounds) <= bestSplit;
+			});
+			mid = static_cast<UINT>(splitIt - _items.begin());
+		}
+	}
+
+	// Overlapping centers or a failed split, fall back to an even split by center.
+	if (mid == begin || mid == end)
+	{
+		mid = begin + count / 2;
+		std::nth_element(_items.begin() + begin, _items.begin() + mid, _items.begin() + end, [axis](const Item &a, const Item &b) {
+			return GetAxis(a.bounds.Center, axis) < GetAxis(b.bounds.Center, axis);
+		});
+	}
+
+	(void)BuildNode(begin, mid, depth + 1);
+	const UINT rightChild = BuildNode(mid, end, depth + 1);
+	_nodes[nodeIndex].rightChild = rightChild;
+
+	return nodeIndex;
+}
+
+bool StaticBVH::Remove(Entity *data)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized)
+		return false;
+
+	auto lookupIt = _itemLookup.find(data);
+	if (lookupIt == _itemLookup.end())
+		return true;
+
+	_items[lookupIt->second].entity = nullptr;
+	_itemLookup.erase(lookupIt);
+	_removedCount++;
+	return true;
+}
+
+bool StaticBVH::Contains(const Entity *data) const
+{
+	return _itemLookup.contains(data);
+}
+
+bool StaticBVH::FitsBakedBounds(const Entity *data, const BoundingOrientedBox &bounds) const
+{
+	auto lookupIt = _itemLookup.find(data);
+	if (lookupIt == _itemLookup.end())
+		return false;
+
+	return _items[lookupIt->second].bounds.Contains(ToAABB(bounds)) == CONTAINS;
+}
+
+UINT StaticBVH::GetItemCount() const
+{
+	return static_cast<UINT>(_items.size()) - _removedCount;
+}
+UINT StaticBVH::GetRemovedCount() const
+{
+	return _removedCount;
+}
+#pragma endregion
+
+
+#pragma region Queries
+void StaticBVH::AddRange(const Node &node, std::vector<Entity *> &containingItems) const
+{
+	const UINT end = node.firstItem + node.itemCount;
+	for (UINT i = node.firstItem; i < end; i++)
+	{
+		Entity *item = _items[i].entity;
+
+		if (item == nullptr)
+			continue;
+
+		if (!item->IsEnabled())
+			continue;
+
+		containingItems.emplace_back(item);
+	}
+}
+
+template <class VolumeType>
+void StaticBVH::CullInternal(const VolumeType &volume, std::vector<Entity *> &containingItems) const
+{
+	ZoneScopedXC(RandomUniqueColor());
+
+	if (_nodes.empty())
+		return;
+
+	UINT stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const UINT index = stack[--stackSize];
+		const Node &node = _nodes[index];
+
+		switch (volume.Contains(node.bounds))
+		{
+		case DISJOINT:
+			break;
+
+		case CONTAINS:
+			AddRange(node, containingItems);
+			break;
+
+		case INTERSECTS:
+			if (!node.IsLeaf())
+			{
+				stack[stackSize++] = node.rightChild;
+				stack[stackSize++] = index + 1;
+				break;
+			}
+
+			for (UINT i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+			{
+				const Item &item = _items[i];
+
+				if (item.entity == nullptr)
+					continue;
+
+				if (!item.entity->IsEnabled())
+					continue;
+
+				if (!volume.Intersects(item.bounds))
+					continue;
+
+				containingItems.emplace_back(item.entity);
+			}
+			break;
+		}
+	}
+}
+
+bool StaticBVH::FrustumCull(const BoundingFrustum &frustum, std::vector<Entity *> &containingItems) const
+{
+	if (!_isInitialized)
+		return false;
+
+	CullInternal(frustum, containingItems);
+	return true;
+}
+
+bool StaticBVH::BoxCull(const BoundingOrientedBox &box, std::vector<Entity *> &containingItems) const
+{
+	if (!_isInitialized)
+		return false;
+
+	CullInternal(box, containingItems);
+	return true;
+}
+
+bool StaticBVH::BoxCull(const BoundingBox &box, std::vector<Entity *> &containingItems) const
+{
+	if (!_isInitialized)
+		return false;
+
+	CullInternal(box, containingItems);
+	return true;
+}
+
+bool StaticBVH::SphereCull(const BoundingSphere &sphere, std::vector<Entity *> &containingItems) const
+{
+	if (!_isInitialized)
+		return false;
+
+	CullInternal(sphere, containingItems);
+	return true;
+}
+
+bool StaticBVH::FindNearest(NearestQuery &query) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized)
+		return false;
+
+	if (_nodes.empty())
+		return true;
+
+	using NodeEntry = std::pair<float, UINT>;
+	std::priority_queue<NodeEntry, std::vector<NodeEntry>, std::greater<NodeEntry>> queue;
+	queue.emplace(query.DistanceSq(_nodes[0].bounds), 0);
+
+	while (!queue.empty())
+	{
+		const auto [distanceSq, index] = queue.top();
+		queue.pop();
+
+		if (distanceSq > query.GetBoundSq())
+			break;
+
+		const Node &node = _nodes[index];
+
+		if (node.IsLeaf())
+		{
+			for (UINT i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+				query.Offer(_items[i].entity);
+			continue;
+		}
+
+		for (const UINT child : { index + 1, node.rightChild })
+		{
+			const float childDistanceSq = query.DistanceSq(_nodes[child].bounds);
+			if (childDistanceSq <= query.GetBoundSq())
+				queue.emplace(childDistanceSq, child);
+		}
+	}
+
+	return true;
+}
+
+bool StaticBVH::MultiCull(const CullView *views, UINT viewCount, std::vector<Entity *> *containingItems) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized)
+		return false;
+
+	if (viewCount > CullView::MAX_BATCH_SIZE)
+		return false;
+
+	if (viewCount == 0 || _nodes.empty())
+		return true;
+
+	struct StackEntry { UINT node; UINT64 viewMask; };
+	StackEntry stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+	stack[stackSize++] = { 0, CullView::GetViewMask(viewCount) };
+
+	while (stackSize > 0)
+	{
+		const StackEntry current = stack[--stackSize];
+		const Node &node = _nodes[current.node];
+
+		UINT64 intersectMask = 0;
+		for (UINT64 remaining = current.viewMask; remaining != 0; remaining &= remaining - 1)
+		{
+			const UINT view = CullView::NextView(remaining);
+
+			switch (views[view].Contains(node.bounds))
+			{
+			case DISJOINT:
+				break;
+
+			case CONTAINS:
+				AddRange(node, containingItems[view]);
+				break;
+
+			case INTERSECTS:
+				intersectMask |= 1ull << view;
+				break;
+			}
+		}
+
+		if (intersectMask == 0)
+			continue;
+
+		if (!node.IsLeaf())
+		{
+			stack[stackSize++] = { node.rightChild, intersectMask };
+			stack[stackSize++] = { current.node + 1, intersectMask };
+			continue;
+		}
+
+		for (UINT i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+		{
+			const Item &item = _items[i];
+
+			if (item.entity == nullptr)
+				continue;
+
+			if (!item.entity->IsEnabled())
+				continue;
+
+			for (UINT64 remaining = intersectMask; remaining != 0; remaining &= remaining - 1)
+			{
+				const UINT view = CullView::NextView(remaining);
+
+				if (views[view].Contains(item.bounds) == DISJOINT)
+					continue;
+
+				containingItems[view].emplace_back(item.entity);
+			}
+		}
+	}
+
+	return true;
+}
+
+bool StaticBVH::RaycastTree(const XMFLOAT3A &orig, const XMFLOAT3A &dir, float &length, Entity *&entity, bool cheap) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized || _nodes.empty())
+		return false;
+
+	float rootLength = FLT_MAX;
+	if (!Raycast(orig, dir, _nodes[0].bounds, rootLength) || rootLength > length)
+		return false;
+
+	Entity *const previousEntity = entity;
+
+	struct StackEntry { UINT node; float length; };
+	StackEntry stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+	stack[stackSize++] = { 0, rootLength };
+
+	while (stackSize > 0)
+	{
+		const StackEntry current = stack[--stackSize];
+
+		// A closer hit was found since this node was pushed.
+		if (current.length > length)
+			continue;
+
+		const Node &node = _nodes[current.node];
+
+		if (node.IsLeaf())
+		{
+			for (UINT i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+			{
+				float itemLength = FLT_MAX;
+				if (!Raycast(orig, dir, _items[i].bounds, itemLength) || itemLength > length)
+					continue;
+
+				RaycastItem(_items[i].entity, orig, dir, length, entity, cheap);
+			}
+			continue;
+		}
+
+		const UINT child1 = current.node + 1, child2 = node.rightChild;
+
+		float length1 = FLT_MAX, length2 = FLT_MAX;
+		const bool hit1 = Raycast(orig, dir, _nodes[child1].bounds, length1) && length1 <= length;
+		const bool hit2 = Raycast(orig, dir, _nodes[child2].bounds, length2) && length2 <= length;
+
+		// Push the furthest child first so the closest one is checked first.
+		if (hit1 && hit2)
+		{
+			if (length1 < length2)
+			{
+				stack[stackSize++] = { child2, length2 };
+				stack[stackSize++] = { child1, length1 };
+			}
+			else
+			{
+				stack[stackSize++] = { child1, length1 };
+				stack[stackSize++] = { child2, length2 };
+			}
+		}
+		else if (hit1)
+			stack[stackSize++] = { child1, length1 };
+		else if (hit2)
+			stack[stackSize++] = { child2, length2 };
+	}
+
+	return (entity != previousEntity);
+}
+
+void StaticBVH::RaycastSubtree(UINT root, float rootLength, const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent) const
+{
+	struct StackEntry { UINT node; float length; };
+	StackEntry stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+	stack[stackSize++] = { root, rootLength };
+
+	while (stackSize > 0)
+	{
+		const StackEntry current = stack[--stackSize];
+
+		if (current.length > hit.length)
+			continue;
+
+		const Node &node = _nodes[current.node];
+
+		if (node.IsLeaf())
+		{
+			for (UINT i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+			{
+				float itemLength = FLT_MAX;
+				if (!Raycast(ray.origin, ray.direction, _items[i].bounds, itemLength) || itemLength > hit.length)
+					continue;
+
+				RaycastItem(_items[i].entity, ray, hit, ent);
+			}
+			continue;
+		}
+
+		const UINT child1 = current.node + 1, child2 = node.rightChild;
+
+		float length1 = FLT_MAX, length2 = FLT_MAX;
+		const bool hit1 = Raycast(ray.origin, ray.direction, _nodes[child1].bounds, length1) && length1 <= hit.length;
+		const bool hit2 = Raycast(ray.origin, ray.direction, _nodes[child2].bounds, length2) && length2 <= hit.length;
+
+		if (hit1 && hit2)
+		{
+			if (length1 < length2)
+			{
+				stack[stackSize++] = { child2, length2 };
+				stack[stackSize++] = { child1, length1 };
+			}
+			else
+			{
+				stack[stackSize++] = { child1, length1 };
+				stack[stackSize++] = { child2, length2 };
+			}
+		}
+		else if (hit1)
+			stack[stackSize++] = { child1, length1 };
+		else if (hit2)
+			stack[stackSize++] = { child2, length2 };
+	}
+}
+bool StaticBVH::RaycastTree(const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized || _nodes.empty())
+		return false;
+
+	float rootLength = hit.length; // In case Intersects() uses the initial dist value as a maximum. Docs don't specify.
+	if (!Raycast(ray.origin, ray.direction, _nodes[0].bounds, rootLength) || rootLength > hit.length)
+		return false;
+
+	Entity *const previousEntity = ent;
+	RaycastSubtree(0, rootLength, ray, hit, ent);
+	return (ent != previousEntity);
+}
+UINT StaticBVH::RaycastTree(const RayPacket &packet, Shape::RayHit *hits, Entity **ents) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isInitialized || _nodes.empty())
+		return 0;
+
+	XMVECTOR rootEntry;
+	const UINT rootMask = packet.Intersects(_nodes[0].bounds, packet.laneMask, RayPacket::LoadLengths(hits), rootEntry);
+	if (!rootMask)
+		return 0;
+
+	UINT hitMask = 0;
+
+	struct StackEntry { UINT node; UINT mask; float length; XMFLOAT4 entry; };
+	StackEntry stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+
+	const auto push = [&](UINT node, UINT mask, FXMVECTOR entry) {
+		StackEntry &top = stack[stackSize++];
+		top.node = node;
+		top.mask = mask;
+		XMStoreFloat4(&top.entry, entry);
+
+		top.length = FLT_MAX;
+		for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+		{
+			if (mask & (1u << lane))
+				top.length = std::min<float>(top.length, (&top.entry.x)[lane]);
+		}
+	};
+
+	push(0, rootMask, rootEntry);
+
+	while (stackSize > 0)
+	{
+		const StackEntry current = stack[--stackSize];
+
+		// Drop lanes that have hit something closer since the node was pushed.
+		UINT mask = current.mask;
+		for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+		{
+			if ((mask & (1u << lane)) && (&current.entry.x)[lane] > hits[lane].length)
+				mask &= ~(1u << lane);
+		}
+
+		if (!mask)
+			continue;
+
+		// Too few rays left for SIMD to pay off, trace the rest of the subtree one ray at a time.
+		if (RayPacket::GetLaneCount(mask) < RAY_PACKET_MIN_LANES)
+		{
+			for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+			{
+				if (!(mask & (1u << lane)))
+					continue;
+
+				Entity *const previousEntity = ents[lane];
+				const float previousLength = hits[lane].length;
+
+				RaycastSubtree(current.node, (&current.entry.x)[lane], packet.rays[lane], hits[lane], ents[lane]);
+
+				if (ents[lane] != previousEntity || hits[lane].length < previousLength)
+					hitMask |= 1u << lane;
+			}
+			continue;
+		}
+
+		const Node &node = _nodes[current.node];
+
+		if (node.IsLeaf())
+		{
+			for (UINT i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+			{
+				XMVECTOR itemEntry;
+				const UINT itemMask = packet.Intersects(_items[i].bounds, mask, RayPacket::LoadLengths(hits), itemEntry);
+				if (!itemMask)
+					continue;
+
+				hitMask |= RaycastItem(_items[i].entity, packet, itemMask, hits, ents);
+			}
+			continue;
+		}
+
+		const UINT child1 = current.node + 1, child2 = node.rightChild;
+		const XMVECTOR maxLengths = RayPacket::LoadLengths(hits);
+
+		XMVECTOR entry1, entry2;
+		const UINT mask1 = packet.Intersects(_nodes[child1].bounds, mask, maxLengths, entry1);
+		const UINT mask2 = packet.Intersects(_nodes[child2].bounds, mask, maxLengths, entry2);
+
+		if (mask1 && mask2)
+		{
+			// Push the child entered first by any lane last, so that it is traversed first.
+			push(child2, mask2, entry2);
+			push(child1, mask1, entry1);
+
+			if (stack[stackSize - 1].length > stack[stackSize - 2].length)
+				std::swap(stack[stackSize - 1], stack[stackSize - 2]);
+		}
+		else if (mask1)
+			push(child1, mask1, entry1);
+		else if (mask2)
+			push(child2, mask2, entry2);
+	}
+
+	return hitMask;
+}
+#pragma endregion
+
+
+#pragma region Debug
+void StaticBVH::DebugGetStructure(std::vector<BoundingBox> &boxCollection, bool full, bool culling) const
+{
+	if (!_isInitialized)
+		return;
+
+	for (const Node &node : _nodes)
+	{
+		if (!node.IsLeaf())
+		{
+			if (full)
+				boxCollection.emplace_back(node.bounds);
+			continue;
+		}
+
+		if (culling)
+		{
+			boxCollection.emplace_back(node.bounds);
+			continue;
+		}
+
+		for (UINT i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+		{
+			if (_items[i].entity != nullptr)
+				boxCollection.emplace_back(_items[i].bounds);
+		}
+	}
+}
+void StaticBVH::DebugGetStructure(std::vector<BoundingBox> &boxCollection, const BoundingFrustum &frustum, bool full, bool culling) const
+{
+	if (!_isInitialized || _nodes.empty())
+		return;
+
+	UINT stack[MAX_STACK_SIZE];
+	UINT stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const UINT index = stack[--stackSize];
+		const Node &node = _nodes[index];
+
+		if (!frustum.Intersects(node.bounds))
+			continue;
+
+		if (!node.IsLeaf())
+		{
+			if (full)
+				boxCollection.emplace_back(node.bounds);
+
+			stack[stackSize++] = node.rightChild;
+			stack[stackSize++] = index + 1;
+			continue;
+		}
+
+		if (culling)
+		{
+			boxCollection.emplace_back(node.bounds);
+			continue;
+		}
+
+		for (UINT i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+		{
+			if (_items[i].entity != nullptr)
+				boxCollection.emplace_back(_items[i].bounds);
+		}
+	}
+}
+
+#ifdef USE_IMGUI
+bool StaticBVH::RenderUI()
+{
+	if (!_isInitialized)
+		return true;
+
+	ImGui::Text("Items: %u (%u removed)", GetItemCount(), _removedCount);
+	ImGui::Text("Nodes: %zu", _nodes.size());
+	ImGui::Text("Depth: %u", _depth);
+
+	ImGui::Separator();
+
+	ImGui::ColorEdit4("Bounds Color##StaticBVH", &boundsColor.x, ImGuiColorEditFlags_NoInputs);
+	ImGui::Checkbox("Draw Bounds##StaticBVH", &drawBounds);
+	ImGui::Checkbox("Leaves Only##StaticBVH", &drawLeavesOnly);
+
+	if (drawBounds)
+	{
+		std::vector<BoundingBox> boxes;
+		DebugGetStructure(boxes, !drawLeavesOnly, true);
+
+		for (const BoundingBox &box : boxes)
+			DebugDrawer::Instance().DrawBoxAABB(box, boundsColor, false, true);
+	}
+
+	return true;
+}
+#endif
+#pragma endregion
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <DirectXCollision.h>
+#include "Entity.h"
+#include "Behaviour.h"
+#include "Collision/Raycast.h"
+#include "Collision/RayPacket.h"
+#include "CullView.h"
+#include "NearestQuery.h"
+#include "Behaviours/MeshBehaviour.h"
+
+#ifdef LEAK_DETECTION
+#define new			DEBUG_NEW
+#endif
+
+// Read-only bounding volume hierarchy for static entities, built once with a binned surface area
+// heuristic. Nodes are stored depth-first in a single array, with the left child directly after
+// its parent, and the items of every subtree lie in one contiguous range. Removing an entity only
+// clears its item slot; the tree itself is never restructured until the next Build.
+class StaticBVH
+{
+public:
+	static constexpr UINT MAX_LEAF_ITEMS = 4;
+	static constexpr UINT MAX_DEPTH = 48;
+
+private:
+	static constexpr UINT SAH_BIN_COUNT = 12;
+	static constexpr UINT MAX_STACK_SIZE = 2 * MAX_DEPTH;
+
+	struct Node
+	{
+		dx::BoundingBox bounds = {};
+		UINT firstItem = 0;
+		UINT itemCount = 0;		// Items in the whole subtree.
+		UINT rightChild = 0;	// Zero for leaves, the root is never a right child.
+
+		[[nodiscard]] inline bool IsLeaf() const { return rightChild == 0; }
+	};
+
+	struct Item
+	{
+		Entity *entity = nullptr; // Null once removed.
+		dx::BoundingBox bounds = {};
+	};
+
+	bool _isInitialized = false;
+
+	std::vector<Node> _nodes;
+	std::vector<Item> _items;
+	std::unordered_map<const Entity *, UINT> _itemLookup;
+	UINT _removedCount = 0;
+	UINT _depth = 0;
+
+	[[nodiscard]] UINT BuildNode(UINT begin, UINT end, UINT depth);
+
+	void AddRange(const Node &node, std::vector<Entity *> &containingItems) const;
+	void RaycastSubtree(UINT root, float rootLength, const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent) const;
+
+	template <class VolumeType>
+	void CullInternal(const VolumeType &volume, std::vector<Entity *> &containingItems) const;
+
+public:
+	StaticBVH() = default;
+	~StaticBVH() = default;
+	StaticBVH(const StaticBVH &other) = default;
+	StaticBVH &operator=(const StaticBVH &other) = default;
+	StaticBVH(StaticBVH &&other) = default;
+	StaticBVH &operator=(StaticBVH &&other) = default;
+
+	[[nodiscard]] bool Initialize();
+	void Clear();
+
+	// Replaces the contents of the tree with the given entities, using their current bounds.
+	[[nodiscard]] bool Build(const std::vector<Entity *> &entities);
+
+	[[nodiscard]] bool Remove(Entity *data);
+	[[nodiscard]] bool Contains(const Entity *data) const;
+
+	// Whether the entity can stay in the tree with its new bounds, without growing its node.
+	[[nodiscard]] bool FitsBakedBounds(const Entity *data, const dx::BoundingOrientedBox &bounds) const;
+
+	[[nodiscard]] UINT GetItemCount() const;
+	[[nodiscard]] UINT GetRemovedCount() const;
+
+	[[nodiscard]] bool FrustumCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems) const;
+	[[nodiscard]] bool BoxCull(const dx::BoundingOrientedBox &box, std::vector<Entity *> &containingItems) const;
+	[[nodiscard]] bool BoxCull(const dx::BoundingBox &box, std::vector<Entity *> &containingItems) const;
+	[[nodiscard]] bool SphereCull(const dx::BoundingSphere &sphere, std::vector<Entity *> &containingItems) const;
+
+	// Best-first search, visiting nodes in order of distance until none can be closer than the k-th candidate.
+	[[nodiscard]] bool FindNearest(NearestQuery &query) const;
+
+	// Culls up to CullView::MAX_BATCH_SIZE views in a single traversal, writing one result list per view.
+	[[nodiscard]] bool MultiCull(const CullView *views, UINT viewCount, std::vector<Entity *> *containingItems) const;
+
+	// Only replaces the results if a hit closer than the given length or hit is found.
+	bool RaycastTree(const dx::XMFLOAT3A &orig, const dx::XMFLOAT3A &dir, float &length, Entity *&entity, bool cheap = false) const;
+	bool RaycastTree(const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent) const;
+
+	// Traces a packet of rays, with the same closer-only rule. hits and ents must hold RAY_PACKET_SIZE
+	// entries. Returns the lanes that were replaced.
+	UINT RaycastTree(const RayPacket &packet, Shape::RayHit *hits, Entity **ents) const;
+
+	void DebugGetStructure(std::vector<dx::BoundingBox> &boxCollection, bool full, bool culling) const;
+	void DebugGetStructure(std::vector<dx::BoundingBox> &boxCollection, const dx::BoundingFrustum &frustum, bool full, bool culling) const;
+
+#ifdef USE_IMGUI
+	bool drawBounds = false;
+	bool drawLeavesOnly = true;
+	dx::XMFLOAT4 boundsColor = { 0.0f, 0.5f, 1.0f, 0.05f };
+
+	bool RenderUI();
+#endif
+
+	TESTABLE()
+};
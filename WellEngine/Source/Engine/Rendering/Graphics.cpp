@@ -35,6 +35,12 @@ bool Graphics::Setup(bool fullscreen, const UINT width, const UINT height, const
 		return false;
 	}
 	
+#ifdef HEADLESS
+	// There is no device to render with, the wrappers set up below keep their data on the CPU instead.
+	device = nullptr;
+	immediateContext = nullptr;
+	_viewport = { 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f };
+#else
 	if (!SetupD3D11(fullscreen, width, height, window.GetHWND(),
 		device, immediateContext, deferredContexts,
 		*_swapChain.ReleaseAndGetAddressOf(),
@@ -51,6 +57,7 @@ bool Graphics::Setup(bool fullscreen, const UINT width, const UINT height, const
 		ErrMsg("Failed to setup d3d11!");
 		return false;
 	}
+#endif
 
 #if defined(TRACY_ENABLE) && defined(TRACY_GPU)
 	_tracyD3D11Context = TracyD3D11Context(device, immediateContext);
@@ -151,6 +158,7 @@ bool Graphics::Setup(bool fullscreen, const UINT width, const UINT height, const
 #endif
 	}
 
+#ifndef HEADLESS
 	// Rasterizer States
 	{
 		D3D11_RASTERIZER_DESC rasterizerDesc = { };
@@ -199,6 +207,7 @@ bool Graphics::Setup(bool fullscreen, const UINT width, const UINT height, const
 		std::memcpy(&_shadowRasterizerDesc, &rasterizerDesc, sizeof(D3D11_RASTERIZER_DESC));
 #endif
 	}
+#endif
 
 #ifdef USE_IMGUI
 	_transparentBlendDesc = { };
@@ -826,6 +835,7 @@ bool Graphics::BeginSceneRender()
 		return false;
 	}
 
+#ifndef HEADLESS
 	// Update buffers if resized window
 	auto &input = Input::Instance();
 	auto *wnd = input.GetWindow();
@@ -876,6 +886,7 @@ bool Graphics::BeginSceneRender()
 			return false;
 		}
 	}
+#endif
 
 	_isRendering = true;
 	return true;
@@ -946,6 +957,9 @@ bool Graphics::EndSceneRender(TimeUtils &time)
 #endif	
 	}
 
+#ifdef HEADLESS
+	RecordHeadlessFrame();
+#else
 	// Bind default resources
 	{
 		TracyD3D11NamedZoneXC(_tracyD3D11Context, bindDefaultResourcesD3D11Zone, "Bind Default Resources", RandomUniqueColor(), true);
@@ -998,10 +1012,60 @@ bool Graphics::EndSceneRender(TimeUtils &time)
 		ErrMsg("Failed to render to screen view!");
 		return false;
 	}
+#endif
 
 	return true;
 }
 
+#ifdef HEADLESS
+void Graphics::RecordHeadlessFrame()
+{
+	ZoneScopedXC(RandomUniqueColor());
+
+	HeadlessFrameStats &stats = _headlessStats;
+	stats.frameCount++;
+	stats.viewDrawCount = 0;
+	stats.shadowDrawCount = 0;
+
+	if (_currViewCamera)
+	{
+		stats.viewDrawCount += static_cast<UINT>(_currViewCamera->GetGeometryQueue().size());
+		stats.viewDrawCount += static_cast<UINT>(_currViewCamera->GetTransparentQueue().size());
+		stats.viewDrawCount += static_cast<UINT>(_currViewCamera->GetOverlayQueue().size());
+	}
+
+	if (_currSpotLightCollection.IsValid())
+	{
+		auto &collection = *_currSpotLightCollection.Get();
+
+		for (UINT i = 0; i < collection.GetNrOfLights(); i++)
+		{
+			const CameraBehaviour *shadowCamera = collection.GetLightBehaviour(i)->GetShadowCamera();
+			stats.shadowDrawCount += static_cast<UINT>(shadowCamera->GetGeometryQueue().size());
+			stats.shadowDrawCount += static_cast<UINT>(shadowCamera->GetTransparentQueue().size());
+		}
+	}
+
+	if (_currPointLightCollection.IsValid())
+	{
+		auto &collection = *_currPointLightCollection.Get();
+
+		for (UINT i = 0; i < collection.GetNrOfLights(); i++)
+		{
+			const CameraCubeBehaviour *shadowCamera = collection.GetLightBehaviour(i)->GetShadowCameraCube();
+			stats.shadowDrawCount += static_cast<UINT>(shadowCamera->GetGeometryQueue().size());
+			stats.shadowDrawCount += static_cast<UINT>(shadowCamera->GetTransparentQueue().size());
+		}
+	}
+
+	stats.totalDrawCount += stats.viewDrawCount + stats.shadowDrawCount;
+}
+const HeadlessFrameStats &Graphics::GetHeadlessFrameStats() const
+{
+	return _headlessStats;
+}
+#endif
+
 bool Graphics::RenderToTarget(
 	ID3D11RenderTargetView *targetRTV, ID3D11RenderTargetView *targetDepthRTV,
 	ID3D11DepthStencilView *targetDSV, const D3D11_VIEWPORT *targetViewport)
@@ -5118,6 +5182,9 @@ bool Graphics::EndFrame()
 	}
 #endif
 
+#ifdef HEADLESS
+	// Nothing to present.
+#else
 	if (FAILED(_swapChain->Present(_vSync, 0)))
 	{
 		TracyD3D11Collect(_tracyD3D11Context);
@@ -5127,6 +5194,7 @@ bool Graphics::EndFrame()
 	}
 
 	TracyD3D11Collect(_tracyD3D11Context);
+#endif
 
 	return true;
 }
@@ -104,6 +104,17 @@ struct OutlineSettingsBuffer
 	float _padding[1];
 };
 
+#ifdef HEADLESS
+/// What the null backend was asked to draw.
+struct HeadlessFrameStats
+{
+	UINT frameCount = 0;
+	UINT viewDrawCount = 0; // Entities queued by the view camera last frame.
+	UINT shadowDrawCount = 0; // Entities queued by all shadow cameras last frame.
+	size_t totalDrawCount = 0;
+};
+#endif
+
 /// Handles rendering of the scene and the GUI.
 class Graphics
 {
@@ -255,6 +266,13 @@ private:
 	void *_tracyD3D11Context = nullptr;
 #endif
 
+#ifdef HEADLESS
+	HeadlessFrameStats _headlessStats;
+
+	/// Counts the queued entities in place of rendering them.
+	void RecordHeadlessFrame();
+#endif
+
 	/// Renders all queued entities to the specified target.
 	[[nodiscard]] bool RenderToTarget(
 		ID3D11RenderTargetView *targetRTV, ID3D11RenderTargetView *targetDepthRTV, 
@@ -378,5 +396,9 @@ public:
 	/// Resets variables and clears all render queues.
 	[[nodiscard]] bool EndFrame();
 
+#ifdef HEADLESS
+	[[nodiscard]] const HeadlessFrameStats &GetHeadlessFrameStats() const;
+#endif
+
 	TESTABLE()
 };
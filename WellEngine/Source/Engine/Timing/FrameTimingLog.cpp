@@ -0,0 +1,83 @@
+#include "stdafx.h"
+#include "Timing/FrameTimingLog.h"
+#include <fstream>
+#include <filesystem>
+
+#ifdef LEAK_DETECTION
+#define new			DEBUG_NEW
+#endif
+
+FrameTimingLog::FrameTimingLog(const std::vector<std::string> &phases) : _phases(phases)
+{
+
+}
+
+void FrameTimingLog::AddFrame(const TimeUtils &time)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	_timings.emplace_back(time.GetRealDeltaTime());
+
+	for (const std::string &phase : _phases)
+	{
+		float phaseTime = 0.0f;
+		if (!time.TryCompareSnapshots(phase, &phaseTime, true))
+			phaseTime = 0.0f;
+
+		_timings.emplace_back(phaseTime);
+	}
+}
+
+size_t FrameTimingLog::GetFrameCount() const
+{
+	return _timings.size() / (_phases.size() + 1);
+}
+float FrameTimingLog::GetAverage(UINT phaseIndex) const
+{
+	const size_t frameCount = GetFrameCount();
+	if (frameCount == 0 || phaseIndex >= _phases.size())
+		return 0.0f;
+
+	const size_t rowSize = _phases.size() + 1;
+
+	double total = 0.0;
+	for (size_t frame = 0; frame < frameCount; frame++)
+		total += _timings[frame * rowSize + phaseIndex + 1];
+
+	return static_cast<float>(total / frameCount);
+}
+
+bool FrameTimingLog::Save(const std::string &path) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+	if (!directory.empty())
+		std::filesystem::create_directories(directory);
+
+	std::ofstream writer(path, std::ios::trunc);
+	if (!writer.is_open())
+	{
+		ErrMsgF("Failed to open frame timing log '{}' for writing!", path);
+		return false;
+	}
+
+	writer << "Frame,Delta (ms)";
+	for (const std::string &phase : _phases)
+		writer << std::format(",{} (ms)", phase);
+	writer << '\n';
+
+	const size_t rowSize = _phases.size() + 1;
+	const size_t frameCount = GetFrameCount();
+
+	for (size_t frame = 0; frame < frameCount; frame++)
+	{
+		writer << frame;
+		for (size_t i = 0; i < rowSize; i++)
+			writer << std::format(",{:.4f}", _timings[frame * rowSize + i] * 1000.0f);
+		writer << '\n';
+	}
+
+	writer.close();
+	return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "Timing/TimeUtils.h"
+
+// Collects how long each phase of every frame took, read from pairs of TimeUtils snapshots named after the phases.
+// Phases measured more than once per frame, like fixed updates, are summed.
+class FrameTimingLog
+{
+private:
+	std::vector<std::string> _phases;
+	std::vector<float> _timings; // Delta time followed by every phase, one row per frame.
+
+public:
+	explicit FrameTimingLog(const std::vector<std::string> &phases);
+	~FrameTimingLog() = default;
+	FrameTimingLog(const FrameTimingLog &other) = delete;
+	FrameTimingLog &operator=(const FrameTimingLog &other) = delete;
+	FrameTimingLog(FrameTimingLog &&other) = delete;
+	FrameTimingLog &operator=(FrameTimingLog &&other) = delete;
+
+	// Reads this frame's snapshots. Call at the end of the frame, before they are cleared by the next TimeUtils::Update().
+	void AddFrame(const TimeUtils &time);
+
+	[[nodiscard]] size_t GetFrameCount() const;
+	// Average time of a phase in seconds, over all frames added.
+	[[nodiscard]] float GetAverage(UINT phaseIndex) const;
+
+	// Writes every frame as a row of milliseconds to a CSV file.
+	[[nodiscard]] bool Save(const std::string &path) const;
+
+	TESTABLE()
+};
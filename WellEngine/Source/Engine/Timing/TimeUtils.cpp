@@ -22,16 +22,42 @@ void TimeUtils::Update()
 	_deltaTime = _realDeltaTime * _timeScale;
 	_time += _deltaTime;
 
-	_snapshots.clear();
+	{
+		std::lock_guard<std::mutex> lock(_snapshotMutex);
+		_snapshots.clear();
+	}
 	_frame = newFrame;
 }
+void TimeUtils::Update(float realDeltaTime)
+{
+	_realTime += realDeltaTime;
+
+	_realDeltaTime = realDeltaTime;
+	_deltaTime = _realDeltaTime * _timeScale;
+	_time += _deltaTime;
+
+	// Snapshots still measure real time.
+	{
+		std::lock_guard<std::mutex> lock(_snapshotMutex);
+		_snapshots.clear();
+	}
+	_frame = std::chrono::high_resolution_clock::now();
+}
 
 UINT TimeUtils::TakeSnapshot(const std::string &name)
 {
-	_snapshots.emplace_back(name, std::chrono::high_resolution_clock::now());
+	const auto now = std::chrono::high_resolution_clock::now();
+
+	std::lock_guard<std::mutex> lock(_snapshotMutex);
+	_snapshots.emplace_back(name, now);
 	return static_cast<UINT>(_snapshots.size() - 1);
 }
 float TimeUtils::CompareSnapshots(const UINT s1, const UINT s2) const
+{
+	std::lock_guard<std::mutex> lock(_snapshotMutex);
+	return CompareSnapshotsLocked(s1, s2);
+}
+float TimeUtils::CompareSnapshotsLocked(const UINT s1, const UINT s2) const
 {
 	if (s1 >= s2)
 		return -1.0f;
@@ -44,6 +70,8 @@ float TimeUtils::CompareSnapshots(const UINT s1, const UINT s2) const
 }
 float TimeUtils::CompareSnapshots(const std::string &name, bool multi) const
 {
+	std::lock_guard<std::mutex> lock(_snapshotMutex);
+
 	UINT s1 = 0, s2 = 0;
 	bool foundFirst = false;
 
@@ -59,7 +87,7 @@ float TimeUtils::CompareSnapshots(const std::string &name, bool multi) const
 			if (foundFirst)
 			{
 				s2 = i;
-				cumulativeTime += CompareSnapshots(s1, s2);
+				cumulativeTime += CompareSnapshotsLocked(s1, s2);
 
 				// Reset for next pair
 				foundFirst = false; 
@@ -74,7 +102,7 @@ float TimeUtils::CompareSnapshots(const std::string &name, bool multi) const
 		if (foundFirst)
 		{
 			// If we found an odd number of snapshots, we need to add the last one
-			cumulativeTime += CompareSnapshots(s1, static_cast<UINT>(_snapshots.size()));
+			cumulativeTime += CompareSnapshotsLocked(s1, static_cast<UINT>(_snapshots.size()));
 		}
 
 		return cumulativeTime;
@@ -96,11 +124,13 @@ float TimeUtils::CompareSnapshots(const std::string &name, bool multi) const
 			foundFirst = true;
 		}
 
-		return CompareSnapshots(s1, s2);
+		return CompareSnapshotsLocked(s1, s2);
 	}
 }
 bool TimeUtils::TryCompareSnapshots(const std::string &name, float *time, bool multi) const
 {
+	std::lock_guard<std::mutex> lock(_snapshotMutex);
+
 	UINT s1 = 0, s2 = 0;
 	bool foundFirst = false;
 
@@ -116,7 +146,7 @@ bool TimeUtils::TryCompareSnapshots(const std::string &name, float *time, bool m
 			if (foundFirst)
 			{
 				s2 = i;
-				*time += CompareSnapshots(s1, s2);
+				*time += CompareSnapshotsLocked(s1, s2);
 				foundAPair = true;
 				
 				// Reset for next pair
@@ -160,7 +190,7 @@ bool TimeUtils::TryCompareSnapshots(const std::string &name, float *time, bool m
 		if (!foundSecond)
 			return false;
 
-		*time = CompareSnapshots(s1, s2);
+		*time = CompareSnapshotsLocked(s1, s2);
 	}
 	
 	return true;
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <chrono>
+#include <mutex>
 
 typedef unsigned int UINT;
 
@@ -18,7 +19,9 @@ private:
 	std::chrono::time_point<std::chrono::high_resolution_clock> _start;
 	std::chrono::time_point<std::chrono::high_resolution_clock> _frame;
 
+	// Snapshots may be taken from jobs, so every access goes through the mutex.
 	std::vector<TimeSnapshot> _snapshots;
+	mutable std::mutex _snapshotMutex;
 
 	float _timeScale = 1.0f;
 
@@ -29,6 +32,9 @@ private:
 	float _realDeltaTime = 1.0f / 60.0f;
 	float _fixedDeltaTime = 1.0f / 20.0f;
 
+	// Same as CompareSnapshots(UINT, UINT), for callers already holding _snapshotMutex.
+	[[nodiscard]] float CompareSnapshotsLocked(UINT s1, UINT s2) const;
+
 public:
 
 	TimeUtils();
@@ -45,8 +51,11 @@ public:
 	}
 
 	void Update();
+	// Advances time by the given real duration instead of measuring it, so recorded frames replay with the same timestep.
+	void Update(float realDeltaTime);
 
 	// Run once to start measuring time, run again with the same name to stop measuring time. Read the time using CompareSnapshots().
+	// Safe to call from any thread.
 	UINT TakeSnapshot(const std::string &name);
 
 	// Read the time between two snapshots using the indexes returned by TakeSnapshot().
@@ -0,0 +1,182 @@
+#include "stdafx.h"
+#include "Utils/FrameGraph.h"
+
+#ifdef LEAK_DETECTION
+#define new			DEBUG_NEW
+#endif
+
+FrameGraph::ResourceID FrameGraph::AddResource(const char *name)
+{
+	_resources.emplace_back(name);
+	return static_cast<ResourceID>(_resources.size() - 1);
+}
+
+void FrameGraph::AddStage(const char *name, std::initializer_list<ResourceID> reads, std::initializer_list<ResourceID> writes,
+	StageFunction function, bool mainThread)
+{
+	Stage &stage = _stages.emplace_back();
+	stage.name = name;
+	stage.function = std::move(function);
+	stage.mainThread = mainThread;
+	stage.reads = reads;
+	stage.writes = writes;
+	stage.group = std::make_unique<JobGroup>();
+
+	_isCompiled = false;
+}
+
+void FrameGraph::Compile()
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	constexpr UINT NO_STAGE = UINT_MAX;
+
+	const UINT resourceCount = static_cast<UINT>(_resources.size());
+	std::vector<UINT> lastWriter(resourceCount, NO_STAGE);
+	std::vector<std::vector<UINT>> readersSinceWrite(resourceCount);
+
+	for (UINT i = 0; i < static_cast<UINT>(_stages.size()); i++)
+	{
+		Stage &stage = _stages[i];
+		stage.dependencies.clear();
+
+		auto addDependency = [&stage](UINT dependency) {
+			if (dependency != NO_STAGE && std::ranges::find(stage.dependencies, dependency) == stage.dependencies.end())
+				stage.dependencies.emplace_back(dependency);
+		};
+
+		for (ResourceID resource : stage.reads)
+			addDependency(lastWriter[resource]);
+
+		for (ResourceID resource : stage.writes)
+		{
+			addDependency(lastWriter[resource]);
+
+			for (UINT reader : readersSinceWrite[resource])
+			{
+				if (reader != i)
+					addDependency(reader);
+			}
+		}
+
+		for (ResourceID resource : stage.reads)
+			readersSinceWrite[resource].emplace_back(i);
+
+		for (ResourceID resource : stage.writes)
+		{
+			lastWriter[resource] = i;
+			readersSinceWrite[resource].clear();
+		}
+	}
+
+	_isCompiled = true;
+}
+
+void FrameGraph::RunStage(UINT index)
+{
+	Stage &stage = _stages[index];
+
+	if (_hasFailed)
+		return;
+
+	if (!stage.function())
+	{
+		stage.failed = true;
+		_hasFailed = true;
+	}
+}
+
+bool FrameGraph::Execute()
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isCompiled)
+		Compile();
+
+	_hasFailed = false;
+	for (Stage &stage : _stages)
+		stage.failed = false;
+
+	const UINT stageCount = GetStageCount();
+	JobSystem &jobSystem = JobSystem::Instance();
+
+	if (jobSystem.GetWorkerCount() == 0)
+	{
+		// Nothing to overlap with, run the stages in the order they were added.
+		for (UINT i = 0; i < stageCount && !_hasFailed; i++)
+		{
+			ZoneNamedNC(stageZone, "Frame Stage", RandomUniqueColor(), true);
+			ZoneNameV(stageZone, _stages[i].name, strlen(_stages[i].name));
+
+			RunStage(i);
+		}
+	}
+	else
+	{
+		std::vector<JobGroup *> dependencyGroups;
+
+		for (UINT i = 0; i < stageCount; i++)
+		{
+			Stage &stage = _stages[i];
+
+			if (stage.mainThread)
+			{
+				jobSystem.Hold(*stage.group);
+				continue;
+			}
+
+			dependencyGroups.clear();
+			for (UINT dependency : stage.dependencies)
+				dependencyGroups.emplace_back(_stages[dependency].group.get());
+
+			jobSystem.Run(*stage.group, [this, i]() { RunStage(i); }, stage.name, dependencyGroups);
+		}
+
+		// Main thread stages only depend on earlier stages, so running them in order cannot wait on a later one.
+		for (UINT i = 0; i < stageCount; i++)
+		{
+			Stage &stage = _stages[i];
+
+			if (!stage.mainThread)
+				continue;
+
+			for (UINT dependency : stage.dependencies)
+				jobSystem.Wait(*_stages[dependency].group);
+
+			{
+				ZoneNamedNC(stageZone, "Frame Stage", RandomUniqueColor(), true);
+				ZoneNameV(stageZone, stage.name, strlen(stage.name));
+
+				RunStage(i);
+			}
+
+			jobSystem.Release(*stage.group);
+		}
+
+		for (Stage &stage : _stages)
+			jobSystem.Wait(*stage.group);
+	}
+
+	for (const Stage &stage : _stages)
+	{
+		if (stage.failed)
+		{
+			ErrMsgF("Frame stage '{}' failed!", stage.name);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+UINT FrameGraph::GetStageCount() const
+{
+	return static_cast<UINT>(_stages.size());
+}
+const std::vector<UINT> &FrameGraph::GetDependencies(UINT stage)
+{
+	if (!_isCompiled)
+		Compile();
+
+	return _stages[stage].dependencies;
+}
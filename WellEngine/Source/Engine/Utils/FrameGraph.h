@@ -0,0 +1,66 @@
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+#include "Utils/JobSystem.h"
+
+// Runs the stages of a frame as jobs, in the order their data allows rather than the order they are written in.
+// Each stage declares the resources it reads and writes. A stage waits for the last earlier stage writing anything
+// it touches, and a writing stage also waits for the earlier stages reading it, so every stage sees the same data
+// it would if the stages ran one after another. Stages sharing nothing run at the same time.
+//
+// Stages marked as main thread run on the thread calling Execute, in the order they were added. Use it for
+// anything touching the immediate context or other single-threaded state.
+class FrameGraph
+{
+public:
+	using ResourceID = UINT;
+	using StageFunction = std::function<bool()>;
+
+private:
+	struct Stage
+	{
+		const char *name = nullptr; // Must outlive the graph.
+		StageFunction function;
+		bool mainThread = false;
+
+		std::vector<ResourceID> reads, writes;
+		std::vector<UINT> dependencies;
+
+		std::unique_ptr<JobGroup> group;
+		bool failed = false;
+	};
+
+	std::vector<const char *> _resources;
+	std::vector<Stage> _stages;
+	bool _isCompiled = false;
+
+	std::atomic_bool _hasFailed = false;
+
+	void Compile();
+	void RunStage(UINT index);
+
+public:
+	FrameGraph() = default;
+	~FrameGraph() = default;
+	FrameGraph(const FrameGraph &other) = delete;
+	FrameGraph &operator=(const FrameGraph &other) = delete;
+	FrameGraph(FrameGraph &&other) = delete;
+	FrameGraph &operator=(FrameGraph &&other) = delete;
+
+	[[nodiscard]] ResourceID AddResource(const char *name);
+
+	void AddStage(const char *name, std::initializer_list<ResourceID> reads, std::initializer_list<ResourceID> writes,
+		StageFunction function, bool mainThread = false);
+
+	// Runs every stage and waits for all of them. Once a stage fails, the stages not yet started are skipped.
+	[[nodiscard]] bool Execute();
+
+	[[nodiscard]] UINT GetStageCount() const;
+	// Indices of the earlier stages a stage waits for.
+	[[nodiscard]] const std::vector<UINT> &GetDependencies(UINT stage);
+
+	TESTABLE()
+};
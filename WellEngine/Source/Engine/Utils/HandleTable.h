@@ -0,0 +1,215 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include "Debug/ErrMsg.h"
+
+template<class T>
+class HandleTable;
+template<class T>
+class IRefTarget;
+
+// Weak reference to an object in a HandleTable, made of a slot index and the generation of the object that
+// held the slot when the handle was created. When the object is destroyed its slot's generation is bumped,
+// so every handle to it stops resolving without having to be found and cleared.
+//
+// Unlike Ref<T>, handles are trivially copyable and the target keeps no list of them, so creating, copying,
+// validating and destroying a handle are all O(1). Use Ref<T> where a destruct callback is needed.
+template<class T>
+class Handle
+{
+private:
+	friend class HandleTable<T>;
+
+	UINT _index = UINT_MAX;
+	UINT _generation = 0;
+
+	Handle(UINT index, UINT generation) noexcept : _index(index), _generation(generation) {}
+
+public:
+	Handle() noexcept = default;
+	Handle(std::nullptr_t) noexcept : Handle() {}
+
+	// Targets must derive from IRefTarget<T>, which holds their slot in the table.
+	Handle(T *target) noexcept
+	{
+		if (target)
+			*this = static_cast<IRefTarget<T> *>(target)->AsHandle();
+	}
+
+	[[nodiscard]] inline T *Get() const noexcept { return HandleTable<T>::Instance().Resolve(*this); }
+	[[nodiscard]] inline bool TryGet(T *&out) const noexcept
+	{
+		out = Get();
+		return out != nullptr;
+	}
+	[[nodiscard]] inline bool IsValid() const noexcept { return Get() != nullptr; }
+	[[nodiscard]] explicit operator bool() const noexcept { return IsValid(); }
+
+	template<class C>
+	[[nodiscard]] inline C *GetAs() const noexcept
+	{
+		static_assert(std::is_base_of_v<T, C>);
+		return dynamic_cast<C *>(Get());
+	}
+
+	// Compares identity, a handle to a destroyed object never equals a handle to the object now in its slot.
+	[[nodiscard]] inline bool operator==(const Handle<T> &other) const noexcept
+	{
+		return _index == other._index && _generation == other._generation;
+	}
+	[[nodiscard]] inline bool operator==(const T *target) const noexcept { return Get() == target; }
+
+	TESTABLE()
+};
+
+
+// Slot map from handles to live objects of one type. Slots are kept in blocks that never move, so handles can be
+// resolved from several threads while other slots are allocated or freed under the table's lock.
+// Freed slots are reused, with a new generation, before any new block is allocated.
+//
+// Resolve() takes no lock. The slot count, slot generations and slot targets are atomic and published with release
+// stores, so a resolving thread that sees a slot also sees its block, and never mixes one object's generation
+// with the target of the object that reused the slot.
+template<class T>
+class HandleTable
+{
+public:
+	static constexpr UINT NULL_SLOT = UINT_MAX;
+
+private:
+	static constexpr UINT SLOTS_PER_BLOCK = 1024;
+	static constexpr UINT MAX_BLOCKS = 1024;
+
+	struct Slot
+	{
+		std::atomic<T *> target{ nullptr };
+		std::atomic<UINT> generation{ 1 }; // Starts at one, so that a default handle never matches.
+		UINT nextFree = NULL_SLOT; // Only accessed under the lock.
+	};
+
+	// The block pointers are written before _slotCount is raised past them, so readers never see a missing block.
+	std::unique_ptr<Slot[]> _blocks[MAX_BLOCKS];
+	UINT _blockCount = 0;
+	std::atomic<UINT> _slotCount = 0;
+	UINT _liveCount = 0;
+	UINT _firstFree = NULL_SLOT;
+	std::mutex _mutex;
+
+	[[nodiscard]] inline Slot &GetSlot(UINT index) noexcept
+	{
+		return _blocks[index / SLOTS_PER_BLOCK][index % SLOTS_PER_BLOCK];
+	}
+	[[nodiscard]] inline const Slot &GetSlot(UINT index) const noexcept
+	{
+		return _blocks[index / SLOTS_PER_BLOCK][index % SLOTS_PER_BLOCK];
+	}
+
+	HandleTable() = default;
+
+public:
+	~HandleTable() = default;
+	HandleTable(const HandleTable &other) = delete;
+	HandleTable &operator=(const HandleTable &other) = delete;
+	HandleTable(HandleTable &&other) = delete;
+	HandleTable &operator=(HandleTable &&other) = delete;
+
+	[[nodiscard]] static HandleTable &Instance() noexcept
+	{
+		static HandleTable instance;
+		return instance;
+	}
+
+	// Places a target in a free slot and returns its index, or NULL_SLOT if the table is full.
+	[[nodiscard]] UINT Allocate(T *target) noexcept
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		UINT index = _firstFree;
+		if (index != NULL_SLOT)
+		{
+			Slot &slot = GetSlot(index);
+			_firstFree = slot.nextFree;
+			slot.nextFree = NULL_SLOT;
+			slot.target.store(target, std::memory_order_release);
+		}
+		else
+		{
+			index = _slotCount.load(std::memory_order_relaxed);
+
+			if (index == _blockCount * SLOTS_PER_BLOCK)
+			{
+				if (_blockCount == MAX_BLOCKS)
+				{
+					ErrMsg("Handle table is full!");
+					return NULL_SLOT;
+				}
+
+				_blocks[_blockCount++] = std::make_unique<Slot[]>(SLOTS_PER_BLOCK);
+			}
+
+			// The slot is not visible to Resolve() until the count is raised.
+			GetSlot(index).target.store(target, std::memory_order_relaxed);
+			_slotCount.store(index + 1, std::memory_order_release);
+		}
+
+		_liveCount++;
+		return index;
+	}
+
+	// Empties a slot, invalidating every handle to it.
+	void Free(UINT index) noexcept
+	{
+		if (index == NULL_SLOT)
+			return;
+
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		Slot &slot = GetSlot(index);
+		slot.target.store(nullptr, std::memory_order_release);
+		slot.generation.fetch_add(1, std::memory_order_release);
+		slot.nextFree = _firstFree;
+		_firstFree = index;
+		_liveCount--;
+	}
+
+	// Points a slot at a new target, keeping existing handles valid.
+	void Retarget(UINT index, T *target) noexcept
+	{
+		if (index == NULL_SLOT)
+			return;
+
+		GetSlot(index).target.store(target, std::memory_order_release);
+	}
+
+	[[nodiscard]] inline Handle<T> MakeHandle(UINT index) noexcept
+	{
+		if (index == NULL_SLOT)
+			return Handle<T>();
+
+		return Handle<T>(index, GetSlot(index).generation.load(std::memory_order_acquire));
+	}
+
+	[[nodiscard]] inline T *Resolve(const Handle<T> &handle) const noexcept
+	{
+		if (handle._index >= _slotCount.load(std::memory_order_acquire))
+			return nullptr;
+
+		const Slot &slot = GetSlot(handle._index);
+		if (slot.generation.load(std::memory_order_acquire) != handle._generation)
+			return nullptr;
+
+		T *target = slot.target.load(std::memory_order_acquire);
+
+		// If the slot was freed and reused after the first check, the target belongs to another object.
+		if (slot.generation.load(std::memory_order_acquire) != handle._generation)
+			return nullptr;
+
+		return target;
+	}
+
+	[[nodiscard]] UINT GetLiveCount() const noexcept { return _liveCount; }
+
+	TESTABLE()
+};
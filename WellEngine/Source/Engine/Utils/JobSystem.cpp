@@ -0,0 +1,344 @@
+#include "stdafx.h"
+#include "Utils/JobSystem.h"
+
+#ifdef LEAK_DETECTION
+#define new			DEBUG_NEW
+#endif
+
+// How many ranges ParallelFor splits work into per thread, so that threads finishing early can steal the rest.
+constexpr UINT RANGES_PER_THREAD = 4;
+
+JobGroup::~JobGroup()
+{
+	// The last job of the group may still be releasing the lock after marking it done.
+	std::lock_guard<std::mutex> lock(_mutex);
+}
+
+JobSystem::~JobSystem()
+{
+	Shutdown();
+}
+
+JobSystem &JobSystem::Instance()
+{
+	static JobSystem instance;
+	return instance;
+}
+
+bool JobSystem::Initialize(UINT workerCount)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (_isRunning)
+	{
+		Warn("Job system is already initialized!");
+		return true;
+	}
+
+	if (workerCount == 0)
+	{
+		const UINT coreCount = std::thread::hardware_concurrency();
+		workerCount = (coreCount > RESERVED_THREADS + 1) ? coreCount - RESERVED_THREADS : 1;
+	}
+
+	_queues.clear();
+	for (UINT i = 0; i < workerCount + 1; i++)
+		_queues.emplace_back(std::make_unique<JobQueue>());
+
+	_isRunning = true;
+
+	_workers.reserve(workerCount);
+	for (UINT i = 0; i < workerCount; i++)
+		_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+
+	DbgMsgF("Started {} job workers.", workerCount);
+	return true;
+}
+
+void JobSystem::Shutdown()
+{
+	if (!_isRunning)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_isRunning = false;
+	}
+	_wakeCondition.notify_all();
+
+	for (std::thread &worker : _workers)
+		worker.join();
+
+	_workers.clear();
+	_queues.clear();
+}
+
+UINT JobSystem::GetWorkerCount() const
+{
+	return static_cast<UINT>(_workers.size());
+}
+UINT JobSystem::GetConcurrency() const
+{
+	return GetWorkerCount() + 1;
+}
+
+void JobSystem::WorkerLoop(UINT workerIndex)
+{
+	_workerIndex = workerIndex;
+
+#ifdef TRACY_ENABLE
+	const std::string threadName = std::format("Job Worker {}", workerIndex);
+	tracy::SetThreadNameWithHint(threadName.c_str(), 983464687);
+#endif
+
+	while (true)
+	{
+		if (Job *job = Dequeue())
+		{
+			Execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_sleepMutex);
+
+		// Queued jobs are drained before the workers stop.
+		if (!_isRunning && _queuedCount == 0)
+			break;
+
+		_sleepingCount++;
+		_wakeCondition.wait(lock, [this]() { return _queuedCount > 0 || !_isRunning; });
+		_sleepingCount--;
+	}
+}
+
+void JobSystem::Enqueue(Job *job)
+{
+	const UINT queueIndex = (_workerIndex != NOT_A_WORKER) ? _workerIndex : static_cast<UINT>(_queues.size()) - 1;
+	JobQueue &queue = *_queues[queueIndex];
+
+	// Counted before it can be taken, so the count never drops below the jobs still queued.
+	_queuedCount++;
+
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.emplace_back(job);
+	}
+
+	// Sleeping threads count themselves before checking for jobs, so either they see this job or it sees them.
+	if (_sleepingCount > 0)
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_wakeCondition.notify_one();
+	}
+}
+
+JobSystem::Job *JobSystem::Dequeue()
+{
+	if (_queuedCount == 0)
+		return nullptr;
+
+	const UINT workerCount = GetWorkerCount();
+
+	// Newest job of our own queue first, its data is most likely still in cache.
+	if (_workerIndex != NOT_A_WORKER)
+	{
+		JobQueue &queue = *_queues[_workerIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (!queue.jobs.empty())
+		{
+			Job *job = queue.jobs.back();
+			queue.jobs.pop_back();
+			_queuedCount--;
+			return job;
+		}
+	}
+
+	// Then the oldest job of the shared queue, and of every other worker in turn.
+	const UINT start = (_workerIndex != NOT_A_WORKER) ? _workerIndex + 1 : 0;
+	for (UINT i = 0; i < workerCount + 1; i++)
+	{
+		const UINT queueIndex = (start + i) % (workerCount + 1);
+		if (queueIndex == _workerIndex)
+			continue;
+
+		JobQueue &queue = *_queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (!queue.jobs.empty())
+		{
+			Job *job = queue.jobs.front();
+			queue.jobs.pop_front();
+			_queuedCount--;
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+void JobSystem::Execute(Job *job)
+{
+	{
+		ZoneScopedC(RandomUniqueColor());
+		if (job->name)
+			ZoneName(job->name, strlen(job->name));
+
+		job->function();
+	}
+
+	JobGroup &group = *job->group;
+	delete job;
+
+	Finish(group);
+}
+
+void JobSystem::Finish(JobGroup &group)
+{
+	std::vector<Job *> dependents;
+	{
+		// Decremented under the lock, so a waiter seeing the group done cannot destroy it before it is unlocked.
+		std::lock_guard<std::mutex> lock(group._mutex);
+
+		if (--group._pending != 0)
+			return;
+
+		dependents.swap(group._dependents);
+	}
+
+	// Threads waiting on the group may be sleeping alongside the workers.
+	if (_sleepingCount > 0)
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_wakeCondition.notify_all();
+	}
+
+	for (Job *dependent : dependents)
+	{
+		if (--dependent->unmetDependencies == 0)
+			Enqueue(dependent);
+	}
+}
+
+void JobSystem::Submit(JobGroup &group, JobFunction function, const char *name, JobGroup *const *dependencies, size_t dependencyCount)
+{
+	if (!_isRunning)
+	{
+		// Without workers everything runs in submission order, so the dependencies are already done.
+		ZoneScopedC(RandomUniqueColor());
+		if (name)
+			ZoneName(name, strlen(name));
+
+		function();
+		return;
+	}
+
+	Job *job = new Job();
+	job->function = std::move(function);
+	job->name = name;
+	job->group = &group;
+
+	group._pending++;
+
+	// Held back by one extra dependency until every group has been checked, so it cannot start halfway through.
+	job->unmetDependencies = static_cast<UINT>(dependencyCount) + 1;
+
+	for (size_t i = 0; i < dependencyCount; i++)
+	{
+		JobGroup *dependency = dependencies[i];
+
+		if (!dependency)
+		{
+			job->unmetDependencies--;
+			continue;
+		}
+
+		std::lock_guard<std::mutex> lock(dependency->_mutex);
+
+		if (dependency->IsDone())
+			job->unmetDependencies--;
+		else
+			dependency->_dependents.emplace_back(job);
+	}
+
+	if (--job->unmetDependencies == 0)
+		Enqueue(job);
+}
+void JobSystem::Run(JobGroup &group, JobFunction function, const char *name, std::initializer_list<JobGroup *> dependencies)
+{
+	Submit(group, std::move(function), name, dependencies.begin(), dependencies.size());
+}
+void JobSystem::Run(JobGroup &group, JobFunction function, const char *name, const std::vector<JobGroup *> &dependencies)
+{
+	Submit(group, std::move(function), name, dependencies.data(), dependencies.size());
+}
+
+void JobSystem::Hold(JobGroup &group)
+{
+	std::lock_guard<std::mutex> lock(group._mutex);
+	group._pending++;
+}
+void JobSystem::Release(JobGroup &group)
+{
+	Finish(group);
+}
+
+void JobSystem::ParallelFor(JobGroup &group, UINT count, UINT minRangeSize, RangeFunction function, const char *name)
+{
+	if (count == 0)
+		return;
+
+	minRangeSize = std::max<UINT>(minRangeSize, 1);
+
+	const UINT rangeCount = std::min<UINT>((count + minRangeSize - 1) / minRangeSize, GetConcurrency() * RANGES_PER_THREAD);
+	const UINT rangeSize = count / rangeCount;
+	const UINT remainder = count % rangeCount;
+
+	// Shared by every range rather than copied into each job.
+	auto sharedFunction = std::make_shared<RangeFunction>(std::move(function));
+
+	UINT begin = 0;
+	for (UINT i = 0; i < rangeCount; i++)
+	{
+		const UINT end = begin + rangeSize + ((i < remainder) ? 1 : 0);
+		Run(group, [sharedFunction, begin, end]() { (*sharedFunction)(begin, end); }, name);
+		begin = end;
+	}
+}
+void JobSystem::ParallelFor(UINT count, UINT minRangeSize, RangeFunction function, const char *name)
+{
+	if (count == 0)
+		return;
+
+	// Not worth the scheduling overhead, run it here.
+	if (count <= std::max<UINT>(minRangeSize, 1) || !_isRunning)
+	{
+		function(0, count);
+		return;
+	}
+
+	JobGroup group;
+	ParallelFor(group, count, minRangeSize, std::move(function), name);
+	Wait(group);
+}
+
+void JobSystem::Wait(JobGroup &group)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	while (!group.IsDone())
+	{
+		if (Job *job = Dequeue())
+		{
+			Execute(job);
+			continue;
+		}
+
+		// The rest of the group is running elsewhere, sleep until it is done or there is another job to help with.
+		std::unique_lock<std::mutex> lock(_sleepMutex);
+
+		_sleepingCount++;
+		_wakeCondition.wait(lock, [this, &group]() { return group.IsDone() || _queuedCount > 0 || !_isRunning; });
+		_sleepingCount--;
+	}
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobGroup;
+
+// Engine-wide work-stealing scheduler, with one worker thread per core not already used by the main and culling threads.
+// Each worker has its own queue, taking its newest job first and stealing the oldest jobs of others when it runs dry.
+// Jobs submitted from outside the workers go to a shared queue. Threads waiting on a group run queued jobs until it is
+// done, so waits can be nested inside jobs. If no workers are running, jobs run immediately on the submitting thread.
+class JobSystem
+{
+public:
+	using JobFunction = std::function<void()>;
+	using RangeFunction = std::function<void(UINT begin, UINT end)>;
+
+private:
+	friend class JobGroup;
+
+	struct Job
+	{
+		JobFunction function;
+		const char *name = nullptr; // Must outlive the job.
+		JobGroup *group = nullptr;
+		std::atomic<UINT> unmetDependencies = 0;
+	};
+
+	struct JobQueue
+	{
+		std::mutex mutex;
+		std::deque<Job *> jobs;
+	};
+
+	// Threads reserved for the main and culling threads.
+	static constexpr UINT RESERVED_THREADS = 2;
+	static constexpr UINT NOT_A_WORKER = UINT_MAX;
+
+	static inline thread_local UINT _workerIndex = NOT_A_WORKER;
+
+	std::vector<std::thread> _workers;
+	std::vector<std::unique_ptr<JobQueue>> _queues; // One per worker, then the shared queue.
+
+	std::atomic<UINT> _queuedCount = 0;
+	std::atomic<UINT> _sleepingCount = 0;
+	std::atomic_bool _isRunning = false;
+	std::mutex _sleepMutex;
+	std::condition_variable _wakeCondition;
+
+	JobSystem() = default;
+
+	void WorkerLoop(UINT workerIndex);
+
+	void Submit(JobGroup &group, JobFunction function, const char *name, JobGroup *const *dependencies, size_t dependencyCount);
+
+	void Enqueue(Job *job);
+	[[nodiscard]] Job *Dequeue();
+	void Execute(Job *job);
+	void Finish(JobGroup &group);
+
+public:
+	~JobSystem();
+	JobSystem(const JobSystem &other) = delete;
+	JobSystem &operator=(const JobSystem &other) = delete;
+	JobSystem(JobSystem &&other) = delete;
+	JobSystem &operator=(JobSystem &&other) = delete;
+
+	[[nodiscard]] static JobSystem &Instance();
+
+	// Starts the workers. A worker count of zero sizes the pool to the machine's core count.
+	[[nodiscard]] bool Initialize(UINT workerCount = 0);
+	// Runs all queued jobs to completion, then stops the workers.
+	void Shutdown();
+
+	[[nodiscard]] UINT GetWorkerCount() const;
+	// Threads that can run jobs at once, the workers plus one waiting thread.
+	[[nodiscard]] UINT GetConcurrency() const;
+
+	// Queues a job in a group. It starts once every dependency group is done.
+	void Run(JobGroup &group, JobFunction function, const char *name = nullptr, std::initializer_list<JobGroup *> dependencies = {});
+	void Run(JobGroup &group, JobFunction function, const char *name, const std::vector<JobGroup *> &dependencies);
+
+	// Keeps a group from being done until released, so jobs can depend on work done outside the job system.
+	// Jobs run without workers do not wait for held groups.
+	void Hold(JobGroup &group);
+	void Release(JobGroup &group);
+
+	// Splits [0, count) into ranges of at least minRangeSize and runs them as jobs in a group, without waiting.
+	void ParallelFor(JobGroup &group, UINT count, UINT minRangeSize, RangeFunction function, const char *name = nullptr);
+	// Splits [0, count) into ranges of at least minRangeSize, runs them as jobs and waits for all of them.
+	void ParallelFor(UINT count, UINT minRangeSize, RangeFunction function, const char *name = nullptr);
+
+	// Runs queued jobs on this thread until the group is done, sleeping while there are none to run.
+	void Wait(JobGroup &group);
+
+	TESTABLE()
+};
+
+
+// Tracks a set of jobs. Waiting on a group returns once every job run in it has finished, and jobs may
+// depend on groups to not start before them. A group can be reused once it is done.
+class JobGroup
+{
+private:
+	friend class JobSystem;
+
+	std::atomic<UINT> _pending = 0;
+
+	// Jobs waiting for this group to finish.
+	std::mutex _mutex;
+	std::vector<JobSystem::Job *> _dependents;
+
+public:
+	JobGroup() = default;
+	~JobGroup();
+	JobGroup(const JobGroup &other) = delete;
+	JobGroup &operator=(const JobGroup &other) = delete;
+	JobGroup(JobGroup &&other) = delete;
+	JobGroup &operator=(JobGroup &&other) = delete;
+
+	[[nodiscard]] inline bool IsDone() const { return _pending.load() == 0; }
+
+	TESTABLE()
+};
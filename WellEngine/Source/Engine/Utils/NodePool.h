@@ -0,0 +1,130 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+// Index of no node in a NodePool.
+constexpr UINT NULL_POOL_NODE = UINT_MAX;
+
+// Fixed-size block allocator for the nodes of spatial trees. Nodes are addressed by index and
+// live in blocks that are never moved or freed until the pool is cleared, so both indices and
+// pointers to nodes stay valid while a tree splits and collapses. Freed nodes are recycled
+// before any new block is allocated.
+template <class NodeType, UINT NODES_PER_BLOCK = 64>
+class NodePool
+{
+public:
+	static constexpr UINT NULL_NODE = NULL_POOL_NODE;
+
+private:
+	std::vector<std::unique_ptr<NodeType[]>> _blocks;
+	std::vector<UINT> _freeNodes;
+	UINT _allocatedCount = 0; // Nodes handed out at least once, including freed ones.
+	UINT _liveCount = 0;
+
+	// Tracy memory pool name, must outlive the pool.
+	const char *_name;
+
+public:
+	explicit NodePool(const char *name) : _name(name) {}
+	~NodePool() { Clear(); }
+	NodePool(const NodePool &other) = delete;
+	NodePool &operator=(const NodePool &other) = delete;
+	NodePool(NodePool &&other) = delete;
+	NodePool &operator=(NodePool &&other) = delete;
+
+	[[nodiscard]] UINT Allocate()
+	{
+		UINT index;
+
+		if (!_freeNodes.empty())
+		{
+			index = _freeNodes.back();
+			_freeNodes.pop_back();
+		}
+		else
+		{
+			if (_allocatedCount == _blocks.size() * NODES_PER_BLOCK)
+				_blocks.emplace_back(std::make_unique<NodeType[]>(NODES_PER_BLOCK));
+
+			index = _allocatedCount++;
+		}
+
+		NodeType &node = (*this)[index];
+		node = NodeType();
+		_liveCount++;
+
+#ifdef TRACY_MEMORY
+		TracyAllocN(&node, sizeof(NodeType), _name);
+#endif
+		return index;
+	}
+
+	void Free(UINT index)
+	{
+		if (index == NULL_NODE)
+			return;
+
+		NodeType &node = (*this)[index];
+
+#ifdef TRACY_MEMORY
+		TracyFreeN(&node, _name);
+#endif
+
+		// Release anything the node holds now rather than when it is reused.
+		node = NodeType();
+		_freeNodes.emplace_back(index);
+		_liveCount--;
+	}
+
+	// Allocates the blocks for nodeCount nodes up front. As long as no more than nodeCount nodes are
+	// allocated, the block list is never modified, so other threads may keep accessing existing nodes
+	// while Allocate() is called under a lock.
+	void Reserve(UINT nodeCount)
+	{
+		const size_t blockCount = (nodeCount + NODES_PER_BLOCK - 1) / NODES_PER_BLOCK;
+
+		_blocks.reserve(blockCount);
+		while (_blocks.size() < blockCount)
+			_blocks.emplace_back(std::make_unique<NodeType[]>(NODES_PER_BLOCK));
+	}
+
+	// Frees every node and releases all blocks.
+	void Clear()
+	{
+#ifdef TRACY_MEMORY
+		if (_liveCount > 0)
+		{
+			std::vector<bool> isFree(_allocatedCount, false);
+			for (UINT index : _freeNodes)
+				isFree[index] = true;
+
+			for (UINT i = 0; i < _allocatedCount; i++)
+			{
+				if (!isFree[i])
+					TracyFreeN(&(*this)[i], _name);
+			}
+		}
+#endif
+
+		_blocks.clear();
+		_freeNodes.clear();
+		_allocatedCount = 0;
+		_liveCount = 0;
+	}
+
+	[[nodiscard]] inline NodeType &operator[](UINT index)
+	{
+		return _blocks[index / NODES_PER_BLOCK][index % NODES_PER_BLOCK];
+	}
+	[[nodiscard]] inline const NodeType &operator[](UINT index) const
+	{
+		return _blocks[index / NODES_PER_BLOCK][index % NODES_PER_BLOCK];
+	}
+
+	[[nodiscard]] UINT GetLiveCount() const { return _liveCount; }
+	[[nodiscard]] UINT GetFreeCount() const { return static_cast<UINT>(_freeNodes.size()); }
+	[[nodiscard]] UINT GetCapacity() const { return static_cast<UINT>(_blocks.size()) * NODES_PER_BLOCK; }
+
+	TESTABLE()
+};
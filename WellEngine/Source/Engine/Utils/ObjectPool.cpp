@@ -0,0 +1,169 @@
+#include "stdafx.h"
+#include "Utils/ObjectPool.h"
+
+#ifdef LEAK_DETECTION
+#define new			DEBUG_NEW
+#endif
+
+ObjectPool::ObjectPool(const char *name, size_t objectSize, UINT slotsPerBlock) :
+	_name(name), _objectSize(objectSize), _slotsPerBlock(std::max<UINT>(slotsPerBlock, 1))
+{
+	// Free slots store the free list in place, so each must fit a pointer.
+	const size_t minSize = std::max<size_t>(objectSize, sizeof(FreeSlot));
+	_slotSize = (minSize + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+}
+ObjectPool::~ObjectPool()
+{
+	// Any objects still alive are leaked by their owners, their memory goes with the pool.
+	for (std::byte *block : _blocks)
+		delete[] block;
+
+	_blocks.clear();
+	_freeList = nullptr;
+}
+
+size_t ObjectPool::GetBlockSize() const
+{
+	return _slotSize * _slotsPerBlock;
+}
+size_t ObjectPool::FindBlock(const void *ptr) const
+{
+	const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+
+	auto it = std::upper_bound(_blocks.begin(), _blocks.end(), address, [](uintptr_t address, const std::byte *block) {
+		return address < reinterpret_cast<uintptr_t>(block);
+	});
+
+	if (it == _blocks.begin())
+		return _blocks.size();
+
+	--it;
+	if (address >= reinterpret_cast<uintptr_t>(*it) + GetBlockSize())
+		return _blocks.size();
+
+	return static_cast<size_t>(it - _blocks.begin());
+}
+
+void *ObjectPool::Allocate()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (!_freeList)
+	{
+		std::byte *block = new std::byte[GetBlockSize()];
+		_blocks.insert(std::upper_bound(_blocks.begin(), _blocks.end(), block, [](const std::byte *a, const std::byte *b) {
+			return reinterpret_cast<uintptr_t>(a) < reinterpret_cast<uintptr_t>(b);
+		}), block);
+
+		// Linked back to front, so the block is handed out in address order.
+		for (UINT i = _slotsPerBlock; i-- > 0;)
+		{
+			FreeSlot *slot = reinterpret_cast<FreeSlot *>(block + i * _slotSize);
+			slot->next = _freeList;
+			_freeList = slot;
+		}
+	}
+
+	FreeSlot *slot = _freeList;
+	_freeList = slot->next;
+	_liveCount++;
+
+#ifdef TRACY_MEMORY
+	TracyAllocN(slot, _objectSize, _name);
+#endif
+	return slot;
+}
+
+bool ObjectPool::Free(void *ptr)
+{
+	if (!ptr)
+		return true;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (FindBlock(ptr) == _blocks.size())
+		return false;
+
+#ifdef TRACY_MEMORY
+	TracyFreeN(ptr, _name);
+#endif
+
+	FreeSlot *slot = static_cast<FreeSlot *>(ptr);
+	slot->next = _freeList;
+	_freeList = slot;
+	_liveCount--;
+	return true;
+}
+
+bool ObjectPool::Owns(const void *ptr) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return FindBlock(ptr) != _blocks.size();
+}
+
+size_t ObjectPool::ReleaseEmptyBlocks()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (_blocks.empty())
+		return 0;
+
+	std::vector<UINT> freeCounts(_blocks.size(), 0);
+	for (FreeSlot *slot = _freeList; slot; slot = slot->next)
+		freeCounts[FindBlock(slot)]++;
+
+	// Unlink the slots of empty blocks, keeping the rest in the same order.
+	FreeSlot *slot = _freeList;
+	FreeSlot **tail = &_freeList;
+	while (slot)
+	{
+		FreeSlot *next = slot->next;
+
+		if (freeCounts[FindBlock(slot)] < _slotsPerBlock)
+		{
+			*tail = slot;
+			tail = &slot->next;
+		}
+
+		slot = next;
+	}
+	*tail = nullptr;
+
+	size_t keptCount = 0;
+	for (size_t i = 0; i < _blocks.size(); i++)
+	{
+		if (freeCounts[i] == _slotsPerBlock)
+			delete[] _blocks[i];
+		else
+			_blocks[keptCount++] = _blocks[i];
+	}
+
+	const size_t releasedCount = _blocks.size() - keptCount;
+	_blocks.resize(keptCount);
+
+	return releasedCount * GetBlockSize();
+}
+
+const char *ObjectPool::GetName() const
+{
+	return _name;
+}
+size_t ObjectPool::GetObjectSize() const
+{
+	return _objectSize;
+}
+UINT ObjectPool::GetLiveCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _liveCount;
+}
+UINT ObjectPool::GetCapacity() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return static_cast<UINT>(_blocks.size()) * _slotsPerBlock;
+}
+size_t ObjectPool::GetReservedBytes() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _blocks.size() * GetBlockSize();
+}
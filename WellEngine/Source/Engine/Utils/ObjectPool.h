@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Slab allocator handing out raw memory for objects of one size. Objects are packed into blocks of slotsPerBlock
+// slots, and freed slots are reused before another block is allocated, so objects created together stay close
+// together and creating and destroying them often does not churn the heap. Blocks are only given back to the heap
+// by ReleaseEmptyBlocks, typically after a scene unloads and frees most of its objects at once.
+//
+// The pool only handles memory. Use it through a class-specific operator new and delete so that objects are still
+// constructed and destroyed as usual. Every member is safe to call from several threads at once.
+class ObjectPool
+{
+private:
+	struct FreeSlot
+	{
+		FreeSlot *next = nullptr;
+	};
+
+	const char *_name; // Must outlive the pool.
+	size_t _objectSize;
+	size_t _slotSize;
+	UINT _slotsPerBlock;
+
+	std::vector<std::byte *> _blocks; // Sorted by address.
+	FreeSlot *_freeList = nullptr;
+	UINT _liveCount = 0;
+
+	mutable std::mutex _mutex;
+
+	[[nodiscard]] size_t GetBlockSize() const;
+	// Index of the block containing ptr, or _blocks.size() if no block does.
+	[[nodiscard]] size_t FindBlock(const void *ptr) const;
+
+public:
+	// Slots are aligned to the default new alignment, so objects with stricter alignment cannot be pooled.
+	static constexpr size_t SLOT_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+	ObjectPool(const char *name, size_t objectSize, UINT slotsPerBlock = 64);
+	~ObjectPool();
+	ObjectPool(const ObjectPool &other) = delete;
+	ObjectPool &operator=(const ObjectPool &other) = delete;
+	ObjectPool(ObjectPool &&other) = delete;
+	ObjectPool &operator=(ObjectPool &&other) = delete;
+
+	// Returns memory for one object of at most the pool's object size.
+	[[nodiscard]] void *Allocate();
+	// Returns an object's memory to the pool. Returns false without freeing anything if the pool does not own ptr.
+	bool Free(void *ptr);
+	[[nodiscard]] bool Owns(const void *ptr) const;
+
+	// Frees every block without live objects and returns how many bytes were freed.
+	size_t ReleaseEmptyBlocks();
+
+	[[nodiscard]] const char *GetName() const;
+	[[nodiscard]] size_t GetObjectSize() const;
+	[[nodiscard]] UINT GetLiveCount() const;
+	[[nodiscard]] UINT GetCapacity() const;
+	// Bytes held from the heap, including free slots.
+	[[nodiscard]] size_t GetReservedBytes() const;
+
+	TESTABLE()
+};
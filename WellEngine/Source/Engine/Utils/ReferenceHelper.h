@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "Debug/ErrMsg.h"
+#include "HandleTable.h"
 #ifdef TRACY_REFS
 #include "Math/ConstRand.h"
 #endif
@@ -23,6 +24,9 @@ private:
 	friend class Ref<T>;
 	std::vector<Ref<T> *> _refs;
 
+	// Slot in HandleTable<T>, allocated the first time a handle is requested.
+	UINT _handleSlot = HandleTable<T>::NULL_SLOT;
+
 	inline void AddRef(Ref<T> *ref) noexcept 
 	{
 #ifdef TRACY_REFS
@@ -91,6 +95,20 @@ protected:
 
 		_refs.insert(_refs.end(), other._refs.begin(), other._refs.end());
 		other._refs.clear(); // Clear the old target's references
+
+		// Handles are inherited too, unless this target already has its own.
+		if (other._handleSlot != HandleTable<T>::NULL_SLOT)
+		{
+			if (_handleSlot == HandleTable<T>::NULL_SLOT)
+			{
+				_handleSlot = other._handleSlot;
+				HandleTable<T>::Instance().Retarget(_handleSlot, static_cast<T *>(this));
+			}
+			else
+				HandleTable<T>::Instance().Free(other._handleSlot);
+
+			other._handleSlot = HandleTable<T>::NULL_SLOT;
+		}
 	}
 
 public:
@@ -124,6 +142,8 @@ public:
 
 			ref->TargetDestructed(); // Notify references that the target is being destructed
 		}
+
+		HandleTable<T>::Instance().Free(_handleSlot); // Invalidates all handles to this target
 	}
 
 	[[nodiscard]] inline Ref<T> AsRef(const char *identifier = nullptr) noexcept
@@ -142,6 +162,16 @@ public:
 #endif
 	}
 
+	// Handles are cheaper than references to create, copy and destroy, but can not notify their owner when the
+	// target is destructed. Requesting the first handle of a target must not race with another request for it.
+	[[nodiscard]] inline Handle<T> AsHandle() noexcept
+	{
+		if (_handleSlot == HandleTable<T>::NULL_SLOT)
+			_handleSlot = HandleTable<T>::Instance().Allocate(static_cast<T *>(this));
+
+		return HandleTable<T>::Instance().MakeHandle(_handleSlot);
+	}
+
 	[[nodiscard]] const std::vector<Ref<T> *> &GetRefs() const noexcept 
 	{
 #ifdef TRACY_REFS
@@ -626,6 +656,15 @@ public:
 		return (bool)*this; 
 	}
 
+	// Converts to a handle to the same target, for migrating code that does not need destruct callbacks.
+	[[nodiscard]] inline Handle<T> ToHandle() const noexcept
+	{
+		if (!_ref)
+			return Handle<T>();
+
+		return _ref->AsHandle();
+	}
+
 	template<class C>
 	[[nodiscard]] inline C *GetAs() const noexcept 
 	{
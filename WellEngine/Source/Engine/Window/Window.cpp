@@ -13,6 +13,11 @@ bool Window::SetupWindow()
 	initFlags |= SDL_INIT_VIDEO;
 	initFlags |= SDL_INIT_EVENTS;
 
+#ifdef HEADLESS
+	// Windows and events still work as usual, but nothing is ever shown on a display.
+	SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+#endif
+
 	if (!SDL_Init(initFlags))
 	{
 		ErrMsgF("Error initializing SDL: {}", SDL_GetError());
@@ -21,6 +26,9 @@ bool Window::SetupWindow()
 
 	SDL_WindowFlags windowFlags = 0;
 	windowFlags |= SDL_WINDOW_RESIZABLE;
+#ifdef HEADLESS
+	windowFlags |= SDL_WINDOW_HIDDEN;
+#endif
 
 #ifdef DEBUG_BUILD
 	DebugData &debugData = DebugData::Get();
@@ -35,6 +43,9 @@ bool Window::SetupWindow()
 		return false;
 	}
 
+#ifdef HEADLESS
+	// Offscreen windows have no native handle, and nothing needs one without a device.
+#else
 	SDL_PropertiesID props = SDL_GetWindowProperties(_window);
 	_hwnd = (HWND)SDL_GetPointerProperty(props, SDL_PROP_WINDOW_WIN32_HWND_POINTER, NULL);
 	if (!_hwnd) 
@@ -42,6 +53,7 @@ bool Window::SetupWindow()
 		ErrMsgF("Couldn't get window handle: {}", SDL_GetError());
 		return false;
 	}
+#endif
     return true;
 }
 
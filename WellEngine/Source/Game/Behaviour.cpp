@@ -1,21 +1,58 @@
 #include "stdafx.h"
 #include "Behaviour.h"
+#include "BehaviourRegistry.h"
 #include "Behaviours/CameraBehaviour.h"
 #include "Rendering/RenderQueuer.h"
 #include "Scenes/Scene.h"
 #include "Entity.h"
+#include "ObjectPools.h"
 
 #ifdef LEAK_DETECTION
 #define new			DEBUG_NEW
 #endif
 
+#pragma push_macro("new")
+#undef new
+void *Behaviour::operator new(size_t size)
+{
+	if (ObjectPool *pool = ObjectPools::GetBehaviourPool(size))
+		return pool->Allocate();
+
+	return ::operator new(size);
+}
+void Behaviour::operator delete(void *ptr, size_t size) noexcept
+{
+	// The size is that of the most derived type, so it finds the same pool as when it was allocated.
+	ObjectPool *pool = ObjectPools::GetBehaviourPool(size);
+	if (!pool || !pool->Free(ptr))
+		::operator delete(ptr);
+}
+#ifdef LEAK_DETECTION
+void *Behaviour::operator new(size_t size, int blockUse, const char *fileName, int lineNumber)
+{
+	return ::operator new(size, blockUse, fileName, lineNumber);
+}
+void Behaviour::operator delete(void *ptr, int blockUse, const char *fileName, int lineNumber) noexcept
+{
+	::operator delete(ptr);
+}
+#endif
+#pragma pop_macro("new")
+
 Behaviour::~Behaviour()
 {
 	_isDestroyed = true;
-	DequeueUpdate();
-	DequeueParallelUpdate();
-	DequeueLateUpdate();
-	DequeueFixedUpdate();
+
+	// Behaviours on entities outside a scene were never queued or registered.
+	if (Scene *scene = GetScene())
+	{
+		DequeueUpdate();
+		DequeueParallelUpdate();
+		DequeueLateUpdate();
+		DequeueFixedUpdate();
+
+		scene->UnregisterBehaviourType(this);
+	}
 }
 
 bool Behaviour::Initialize(Entity *entity, const std::string &behaviourName)
@@ -36,8 +73,12 @@ bool Behaviour::Initialize(Entity *entity, const std::string &behaviourName)
 	}
 
 	_entity = entity;
+	_typeID = BehaviourRegistry::GetTypeID(typeid(*this));
 	entity->AddBehaviour(this);
 
+	if (Scene *scene = GetScene())
+		scene->RegisterBehaviourType(this);
+
 	if (behaviourName.empty())
 	{
 		_name = behaviourName;
@@ -139,6 +180,10 @@ Game *Behaviour::GetGame() const
 
 	return _entity->GetGame();
 }
+UINT Behaviour::GetTypeID() const
+{
+	return _typeID;
+}
 
 void Behaviour::SetName(const std::string &name)
 {
@@ -153,6 +198,27 @@ bool Behaviour::IsEnabled() const
 {
 	return _entity->IsEnabled() && _isEnabledSelf;
 }
+bool Behaviour::ShouldUpdate() const
+{
+	if (!IsEnabled())
+		return false;
+
+	if (_entity->IsRemoved())
+		return false;
+
+	if (!_isInitialized)
+	{
+#ifdef DEBUG_BUILD
+		// Parallel updates can get here from several workers at once.
+		static std::mutex warnMutex;
+		std::lock_guard<std::mutex> lock(warnMutex);
+		Warn("Behaviour is not initialized!");
+#endif
+		return false;
+	}
+
+	return true;
+}
 bool Behaviour::IsEnabledSelf() const
 {
 	return _isEnabledSelf;
@@ -193,18 +259,9 @@ void Behaviour::SetDirty()
 
 bool Behaviour::InitialUpdate(TimeUtils &time, const Input &input)
 {
-	if (!IsEnabled())
-		return true;
-
-	if (_entity->IsRemoved())
+	if (!ShouldUpdate())
 		return true;
 
-	if (!_isInitialized)
-	{
-		Warn("Behaviour is not initialized!");
-		return true;
-	}
-
 	ZoneScopedXC(RandomUniqueColor());
 	const std::string &name = GetName();
 	ZoneTextX(name.c_str(), name.size());
@@ -213,21 +270,9 @@ bool Behaviour::InitialUpdate(TimeUtils &time, const Input &input)
 }
 bool Behaviour::InitialParallelUpdate(const TimeUtils &time, const Input &input)
 {
-	if (!IsEnabled())
-		return true;
-
-	if (_entity->IsRemoved())
+	if (!ShouldUpdate())
 		return true;
 
-	if (!_isInitialized)
-	{
-#pragma omp critical
-		{
-			Warn("Behaviour is not initialized!");
-		}
-		return true;
-	}
-
 	ZoneScopedXC(RandomUniqueColor());
 	const std::string &name = GetName();
 	ZoneTextX(name.c_str(), name.size());
@@ -236,20 +281,9 @@ bool Behaviour::InitialParallelUpdate(const TimeUtils &time, const Input &input)
 }
 bool Behaviour::InitialLateUpdate(TimeUtils &time, const Input &input)
 {
-	if (!IsEnabled())
+	if (!ShouldUpdate())
 		return true;
 
-	if (_entity->IsRemoved())
-		return true;
-
-#ifdef DEBUG_BUILD
-	if (!_isInitialized)
-	{
-		Warn("Behaviour is not initialized!");
-		return true;
-	}
-#endif
-
 	ZoneScopedXC(RandomUniqueColor());
 	const std::string &name = GetName();
 	ZoneTextX(name.c_str(), name.size());
@@ -258,20 +292,9 @@ bool Behaviour::InitialLateUpdate(TimeUtils &time, const Input &input)
 }
 bool Behaviour::InitialFixedUpdate(float deltaTime, const Input &input)
 {
-	if (!IsEnabled())
+	if (!ShouldUpdate())
 		return true;
 
-	if (_entity->IsRemoved())
-		return true;
-
-#ifdef DEBUG_BUILD
-	if (!_isInitialized)
-	{
-		Warn("Behaviour is not initialized!");
-		return true;
-	}
-#endif
-
 	ZoneScopedXC(RandomUniqueColor());
 	const std::string &name = GetName();
 	ZoneTextX(name.c_str(), name.size());
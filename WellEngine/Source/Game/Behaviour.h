@@ -5,6 +5,7 @@
 #include "Timing/TimeUtils.h"
 #include "Input/Input.h"
 #include "Transform.h"
+#include "BehaviourTypes.h"
 #include "Rendering/RendererInfo.h"
 #include "rapidjson/document.h"
 
@@ -17,6 +18,12 @@ class Entity;
 class CameraBehaviour;
 class RenderQueuer;
 
+// Specialize as std::true_type for a registered behaviour whose Update, LateUpdate and FixedUpdate only touch its own
+// state and never queue or dequeue updates, letting the scene update every behaviour of that type in parallel.
+// Derived types do not inherit it.
+template<class T>
+struct IsBehaviourUpdateThreadSafe : std::false_type {};
+
 class Behaviour : public IRefTarget<Behaviour>
 {
 private:
@@ -27,6 +34,12 @@ private:
 
 	Entity *_entity = nullptr;
 
+	UINT _typeID = BEHAVIOUR_TYPE_NULL;
+	UINT _typeRegistryIndex = -1; // Position in the scene's list of behaviours of the same type.
+
+	friend class Scene;
+	friend class BehaviourUpdateList;
+
 protected:
 	std::string _name = "";
 
@@ -49,6 +62,7 @@ protected:
 	[[nodiscard]] virtual bool Update(TimeUtils &time, const Input &input);
 	
 	// ParallelUpdate runs after update and exeutes in parallel with all other behaviours, so one must ensure thread safety between behaviours.
+	// It runs on job workers, so it must not call rand(), whose state is per thread and not seeded there. Draw random numbers in Start or Update.
 	[[nodiscard]] virtual bool ParallelUpdate(const TimeUtils &time, const Input &input);
 	
 	// Like Update, but later.
@@ -60,7 +74,8 @@ protected:
 	// Render runs for all objects queued for rendering before they are rendered.
 	[[nodiscard]] virtual bool BeforeRender();
 
-	// Render runs when objects are being queued for rendering.
+	// Render runs when objects are being queued for rendering. Views are queued in parallel, so it may run for
+	// several views at once and must not modify shared state.
 	[[nodiscard]] virtual bool Render(const RenderQueuer &queuer, const RendererInfo &rendererInfo);
 
 
@@ -98,6 +113,19 @@ public:
 	Behaviour() = default;
 	virtual ~Behaviour();
 
+#pragma push_macro("new")
+#undef new
+	// Allocated from ObjectPools::GetBehaviourPool() when a registered type has the same size,
+	// otherwise from the heap.
+	[[nodiscard]] static void *operator new(size_t size);
+	static void operator delete(void *ptr, size_t size) noexcept;
+#ifdef LEAK_DETECTION
+	// Used by DEBUG_NEW. Allocates from the heap instead, so that leaks are still reported where they were created.
+	[[nodiscard]] static void *operator new(size_t size, int blockUse, const char *fileName, int lineNumber);
+	static void operator delete(void *ptr, int blockUse, const char *fileName, int lineNumber) noexcept;
+#endif
+#pragma pop_macro("new")
+
 	[[nodiscard]] bool Initialize(Entity *entity, const std::string &behaviourName = "");
 	[[nodiscard]] bool IsInitialized() const;
 	[[nodiscard]] bool IsDestroyed() const;
@@ -110,6 +138,9 @@ public:
 	[[nodiscard]] Scene *GetScene() const;
 	[[nodiscard]] Game *GetGame() const;
 
+	// Registered type of the behaviour, BEHAVIOUR_TYPE_NULL until initialized or if its class is not registered.
+	[[nodiscard]] UINT GetTypeID() const;
+
 	void SetName(const std::string &name);
 	[[nodiscard]] const std::string &GetName() const;
 
@@ -130,6 +161,8 @@ public:
 	[[nodiscard]] bool InitialOnDebugSelect();
 
 	[[nodiscard]] bool IsEnabled() const;
+	// Whether the behaviour takes part in Update, ParallelUpdate, LateUpdate and FixedUpdate this frame.
+	[[nodiscard]] bool ShouldUpdate() const;
 	[[nodiscard]] bool IsEnabledSelf() const;
 	void InheritEnabled(bool state);
 	void SetEnabled(bool state);
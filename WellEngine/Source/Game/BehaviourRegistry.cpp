@@ -44,6 +44,9 @@
 #include "Behaviours/SpotLightBehaviour.h"
 #include "Behaviours/TrackerBehaviour.h"
 
+#include "Utils/ObjectPool.h"
+#include <array>
+#include <typeindex>
 
 #ifdef LEAK_DETECTION
 #define new			DEBUG_NEW
@@ -101,3 +104,290 @@ const std::map<std::string_view, std::function<Behaviour *(void)>> &BehaviourReg
 
     return behaviourMap;
 };
+
+UINT BehaviourRegistry::GetTypeID(const std::type_info &type)
+{
+    static const std::unordered_map<std::type_index, UINT> typeIDs = {
+		{ typeid(AmbientSoundBehaviour),     BehaviourType<AmbientSoundBehaviour>::ID     },
+		{ typeid(BillboardMeshBehaviour),    BehaviourType<BillboardMeshBehaviour>::ID    },
+		{ typeid(BreadcrumbBehaviour),       BehaviourType<BreadcrumbBehaviour>::ID       },
+		{ typeid(BreadcrumbPileBehaviour),   BehaviourType<BreadcrumbPileBehaviour>::ID   },
+		{ typeid(PlayButtonBehaviour),       BehaviourType<PlayButtonBehaviour>::ID       },
+		{ typeid(SaveButtonBehaviour),       BehaviourType<SaveButtonBehaviour>::ID       },
+		{ typeid(NewSaveButtonBehaviour),    BehaviourType<NewSaveButtonBehaviour>::ID    },
+		{ typeid(CreditsButtonBehaviour),    BehaviourType<CreditsButtonBehaviour>::ID    },
+		{ typeid(ExitButtonBehaviour),       BehaviourType<ExitButtonBehaviour>::ID       },
+		{ typeid(CameraBehaviour),           BehaviourType<CameraBehaviour>::ID           },
+		{ typeid(CameraCubeBehaviour),       BehaviourType<CameraCubeBehaviour>::ID       },
+		{ typeid(CameraItemBehaviour),       BehaviourType<CameraItemBehaviour>::ID       },
+		{ typeid(ColliderBehaviour),         BehaviourType<ColliderBehaviour>::ID         },
+		{ typeid(CompassBehaviour),          BehaviourType<CompassBehaviour>::ID          },
+		{ typeid(CreditsBehaviour),          BehaviourType<CreditsBehaviour>::ID          },
+		{ typeid(DebugPlayerBehaviour),      BehaviourType<DebugPlayerBehaviour>::ID      },
+		{ typeid(EndCutSceneBehaviour),      BehaviourType<EndCutSceneBehaviour>::ID      },
+		{ typeid(ExampleBehaviour),          BehaviourType<ExampleBehaviour>::ID          },
+		{ typeid(ExampleCollisionBehaviour), BehaviourType<ExampleCollisionBehaviour>::ID },
+		{ typeid(FlashlightBehaviour),       BehaviourType<FlashlightBehaviour>::ID       },
+		{ typeid(FlashlightPropBehaviour),   BehaviourType<FlashlightPropBehaviour>::ID   },
+		{ typeid(GraphNodeBehaviour),        BehaviourType<GraphNodeBehaviour>::ID        },
+		{ typeid(HideBehaviour),             BehaviourType<HideBehaviour>::ID             },
+		{ typeid(InteractableBehaviour),     BehaviourType<InteractableBehaviour>::ID     },
+		{ typeid(InteractorBehaviour),       BehaviourType<InteractorBehaviour>::ID       },
+		{ typeid(InventoryBehaviour),        BehaviourType<InventoryBehaviour>::ID        },
+		{ typeid(MenuCameraBehaviour),       BehaviourType<MenuCameraBehaviour>::ID       },
+		{ typeid(MeshBehaviour),             BehaviourType<MeshBehaviour>::ID             },
+		{ typeid(MonsterBehaviour),          BehaviourType<MonsterBehaviour>::ID          },
+		{ typeid(MonsterHintBehaviour),      BehaviourType<MonsterHintBehaviour>::ID      },
+		{ typeid(PickupBehaviour),           BehaviourType<PickupBehaviour>::ID           },
+		{ typeid(PictureBehaviour),          BehaviourType<PictureBehaviour>::ID          },
+		{ typeid(PlayerCutsceneBehaviour),   BehaviourType<PlayerCutsceneBehaviour>::ID   },
+		{ typeid(PlayerMovementBehaviour),   BehaviourType<PlayerMovementBehaviour>::ID   },
+		{ typeid(PlayerViewBehaviour),       BehaviourType<PlayerViewBehaviour>::ID       },
+		{ typeid(PointLightBehaviour),       BehaviourType<PointLightBehaviour>::ID       },
+		{ typeid(RestrictedViewBehaviour),   BehaviourType<RestrictedViewBehaviour>::ID   },
+		{ typeid(SimplePointLightBehaviour), BehaviourType<SimplePointLightBehaviour>::ID },
+		{ typeid(SimpleSpotLightBehaviour),  BehaviourType<SimpleSpotLightBehaviour>::ID  },
+		{ typeid(SolidObjectBehaviour),      BehaviourType<SolidObjectBehaviour>::ID      },
+		{ typeid(SoundBehaviour),            BehaviourType<SoundBehaviour>::ID            },
+		{ typeid(SpotLightBehaviour),        BehaviourType<SpotLightBehaviour>::ID        },
+		{ typeid(TrackerBehaviour),          BehaviourType<TrackerBehaviour>::ID          },
+
+    };
+
+    const auto it = typeIDs.find(type);
+    return (it != typeIDs.end()) ? it->second : BEHAVIOUR_TYPE_NULL;
+};
+
+template<class Base, class... Types>
+static BehaviourTypeMask MakeDerivedTypeMask()
+{
+    BehaviourTypeMask mask;
+    ((std::is_base_of_v<Base, Types> ? (void)mask.set(BehaviourType<Types>::ID) : (void)0), ...);
+    return mask;
+}
+template<class... Types>
+static std::array<BehaviourTypeMask, sizeof...(Types)> MakeDerivedTypeMasks()
+{
+    return { MakeDerivedTypeMask<Types, Types...>()... };
+}
+
+const BehaviourTypeMask &BehaviourRegistry::GetDerivedTypes(UINT typeID)
+{
+    static const std::array<BehaviourTypeMask, BEHAVIOUR_TYPE_COUNT> derivedTypes = MakeDerivedTypeMasks<
+		AmbientSoundBehaviour,
+		BillboardMeshBehaviour,
+		BreadcrumbBehaviour,
+		BreadcrumbPileBehaviour,
+		PlayButtonBehaviour,
+		SaveButtonBehaviour,
+		NewSaveButtonBehaviour,
+		CreditsButtonBehaviour,
+		ExitButtonBehaviour,
+		CameraBehaviour,
+		CameraCubeBehaviour,
+		CameraItemBehaviour,
+		ColliderBehaviour,
+		CompassBehaviour,
+		CreditsBehaviour,
+		DebugPlayerBehaviour,
+		EndCutSceneBehaviour,
+		ExampleBehaviour,
+		ExampleCollisionBehaviour,
+		FlashlightBehaviour,
+		FlashlightPropBehaviour,
+		GraphNodeBehaviour,
+		HideBehaviour,
+		InteractableBehaviour,
+		InteractorBehaviour,
+		InventoryBehaviour,
+		MenuCameraBehaviour,
+		MeshBehaviour,
+		MonsterBehaviour,
+		MonsterHintBehaviour,
+		PickupBehaviour,
+		PictureBehaviour,
+		PlayerCutsceneBehaviour,
+		PlayerMovementBehaviour,
+		PlayerViewBehaviour,
+		PointLightBehaviour,
+		RestrictedViewBehaviour,
+		SimplePointLightBehaviour,
+		SimpleSpotLightBehaviour,
+		SolidObjectBehaviour,
+		SoundBehaviour,
+		SpotLightBehaviour,
+		TrackerBehaviour
+
+    >();
+
+    return derivedTypes[typeID];
+};
+
+const char *BehaviourRegistry::GetTypeName(UINT typeID)
+{
+    static constexpr std::array<const char *, BEHAVIOUR_TYPE_COUNT> typeNames = {
+		"AmbientSoundBehaviour",
+		"BillboardMeshBehaviour",
+		"BreadcrumbBehaviour",
+		"BreadcrumbPileBehaviour",
+		"PlayButtonBehaviour",
+		"SaveButtonBehaviour",
+		"NewSaveButtonBehaviour",
+		"CreditsButtonBehaviour",
+		"ExitButtonBehaviour",
+		"CameraBehaviour",
+		"CameraCubeBehaviour",
+		"CameraItemBehaviour",
+		"ColliderBehaviour",
+		"CompassBehaviour",
+		"CreditsBehaviour",
+		"DebugPlayerBehaviour",
+		"EndCutSceneBehaviour",
+		"ExampleBehaviour",
+		"ExampleCollisionBehaviour",
+		"FlashlightBehaviour",
+		"FlashlightPropBehaviour",
+		"GraphNodeBehaviour",
+		"HideBehaviour",
+		"InteractableBehaviour",
+		"InteractorBehaviour",
+		"InventoryBehaviour",
+		"MenuCameraBehaviour",
+		"MeshBehaviour",
+		"MonsterBehaviour",
+		"MonsterHintBehaviour",
+		"PickupBehaviour",
+		"PictureBehaviour",
+		"PlayerCutsceneBehaviour",
+		"PlayerMovementBehaviour",
+		"PlayerViewBehaviour",
+		"PointLightBehaviour",
+		"RestrictedViewBehaviour",
+		"SimplePointLightBehaviour",
+		"SimpleSpotLightBehaviour",
+		"SolidObjectBehaviour",
+		"SoundBehaviour",
+		"SpotLightBehaviour",
+		"TrackerBehaviour"
+
+    };
+
+    return (typeID < BEHAVIOUR_TYPE_COUNT) ? typeNames[typeID] : "Unregistered";
+};
+
+template<class... Types>
+static constexpr std::array<bool, sizeof...(Types)> MakeThreadSafeUpdateFlags()
+{
+    return { IsBehaviourUpdateThreadSafe<Types>::value... };
+}
+
+bool BehaviourRegistry::IsUpdateThreadSafe(UINT typeID)
+{
+    static constexpr std::array<bool, BEHAVIOUR_TYPE_COUNT> threadSafe = MakeThreadSafeUpdateFlags<
+		AmbientSoundBehaviour,
+		BillboardMeshBehaviour,
+		BreadcrumbBehaviour,
+		BreadcrumbPileBehaviour,
+		PlayButtonBehaviour,
+		SaveButtonBehaviour,
+		NewSaveButtonBehaviour,
+		CreditsButtonBehaviour,
+		ExitButtonBehaviour,
+		CameraBehaviour,
+		CameraCubeBehaviour,
+		CameraItemBehaviour,
+		ColliderBehaviour,
+		CompassBehaviour,
+		CreditsBehaviour,
+		DebugPlayerBehaviour,
+		EndCutSceneBehaviour,
+		ExampleBehaviour,
+		ExampleCollisionBehaviour,
+		FlashlightBehaviour,
+		FlashlightPropBehaviour,
+		GraphNodeBehaviour,
+		HideBehaviour,
+		InteractableBehaviour,
+		InteractorBehaviour,
+		InventoryBehaviour,
+		MenuCameraBehaviour,
+		MeshBehaviour,
+		MonsterBehaviour,
+		MonsterHintBehaviour,
+		PickupBehaviour,
+		PictureBehaviour,
+		PlayerCutsceneBehaviour,
+		PlayerMovementBehaviour,
+		PlayerViewBehaviour,
+		PointLightBehaviour,
+		RestrictedViewBehaviour,
+		SimplePointLightBehaviour,
+		SimpleSpotLightBehaviour,
+		SolidObjectBehaviour,
+		SoundBehaviour,
+		SpotLightBehaviour,
+		TrackerBehaviour
+
+    >();
+
+    return (typeID < BEHAVIOUR_TYPE_COUNT) && threadSafe[typeID];
+};
+
+template<class... Types>
+static constexpr std::array<size_t, sizeof...(Types)> MakeTypeSizes()
+{
+    static_assert(((alignof(Types) <= ObjectPool::SLOT_ALIGNMENT) && ...), "Behaviours must not be over-aligned to be pooled!");
+    return { sizeof(Types)... };
+}
+
+size_t BehaviourRegistry::GetTypeSize(UINT typeID)
+{
+    static constexpr std::array<size_t, BEHAVIOUR_TYPE_COUNT> typeSizes = MakeTypeSizes<
+		AmbientSoundBehaviour,
+		BillboardMeshBehaviour,
+		BreadcrumbBehaviour,
+		BreadcrumbPileBehaviour,
+		PlayButtonBehaviour,
+		SaveButtonBehaviour,
+		NewSaveButtonBehaviour,
+		CreditsButtonBehaviour,
+		ExitButtonBehaviour,
+		CameraBehaviour,
+		CameraCubeBehaviour,
+		CameraItemBehaviour,
+		ColliderBehaviour,
+		CompassBehaviour,
+		CreditsBehaviour,
+		DebugPlayerBehaviour,
+		EndCutSceneBehaviour,
+		ExampleBehaviour,
+		ExampleCollisionBehaviour,
+		FlashlightBehaviour,
+		FlashlightPropBehaviour,
+		GraphNodeBehaviour,
+		HideBehaviour,
+		InteractableBehaviour,
+		InteractorBehaviour,
+		InventoryBehaviour,
+		MenuCameraBehaviour,
+		MeshBehaviour,
+		MonsterBehaviour,
+		MonsterHintBehaviour,
+		PickupBehaviour,
+		PictureBehaviour,
+		PlayerCutsceneBehaviour,
+		PlayerMovementBehaviour,
+		PlayerViewBehaviour,
+		PointLightBehaviour,
+		RestrictedViewBehaviour,
+		SimplePointLightBehaviour,
+		SimpleSpotLightBehaviour,
+		SolidObjectBehaviour,
+		SoundBehaviour,
+		SpotLightBehaviour,
+		TrackerBehaviour
+
+    >();
+
+    return (typeID < BEHAVIOUR_TYPE_COUNT) ? typeSizes[typeID] : 0;
+};
@@ -1,9 +1,28 @@
 #pragma once
 #include <string>
+#include <string_view>
+#include <map>
+#include <typeinfo>
+#include "BehaviourTypes.h"
 
 class Behaviour;
 
 namespace BehaviourRegistry
 {
 	[[nodiscard]] const std::map<std::string_view, std::function<Behaviour *(void)>> &Get();
+
+	// Returns the type ID of a behaviour's most derived class, or BEHAVIOUR_TYPE_NULL if it is not registered.
+	[[nodiscard]] UINT GetTypeID(const std::type_info &type);
+
+	// Returns the types of every registered behaviour deriving from the given type, including itself.
+	[[nodiscard]] const BehaviourTypeMask &GetDerivedTypes(UINT typeID);
+
+	// Returns the class name of a registered behaviour type.
+	[[nodiscard]] const char *GetTypeName(UINT typeID);
+
+	// Returns whether all behaviours of the given type may be updated in parallel with each other.
+	[[nodiscard]] bool IsUpdateThreadSafe(UINT typeID);
+
+	// Returns the size of a registered behaviour type, or 0 if it is not registered.
+	[[nodiscard]] size_t GetTypeSize(UINT typeID);
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+// Automatically generated during build by BehaviourRegistration.
+// Gives every registered behaviour a type ID, so entities and scenes can look up behaviours by type without dynamic_cast.
+
+#pragma once
+#include <bitset>
+
+inline constexpr UINT BEHAVIOUR_TYPE_COUNT = 43;
+inline constexpr UINT BEHAVIOUR_TYPE_NULL = UINT_MAX;
+
+// One bit per registered behaviour type.
+using BehaviourTypeMask = std::bitset<BEHAVIOUR_TYPE_COUNT>;
+
+// Type ID of a behaviour class, or BEHAVIOUR_TYPE_NULL if the class is not registered.
+// IDs follow the order the behaviours are found in and are not stable between builds, so they must not be serialized.
+template<class T>
+struct BehaviourType
+{
+    static constexpr UINT ID = BEHAVIOUR_TYPE_NULL;
+};
+
+class AmbientSoundBehaviour;
+class BillboardMeshBehaviour;
+class BreadcrumbBehaviour;
+class BreadcrumbPileBehaviour;
+class PlayButtonBehaviour;
+class SaveButtonBehaviour;
+class NewSaveButtonBehaviour;
+class CreditsButtonBehaviour;
+class ExitButtonBehaviour;
+class CameraBehaviour;
+class CameraCubeBehaviour;
+class CameraItemBehaviour;
+class ColliderBehaviour;
+class CompassBehaviour;
+class CreditsBehaviour;
+class DebugPlayerBehaviour;
+class EndCutSceneBehaviour;
+class ExampleBehaviour;
+class ExampleCollisionBehaviour;
+class FlashlightBehaviour;
+class FlashlightPropBehaviour;
+class GraphNodeBehaviour;
+class HideBehaviour;
+class InteractableBehaviour;
+class InteractorBehaviour;
+class InventoryBehaviour;
+class MenuCameraBehaviour;
+class MeshBehaviour;
+class MonsterBehaviour;
+class MonsterHintBehaviour;
+class PickupBehaviour;
+class PictureBehaviour;
+class PlayerCutsceneBehaviour;
+class PlayerMovementBehaviour;
+class PlayerViewBehaviour;
+class PointLightBehaviour;
+class RestrictedViewBehaviour;
+class SimplePointLightBehaviour;
+class SimpleSpotLightBehaviour;
+class SolidObjectBehaviour;
+class SoundBehaviour;
+class SpotLightBehaviour;
+class TrackerBehaviour;
+
+template<> struct BehaviourType<AmbientSoundBehaviour> { static constexpr UINT ID = 0; };
+template<> struct BehaviourType<BillboardMeshBehaviour> { static constexpr UINT ID = 1; };
+template<> struct BehaviourType<BreadcrumbBehaviour> { static constexpr UINT ID = 2; };
+template<> struct BehaviourType<BreadcrumbPileBehaviour> { static constexpr UINT ID = 3; };
+template<> struct BehaviourType<PlayButtonBehaviour> { static constexpr UINT ID = 4; };
+template<> struct BehaviourType<SaveButtonBehaviour> { static constexpr UINT ID = 5; };
+template<> struct BehaviourType<NewSaveButtonBehaviour> { static constexpr UINT ID = 6; };
+template<> struct BehaviourType<CreditsButtonBehaviour> { static constexpr UINT ID = 7; };
+template<> struct BehaviourType<ExitButtonBehaviour> { static constexpr UINT ID = 8; };
+template<> struct BehaviourType<CameraBehaviour> { static constexpr UINT ID = 9; };
+template<> struct BehaviourType<CameraCubeBehaviour> { static constexpr UINT ID = 10; };
+template<> struct BehaviourType<CameraItemBehaviour> { static constexpr UINT ID = 11; };
+template<> struct BehaviourType<ColliderBehaviour> { static constexpr UINT ID = 12; };
+template<> struct BehaviourType<CompassBehaviour> { static constexpr UINT ID = 13; };
+template<> struct BehaviourType<CreditsBehaviour> { static constexpr UINT ID = 14; };
+template<> struct BehaviourType<DebugPlayerBehaviour> { static constexpr UINT ID = 15; };
+template<> struct BehaviourType<EndCutSceneBehaviour> { static constexpr UINT ID = 16; };
+template<> struct BehaviourType<ExampleBehaviour> { static constexpr UINT ID = 17; };
+template<> struct BehaviourType<ExampleCollisionBehaviour> { static constexpr UINT ID = 18; };
+template<> struct BehaviourType<FlashlightBehaviour> { static constexpr UINT ID = 19; };
+template<> struct BehaviourType<FlashlightPropBehaviour> { static constexpr UINT ID = 20; };
+template<> struct BehaviourType<GraphNodeBehaviour> { static constexpr UINT ID = 21; };
+template<> struct BehaviourType<HideBehaviour> { static constexpr UINT ID = 22; };
+template<> struct BehaviourType<InteractableBehaviour> { static constexpr UINT ID = 23; };
+template<> struct BehaviourType<InteractorBehaviour> { static constexpr UINT ID = 24; };
+template<> struct BehaviourType<InventoryBehaviour> { static constexpr UINT ID = 25; };
+template<> struct BehaviourType<MenuCameraBehaviour> { static constexpr UINT ID = 26; };
+template<> struct BehaviourType<MeshBehaviour> { static constexpr UINT ID = 27; };
+template<> struct BehaviourType<MonsterBehaviour> { static constexpr UINT ID = 28; };
+template<> struct BehaviourType<MonsterHintBehaviour> { static constexpr UINT ID = 29; };
+template<> struct BehaviourType<PickupBehaviour> { static constexpr UINT ID = 30; };
+template<> struct BehaviourType<PictureBehaviour> { static constexpr UINT ID = 31; };
+template<> struct BehaviourType<PlayerCutsceneBehaviour> { static constexpr UINT ID = 32; };
+template<> struct BehaviourType<PlayerMovementBehaviour> { static constexpr UINT ID = 33; };
+template<> struct BehaviourType<PlayerViewBehaviour> { static constexpr UINT ID = 34; };
+template<> struct BehaviourType<PointLightBehaviour> { static constexpr UINT ID = 35; };
+template<> struct BehaviourType<RestrictedViewBehaviour> { static constexpr UINT ID = 36; };
+template<> struct BehaviourType<SimplePointLightBehaviour> { static constexpr UINT ID = 37; };
+template<> struct BehaviourType<SimpleSpotLightBehaviour> { static constexpr UINT ID = 38; };
+template<> struct BehaviourType<SolidObjectBehaviour> { static constexpr UINT ID = 39; };
+template<> struct BehaviourType<SoundBehaviour> { static constexpr UINT ID = 40; };
+template<> struct BehaviourType<SpotLightBehaviour> { static constexpr UINT ID = 41; };
+template<> struct BehaviourType<TrackerBehaviour> { static constexpr UINT ID = 42; };
@@ -0,0 +1,192 @@
+#include "stdafx.h"
+#include "BehaviourUpdateList.h"
+#include "Behaviour.h"
+#include "BehaviourRegistry.h"
+#include "Entity.h"
+
+#ifdef LEAK_DETECTION
+#define new			DEBUG_NEW
+#endif
+
+// Fewest behaviours of a thread-safe type given to one job. Updates meant for this are short, so small batches
+// would spend more time scheduling than updating.
+constexpr UINT THREAD_SAFE_BATCH_SIZE = 32;
+
+UINT BehaviourUpdateList::GetBucket(const Behaviour *beh)
+{
+	const UINT typeID = beh->GetTypeID();
+	return (typeID < BEHAVIOUR_TYPE_COUNT) ? typeID : UNTYPED_BUCKET;
+}
+
+void BehaviourUpdateList::Add(Behaviour *beh)
+{
+	const UINT bucketIndex = GetBucket(beh);
+	std::vector<Behaviour *> &bucket = _buckets[bucketIndex];
+
+	// Check if the behaviour is already queued
+	if (std::find(bucket.begin(), bucket.end(), beh) != bucket.end())
+		return;
+
+	bucket.emplace_back(beh);
+	_count++;
+
+	// Buckets keep their place once emptied, so types queued and dequeued every so often are not reordered.
+	if (!_isBucketOrdered[bucketIndex])
+	{
+		_isBucketOrdered[bucketIndex] = true;
+		_bucketOrder.emplace_back(bucketIndex);
+	}
+}
+void BehaviourUpdateList::Remove(Behaviour *beh)
+{
+	std::vector<Behaviour *> &bucket = _buckets[GetBucket(beh)];
+
+	auto it = std::find(bucket.begin(), bucket.end(), beh);
+	if (it == bucket.end())
+		return;
+
+	bucket.erase(it);
+	_count--;
+}
+bool BehaviourUpdateList::Contains(const Behaviour *beh) const
+{
+	const std::vector<Behaviour *> &bucket = _buckets[GetBucket(beh)];
+	return std::find(bucket.begin(), bucket.end(), beh) != bucket.end();
+}
+UINT BehaviourUpdateList::GetCount() const
+{
+	return _count;
+}
+
+template<class UpdateFunc>
+Behaviour *BehaviourUpdateList::Run(bool allParallel, UpdateFunc update)
+{
+	JobSystem &jobSystem = JobSystem::Instance();
+	std::atomic<Behaviour *> failed = nullptr;
+
+	auto updateRange = [&failed, &update](const std::vector<Behaviour *> &bucket, UINT begin, UINT end) {
+		for (UINT i = begin; i < end; i++)
+		{
+			if (failed.load(std::memory_order_relaxed))
+				return;
+
+			Behaviour *beh = bucket[i];
+			if (!beh->ShouldUpdate())
+				continue;
+
+#ifdef TRACY_DETAILED
+			// A zone per behaviour is too costly to keep in regular captures, the bucket zones cover those.
+			ZoneScopedXC(RandomUniqueColor());
+			ZoneTextX(beh->_name.c_str(), beh->_name.size());
+#endif
+
+			if (!update(beh))
+			{
+				Behaviour *expected = nullptr;
+				failed.compare_exchange_strong(expected, beh);
+				return;
+			}
+		}
+	};
+
+	if (allParallel)
+	{
+		JobGroup group;
+
+		for (UINT bucketIndex : _bucketOrder)
+		{
+			const std::vector<Behaviour *> &bucket = _buckets[bucketIndex];
+
+			jobSystem.ParallelFor(group, static_cast<UINT>(bucket.size()), 1, [&updateRange, &bucket](UINT begin, UINT end) {
+				updateRange(bucket, begin, end);
+			}, BehaviourRegistry::GetTypeName(bucketIndex));
+		}
+
+		jobSystem.Wait(group);
+		return failed.load();
+	}
+
+	// Updates may queue more behaviours, so the order and the buckets are indexed rather than iterated.
+	for (UINT orderIndex = 0; orderIndex < _bucketOrder.size(); orderIndex++)
+	{
+		const UINT bucketIndex = _bucketOrder[orderIndex];
+		const std::vector<Behaviour *> &bucket = _buckets[bucketIndex];
+
+		if (bucket.empty())
+			continue;
+
+		const char *typeName = BehaviourRegistry::GetTypeName(bucketIndex);
+		ZoneNamedNC(bucketZone, "Behaviour Type", RandomUniqueColor(), true);
+		ZoneNameV(bucketZone, typeName, strlen(typeName));
+
+		if (BehaviourRegistry::IsUpdateThreadSafe(bucketIndex))
+		{
+			jobSystem.ParallelFor(static_cast<UINT>(bucket.size()), THREAD_SAFE_BATCH_SIZE, [&updateRange, &bucket](UINT begin, UINT end) {
+				updateRange(bucket, begin, end);
+			}, typeName);
+		}
+		else
+		{
+			for (UINT i = 0; i < bucket.size(); i++)
+				updateRange(bucket, i, i + 1);
+		}
+
+		if (Behaviour *failedBeh = failed.load())
+			return failedBeh;
+	}
+
+	return nullptr;
+}
+
+bool BehaviourUpdateList::RunUpdate(TimeUtils &time, const Input &input)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	Behaviour *failed = Run(false, [&time, &input](Behaviour *beh) { return beh->Update(time, input); });
+	if (failed)
+	{
+		ErrMsgF("Failed to update entity '{}'!", failed->GetEntity()->GetName());
+		return false;
+	}
+
+	return true;
+}
+bool BehaviourUpdateList::RunParallelUpdate(const TimeUtils &time, const Input &input)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	Behaviour *failed = Run(true, [&time, &input](Behaviour *beh) { return beh->ParallelUpdate(time, input); });
+	if (failed)
+	{
+		ErrMsgF("Failed to update entity '{}' in parallel!", failed->GetEntity()->GetName());
+		return false;
+	}
+
+	return true;
+}
+bool BehaviourUpdateList::RunLateUpdate(TimeUtils &time, const Input &input)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	Behaviour *failed = Run(false, [&time, &input](Behaviour *beh) { return beh->LateUpdate(time, input); });
+	if (failed)
+	{
+		ErrMsgF("Failed to late update entity '{}'!", failed->GetEntity()->GetName());
+		return false;
+	}
+
+	return true;
+}
+bool BehaviourUpdateList::RunFixedUpdate(float deltaTime, const Input &input)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	Behaviour *failed = Run(false, [deltaTime, &input](Behaviour *beh) { return beh->FixedUpdate(deltaTime, input); });
+	if (failed)
+	{
+		ErrMsgF("Failed to fixed update entity '{}'!", failed->GetEntity()->GetName());
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "BehaviourTypes.h"
+#include "Timing/TimeUtils.h"
+#include "Input/Input.h"
+
+class Behaviour;
+
+// The behaviours queued for one kind of update, bucketed by their registered type. Each bucket is updated in one
+// tight loop calling the same override over and over, and the buckets of types specializing IsBehaviourUpdateThreadSafe
+// are split over the job system. Types are updated in the order they were first queued, and behaviours of the same
+// type in the order they were queued.
+class BehaviourUpdateList
+{
+private:
+	// Behaviours of unregistered types share the last bucket.
+	static constexpr UINT UNTYPED_BUCKET = BEHAVIOUR_TYPE_COUNT;
+	static constexpr UINT BUCKET_COUNT = BEHAVIOUR_TYPE_COUNT + 1;
+
+	std::array<std::vector<Behaviour *>, BUCKET_COUNT> _buckets;
+	std::array<bool, BUCKET_COUNT> _isBucketOrdered = {};
+	std::vector<UINT> _bucketOrder;
+	UINT _count = 0;
+
+	[[nodiscard]] static UINT GetBucket(const Behaviour *beh);
+
+	// Calls update on every behaviour that is not skipped. Returns the behaviour whose update failed, or nullptr.
+	template<class UpdateFunc>
+	[[nodiscard]] Behaviour *Run(bool allParallel, UpdateFunc update);
+
+public:
+	BehaviourUpdateList() = default;
+	~BehaviourUpdateList() = default;
+	BehaviourUpdateList(const BehaviourUpdateList &other) = delete;
+	BehaviourUpdateList &operator=(const BehaviourUpdateList &other) = delete;
+	BehaviourUpdateList(BehaviourUpdateList &&other) = delete;
+	BehaviourUpdateList &operator=(BehaviourUpdateList &&other) = delete;
+
+	// Queues a behaviour. Its type must not change while it is queued.
+	void Add(Behaviour *beh);
+	void Remove(Behaviour *beh);
+	[[nodiscard]] bool Contains(const Behaviour *beh) const;
+	[[nodiscard]] UINT GetCount() const;
+
+	[[nodiscard]] bool RunUpdate(TimeUtils &time, const Input &input);
+	// Updates every bucket at the same time, regardless of thread safety.
+	[[nodiscard]] bool RunParallelUpdate(const TimeUtils &time, const Input &input);
+	[[nodiscard]] bool RunLateUpdate(TimeUtils &time, const Input &input);
+	[[nodiscard]] bool RunFixedUpdate(float deltaTime, const Input &input);
+
+	TESTABLE()
+};
@@ -872,38 +872,37 @@ const CamBounds *CameraBehaviour::GetLightGridBounds()
 			float l = -r;			// Left plane
 			float b = -t;			// Bottom plane
 
-#pragma warning(disable: 6993)
-#pragma omp parallel for num_threads(PARALLEL_THREADS)
-#pragma warning(default: 6993)
-			for (int tileY = 0; tileY < LIGHT_GRID_RES; ++tileY)
-			{
-				for (int tileX = 0; tileX < LIGHT_GRID_RES; ++tileX)
+			JobSystem::Instance().ParallelFor(LIGHT_GRID_RES, 1, [&](UINT rowBegin, UINT rowEnd) {
+				for (int tileY = static_cast<int>(rowBegin); tileY < static_cast<int>(rowEnd); ++tileY)
 				{
-					// Calculate NDC boundaries for this tile
-					float xMinNDC = -1.0f + (static_cast<float>(tileX) / LIGHT_GRID_RES) * 2.0f;
-					float xMaxNDC = -1.0f + (static_cast<float>(tileX + 1) / LIGHT_GRID_RES) * 2.0f;
-					float yMinNDC = -1.0f + (static_cast<float>(tileY) / LIGHT_GRID_RES) * 2.0f;
-					float yMaxNDC = -1.0f + (static_cast<float>(tileY + 1) / LIGHT_GRID_RES) * 2.0f;
-
-					// Convert NDC to parametric space [0, 1]
-					float txMin = (xMinNDC + 1.0f) * 0.5f;
-					float txMax = (xMaxNDC + 1.0f) * 0.5f;
-					float tyMin = (yMinNDC + 1.0f) * 0.5f;
-					float tyMax = (yMaxNDC + 1.0f) * 0.5f;
-
-					// Calculate tile box planes in view space
-					float tileL = l + (r - l) * txMin;
-					float tileR = l + (r - l) * txMax;
-					float tileB = b + (t - b) * tyMin;
-					float tileT = b + (t - b) * tyMax;
-
-					// Create tile projection matrix
-					XMMATRIX projTile = XMMatrixOrthographicOffCenterLH(tileL, tileR, tileB, tileT, nearZ, farZ);
-
-					// Store bounding frustum
-					BoundingOrientedBox().Transform(_lightGrid[tileX + (size_t)tileY * LIGHT_GRID_RES].ortho, projTile);
+					for (int tileX = 0; tileX < LIGHT_GRID_RES; ++tileX)
+					{
+						// Calculate NDC boundaries for this tile
+						float xMinNDC = -1.0f + (static_cast<float>(tileX) / LIGHT_GRID_RES) * 2.0f;
+						float xMaxNDC = -1.0f + (static_cast<float>(tileX + 1) / LIGHT_GRID_RES) * 2.0f;
+						float yMinNDC = -1.0f + (static_cast<float>(tileY) / LIGHT_GRID_RES) * 2.0f;
+						float yMaxNDC = -1.0f + (static_cast<float>(tileY + 1) / LIGHT_GRID_RES) * 2.0f;
+
+						// Convert NDC to parametric space [0, 1]
+						float txMin = (xMinNDC + 1.0f) * 0.5f;
+						float txMax = (xMaxNDC + 1.0f) * 0.5f;
+						float tyMin = (yMinNDC + 1.0f) * 0.5f;
+						float tyMax = (yMaxNDC + 1.0f) * 0.5f;
+
+						// Calculate tile box planes in view space
+						float tileL = l + (r - l) * txMin;
+						float tileR = l + (r - l) * txMax;
+						float tileB = b + (t - b) * tyMin;
+						float tileT = b + (t - b) * tyMax;
+
+						// Create tile projection matrix
+						XMMATRIX projTile = XMMatrixOrthographicOffCenterLH(tileL, tileR, tileB, tileT, nearZ, farZ);
+
+						// Store bounding frustum
+						BoundingOrientedBox().Transform(_lightGrid[tileX + (size_t)tileY * LIGHT_GRID_RES].ortho, projTile);
+					}
 				}
-			}
+			}, "Build Light Grid");
 		}
 		else
 		{
@@ -927,38 +926,37 @@ const CamBounds *CameraBehaviour::GetLightGridBounds()
 			float l = -r;			// Left plane
 			float b = -t;			// Bottom plane
 
-#pragma warning(disable: 6993)
-#pragma omp parallel for num_threads(PARALLEL_THREADS)
-#pragma warning(default: 6993)
-			for (int tileY = 0; tileY < LIGHT_GRID_RES; ++tileY)
-			{
-				for (int tileX = 0; tileX < LIGHT_GRID_RES; ++tileX)
+			JobSystem::Instance().ParallelFor(LIGHT_GRID_RES, 1, [&](UINT rowBegin, UINT rowEnd) {
+				for (int tileY = static_cast<int>(rowBegin); tileY < static_cast<int>(rowEnd); ++tileY)
 				{
-					// Calculate NDC boundaries for this tile
-					float xMinNDC = -1.0f + (static_cast<float>(tileX) / LIGHT_GRID_RES) * 2.0f;
-					float xMaxNDC = -1.0f + (static_cast<float>(tileX + 1) / LIGHT_GRID_RES) * 2.0f;
-					float yMinNDC = -1.0f + (static_cast<float>(tileY) / LIGHT_GRID_RES) * 2.0f;
-					float yMaxNDC = -1.0f + (static_cast<float>(tileY + 1) / LIGHT_GRID_RES) * 2.0f;
-
-					// Convert NDC to parametric space [0, 1]
-					float txMin = (xMinNDC + 1.0f) * 0.5f;
-					float txMax = (xMaxNDC + 1.0f) * 0.5f;
-					float tyMin = (yMinNDC + 1.0f) * 0.5f;
-					float tyMax = (yMaxNDC + 1.0f) * 0.5f;
-
-					// Calculate tile frustum planes in view space
-					float tileL = l + (r - l) * txMin;
-					float tileR = l + (r - l) * txMax;
-					float tileB = b + (t - b) * tyMin;
-					float tileT = b + (t - b) * tyMax;
-
-					// Create tile projection matrix
-					XMMATRIX projTile = XMMatrixPerspectiveOffCenterLH(tileL, tileR, tileB, tileT, nearZ, farZ);
-
-					// Store bounding frustum
-					BoundingFrustum::CreateFromMatrix(_lightGrid[tileX + (size_t)tileY * LIGHT_GRID_RES].perspective, projTile);
+					for (int tileX = 0; tileX < LIGHT_GRID_RES; ++tileX)
+					{
+						// Calculate NDC boundaries for this tile
+						float xMinNDC = -1.0f + (static_cast<float>(tileX) / LIGHT_GRID_RES) * 2.0f;
+						float xMaxNDC = -1.0f + (static_cast<float>(tileX + 1) / LIGHT_GRID_RES) * 2.0f;
+						float yMinNDC = -1.0f + (static_cast<float>(tileY) / LIGHT_GRID_RES) * 2.0f;
+						float yMaxNDC = -1.0f + (static_cast<float>(tileY + 1) / LIGHT_GRID_RES) * 2.0f;
+
+						// Convert NDC to parametric space [0, 1]
+						float txMin = (xMinNDC + 1.0f) * 0.5f;
+						float txMax = (xMaxNDC + 1.0f) * 0.5f;
+						float tyMin = (yMinNDC + 1.0f) * 0.5f;
+						float tyMax = (yMaxNDC + 1.0f) * 0.5f;
+
+						// Calculate tile frustum planes in view space
+						float tileL = l + (r - l) * txMin;
+						float tileR = l + (r - l) * txMax;
+						float tileB = b + (t - b) * tyMin;
+						float tileT = b + (t - b) * tyMax;
+
+						// Create tile projection matrix
+						XMMATRIX projTile = XMMatrixPerspectiveOffCenterLH(tileL, tileR, tileB, tileT, nearZ, farZ);
+
+						// Store bounding frustum
+						BoundingFrustum::CreateFromMatrix(_lightGrid[tileX + (size_t)tileY * LIGHT_GRID_RES].perspective, projTile);
+					}
 				}
-			}
+			}, "Build Light Grid");
 		}
 	}
 
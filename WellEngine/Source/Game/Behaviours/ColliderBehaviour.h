@@ -41,6 +41,8 @@ public:
 	void SetCollider(Collisions::Collider *collider);
 	const Collisions::Collider *GetCollider() const;
 
+	// Collision callbacks run on the main thread while sound is updated, and may only change entities.
+	// Play sounds or use the device context from the next Update instead.
 	void AddOnIntersection(std::function<void(const Collisions::CollisionData &)> callback);
 	void AddOnCollisionEnter(std::function<void(const Collisions::CollisionData &)> callback);
 	void AddOnCollisionExit(std::function<void(const Collisions::CollisionData &)> callback);
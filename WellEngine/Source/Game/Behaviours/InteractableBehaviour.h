@@ -36,4 +36,8 @@ public:
 
 	// Deserializes the behaviour from a string.
 	[[nodiscard]] bool Deserialize(const json::Value &obj, Scene *scene) override;
-};
\ No newline at end of file
+};
+
+// Update only copies the interaction range from the interactor, which no interactable writes to.
+template<>
+struct IsBehaviourUpdateThreadSafe<InteractableBehaviour> : std::true_type {};
\ No newline at end of file
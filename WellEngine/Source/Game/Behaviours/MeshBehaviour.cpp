@@ -1974,6 +1974,18 @@ const Material *MeshBehaviour::GetMaterial() const
 {
 	return _material;
 }
+bool MeshBehaviour::IsTransparent() const
+{
+	return _isTransparent;
+}
+bool MeshBehaviour::IsOverlay() const
+{
+	return _isOverlay;
+}
+bool MeshBehaviour::IsShadowsOnly() const
+{
+	return _shadowsOnly;
+}
 
 void MeshBehaviour::SetLastUsedLOD(UINT lodIndex, float normalizedDist)
 {
@@ -127,6 +127,9 @@ public:
 	[[nodiscard]] UINT GetMeshID() const;
 	[[nodiscard]] UINT GetBlendStateID() const;
 	[[nodiscard]] const Material *GetMaterial() const;
+	[[nodiscard]] bool IsTransparent() const;
+	[[nodiscard]] bool IsOverlay() const;
+	[[nodiscard]] bool IsShadowsOnly() const;
 
 	void SetLastUsedLOD(UINT lodIndex, float normalizedDist);
 	[[nodiscard]] UINT GetLastUsedLODIndex() const;
@@ -67,6 +67,10 @@ bool PointLightBehaviour::Start()
 	_shadowCameraCube->SetRendererInfo({ false, true });
 	_shadowCameraCube->SetSerialization(false);
 
+	// Randomize the first update timer here rather than in ParallelUpdate, where rand() would draw from a worker's unseeded state.
+	if (_updateTimer == -1)
+		_updateTimer = std::rand() % (_updateFrequency + 1);
+
 	PointLightCollection *pointlights = GetScene()->GetPointlights();
 
 	if (!pointlights)
@@ -101,11 +105,7 @@ bool PointLightBehaviour::ParallelUpdate(const TimeUtils &time, const Input &inp
 {
 	if (_updateTimer <= 0)
 	{
-		if (_updateTimer == -1) // Randomize the first update timer
-			_updateTimer = std::rand() % (_updateFrequency + 1);
-		else
-			_updateTimer += _updateFrequency;
-
+		_updateTimer += _updateFrequency;
 		_boundsDirty = true;
 	}
 
@@ -281,8 +281,9 @@ bool PointLightBehaviour::ContainsPoint(const XMFLOAT3A &point)
 	XMFLOAT3 lightPos = _transformedBounds.Center;
 	if (DoUpdate())
 	{
-#pragma omp critical
 		{
+			std::lock_guard<std::mutex> lock(_boundsMutex);
+
 			if (_boundsDirty)
 				lightPos = GetTransform()->GetPosition(World);
 		}
@@ -298,8 +299,9 @@ bool PointLightBehaviour::IntersectsLightTile(const BoundingFrustum &tile)
 	if (DoUpdate())
 	{
 		bool failed = false;
-#pragma omp critical
 		{
+			std::lock_guard<std::mutex> lock(_boundsMutex);
+
 			if (_boundsDirty)
 			{
 				_boundsDirty = false;
@@ -329,8 +331,9 @@ bool PointLightBehaviour::IntersectsLightTile(const BoundingOrientedBox &tile)
 	if (DoUpdate())
 	{
 		bool failed = false;
-#pragma omp critical
 		{
+			std::lock_guard<std::mutex> lock(_boundsMutex);
+
 			if (_boundsDirty)
 			{
 				_boundsDirty = false;
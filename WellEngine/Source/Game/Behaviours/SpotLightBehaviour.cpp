@@ -364,8 +364,9 @@ bool SpotLightBehaviour::ContainsPoint(const XMFLOAT3A &point)
 	if (DoUpdate())
 	{
 		bool failed = false;
-#pragma omp critical
 		{
+			std::lock_guard<std::mutex> lock(_boundsMutex);
+
 			if (_boundsDirty)
 			{
 				_boundsDirty = false;
@@ -388,8 +389,9 @@ bool SpotLightBehaviour::IntersectsLightTile(const BoundingFrustum &tile)
 	if (DoUpdate())
 	{
 		bool failed = false;
-#pragma omp critical
 		{
+			std::lock_guard<std::mutex> lock(_boundsMutex);
+
 			if (_boundsDirty)
 			{
 				_boundsDirty = false;
@@ -415,8 +417,9 @@ bool SpotLightBehaviour::IntersectsLightTile(const BoundingOrientedBox &tile)
 	if (DoUpdate())
 	{
 		bool failed = false;
-#pragma omp critical
 		{
+			std::lock_guard<std::mutex> lock(_boundsMutex);
+
 			if (_boundsDirty)
 			{
 				_boundsDirty = false;
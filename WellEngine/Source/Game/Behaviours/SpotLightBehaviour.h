@@ -37,6 +37,7 @@ private:
 
 	dx::BoundingFrustum _transformedBounds = { };
 	bool _boundsDirty = true;
+	std::mutex _boundsMutex; // Bounds are refreshed by whichever light tiling job needs them first.
 
 protected:
 	[[nodiscard]] bool Start() override;
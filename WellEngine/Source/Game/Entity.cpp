@@ -4,6 +4,7 @@
 #include "Behaviours/DebugPlayerBehaviour.h"
 #include "Behaviours/MeshBehaviour.h"
 #include "BehaviourFactory.h"
+#include "ObjectPools.h"
 
 #ifdef LEAK_DETECTION
 #define new			DEBUG_NEW
@@ -11,6 +12,33 @@
 
 using namespace DirectX;
 
+#pragma push_macro("new")
+#undef new
+void *Entity::operator new(size_t size)
+{
+	// Anything larger is not an entity the pool was sized for.
+	if (size != sizeof(Entity))
+		return ::operator new(size);
+
+	return ObjectPools::GetEntityPool().Allocate();
+}
+void Entity::operator delete(void *ptr, size_t size) noexcept
+{
+	if (!ObjectPools::GetEntityPool().Free(ptr))
+		::operator delete(ptr);
+}
+#ifdef LEAK_DETECTION
+void *Entity::operator new(size_t size, int blockUse, const char *fileName, int lineNumber)
+{
+	return ::operator new(size, blockUse, fileName, lineNumber);
+}
+void Entity::operator delete(void *ptr, int blockUse, const char *fileName, int lineNumber) noexcept
+{
+	::operator delete(ptr);
+}
+#endif
+#pragma pop_macro("new")
+
 Entity::~Entity()
 {
 	if (_entityID == -1)
@@ -29,6 +57,7 @@ Entity::~Entity()
 
 	_isRemoved = true;
 	_behaviours.clear();
+	UpdateBehaviourTypes();
 
 	for (auto& child : _children)
 	{
@@ -55,12 +84,17 @@ Entity &Entity::operator=(Entity &&other) noexcept
 	_isInitialized = other._isInitialized;  
 	_doSerialize = other._doSerialize;  
 	_behaviours = std::move(other._behaviours);
+	_behaviourTypes = other._behaviourTypes;
+	_untypedBehaviourCount = other._untypedBehaviourCount;
 	_isEnabled = other._isEnabled;  
 	_transform = std::move(other._transform);  
+	_transform.SetChangeLog(_transform.GetChangeLog(), this);
 	_isRemoved = other._isRemoved;  
 	_doRender.store(other._doRender.load());
+	_isTreeSyncQueued.store(other._isTreeSyncQueued.load());
 	_children = std::move(other._children);
 	_entityID = other._entityID; other._entityID = -1;
+	_sceneIndex = other._sceneIndex; other._sceneIndex = -1;
 	_isStatic = other._isStatic;  
 	_parent = other._parent; other._parent = nullptr;
 	_bounds = std::move(other._bounds);
@@ -84,21 +118,18 @@ bool Entity::Initialize(ID3D11Device *device, Scene *scene, const std::string &n
 	SetScene(scene);
 	SetName(name);
 
-	if (scene)
-	{
-		if (SceneHolder *sceneHolder = scene->GetSceneHolder())
-		{
-			sceneHolder->RemoveIDFromHashIfNull(_entityID); // Remove id from hash if it's hashed as not found
-		}
-	}
-
 	if (!_transform.Initialize(device))
 	{
 		ErrMsg("Failed to initialize entity transform!");
 		return false;
 	}
 
-	_transform.AddDirtyCallback(std::bind(&Entity::SetDirtyImmediate, this));
+	_transform.SetChangeLog(scene ? scene->GetTransformChangeLog() : nullptr, this);
+
+#ifdef TRANSFORM_HIERARCHY
+	if (scene)
+		scene->GetTransformHierarchy()->Add(&_transform);
+#endif
 
 	_isInitialized = true;
 	return true;
@@ -132,6 +163,12 @@ void Entity::AddBehaviour(Behaviour *behaviour)
 	}
 
 	_behaviours.emplace_back(behaviour);
+
+	const UINT typeID = behaviour->GetTypeID();
+	if (typeID != BEHAVIOUR_TYPE_NULL)
+		_behaviourTypes.set(typeID);
+	else
+		_untypedBehaviourCount++;
 }
 void Entity::RemoveBehaviour(Behaviour *behaviour)
 {
@@ -150,6 +187,22 @@ void Entity::RemoveBehaviour(Behaviour *behaviour)
 
 		_behaviours.erase(_behaviours.begin() + i);
 	}
+
+	UpdateBehaviourTypes();
+}
+void Entity::UpdateBehaviourTypes()
+{
+	_behaviourTypes.reset();
+	_untypedBehaviourCount = 0;
+
+	for (auto &behaviour : _behaviours)
+	{
+		const UINT typeID = behaviour->GetTypeID();
+		if (typeID != BEHAVIOUR_TYPE_NULL)
+			_behaviourTypes.set(typeID);
+		else
+			_untypedBehaviourCount++;
+	}
 }
 Behaviour *Entity::GetBehaviour(UINT index) const
 {
@@ -303,6 +356,25 @@ void Entity::SetDirtyImmediate()
 	_recalculateCollider = true;
 	for (auto &behaviour : _behaviours)
 		behaviour.get()->SetDirty();
+
+	if (_isRemoved || !_scene)
+		return;
+
+	if (SceneHolder *sceneHolder = _scene->GetSceneHolder())
+		sceneHolder->QueueTreeSync(this);
+}
+
+bool Entity::IsTreeSyncQueued() const
+{
+	return _isTreeSyncQueued.load();
+}
+bool Entity::MarkTreeSyncQueued()
+{
+	return !_isTreeSyncQueued.exchange(true);
+}
+void Entity::ClearTreeSyncQueued()
+{
+	_isTreeSyncQueued.store(false);
 }
 
 void Entity::MarkAsRemoved()
@@ -473,21 +545,24 @@ UINT Entity::GetID() const
 {
 	return _entityID;
 }
+UINT Entity::GetSceneIndex() const
+{
+	return _sceneIndex;
+}
 void Entity::SetName(const std::string &name)
 {
-	// Update name search hash in SceneHolder
+	if (_name == name)
+		return;
+
+	const std::string oldName = std::move(_name);
+	_name.assign(name);
+
+	// Update name lookup in SceneHolder
 	if (_scene)
 	{
 		if (SceneHolder *sceneHolder = _scene->GetSceneHolder())
-		{
-			if (!_name.empty())
-				sceneHolder->RemoveNameFromHash(_name); // Remove old name from hash
-
-			sceneHolder->RemoveNameFromHashIfNull(name); // Remove new name from hash if it's hashed as not found
-		}
+			sceneHolder->RenameEntity(this, oldName);
 	}
-
-	_name.assign(name);
 }
 const std::string &Entity::GetName() const
 {
@@ -545,7 +620,8 @@ void Entity::StoreEntityBounds(dx::BoundingOrientedBox &bounds, ReferenceSpace s
 		return;
 	}
 	
-	if (_recalculateBounds)
+	// The owner is only notified of transform changes once per update, so check for pending ones as well.
+	if (_recalculateBounds || _transform.IsChangeLogged())
 	{
 		XMFLOAT4X4A worldMatrix = GetTransform()->GetWorldMatrix();
 		_bounds.Transform(_transformedBounds, Load(&worldMatrix));
@@ -564,6 +640,19 @@ void Entity::UpdateCullingBounds()
 	StoreEntityBounds(_lastTransformedCullingBounds, ReferenceSpace::World);
 }
 
+const std::vector<TreePath> &Entity::GetCullingTreePaths() const
+{
+	return _cullingTreePaths;
+}
+void Entity::AddCullingTreePath(const TreePath &path)
+{
+	_cullingTreePaths.emplace_back(path);
+}
+void Entity::RemoveCullingTreePath(const TreePath &path)
+{
+	std::erase(_cullingTreePaths, path);
+}
+
 bool Entity::InitialUpdate(TimeUtils &time, const Input &input)
 {
 	if (!_isEnabled)
@@ -597,10 +686,9 @@ bool Entity::InitialParallelUpdate(const TimeUtils &time, const Input &input)
 	{
 		if (!behaviour.get()->InitialParallelUpdate(time, input))
 		{
-#pragma omp critical
-			{
-				ErrMsg("Failed to update behaviour in parallel!");
-			}
+			static std::mutex errorMutex;
+			std::lock_guard<std::mutex> lock(errorMutex);
+			ErrMsg("Failed to update behaviour in parallel!");
 			return false;
 		}
 	}
@@ -656,11 +744,9 @@ bool Entity::InitialFixedUpdate(float deltaTime, const Input &input)
 
 bool Entity::InitialBeforeRender()
 {
-	if (!_doRender)
+	if (!_doRender.exchange(false, std::memory_order_relaxed))
 		return true;
 
-	_doRender = false;
-
 	ZoneScopedC(RandomUniqueColor());
 	const std::string &name = GetName();
 	ZoneTextX(name.c_str(), name.size());
@@ -701,7 +787,8 @@ bool Entity::InitialRender(const RenderQueuer &queuer, const RendererInfo &rende
 		}
 	}
 
-	_doRender = true;
+	// Several views may queue the entity at once, they all store the same value.
+	_doRender.store(true, std::memory_order_relaxed);
 	return true;
 }
 
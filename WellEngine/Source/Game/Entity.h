@@ -5,6 +5,7 @@
 #include "Input/Input.h"
 #include "Rendering/Graphics.h"
 #include "Behaviour.h"
+#include "BehaviourRegistry.h"
 #include "Rendering/Culling/NodePath.h"
 #include "Rendering/RenderQueuer.h"
 #include "Collision/Colliders.h"
@@ -21,6 +22,7 @@ class Entity : public IRefTarget<Entity>
 private:
 	UINT _entityID = -1;
 	UINT _deserializedID = -1;
+	UINT _sceneIndex = -1; // Position in the SceneHolder's entity list, kept up to date by it.
 	std::string _name = "";
 	std::string _prefabName = "";
 
@@ -30,7 +32,8 @@ private:
 	bool _isDebugSelectable = true;
 	bool _recalculateBounds = true;
 	bool _doSerialize = true;
-	std::atomic_bool _doRender = false;
+	std::atomic_bool _doRender = false; // Set when queued by any view, cleared by InitialBeforeRender().
+	std::atomic_bool _isTreeSyncQueued = false;
 	UINT _inheritedDisabled = 0;
 
 	bool _skipInRaycast = false;
@@ -54,12 +57,26 @@ protected:
 	std::vector<Entity *> _children;
 	std::vector<std::unique_ptr<Behaviour>> _behaviours;
 
+	// Registered types of the behaviours held, and how many behaviours are of unregistered types.
+	// Lets type lookups skip entities without a matching behaviour, and match the rest by ID instead of dynamic_cast.
+	BehaviourTypeMask _behaviourTypes;
+	UINT _untypedBehaviourCount = 0;
+
 	// Tracks all paths in the culling tree this entity is currently placed in 
 	std::vector<TreePath> _cullingTreePaths;
 
+	void UpdateBehaviourTypes();
+
+	// Returns the index of the first behaviour of type T at or after start, or -1 if there is none.
+	template <class T>
+	[[nodiscard]] UINT FindBehaviourOfType(UINT start) const;
+
 	inline void AddChild(Entity *child, bool keepWorldTransform = false);
 	inline void RemoveChild(Entity *child, bool keepWorldTransform = false);
 
+	friend class SceneHolder;
+	inline void SetSceneIndex(UINT index) { _sceneIndex = index; }
+
 public:
 	Entity(UINT id, const dx::BoundingOrientedBox &bounds) : _entityID(id), _bounds(bounds) {}
 	virtual ~Entity();
@@ -68,6 +85,18 @@ public:
 	Entity(Entity &&other) noexcept; // Move constructor, internal use only, DO NOT USE
 	Entity &operator=(Entity &&other) noexcept; // Move assignment operator, internal use only, DO NOT USE
 
+#pragma push_macro("new")
+#undef new
+	// Allocated from ObjectPools::GetEntityPool().
+	[[nodiscard]] static void *operator new(size_t size);
+	static void operator delete(void *ptr, size_t size) noexcept;
+#ifdef LEAK_DETECTION
+	// Used by DEBUG_NEW. Allocates from the heap instead, so that leaks are still reported where they were created.
+	[[nodiscard]] static void *operator new(size_t size, int blockUse, const char *fileName, int lineNumber);
+	static void operator delete(void *ptr, int blockUse, const char *fileName, int lineNumber) noexcept;
+#endif
+#pragma pop_macro("new")
+
 	[[nodiscard]] bool Initialize(ID3D11Device *device, Scene *scene, const std::string &name);
 	[[nodiscard]] bool IsInitialized() const;
 
@@ -109,6 +138,12 @@ public:
 	void SetDirty();
 	void SetDirtyImmediate();
 
+	// Set while the entity waits in the tree sync queue of its scene, so it is only queued once.
+	[[nodiscard]] bool IsTreeSyncQueued() const;
+	// Returns false if the entity was already queued.
+	[[nodiscard]] bool MarkTreeSyncQueued();
+	void ClearTreeSyncQueued();
+
 	void MarkAsRemoved();
 	[[nodiscard]] bool IsRemoved() const;
 
@@ -137,6 +172,7 @@ public:
 	[[nodiscard]] const std::string &GetName() const;
 
 	[[nodiscard]] UINT GetID() const;
+	[[nodiscard]] UINT GetSceneIndex() const;
 
 	[[nodiscard]] UINT GetDeserializedID() const;
 	void SetDeserializedID(UINT id);
@@ -151,6 +187,10 @@ public:
 	[[nodiscard]] const dx::BoundingOrientedBox &GetLastCullingBounds() const;
 	void UpdateCullingBounds();
 
+	[[nodiscard]] const std::vector<TreePath> &GetCullingTreePaths() const;
+	void AddCullingTreePath(const TreePath &path);
+	void RemoveCullingTreePath(const TreePath &path);
+
 	[[nodiscard]] bool InitialUpdate(TimeUtils &time, const Input &input);
 	[[nodiscard]] bool InitialParallelUpdate(const TimeUtils &time, const Input &input);
 	[[nodiscard]] bool InitialLateUpdate(TimeUtils &time, const Input &input);
@@ -170,74 +210,84 @@ public:
 };
 
 template<class T>
-inline bool Entity::HasBehaviourOfType() const
+inline UINT Entity::FindBehaviourOfType(UINT start) const
 {
-	if (_isRemoved)
-		return false;
+	using Type = std::remove_cv_t<T>;
+	const UINT behaviourCount = static_cast<UINT>(_behaviours.size());
 
-	if (!std::is_base_of<Behaviour, T>::value)
-		return false;
-
-	UINT behaviourCount = static_cast<UINT>(_behaviours.size());
-	for (UINT i = 0; i < behaviourCount; i++)
+	if constexpr (!std::is_base_of_v<Behaviour, Type>)
+	{
+		return -1;
+	}
+	else if constexpr (BehaviourType<Type>::ID != BEHAVIOUR_TYPE_NULL)
 	{
-		T *castedBehaviour = dynamic_cast<T*>(_behaviours[i].get());
+		const BehaviourTypeMask &types = BehaviourRegistry::GetDerivedTypes(BehaviourType<Type>::ID);
+
+		if (_untypedBehaviourCount == 0 && (_behaviourTypes & types).none())
+			return -1;
+
+		for (UINT i = start; i < behaviourCount; i++)
+		{
+			const UINT typeID = _behaviours[i]->GetTypeID();
+
+			// Unregistered behaviours may still derive from a registered type.
+			if (typeID != BEHAVIOUR_TYPE_NULL ? types.test(typeID) : dynamic_cast<Type *>(_behaviours[i].get()) != nullptr)
+				return i;
+		}
 
-		if (castedBehaviour)
-			return true;
+		return -1;
 	}
+	else
+	{
+		for (UINT i = start; i < behaviourCount; i++)
+		{
+			if (dynamic_cast<Type *>(_behaviours[i].get()))
+				return i;
+		}
 
-	return false;
+		return -1;
+	}
 }
 
 template<class T>
-inline bool Entity::GetBehaviourByType(T *&behaviour) const
+inline bool Entity::HasBehaviourOfType() const
 {
 	if (_isRemoved)
 		return false;
 
-	if (!std::is_base_of<Behaviour, T>::value)
-		return false;
+	return FindBehaviourOfType<T>(0) != -1;
+}
 
-	UINT behaviourCount = static_cast<UINT>(_behaviours.size());
-	for (UINT i = 0; i < behaviourCount; i++)
-	{
-		T *castedBehaviour = dynamic_cast<T*>(_behaviours[i].get());
+template<class T>
+inline bool Entity::GetBehaviourByType(T *&behaviour) const
+{
+	behaviour = nullptr;
 
-		if (!castedBehaviour)
-			continue;
+	if (_isRemoved)
+		return false;
 
-		behaviour = castedBehaviour;
-		return true;
-	}
+	const UINT index = FindBehaviourOfType<T>(0);
+	if (index == -1)
+		return false;
 
-	behaviour = nullptr;
-	return false;
+	behaviour = static_cast<T *>(_behaviours[index].get());
+	return true;
 }
 
 template<class T>
 inline bool Entity::GetBehaviourByType(Behaviour *&behaviour) const
 {
+	behaviour = nullptr;
+
 	if (_isRemoved)
 		return false;
 
-	if (!std::is_base_of<Behaviour, T>::value)
+	const UINT index = FindBehaviourOfType<T>(0);
+	if (index == -1)
 		return false;
 
-	UINT behaviourCount = static_cast<UINT>(_behaviours.size());
-	for (UINT i = 0; i < behaviourCount; i++)
-	{
-		T *castedBehaviour = dynamic_cast<T *>(_behaviours[i].get());
-
-		if (!castedBehaviour)
-			continue;
-
-		behaviour = _behaviours[i].get();
-		return true;
-	}
-
-	behaviour = nullptr;
-	return false;
+	behaviour = _behaviours[index].get();
+	return true;
 }
 
 template<class T>
@@ -246,20 +296,11 @@ inline bool Entity::GetBehavioursByType(std::vector<T*> &behaviours) const
 	if (_isRemoved)
 		return false;
 
-	if (!std::is_base_of<Behaviour, T>::value)
-		return false;
-	
 	bool found = false;
 
-	UINT behaviourCount = static_cast<UINT>(_behaviours.size());
-	for (UINT i = 0; i < behaviourCount; i++)
+	for (UINT i = FindBehaviourOfType<T>(0); i != -1; i = FindBehaviourOfType<T>(i + 1))
 	{
-		T *castedBehaviour = dynamic_cast<T*>(_behaviours[i].get());
-
-		if (!castedBehaviour)
-			continue;
-
-		behaviours.emplace_back(castedBehaviour);
+		behaviours.emplace_back(static_cast<T *>(_behaviours[i].get()));
 		found = true;
 	}
 
@@ -272,19 +313,10 @@ inline bool Entity::GetBehavioursByType(std::vector<Behaviour *> &behaviours) co
 	if (_isRemoved)
 		return false;
 
-	if (!std::is_base_of<Behaviour, T>::value)
-		return false;
-	
 	bool found = false;
 
-	UINT behaviourCount = static_cast<UINT>(_behaviours.size());
-	for (UINT i = 0; i < behaviourCount; i++)
+	for (UINT i = FindBehaviourOfType<T>(0); i != -1; i = FindBehaviourOfType<T>(i + 1))
 	{
-		T *castedBehaviour = dynamic_cast<T*>(_behaviours[i].get());
-
-		if (!castedBehaviour)
-			continue;
-
 		behaviours.emplace_back(_behaviours[i].get());
 		found = true;
 	}
@@ -2,6 +2,7 @@
 #include "Game.h"
 //#include <dxgiformat.h>
 #include "Debug/DebugData.h"
+#include "ObjectPools.h"
 #ifdef USE_IMGUI
 #include "UI/UILayout.h"
 #endif
@@ -177,11 +178,11 @@ bool Game::LoadContent(
 		}
 	}
 	
-#pragma warning(disable: 6993)
-#pragma omp parallel num_threads(4)
-	{
-#pragma omp for nowait
-		for (int i = 0; i < cubemapNames.size(); i++)
+	JobSystem &jobSystem = JobSystem::Instance();
+	JobGroup loadGroup;
+
+	jobSystem.ParallelFor(loadGroup, static_cast<UINT>(cubemapNames.size()), 1, [&](UINT begin, UINT end) {
+		for (UINT i = begin; i < end; i++)
 		{
 			const TextureData &cubemap = cubemapNames[i];
 
@@ -196,9 +197,10 @@ bool Game::LoadContent(
 				ErrMsgF("Failed to add cubemap {}!", cubemap.name);
 			}
 		}
+	}, "Load Cubemaps");
 
-#pragma omp for nowait
-		for (int i = 0; i < heightMapNames.size(); i++)
+	jobSystem.ParallelFor(loadGroup, static_cast<UINT>(heightMapNames.size()), 1, [&](UINT begin, UINT end) {
+		for (UINT i = begin; i < end; i++)
 		{
 			const HeightMapData &heightMap = heightMapNames[i];
 
@@ -211,8 +213,9 @@ bool Game::LoadContent(
 				ErrMsgF("Failed to add heightmap {}!", heightMap.name);
 			}
 		}
-	}
-#pragma warning(default: 6993)
+	}, "Load Heightmaps");
+
+	jobSystem.Wait(loadGroup);
 
 	for (const ShaderData &shader : shaderNames)
 	{
@@ -904,6 +907,12 @@ bool Game::Setup(TimeUtils &time, Window window)
 	}
 	time.TakeSnapshot("AddScenes");
 
+#if defined(RECORD_INPUT)
+	InputRecording::Instance().SetStartScene(_pendingSceneChange);
+#elif defined(REPLAY_INPUT)
+	_pendingSceneChange = InputRecording::Instance().GetStartScene();
+#endif
+
 	// Ensure the main menu scene is loaded
 	if (_pendingSceneChange != "MainMenu")
 	{
@@ -1171,6 +1180,8 @@ bool Game::Update(TimeUtils &time, const Input& input)
 {
 	ZoneScopedC(RandomUniqueColor());
 
+	const bool removingScenes = !_pendingSceneRemovals.empty();
+
 	for (const std::string &sceneName : _pendingSceneRemovals)
 	{
 		UINT sceneIndex = GetSceneIndex(sceneName);
@@ -1196,6 +1207,20 @@ bool Game::Update(TimeUtils &time, const Input& input)
 	}
 	_pendingSceneRemovals.clear();
 
+	if (removingScenes)
+		ObjectPools::ReleaseEmptyBlocks();
+
+#if defined(RECORD_INPUT)
+	InputRecording::Instance().RecordSceneChange(_pendingSceneChange);
+#elif defined(REPLAY_INPUT)
+	// Scene changes are replayed as recorded, even if the game did not request the same change.
+	const std::string &recordedSceneChange = InputRecording::Instance().GetCurrentFrame()->sceneChange;
+	if (recordedSceneChange != _pendingSceneChange)
+		DbgMsgF("Replay diverged, recording changed scene to '{}' where the game requested '{}'.", recordedSceneChange, _pendingSceneChange);
+
+	_pendingSceneChange = recordedSceneChange;
+#endif
+
 	if (!_pendingSceneChange.empty())
 	{
 		if (!SetSceneInternal(_pendingSceneChange))
@@ -1969,7 +1994,7 @@ bool Game::RenderUI(TimeUtils &time)
 
 #ifdef PARALLEL_UPDATE
 				ImGui::Text("Parallel Update");
-				ImGui::Text(std::format("Thread Count: {}", PARALLEL_THREADS).c_str());
+				ImGui::Text(std::format("Thread Count: {}", JobSystem::Instance().GetConcurrency()).c_str());
 				ImGui::Dummy({ 0, 3 });
 #endif
 
@@ -2309,6 +2334,12 @@ bool Game::RenderUI(TimeUtils &time)
 			ErrMsg("Failed to render content UI!");
 			return false;
 		}
+
+		if (!ObjectPools::RenderUI())
+		{
+			ErrMsg("Failed to render object pool UI!");
+			return false;
+		}
 	}
 	ImGui::End();
 
@@ -2355,6 +2386,12 @@ bool Game::RenderUI(TimeUtils &time)
 				return false;
 			}
 		}
+
+		if (!ObjectPools::RenderUI())
+		{
+			ErrMsg("Failed to render object pool UI!");
+			return false;
+		}
 	}
 	ImGui::End();
 
@@ -0,0 +1,131 @@
+#include "stdafx.h"
+#include "ObjectPools.h"
+#include "Entity.h"
+#include "BehaviourRegistry.h"
+#include <unordered_map>
+
+#ifdef LEAK_DETECTION
+#define new			DEBUG_NEW
+#endif
+
+struct BehaviourPools
+{
+	std::vector<std::string> names; // Pool names, must outlive the pools.
+	std::vector<std::unique_ptr<ObjectPool>> pools;
+	std::unordered_map<size_t, ObjectPool *> poolsBySize;
+
+	BehaviourPools()
+	{
+		// Name each pool after every type sharing it before creating any, so the names are not moved afterwards.
+		std::vector<size_t> sizes;
+		for (UINT typeID = 0; typeID < BEHAVIOUR_TYPE_COUNT; typeID++)
+		{
+			const size_t size = BehaviourRegistry::GetTypeSize(typeID);
+			const char *typeName = BehaviourRegistry::GetTypeName(typeID);
+
+			auto it = std::find(sizes.begin(), sizes.end(), size);
+			if (it == sizes.end())
+			{
+				sizes.emplace_back(size);
+				names.emplace_back(typeName);
+			}
+			else
+			{
+				names[it - sizes.begin()] += std::format(", {}", typeName);
+			}
+		}
+
+		for (size_t i = 0; i < sizes.size(); i++)
+		{
+			ObjectPool *pool = pools.emplace_back(std::make_unique<ObjectPool>(names[i].c_str(), sizes[i], 32)).get();
+			poolsBySize.emplace(sizes[i], pool);
+		}
+	}
+};
+
+static BehaviourPools &GetBehaviourPools()
+{
+	static BehaviourPools behaviourPools;
+	return behaviourPools;
+}
+
+ObjectPool &ObjectPools::GetEntityPool()
+{
+	static_assert(alignof(Entity) <= ObjectPool::SLOT_ALIGNMENT, "Entities must not be over-aligned to be pooled!");
+
+	static ObjectPool entityPool("Entity", sizeof(Entity), 128);
+	return entityPool;
+}
+
+ObjectPool *ObjectPools::GetBehaviourPool(size_t size)
+{
+	const BehaviourPools &behaviourPools = GetBehaviourPools();
+
+	auto it = behaviourPools.poolsBySize.find(size);
+	return (it != behaviourPools.poolsBySize.end()) ? it->second : nullptr;
+}
+
+void ObjectPools::ReleaseEmptyBlocks()
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	size_t releasedBytes = GetEntityPool().ReleaseEmptyBlocks();
+
+	for (const std::unique_ptr<ObjectPool> &pool : GetBehaviourPools().pools)
+		releasedBytes += pool->ReleaseEmptyBlocks();
+
+	if (releasedBytes > 0)
+		DbgMsgF("Released {} bytes of empty object pool blocks.", releasedBytes);
+}
+
+#ifdef USE_IMGUI
+bool ObjectPools::RenderUI()
+{
+	ZoneScopedXC(RandomUniqueColor());
+
+	if (!ImGui::TreeNode("Object Pools"))
+		return true;
+
+	auto poolRow = [](const ObjectPool &pool) {
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn(); ImGui::Text("%s", pool.GetName());
+		ImGui::TableNextColumn(); ImGui::Text("%u / %u", pool.GetLiveCount(), pool.GetCapacity());
+		ImGui::TableNextColumn(); ImGui::Text("%.1f KiB", pool.GetReservedBytes() / 1024.0f);
+	};
+
+	const ObjectPool &entityPool = GetEntityPool();
+	size_t totalBytes = entityPool.GetReservedBytes();
+
+	for (const std::unique_ptr<ObjectPool> &pool : GetBehaviourPools().pools)
+		totalBytes += pool->GetReservedBytes();
+
+	ImGui::Text("Reserved: %.1f KiB", totalBytes / 1024.0f);
+
+	if (ImGui::Button("Release Empty Blocks"))
+		ReleaseEmptyBlocks();
+
+	static bool showEmpty = false;
+	ImGui::Checkbox("Show Empty Pools", &showEmpty);
+
+	if (ImGui::BeginTable("Object Pools", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable))
+	{
+		ImGui::TableSetupColumn("Types");
+		ImGui::TableSetupColumn("Live / Capacity");
+		ImGui::TableSetupColumn("Reserved");
+		ImGui::TableHeadersRow();
+
+		poolRow(entityPool);
+
+		for (const std::unique_ptr<ObjectPool> &pool : GetBehaviourPools().pools)
+		{
+			if (showEmpty || pool->GetCapacity() > 0)
+				poolRow(*pool);
+		}
+
+		ImGui::EndTable();
+	}
+
+	ImGui::TreePop();
+	return true;
+}
+#endif
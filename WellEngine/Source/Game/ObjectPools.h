@@ -0,0 +1,19 @@
+#pragma once
+#include "Utils/ObjectPool.h"
+
+// The pools entities and behaviours are allocated from by their class-specific operator new and delete.
+namespace ObjectPools
+{
+	[[nodiscard]] ObjectPool &GetEntityPool();
+
+	// Returns the pool for behaviours of the given size, or nullptr if no registered behaviour type has that size.
+	// Registered types of the same size share a pool.
+	[[nodiscard]] ObjectPool *GetBehaviourPool(size_t size);
+
+	// Gives the empty blocks of every pool back to the heap. Called once a scene has freed its entities.
+	void ReleaseEmptyBlocks();
+
+#ifdef USE_IMGUI
+	[[nodiscard]] bool RenderUI();
+#endif
+}
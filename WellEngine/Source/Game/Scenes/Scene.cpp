@@ -4,6 +4,8 @@
 #include "Game.h"
 #include "GraphManager.h"
 #include "Audio/SoundEngine.h"
+#include "Utils/FrameGraph.h"
+#include "ObjectPools.h"
 
 #include "Behaviours/BreadcrumbPileBehaviour.h"
 #include "Behaviours/RestrictedViewBehaviour.h"
@@ -1576,6 +1578,9 @@ void Scene::ResetScene()
 
 	_spotlights = std::make_unique<SpotLightCollection>();
 	_pointlights = std::make_unique<PointLightCollection>();
+
+	// The entities and behaviours of the scene are gone, hand their memory back in bulk.
+	ObjectPools::ReleaseEmptyBlocks();
 }
 #pragma endregion
 
@@ -1583,66 +1588,65 @@ void Scene::ResetScene()
 #pragma region Update
 void Scene::AddUpdateCallback(Behaviour *beh)
 {
-	// Check if the callback already exists
-	if (std::find(_updateCallbacks.begin(), _updateCallbacks.end(), beh) != _updateCallbacks.end())
-		return;
-
-	_updateCallbacks.emplace_back(beh);
+	_updateCallbacks.Add(beh);
 }
 void Scene::RemoveUpdateCallback(Behaviour *beh)
 {
-	// Remove any callbacks from the same behaviour
-	auto it = std::remove(_updateCallbacks.begin(), _updateCallbacks.end(), beh);
-	if (it != _updateCallbacks.end())
-		_updateCallbacks.erase(it);
+	_updateCallbacks.Remove(beh);
 }
 
 void Scene::AddParallelUpdateCallback(Behaviour *beh)
 {
-	// Check if the callback already exists
-	if (std::find(_parallelUpdateCallbacks.begin(), _parallelUpdateCallbacks.end(), beh) != _parallelUpdateCallbacks.end())
-		return;
-
-	_parallelUpdateCallbacks.emplace_back(beh);
+	_parallelUpdateCallbacks.Add(beh);
 }
 void Scene::RemoveParallelUpdateCallback(Behaviour *beh)
 {
-	// Remove any callbacks from the same behaviour
-	auto it = std::remove(_parallelUpdateCallbacks.begin(), _parallelUpdateCallbacks.end(), beh);
-	if (it != _parallelUpdateCallbacks.end())
-		_parallelUpdateCallbacks.erase(it);
+	_parallelUpdateCallbacks.Remove(beh);
 }
 
 void Scene::AddLateUpdateCallback(Behaviour *beh)
 {
-	// Check if the callback already exists
-	if (std::find(_lateUpdateCallbacks.begin(), _lateUpdateCallbacks.end(), beh) != _lateUpdateCallbacks.end())
-		return;
-
-	_lateUpdateCallbacks.emplace_back(beh);
+	_lateUpdateCallbacks.Add(beh);
 }
 void Scene::RemoveLateUpdateCallback(Behaviour *beh)
 {
-	// Remove any callbacks from the same behaviour
-	auto it = std::remove(_lateUpdateCallbacks.begin(), _lateUpdateCallbacks.end(), beh);
-	if (it != _lateUpdateCallbacks.end())
-		_lateUpdateCallbacks.erase(it);
+	_lateUpdateCallbacks.Remove(beh);
 }
 
 void Scene::AddFixedUpdateCallback(Behaviour *beh)
 {
-	// Check if the callback already exists
-	if (std::find(_fixedUpdateCallbacks.begin(), _fixedUpdateCallbacks.end(), beh) != _fixedUpdateCallbacks.end())
+	_fixedUpdateCallbacks.Add(beh);
+}
+void Scene::RemoveFixedUpdateCallback(Behaviour *beh)
+{
+	_fixedUpdateCallbacks.Remove(beh);
+}
+
+void Scene::RegisterBehaviourType(Behaviour *beh)
+{
+	if (beh->_typeRegistryIndex != -1)
 		return;
 
-	_fixedUpdateCallbacks.emplace_back(beh);
+	const UINT typeID = beh->GetTypeID();
+	std::vector<Behaviour *> &behaviours = _behavioursByType[(typeID != BEHAVIOUR_TYPE_NULL) ? typeID : UNTYPED_BEHAVIOURS];
+	beh->_typeRegistryIndex = static_cast<UINT>(behaviours.size());
+	behaviours.emplace_back(beh);
 }
-void Scene::RemoveFixedUpdateCallback(Behaviour *beh)
+void Scene::UnregisterBehaviourType(Behaviour *beh)
 {
-	// Remove any callbacks from the same behaviour
-	auto it = std::remove(_fixedUpdateCallbacks.begin(), _fixedUpdateCallbacks.end(), beh);
-	if (it != _fixedUpdateCallbacks.end())
-		_fixedUpdateCallbacks.erase(it);
+	const UINT index = beh->_typeRegistryIndex;
+	if (index == -1)
+		return;
+
+	// Swap with the last behaviour of the same type, order within a type is not kept.
+	const UINT typeID = beh->GetTypeID();
+	std::vector<Behaviour *> &behaviours = _behavioursByType[(typeID != BEHAVIOUR_TYPE_NULL) ? typeID : UNTYPED_BEHAVIOURS];
+	Behaviour *last = behaviours.back();
+	behaviours[index] = last;
+	last->_typeRegistryIndex = index;
+	behaviours.pop_back();
+
+	beh->_typeRegistryIndex = -1;
 }
 
 
@@ -1669,74 +1673,79 @@ bool Scene::Update(TimeUtils &time, const Input &input)
 
 	_input = &input;
 
-	// Update entities
-	for (UINT i = 0; i < _updateCallbacks.size(); i++)
-	{
-		if (!_updateCallbacks[i]->InitialUpdate(time, input))
+	// Stages touching the immediate context, or running arbitrary behaviour code, stay on the main thread.
+	// Collision callbacks only change entities, so sound updates on a worker while the main thread sets
+	// the light collections and then checks collisions.
+	FrameGraph updateGraph;
+	const FrameGraph::ResourceID
+		entities = updateGraph.AddResource("Entities"),
+		audio = updateGraph.AddResource("Audio"),
+		graphics = updateGraph.AddResource("Graphics");
+
+	updateGraph.AddStage("Update Callbacks", {}, { entities, audio, graphics }, [&]() {
+		return _updateCallbacks.RunUpdate(time, input);
+	}, true);
+
+	updateGraph.AddStage("Set Light Collections", {}, { graphics }, [&]() {
+		if (!_graphics->SetSpotlightCollection(_spotlights.get()))
 		{
-			ErrMsgF("Failed to update entity '{}'!", _updateCallbacks[i]->GetEntity()->GetName());
+			ErrMsg("Failed to set spotlight collection!");
 			return false;
 		}
-	}
-
-#ifdef PARALLEL_UPDATE
-	bool parallelFailed = false;
-	int parallelBallbackCount = static_cast<int>(_parallelUpdateCallbacks.size());
 
-#pragma omp parallel for num_threads(PARALLEL_THREADS)
-	for (int i = 0; i < parallelBallbackCount; i++)
-	{
-		if (!parallelFailed)
+		if (!_graphics->SetPointlightCollection(_pointlights.get()))
 		{
-			if (!_parallelUpdateCallbacks[i]->InitialParallelUpdate(time, input))
-			{
-#pragma omp critical
-				{
-					ErrMsgF("Failed to update entity '{}' in parallel!", _parallelUpdateCallbacks[i]->GetEntity()->GetName());
-					parallelFailed = true;
-				}
-			}
+			ErrMsg("Failed to set pointlight collection!");
+			return false;
 		}
-	}
+		return true;
+	}, true);
 
-	if (parallelFailed)
-	{
-		ErrMsg("Parallel update failed!");
-		return false;
-	}
+#ifdef PARALLEL_UPDATE
+	updateGraph.AddStage("Parallel Update", {}, { entities }, [&]() {
+		return _parallelUpdateCallbacks.RunParallelUpdate(time, input);
+	});
 #endif
 
-	if (!_collisionHandler.CheckCollisions(time, this, _context))
-	{
-		ErrMsg("Failed to performed collision checks!");
-		return false;
-	}
-
-	if (!UpdateSound())
-	{
-		ErrMsg("Failed to update sound!");
-		return false;
-	}
-
-	if (!_graphics->SetSpotlightCollection(_spotlights.get()))
-	{
-		ErrMsg("Failed to set spotlight collection!");
-		return false;
-	}
+	updateGraph.AddStage("Process Transform Changes", {}, { entities }, [&]() {
+		ProcessTransformChanges();
+		return true;
+	});
 
-	if (!_graphics->SetPointlightCollection(_pointlights.get()))
-	{
-		ErrMsg("Failed to set pointlight collection!");
-		return false;
-	}
+	updateGraph.AddStage("Check Collisions", {}, { entities }, [&]() {
+		if (!_collisionHandler.CheckCollisions(time, this))
+		{
+			ErrMsg("Failed to performed collision checks!");
+			return false;
+		}
+		return true;
+	}, true);
 
-	if (_viewCamera)
-	{
-		if (!_viewCamera.Get()->UpdateBuffers())
+	updateGraph.AddStage("Update Sound", {}, { audio }, [&]() {
+		if (!UpdateSound())
 		{
-			ErrMsg("Failed to update view camera's buffers!");
+			ErrMsg("Failed to update sound!");
 			return false;
 		}
+		return true;
+	});
+
+	updateGraph.AddStage("Update View Camera Buffers", { entities }, { graphics }, [&]() {
+		if (_viewCamera)
+		{
+			if (!_viewCamera.Get()->UpdateBuffers())
+			{
+				ErrMsg("Failed to update view camera's buffers!");
+				return false;
+			}
+		}
+		return true;
+	}, true);
+
+	if (!updateGraph.Execute())
+	{
+		ErrMsg("Failed to run update stages!");
+		return false;
 	}
 
 	return true;
@@ -1749,15 +1758,14 @@ bool Scene::LateUpdate(TimeUtils &time, const Input &input)
 		return false;
 
 	// Late update entities
-	for (UINT i = 0; i < _lateUpdateCallbacks.size(); i++)
+	if (!_lateUpdateCallbacks.RunLateUpdate(time, input))
 	{
-		if (!_lateUpdateCallbacks[i]->InitialLateUpdate(time, input))
-		{
-			ErrMsgF("Failed to late update entity '{}'!", _lateUpdateCallbacks[i]->GetEntity()->GetName());
-			return false;
-		}
+		ErrMsg("Failed to late update behaviours!");
+		return false;
 	}
 
+	ProcessTransformChanges();
+
 	// Update volume tree & insert new entities
 	if (!_sceneHolder.Update())
 	{
@@ -1789,13 +1797,10 @@ bool Scene::FixedUpdate(float deltaTime, const Input &input)
 	if (!_initialized)
 		return false;
 
-	for (UINT i = 0; i < _fixedUpdateCallbacks.size(); i++)
+	if (!_fixedUpdateCallbacks.RunFixedUpdate(deltaTime, input))
 	{
-		if (!_fixedUpdateCallbacks[i]->InitialFixedUpdate(deltaTime, input))
-		{
-			ErrMsgF("Failed to fixed update entity '{}'!", _fixedUpdateCallbacks[i]->GetEntity()->GetName());
-			return false;
-		}
+		ErrMsg("Failed to fixed update behaviours!");
+		return false;
 	}
 
 	return true;
@@ -1808,31 +1813,39 @@ bool Scene::UpdateCullingTree()
 	if (!_initialized)
 		return false;
 
-	const UINT entityCount = _sceneHolder.GetEntityCount();
-	for (UINT i = 0; i < entityCount; i++)
-	{
-		Entity *ent = _sceneHolder.GetEntity(i);
-
-		if (!ent)
-			continue;
-
-		if (ent->IsRemoved())
-			continue;
+	ProcessTransformChanges();
 
-		if (!ent->GetTransform()->IsScenePosDirty())
-			continue;
+#ifdef TRANSFORM_HIERARCHY
+	// Resolve all world matrices in bulk before the bounds of moved entities read them.
+	_transformHierarchy.Update();
+#endif
 
-		if (!_sceneHolder.UpdateEntityPosition(ent))
-		{
-			ErrMsg("Failed to update entity transform!");
-			return false;
-		}
+	// Only entities that moved since the last frame are visited, they queue themselves when their transform changes.
+	if (!_sceneHolder.SyncTree())
+	{
+		ErrMsg("Failed to sync culling tree!");
+		return false;
 	}
 
 	_sceneHolder.RecalculateTreeCullingBounds();
 
 	return true;
 }
+void Scene::ProcessTransformChanges()
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (_transformChanges.IsEmpty())
+		return;
+
+	_transformChanges.Consume(_changedTransforms);
+
+	for (Transform *transform : _changedTransforms)
+	{
+		if (Entity *entity = transform->GetChangeOwner())
+			entity->SetDirtyImmediate();
+	}
+}
 bool Scene::UpdateSound()
 {
 	ZoneScopedXC(RandomUniqueColor());
@@ -1859,6 +1872,109 @@ void Scene::UpdateBillboardGizmos()
 
 
 #pragma region Render
+bool Scene::OcclusionCull(std::vector<Entity *> &entities)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	constexpr UINT MAX_OCCLUDERS = 16;
+	constexpr float MIN_OCCLUDER_RADIUS = 2.5f;
+
+	if (_occlusionBuffer.GetWidth() == 0)
+	{
+		if (!_occlusionBuffer.Initialize())
+		{
+			ErrMsg("Failed to initialize occlusion buffer!");
+			return false;
+		}
+	}
+
+	CameraBehaviour *camera = _viewCamera.Get();
+	const dx::XMVECTOR cameraPos = Load(camera->GetTransform()->GetPosition(World));
+	const float nearZ = camera->GetPlanes().nearZ;
+
+	// Large static meshes close to the camera make the best occluders.
+	struct Occluder
+	{
+		Entity *entity;
+		const MeshData *mesh;
+		float score;
+	};
+	std::vector<Occluder> occluders;
+
+	for (Entity *ent : entities)
+	{
+		if (!ent->IsStatic())
+			continue;
+
+		MeshBehaviour *meshBehaviour = nullptr;
+		if (!ent->GetBehaviourByType<MeshBehaviour>(meshBehaviour))
+			continue;
+
+		if (meshBehaviour->IsTransparent() || meshBehaviour->IsOverlay() || meshBehaviour->IsShadowsOnly())
+			continue;
+
+		const MeshD3D11 *mesh = _content->GetMesh(meshBehaviour->GetMeshID());
+		if (mesh == nullptr)
+			continue;
+
+		const MeshData *meshData = mesh->GetMeshData();
+		if (meshData == nullptr || meshData->subMeshInfo.empty())
+			continue;
+
+		dx::BoundingOrientedBox bounds;
+		ent->StoreEntityBounds(bounds);
+
+		const float radius = dx::XMVectorGetX(dx::XMVector3Length(Load(bounds.Extents)));
+		if (radius < MIN_OCCLUDER_RADIUS)
+			continue;
+
+		const float dist = dx::XMVectorGetX(dx::XMVector3Length(dx::XMVectorSubtract(Load(bounds.Center), cameraPos)));
+		occluders.push_back({ ent, meshData, radius / max(dist - radius, nearZ) });
+	}
+
+	if (occluders.size() > MAX_OCCLUDERS)
+	{
+		std::partial_sort(occluders.begin(), occluders.begin() + MAX_OCCLUDERS, occluders.end(),
+			[](const Occluder &a, const Occluder &b) { return a.score > b.score; });
+		occluders.resize(MAX_OCCLUDERS);
+	}
+
+	dx::XMFLOAT4X4 viewProj;
+	dx::XMStoreFloat4x4(&viewProj, dx::XMMatrixMultiply(Load(camera->GetViewMatrix()), Load(camera->GetProjectionMatrix())));
+
+	_occlusionBuffer.Clear(viewProj);
+
+	for (const Occluder &occluder : occluders)
+	{
+		// LODs are stored as submeshes, the last one being the coarsest.
+		const MeshData &meshData = *occluder.mesh;
+		const MeshData::SubMeshInfo &lod = meshData.subMeshInfo.back();
+
+		if (lod.startIndexValue + lod.nrOfIndicesInSubMesh > meshData.indexInfo.nrOfIndicesInBuffer)
+			continue;
+
+		const dx::XMFLOAT4X4A worldMatrix = occluder.entity->GetTransform()->GetWorldMatrix();
+
+		_occlusionBuffer.RasterizeOccluder(
+			meshData.vertexInfo.vertexData, meshData.vertexInfo.sizeOfVertex, meshData.vertexInfo.nrOfVerticesInBuffer,
+			meshData.indexInfo.indexData + lod.startIndexValue, lod.nrOfIndicesInSubMesh, worldMatrix
+		);
+	}
+
+	_occlusionBuffer.Finalize();
+
+	// Occluders never hide themselves, their nearest bounds are always in front of their own surface.
+	const size_t candidateCount = entities.size();
+	std::erase_if(entities, [this](Entity *ent) {
+		dx::BoundingOrientedBox bounds;
+		ent->StoreEntityBounds(bounds);
+		return !_occlusionBuffer.IsVisible(bounds);
+	});
+
+	_lastOccludedCount = static_cast<UINT>(candidateCount - entities.size());
+	return true;
+}
+
 bool Scene::Render(TimeUtils &time, const Input &input)
 {
 	ZoneScopedC(RandomUniqueColor());
@@ -1874,15 +1990,24 @@ bool Scene::Render(TimeUtils &time, const Input &input)
 
 	DebugDrawer::Instance().SetCamera(_viewCamera.Get());
 
-	std::vector<Entity *> entitiesToRender;
-	entitiesToRender.reserve(_viewCamera.Get()->GetCullCount());
-
 	union {
 		dx::BoundingFrustum frustum = {};
 		dx::BoundingOrientedBox box;
 	} view;
 	bool isCameraOrtho = _viewCamera.Get()->GetOrtho();
 
+	const int spotlightCount = static_cast<int>(_spotlights->GetNrOfLights());
+	const int pointlightCount = static_cast<int>(_pointlights->GetNrOfLights());
+
+	// Every light view that needs culling this frame is gathered first, so the tree is traversed once for all of them.
+	// lightViews holds the light index of every view, with pointlight indices offset by spotlightCount.
+	// The main camera is culled on its own, as it moves smoothly and benefits from coherent frustum culling.
+	std::vector<CullView> cullViews;
+	cullViews.reserve(spotlightCount + pointlightCount);
+
+	std::vector<int> lightViews;
+	lightViews.reserve(spotlightCount + pointlightCount);
+
 	time.TakeSnapshot("FrustumCull");
 	if (isCameraOrtho)
 	{
@@ -1891,68 +2016,98 @@ bool Scene::Render(TimeUtils &time, const Input &input)
 			ErrMsg("Failed to store camera box!");
 			return false;
 		}
-
-		if (!_sceneHolder.BoxCull(view.box, entitiesToRender))
-		{
-			ErrMsg("Failed to perform box culling!");
-			return false;
-		}
 	}
 	else
 	{
 		if (!_viewCamera.Get()->StoreBounds(view.frustum, false))
-
 		{
 			ErrMsg("Failed to store camera frustum!");
 			return false;
 		}
+	}
 
-		if (!_sceneHolder.FrustumCull(view.frustum, entitiesToRender))
-		{
-			ErrMsg("Failed to perform frustum culling!");
-			return false;
+	std::vector<Entity *> entitiesToRender;
+	std::vector<std::vector<Entity *>> cullResults;
+
+	// The view and the light views are culled and queued independently of each other, and light tiling only
+	// needs to know which lights are enabled. The culling tree is only read here, it is updated between frames.
+	// An entity may be queued by several views at once, Entity::InitialRender only reads behaviours and sets an atomic flag.
+	FrameGraph renderGraph;
+	const FrameGraph::ResourceID
+		sceneTree = renderGraph.AddResource("Scene Tree"),
+		viewEntities = renderGraph.AddResource("View Entities"),
+		viewQueues = renderGraph.AddResource("View Queues"),
+		lightViewList = renderGraph.AddResource("Light Views"),
+		lightEntities = renderGraph.AddResource("Light Entities"),
+		lightQueues = renderGraph.AddResource("Light Queues"),
+		lightGrid = renderGraph.AddResource("Light Grid");
+
+	renderGraph.AddStage("Cull View", { sceneTree }, { viewEntities }, [&]() {
+		entitiesToRender.reserve(_viewCamera.Get()->GetCullCount());
+
+		if (isCameraOrtho)
+		{
+			if (!_sceneHolder.BoxCull(view.box, entitiesToRender))
+			{
+				ErrMsg("Failed to perform box culling!");
+				return false;
+			}
 		}
-	}
+		else
+		{
+			FrustumCullOptions cullOptions;
+			cullOptions.planeMasking = true;
+			cullOptions.cacheSlot = FrustumCullOptions::MAIN_CAMERA_SLOT;
 
-	for (UINT i = 0; i < entitiesToRender.size(); i++)
-	{
-		Entity *ent = entitiesToRender[i];
+			if (!_sceneHolder.PortalCull(view.frustum, entitiesToRender, cullOptions))
+			{
+				ErrMsg("Failed to perform frustum culling!");
+				return false;
+			}
 
-		CamRenderQueuer queuer = { _viewCamera.Get() };
-		if (!ent->InitialRender(queuer, _viewCamera.Get()->GetRendererInfo()))
-		{
-			ErrMsg("Failed to render entity!");
-			return false;
+			if (_occlusionCulling)
+			{
+				if (!OcclusionCull(entitiesToRender))
+				{
+					ErrMsg("Failed to perform occlusion culling!");
+					return false;
+				}
+			}
 		}
-	}
+		return true;
+	});
 
-	_viewCamera.Get()->SortGeometryQueue();
-	if (_graphics->GetRenderTransparent())
-		_viewCamera.Get()->SortTransparentQueue();
-	if (_graphics->GetRenderOverlay())
-		_viewCamera.Get()->SortOverlayQueue();
+	renderGraph.AddStage("Queue View", { viewEntities }, { viewQueues }, [&]() {
+		for (UINT i = 0; i < entitiesToRender.size(); i++)
+		{
+			Entity *ent = entitiesToRender[i];
 
-	time.TakeSnapshot("FrustumCull");
+			CamRenderQueuer queuer = { _viewCamera.Get() };
+			if (!ent->InitialRender(queuer, _viewCamera.Get()->GetRendererInfo()))
+			{
+				ErrMsg("Failed to render entity!");
+				return false;
+			}
+		}
 
-	const int spotlightCount = static_cast<int>(_spotlights->GetNrOfLights());
-	const int pointlightCount = static_cast<int>(_pointlights->GetNrOfLights());
+		_viewCamera.Get()->SortGeometryQueue();
+		if (_graphics->GetRenderTransparent())
+			_viewCamera.Get()->SortTransparentQueue();
+		if (_graphics->GetRenderOverlay())
+			_viewCamera.Get()->SortOverlayQueue();
 
-#pragma warning(disable: 6993)
-#pragma omp parallel num_threads(PARALLEL_THREADS)
-	{
-#pragma omp for nowait
+		time.TakeSnapshot("FrustumCull");
+		return true;
+	});
+
+	renderGraph.AddStage("Collect Light Views", {}, { lightViewList }, [&]() {
 		for (int i = 0; i < spotlightCount; i++)
 		{
-			ZoneNamedXNC(cullSpotlightZone, "Cull Spotlight", RandomUniqueColor(), true);
-
 			if (!_spotlights.get()->GetLightBehaviour(i)->DoUpdate())
 				continue;
 
 			CameraBehaviour *spotlightCamera = _spotlights.get()->GetLightBehaviour(i)->GetShadowCamera();
 
-			std::vector<Entity *> entitiesToCastShadows;
-			entitiesToCastShadows.reserve(spotlightCamera->GetCullCount());
-
 			bool isSpotlightOrtho = spotlightCamera->GetOrtho();
 
 			bool intersectResult = false;
@@ -1974,11 +2129,7 @@ bool Scene::Render(TimeUtils &time, const Input &input)
 					continue;
 				}
 
-				if (!_sceneHolder.BoxCull(lightBounds, entitiesToCastShadows))
-				{
-					ErrMsgF("Failed to perform box culling for spotlight #{}!", i);
-					continue;
-				}
+				cullViews.emplace_back(lightBounds);
 			}
 			else
 			{
@@ -1999,39 +2150,19 @@ bool Scene::Render(TimeUtils &time, const Input &input)
 				}
 				_spotlights->SetLightEnabled(i, true);
 
-				if (!_sceneHolder.FrustumCull(lightBounds, entitiesToCastShadows))
-				{
-					ErrMsgF("Failed to perform frustum culling for spotlight #{}!", i);
-					continue;
-				}
-			}
-
-			for (Entity *ent : entitiesToCastShadows)
-			{
-				CamRenderQueuer queuer = { spotlightCamera };
-				if (!ent->InitialRender(queuer, spotlightCamera->GetRendererInfo()))
-				{
-					ErrMsgF("Failed to render entity for spotlight #{}!", i);
-					break;
-				}
+				cullViews.emplace_back(lightBounds);
 			}
 
-			spotlightCamera->SortGeometryQueue();
+			lightViews.emplace_back(i);
 		}
 
-#pragma omp for nowait
 		for (int i = 0; i < pointlightCount; i++)
 		{
-			ZoneNamedXNC(cullPointlightZone, "Cull Pointlight", RandomUniqueColor(), true);
-
 			if (!_pointlights.get()->GetLightBehaviour(i)->DoUpdate())
 				continue;
 
 			CameraCubeBehaviour *pointlightCamera = _pointlights.get()->GetLightBehaviour(i)->GetShadowCameraCube();
 
-			std::vector<Entity *> entitiesToCastShadows;
-			entitiesToCastShadows.reserve(pointlightCamera->GetCullCount());
-
 			dx::BoundingBox pointlightBox;
 			if (!pointlightCamera->StoreBounds(pointlightBox))
 			{
@@ -2050,41 +2181,84 @@ bool Scene::Render(TimeUtils &time, const Input &input)
 				continue;
 			}
 
-			if (!_sceneHolder.BoxCull(pointlightBox, entitiesToCastShadows))
-			{
-				ErrMsgF("Failed to perform box culling for pointlight #{}!", i);
-				continue;
-			}
+			_pointlights->SetLightEnabled(i, true);
 
-			pointlightCamera->SetCullCount(static_cast<UINT>(entitiesToCastShadows.size()));
+			cullViews.emplace_back(pointlightBox);
+			lightViews.emplace_back(spotlightCount + i);
+		}
+		return true;
+	});
 
-			_pointlights->SetLightEnabled(i, true);
+	renderGraph.AddStage("Cull Light Views", { sceneTree, lightViewList }, { lightEntities }, [&]() {
+		cullResults.resize(cullViews.size());
+		if (!_sceneHolder.MultiCull(cullViews, cullResults))
+		{
+			ErrMsg("Failed to perform batched culling!");
+			return false;
+		}
+		return true;
+	});
 
-			for (Entity *ent : entitiesToCastShadows)
+	renderGraph.AddStage("Queue Light Views", { lightViewList, lightEntities }, { lightQueues }, [&]() {
+		// Each light view only writes to its own camera's queues.
+		JobSystem::Instance().ParallelFor(static_cast<UINT>(lightViews.size()), 1, [&](UINT begin, UINT end) {
+			for (UINT v = begin; v < end; v++)
 			{
-				dx::BoundingOrientedBox entBounds;
-				ent->StoreEntityBounds(entBounds);
-
-				if (!pointlightBox.Intersects(entBounds))
-					continue;
+				const int light = lightViews[v];
+				const std::vector<Entity *> &entitiesToCastShadows = cullResults[v];
 
-				CubeRenderQueuer queuer = { pointlightCamera };
-				if (!ent->InitialRender(queuer, pointlightCamera->GetRendererInfo()))
+				if (light < spotlightCount)
 				{
-					ErrMsgF("Failed to render entity for pointlight #{}!", i);
-					break;
+					ZoneNamedXNC(queueSpotlightZone, "Queue Spotlight", RandomUniqueColor(), true);
+
+					CameraBehaviour *spotlightCamera = _spotlights.get()->GetLightBehaviour(light)->GetShadowCamera();
+
+					for (Entity *ent : entitiesToCastShadows)
+					{
+						CamRenderQueuer queuer = { spotlightCamera };
+						if (!ent->InitialRender(queuer, spotlightCamera->GetRendererInfo()))
+						{
+							ErrMsgF("Failed to render entity for spotlight #{}!", light);
+							break;
+						}
+					}
+
+					spotlightCamera->SortGeometryQueue();
 				}
-			}
+				else
+				{
+					ZoneNamedXNC(queuePointlightZone, "Queue Pointlight", RandomUniqueColor(), true);
 
-			pointlightCamera->SortGeometryQueue();
-		}
-	}
-#pragma warning(default: 6993)
+					const int i = light - spotlightCount;
+					CameraCubeBehaviour *pointlightCamera = _pointlights.get()->GetLightBehaviour(i)->GetShadowCameraCube();
+					const dx::BoundingBox &pointlightBox = cullViews[v].box;
 
-	// Calculate light tiles
-	{
-		ZoneNamedNC(calculateLightTilesZone, "Calculate Light Tiles", RandomUniqueColor(), true);
+					pointlightCamera->SetCullCount(static_cast<UINT>(entitiesToCastShadows.size()));
 
+					for (Entity *ent : entitiesToCastShadows)
+					{
+						dx::BoundingOrientedBox entBounds;
+						ent->StoreEntityBounds(entBounds);
+
+						if (!pointlightBox.Intersects(entBounds))
+							continue;
+
+						CubeRenderQueuer queuer = { pointlightCamera };
+						if (!ent->InitialRender(queuer, pointlightCamera->GetRendererInfo()))
+						{
+							ErrMsgF("Failed to render entity for pointlight #{}!", i);
+							break;
+						}
+					}
+
+					pointlightCamera->SortGeometryQueue();
+				}
+			}
+		}, "Queue Light Views");
+		return true;
+	});
+
+	renderGraph.AddStage("Calculate Light Tiles", { lightViewList }, { lightGrid }, [&]() {
 		_graphics->ResetLightGrid(); // Clear light grid buffer
 		const UINT lightTileCount = LIGHT_GRID_RES * LIGHT_GRID_RES;
 
@@ -2170,16 +2344,18 @@ bool Scene::Render(TimeUtils &time, const Input &input)
 
 		dx::XMFLOAT3A cameraPos = _viewCamera.Get()->GetTransform()->GetPosition(World);
 
-		const int spotlightCount = static_cast<int>(_spotlights->GetNrOfLights());
-		const int pointlightCount = static_cast<int>(_pointlights->GetNrOfLights());
-		const int simpleSpotlightCount = static_cast<int>(_spotlights->GetNrOfSimpleLights());
-		const int simplePointlightCount = static_cast<int>(_pointlights->GetNrOfSimpleLights());
+		const UINT spotlightCount = static_cast<UINT>(_spotlights->GetNrOfLights());
+		const UINT pointlightCount = static_cast<UINT>(_pointlights->GetNrOfLights());
+		const UINT simpleSpotlightCount = static_cast<UINT>(_spotlights->GetNrOfSimpleLights());
+		const UINT simplePointlightCount = static_cast<UINT>(_pointlights->GetNrOfSimpleLights());
 
-#pragma warning(disable: 6993)
-#pragma omp parallel num_threads(PARALLEL_THREADS)
-		{
-#pragma omp for nowait
-			for (int i = 0; i < spotlightCount; i++)
+		// All four light types are tiled at once, with no barrier between them.
+		JobSystem &jobSystem = JobSystem::Instance();
+		JobGroup lightTileGroup;
+		std::mutex lightTileMutex;
+
+		jobSystem.ParallelFor(lightTileGroup, spotlightCount, 1, [&](UINT begin, UINT end) {
+			for (UINT i = begin; i < end; i++)
 			{
 				ZoneNamedXNC(spotlightZone, "Calculate Spotlight Tiles", RandomUniqueColor(), true);
 
@@ -2206,15 +2382,14 @@ bool Scene::Render(TimeUtils &time, const Input &input)
 						}
 					}
 
-#pragma omp critical
-					{
-						_graphics->AddLightToTile(j, i, SPOTLIGHT);
-					}
+					std::lock_guard<std::mutex> lock(lightTileMutex);
+					_graphics->AddLightToTile(j, i, SPOTLIGHT);
 				}
 			}
+		}, "Calculate Spotlight Tiles");
 
-#pragma omp for nowait
-			for (int i = 0; i < pointlightCount; i++)
+		jobSystem.ParallelFor(lightTileGroup, pointlightCount, 1, [&](UINT begin, UINT end) {
+			for (UINT i = begin; i < end; i++)
 			{
 				ZoneNamedXNC(pointlightZone, "Calculate Pointlight Tiles", RandomUniqueColor(), true);
 
@@ -2237,15 +2412,14 @@ bool Scene::Render(TimeUtils &time, const Input &input)
 							continue;
 					}
 
-#pragma omp critical
-					{
-						_graphics->AddLightToTile(j, i, POINTLIGHT);
-					}
+					std::lock_guard<std::mutex> lock(lightTileMutex);
+					_graphics->AddLightToTile(j, i, POINTLIGHT);
 				}
 			}
+		}, "Calculate Pointlight Tiles");
 
-#pragma omp for nowait
-			for (int i = 0; i < simpleSpotlightCount; i++)
+		jobSystem.ParallelFor(lightTileGroup, simpleSpotlightCount, 1, [&](UINT begin, UINT end) {
+			for (UINT i = begin; i < end; i++)
 			{
 				ZoneNamedXNC(simpleSpotlightZone, "Calculate Simple Spotlight Tiles", RandomUniqueColor(), true);
 
@@ -2272,15 +2446,14 @@ bool Scene::Render(TimeUtils &time, const Input &input)
 						}
 					}
 
-#pragma omp critical
-					{
-						_graphics->AddLightToTile(j, i, SIMPLE_SPOTLIGHT);
-					}
+					std::lock_guard<std::mutex> lock(lightTileMutex);
+					_graphics->AddLightToTile(j, i, SIMPLE_SPOTLIGHT);
 				}
 			}
+		}, "Calculate Simple Spotlight Tiles");
 
-#pragma omp for nowait
-			for (int i = 0; i < simplePointlightCount; i++)
+		jobSystem.ParallelFor(lightTileGroup, simplePointlightCount, 1, [&](UINT begin, UINT end) {
+			for (UINT i = begin; i < end; i++)
 			{
 				ZoneNamedXNC(simplePointlightZone, "Calculate Simple Pointlight Tiles", RandomUniqueColor(), true);
 
@@ -2308,14 +2481,20 @@ bool Scene::Render(TimeUtils &time, const Input &input)
 						}
 					}
 
-#pragma omp critical
-					{
-						_graphics->AddLightToTile(j, i, SIMPLE_POINTLIGHT);
-					}
+					std::lock_guard<std::mutex> lock(lightTileMutex);
+					_graphics->AddLightToTile(j, i, SIMPLE_POINTLIGHT);
 				}
 			}
-		}
-#pragma warning(default: 6993)
+		}, "Calculate Simple Pointlight Tiles");
+
+		jobSystem.Wait(lightTileGroup);
+		return true;
+	});
+
+	if (!renderGraph.Execute())
+	{
+		ErrMsg("Failed to run render stages!");
+		return false;
 	}
 
 #ifdef DEBUG_BUILD
@@ -2436,6 +2615,16 @@ SceneHolder *Scene::GetSceneHolder()
 {
 	return &_sceneHolder;
 }
+TransformChangeLog *Scene::GetTransformChangeLog()
+{
+	return &_transformChanges;
+}
+#ifdef TRANSFORM_HIERARCHY
+TransformHierarchy *Scene::GetTransformHierarchy()
+{
+	return &_transformHierarchy;
+}
+#endif
 CollisionHandler *Scene::GetCollisionHandler()
 {
 	return &_collisionHandler;
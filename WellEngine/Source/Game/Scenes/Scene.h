@@ -2,6 +2,7 @@
 
 #pragma region Includes, Usings & Defines
 #include <d3d11.h>
+#include <array>
 
 #include "rapidjson/document.h"
 #include "SceneHolder.h"
@@ -15,7 +16,10 @@
 #include "Collision/CollisionHandler.h"
 #include "Debug/DebugDrawer.h"
 #include "GraphManager.h"
+#include "TransformChangeLog.h"
+#include "BehaviourUpdateList.h"
 #include "Timing/TimelineManager.h"
+#include "Rendering/Culling/OcclusionBuffer.h"
 
 namespace json = rapidjson;
 
@@ -33,6 +37,20 @@ class DebugPlayerBehaviour;
 class Scene : public IRefTarget<Scene>, public Identifiable
 {
 private:
+#ifdef TRANSFORM_HIERARCHY
+	// Declared first so that it outlives every entity transform stored in it.
+	TransformHierarchy _transformHierarchy;
+#endif
+
+	// Transforms of scene entities that changed since their owners were last notified. Outlives the entities.
+	TransformChangeLog _transformChanges;
+	std::vector<Transform *> _changedTransforms;
+
+	// Every behaviour in the scene of each registered type, indexed by type ID. Outlives the entities.
+	// Behaviours of unregistered classes share the last list.
+	static constexpr UINT UNTYPED_BEHAVIOURS = BEHAVIOUR_TYPE_COUNT;
+	std::array<std::vector<Behaviour *>, BEHAVIOUR_TYPE_COUNT + 1> _behavioursByType;
+
 	std::vector<std::unique_ptr<Entity>> _globalEntities = {};
 	std::unique_ptr<SpotLightCollection> _spotlights;
 	std::unique_ptr<PointLightCollection> _pointlights;
@@ -51,7 +69,8 @@ private:
 	SceneHolder _sceneHolder;
 	const Input *_input = nullptr;
 
-	Ref<CameraBehaviour>
+	// Read several times per frame, so held by handle rather than by reference.
+	Handle<CameraBehaviour>
 		_viewCamera = nullptr,
 		_playerCamera = nullptr,
 		_animationCamera = nullptr;
@@ -60,8 +79,8 @@ private:
 	Ref<DebugPlayerBehaviour> _debugPlayer = nullptr;
 #endif
 	Ref<Entity> _player = nullptr;
-	Ref<Behaviour> _monster = nullptr;
-	Ref<Behaviour> _terrainBehaviour = nullptr;
+	Handle<Behaviour> _monster = nullptr;
+	Handle<Behaviour> _terrainBehaviour = nullptr;
 	const Collisions::Terrain *_terrain = nullptr;
 
 	CollisionHandler _collisionHandler;
@@ -74,6 +93,10 @@ private:
 	FogSettingsBuffer _fogSettings = { };
 	EmissionSettingsBuffer _emissionSettings = { };
 
+	OcclusionBuffer _occlusionBuffer;
+	bool _occlusionCulling = true;
+	UINT _lastOccludedCount = 0;
+
 #ifdef DEBUG_BUILD
 	bool _isGeneratingEntityBounds = false;
 	bool _isGeneratingVolumeTree = false;
@@ -91,16 +114,22 @@ private:
 
 	std::string _sceneName = "";
 
-	std::vector<Behaviour *> _updateCallbacks;
-	std::vector<Behaviour *> _parallelUpdateCallbacks;
-	std::vector<Behaviour *> _lateUpdateCallbacks;
-	std::vector<Behaviour *> _fixedUpdateCallbacks;
+	BehaviourUpdateList _updateCallbacks;
+	BehaviourUpdateList _parallelUpdateCallbacks;
+	BehaviourUpdateList _lateUpdateCallbacks;
+	BehaviourUpdateList _fixedUpdateCallbacks;
 
 	std::vector<Behaviour *> _postDeserializeCallbacks;
 
 	[[nodiscard]] bool UpdateSound();
+
+	// Notifies the owners of every transform changed since the last call.
+	void ProcessTransformChanges();
 	[[nodiscard]] bool MergeStaticEntities();
 
+	// Removes entities hidden behind large static occluders from the view camera's culling results.
+	[[nodiscard]] bool OcclusionCull(std::vector<Entity *> &entities);
+
 #ifdef USE_IMGUI
 	[[nodiscard]] bool RenderEntityCreatorUI();
 	[[nodiscard]] bool RenderSceneHierarchyUI();
@@ -139,6 +168,17 @@ public:
 	void AddFixedUpdateCallback(Behaviour *beh);
 	void RemoveFixedUpdateCallback(Behaviour *beh);
 
+	void RegisterBehaviourType(Behaviour *beh);
+	void UnregisterBehaviourType(Behaviour *beh);
+
+	// Every behaviour in the scene whose class is exactly T, in no particular order.
+	template <class T>
+	[[nodiscard]] const std::vector<Behaviour *> &GetBehavioursOfType() const;
+
+	// Appends every behaviour in the scene that is a T, including subclasses, in no particular order.
+	template <class T>
+	void GetBehavioursDerivedFrom(std::vector<T *> &behaviours) const;
+
 	[[nodiscard]] bool Update(TimeUtils &time, const Input &input);
 	[[nodiscard]] bool LateUpdate(TimeUtils &time, const Input &input);
 	[[nodiscard]] bool FixedUpdate(float deltaTime, const Input &input);
@@ -195,6 +235,10 @@ public:
 	[[nodiscard]] ID3D11DeviceContext *GetContext() const;
 	[[nodiscard]] Content *GetContent() const;
 	[[nodiscard]] SceneHolder *GetSceneHolder();
+	[[nodiscard]] TransformChangeLog *GetTransformChangeLog();
+#ifdef TRANSFORM_HIERARCHY
+	[[nodiscard]] TransformHierarchy *GetTransformHierarchy();
+#endif
 	[[nodiscard]] Graphics *GetGraphics() const;
 	[[nodiscard]] GraphManager *GetGraphManager();
 	[[nodiscard]] const Input *GetInput() const;
@@ -258,3 +302,33 @@ public:
 
 	TESTABLE()
 };
+
+template<class T>
+inline const std::vector<Behaviour *> &Scene::GetBehavioursOfType() const
+{
+	static_assert(BehaviourType<T>::ID != BEHAVIOUR_TYPE_NULL, "Only registered behaviours are tracked by type.");
+	return _behavioursByType[BehaviourType<T>::ID];
+}
+
+template<class T>
+inline void Scene::GetBehavioursDerivedFrom(std::vector<T *> &behaviours) const
+{
+	static_assert(BehaviourType<T>::ID != BEHAVIOUR_TYPE_NULL, "Only registered behaviours are tracked by type.");
+	const BehaviourTypeMask &types = BehaviourRegistry::GetDerivedTypes(BehaviourType<T>::ID);
+
+	for (UINT typeID = 0; typeID < BEHAVIOUR_TYPE_COUNT; typeID++)
+	{
+		if (!types.test(typeID))
+			continue;
+
+		for (Behaviour *beh : _behavioursByType[typeID])
+			behaviours.emplace_back(static_cast<T *>(beh));
+	}
+
+	// Unregistered behaviours may still derive from a registered type.
+	for (Behaviour *beh : _behavioursByType[UNTYPED_BEHAVIOURS])
+	{
+		if (T *derived = dynamic_cast<T *>(beh))
+			behaviours.emplace_back(derived);
+	}
+}
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "SceneHolder.h"
 #include "Scene.h"
+#include <unordered_set>
 
 #ifdef LEAK_DETECTION
 #define new			DEBUG_NEW
@@ -8,11 +9,11 @@
 
 using namespace DirectX;
 
-constexpr UINT EntityIDHashMaxSize = 64;
-constexpr UINT EntityIDHashRemoveAge = 16;
+// Queued insertions into an empty volume tree build it in one pass from this many entities.
+constexpr UINT TreeBulkBuildMinEntities = 64;
 
-constexpr UINT EntityNameHashMaxSize = 32;
-constexpr UINT EntityNameHashRemoveAge = 32;
+// Levels of the tree sync with fewer entities than this compute their bounds on one thread.
+constexpr UINT TreeSyncParallelMinEntities = 32;
 
 namespace SceneContents
 {
@@ -58,7 +59,10 @@ namespace SceneContents
 	{
 		if (index >= _entities.size())
 			return nullptr;
-		return _entities[index]->GetEntity();
+
+		// Slots of detached entities stay null until the scene holder compacts them.
+		const SceneEntity *sceneEntity = _entities[index];
+		return sceneEntity ? sceneEntity->GetEntity() : nullptr;
 	}
 	Entity *SceneIterator::Step(bool skipInvalid, bool skipDisabled)
 	{
@@ -69,7 +73,7 @@ namespace SceneContents
 			if (_current == _end)
 				return nullptr;
 
-			ent = (*_current)->entity;
+			ent = *_current ? (*_current)->entity : nullptr;
 			++_current;
 
 			return ent;
@@ -81,7 +85,7 @@ namespace SceneContents
 			if (_current == _end)
 				return nullptr;
 
-			ent = (*_current)->entity;
+			ent = *_current ? (*_current)->entity : nullptr;
 			++_current;
 
 			if (!ent)
@@ -101,7 +105,7 @@ namespace SceneContents
 	}
 	[[nodiscard]] Entity *SceneIterator::Peek() const
 	{
-		if (_current == _end)
+		if (_current == _end || !*_current)
 			return nullptr;
 		return (*_current)->entity;
 	}
@@ -122,6 +126,12 @@ bool SceneHolder::Initialize(const BoundingBox &sceneBounds)
 		return false;
 	}
 
+	if (!_staticTree.Initialize())
+	{
+		ErrMsg("Failed to initialize static tree!");
+		return false;
+	}
+
 	return true;
 }
 
@@ -156,88 +166,51 @@ bool SceneHolder::Update()
 			SceneContents::SceneEntity *ent = _entities[currentIndex];
 			_entities.erase(_entities.begin() + currentIndex);
 			_entities.insert(_entities.begin() + newIndex, ent);
-		}
-		_entityReorderQueue.clear();
-	}
-
-	// Update Hashes
-	{
-		ZoneNamedXNC(updateHashesZone, "Update Hashes", RandomUniqueColor(), true);
-
-		for (auto it = _entNameSearchHash.begin(); it != _entNameSearchHash.end(); /*This space intentionally left blank*/ )
-		{
-			std::string_view name = it->first;
-			SceneContents::HashedEntity &hashedEnt = it->second;
-
-			ZoneNamedXNC(updateNameHashZone, "Update Name Hash", RandomUniqueColor(), true);
-			ZoneTextXVF(updateNameHashZone, "name:\"%s\"  ref:%d  age:%d", name.data(), &hashedEnt.entRef, hashedEnt.age);
-
-			if (hashedEnt.age >= EntityNameHashRemoveAge)
-			{
-				_entNameSearchHash.erase(it++);
-				continue;
-			}
 
-			++it;
-			hashedEnt.age++;
-		}
-
-		for (auto it = _entIDSearchHash.begin(); it != _entIDSearchHash.end(); /*This space intentionally left blank*/ )
-		{
-			UINT id = it->first;
-			SceneContents::HashedEntity &hashedEnt = it->second;
-
-			ZoneNamedXNC(updateIDHashZone, "Update ID Hash", RandomUniqueColor(), true);
-			ZoneTextXVF(updateIDHashZone, "ID:%d  ref:%d  age:%d", id, &hashedEnt.entRef, hashedEnt.age);
-
-			if (hashedEnt.age >= EntityIDHashRemoveAge)
-			{
-				_entIDSearchHash.erase(it++);
-				continue;
-			}
-
-			++it;
-			hashedEnt.age++;
+			// Only the entities between the old and new position moved.
+			ReindexEntities(std::min<UINT>(currentIndex, newIndex), std::min<UINT>(std::max<UINT>(currentIndex, newIndex), GetEntityCount() - 1));
 		}
+		_entityReorderQueue.clear();
 	}
 
 	{
 		ZoneNamedXNC(updateTreeInsertionZone, "Update Tree Insertion Queue", RandomUniqueColor(), true);
 
-		for (Ref<Entity> &entRef : _treeInsertionQueue)
-		{
-			ZoneNamedXNC(insertEntZone, "Insert Entity", RandomUniqueColor(), true);
-
-			Entity *entity;
-			if (!entRef.TryGet(entity))
-				continue;
-
-			dx::BoundingOrientedBox entityBounds;
-			entity->StoreEntityBounds(entityBounds);
-
-			_volumeTree.Insert(entity, entityBounds);
-		}
-		_treeInsertionQueue.clear();
+		// A queued bake moves static entities out of the volume tree, so they are not inserted first.
+		FlushTreeInsertionQueue(_staticTreeBakeQueued);
 	}
 
 	{
 		ZoneNamedXNC(updateEntRemovalZone, "Update Entity Removal Queue", RandomUniqueColor(), true);
 
-		for (Ref<Entity> &entRef : _entityRemovalQueue)
+		for (Handle<Entity> &entHandle : _entityRemovalQueue)
 		{
 			ZoneNamedXNC(removeEntZone, "Remove Entity", RandomUniqueColor(), true);
 
 			Entity *entity;
-			if (!entRef.TryGet(entity))
+			if (!entHandle.TryGet(entity))
 				continue;
 
-			if (!RemoveEntityImmediate(entity))
+			if (!DetachEntity(entity))
 			{
+				CompactEntities();
 				ErrMsg("Failed to flush removal of entity!");
 				return false;
 			}
 		}
 		_entityRemovalQueue.clear();
+
+		// Close the gaps of every removed entity in one pass.
+		CompactEntities();
+	}
+
+	if (_staticTreeBakeQueued)
+	{
+		if (!BakeStaticTree())
+		{
+			ErrMsg("Failed to bake static tree!");
+			return false;
+		}
 	}
 
 	_recalculateColliders = false;
@@ -252,12 +225,18 @@ Entity *SceneHolder::AddEntity(const BoundingOrientedBox &bounds, bool addToTree
 		_entityCounter = 0;
 
 	SceneContents::SceneEntity *newEntity = new SceneContents::SceneEntity(_entityCounter, bounds, addToTree);
+	newEntity->GetEntity()->SetSceneIndex(GetEntityCount());
 	_entities.emplace_back(newEntity);
+
+	if (_entityIndexByID.size() <= _entityCounter)
+		_entityIndexByID.resize(_entityCounter + 1, CONTENT_NULL);
+	_entityIndexByID[_entityCounter] = newEntity->GetEntity()->GetSceneIndex();
+
 	_entityCounter++;
 	_recalculateColliders = true;
 
 	if (addToTree)
-		_treeInsertionQueue.emplace_back(newEntity->GetEntity()->AsRef());
+		_treeInsertionQueue.emplace_back(newEntity->GetEntity()->AsHandle());
 
 	return _entities.back()->GetEntity();
 }
@@ -269,11 +248,19 @@ bool SceneHolder::RemoveEntityImmediate(Entity *entity)
 	if (entity == nullptr)
 		return false;
 
+	const bool result = DetachEntity(entity);
+	CompactEntities();
+	return result;
+}
+bool SceneHolder::DetachEntity(Entity *entity)
+{
+	ZoneScopedXC(RandomUniqueColor());
+
 	entity->MarkAsRemoved();
 
 	for (auto &child : *entity->GetChildren())
 	{
-		if (!RemoveEntityImmediate(child))
+		if (!DetachEntity(child))
 		{
 			ErrMsg("Failed to remove child entity!");
 			return false;
@@ -287,20 +274,59 @@ bool SceneHolder::RemoveEntityImmediate(Entity *entity)
 		return false;
 	}
 
-	for (int i = 0; i < _entities.size(); i++)
+	if (!_staticTree.Remove(entity))
 	{
-		Entity *ent = _entities[i]->GetEntity();
-		if ((ent == entity) || (ent->GetID() == entity->GetID()))
-		{
-			delete _entities[i];
-			_entities.erase(_entities.begin() + i);
-			_recalculateColliders = true;
-			break;
-		}
+		delete entity;
+		ErrMsg("Failed to remove entity from static tree!");
+		return false;
 	}
 
+	if (GetSceneEntity(entity) == nullptr)
+		return true;
+
+	const UINT index = entity->GetSceneIndex();
+
+	if (entity->IsTreeSyncQueued())
+		std::erase(_treeSyncQueue, entity);
+
+	if (entity->GetID() < _entityIndexByID.size())
+		_entityIndexByID[entity->GetID()] = CONTENT_NULL;
+
+	RemoveNameLookup(entity, entity->GetName());
+
+	// Unlink the slot before deleting, destructors may iterate or compact the scene.
+	SceneContents::SceneEntity *sceneEntity = _entities[index];
+	_entities[index] = nullptr;
+	_recalculateColliders = true;
+
+	delete sceneEntity;
 	return true;
 }
+void SceneHolder::CompactEntities()
+{
+	ZoneScopedXC(RandomUniqueColor());
+
+	const auto firstGap = std::find(_entities.begin(), _entities.end(), nullptr);
+	if (firstGap == _entities.end())
+		return;
+
+	const UINT firstIndex = static_cast<UINT>(std::distance(_entities.begin(), firstGap));
+	_entities.erase(std::remove(firstGap, _entities.end(), nullptr), _entities.end());
+
+	if (firstIndex < GetEntityCount())
+		ReindexEntities(firstIndex, GetEntityCount() - 1);
+}
+void SceneHolder::ReindexEntities(UINT first, UINT last)
+{
+	for (UINT i = first; i <= last; i++)
+	{
+		Entity *entity = _entities[i]->GetEntity();
+		entity->SetSceneIndex(i);
+
+		if (entity->GetID() < _entityIndexByID.size())
+			_entityIndexByID[entity->GetID()] = i;
+	}
+}
 
 bool SceneHolder::RemoveEntity(Entity *entity)
 {
@@ -315,8 +341,7 @@ bool SceneHolder::RemoveEntity(Entity *entity)
 	size_t currentQueueSize = _entityRemovalQueue.size();
 	for (size_t i = 0; i < currentQueueSize; i++)
 	{
-		Ref<Entity> &queuedEntityRef = _entityRemovalQueue[i];
-		Entity *queuedEnt = queuedEntityRef.Get();
+		Entity *queuedEnt = _entityRemovalQueue[i].Get();
 
 		if (entity == queuedEnt)
 			return true;
@@ -333,7 +358,7 @@ bool SceneHolder::RemoveEntity(Entity *entity)
 		}
 	}
 
-	_entityRemovalQueue.emplace_back(*entity);
+	_entityRemovalQueue.emplace_back(entity->AsHandle());
 	entity->MarkAsRemoved();
 	_recalculateColliders = true;
 	return true;
@@ -346,6 +371,9 @@ bool SceneHolder::RemoveEntity(const UINT index)
 		return false;
 	}
 
+	if (!_entities[index])
+		return true; // Already detached
+
 	_recalculateColliders = true;
 	return RemoveEntity(_entities[index]->GetEntity());
 }
@@ -377,6 +405,11 @@ bool SceneHolder::IncludeEntityInTree(UINT index)
 	}
 
 	SceneContents::SceneEntity *sceneEntity = _entities[index];
+	if (!sceneEntity)
+	{
+		ErrMsgF("Failed to include entity in tree, ID:{} is detached!", index);
+		return false;
+	}
 
 	if (sceneEntity->includeInTree)
 		return true; // Already included
@@ -418,6 +451,8 @@ bool SceneHolder::ExcludeEntityFromTree(UINT index)
 	}
 
 	SceneContents::SceneEntity *sceneEntity = _entities[index];
+	if (!sceneEntity)
+		return true; // Detached entities are already out of both trees
 
 	if (!sceneEntity->includeInTree)
 		return true; // Already excluded
@@ -437,6 +472,12 @@ bool SceneHolder::ExcludeEntityFromTree(UINT index)
 		return false;
 	}
 
+	if (!_staticTree.Remove(entity))
+	{
+		ErrMsg("Failed to remove entity from static tree!");
+		return false;
+	}
+
 	sceneEntity->includeInTree = false;
 
 	return true;
@@ -455,7 +496,7 @@ bool SceneHolder::IsEntityIncludedInTree(UINT index) const
 		return false;
 
 	SceneContents::SceneEntity *sceneEntity = _entities[index];
-	return sceneEntity->includeInTree;
+	return sceneEntity && sceneEntity->includeInTree;
 }
 
 bool SceneHolder::UpdateEntityPosition(Entity *entity)
@@ -474,21 +515,16 @@ bool SceneHolder::UpdateEntityPosition(Entity *entity)
 		}
 	}
 
-	UINT entityIndex = GetEntityIndex(entity);
-	if (entityIndex >= 0)
+	const SceneContents::SceneEntity *sceneEntity = GetSceneEntity(entity);
+	if (sceneEntity && sceneEntity->includeInTree)
 	{
-		if (_entities[entityIndex]->includeInTree)
-		{
-			dx::BoundingOrientedBox entityBounds;
-			entity->StoreEntityBounds(entityBounds);
+		dx::BoundingOrientedBox entityBounds;
+		entity->StoreEntityBounds(entityBounds);
 
-			if (!_volumeTree.Remove(entity))
-			{
-				ErrMsg("Failed to remove entity from volume tree!");
-				return false;
-			}
-
-			_volumeTree.Insert(entity, entityBounds);
+		if (!ApplyEntityMove(entity, entityBounds))
+		{
+			ErrMsg("Failed to apply entity move!");
+			return false;
 		}
 	}
 
@@ -496,160 +532,198 @@ bool SceneHolder::UpdateEntityPosition(Entity *entity)
 	return true;
 }
 
-const dx::BoundingBox &SceneHolder::GetBounds() const
+void SceneHolder::QueueTreeSync(Entity *entity)
 {
-	return _bounds;
+	if (!entity->MarkTreeSyncQueued())
+		return;
+
+	std::lock_guard<std::mutex> lock(_treeSyncQueueMutex);
+	_treeSyncQueue.emplace_back(entity);
 }
 
-Entity *SceneHolder::GetEntity(const UINT i) const
+bool SceneHolder::SyncTree()
 {
-	if (i < 0)
-		return nullptr;
+	ZoneScopedC(RandomUniqueColor());
 
-	if (i >= _entities.size())
-		return nullptr;
+	if (_treeSyncQueue.empty())
+		return true;
 
-	return _entities[i]->GetEntity();
-}
-Entity *SceneHolder::GetEntityByID(const UINT id)
-{
-	ZoneScopedXC(RandomUniqueColor());
+	struct SyncItem
+	{
+		Entity *entity;
+		UINT depth;
+		dx::BoundingOrientedBox bounds;
+	};
 
-	// Try to find in hash first
-	if (auto hashIter = _entIDSearchHash.find(id); hashIter != _entIDSearchHash.end())
+	std::vector<SyncItem> items;
+	items.reserve(_treeSyncQueue.size());
+
+	for (Entity *entity : _treeSyncQueue)
 	{
-		if (!hashIter->second.found)
-		{
-			// Hash says entity is not found
-			hashIter->second.age = 0;
-			return nullptr;
-		}
+		entity->ClearTreeSyncQueued();
 
-		Entity *ent = nullptr;
-		if (hashIter->second.entRef.TryGet(ent))
-			hashIter->second.age = 0;
+		if (entity->IsRemoved())
+			continue;
 
-		return ent;
+		UINT depth = 0;
+		for (const Entity *parent = entity->GetParent(); parent != nullptr; parent = parent->GetParent())
+			depth++;
+
+		items.push_back({ entity, depth, {} });
 	}
+	_treeSyncQueue.clear();
+
+	// World matrices are computed lazily from the parent's, so bounds are computed one hierarchy level at a time.
+	// A moved parent is queued along with its children, so every parent is resolved before the next level reads it.
+	{
+		ZoneNamedXNC(syncBoundsZone, "Compute Bounds", RandomUniqueColor(), true);
+
+		std::ranges::stable_sort(items, {}, &SyncItem::depth);
 
-	// Not found in hash, do a binary search
-	auto entIter = std::lower_bound(
-		_entities.begin(), _entities.end(), &id,
-		[](const void *entity, const void *id) {
-			return ((const SceneContents::SceneEntity *)entity)->entity->GetID() < *((const UINT *)id);
+		const int itemCount = static_cast<int>(items.size());
+		for (int levelStart = 0; levelStart < itemCount; )
+		{
+			int levelEnd = levelStart + 1;
+			while (levelEnd < itemCount && items[levelEnd].depth == items[levelStart].depth)
+				levelEnd++;
+
+			JobSystem::Instance().ParallelFor(static_cast<UINT>(levelEnd - levelStart), TreeSyncParallelMinEntities, [&](UINT begin, UINT end) {
+				for (int i = levelStart + static_cast<int>(begin); i < levelStart + static_cast<int>(end); i++)
+					items[i].entity->StoreEntityBounds(items[i].bounds);
+			}, "Compute Level Bounds");
+
+			levelStart = levelEnd;
 		}
-	);
+	}
 
-	Entity *ent = nullptr;
-	if (entIter != _entities.end() && (*entIter)->entity->GetID() == id)
-		Entity *ent = (*entIter)->entity;
+	// Queued insertions are placed with their bounds at the time the queue is flushed.
+	std::unordered_set<const Entity *> pendingInsertions;
+	for (Handle<Entity> &entHandle : _treeInsertionQueue)
+	{
+		Entity *entity;
+		if (entHandle.TryGet(entity))
+			pendingInsertions.emplace(entity);
+	}
 
-	// If not found in binary search, do a linear search as fallback
-	if (!ent)
 	{
-		const UINT entityCount = GetEntityCount();
-		for (UINT i = 0; i < entityCount; i++)
+		ZoneNamedXNC(syncTreeZone, "Apply Moves", RandomUniqueColor(), true);
+
+		for (const SyncItem &item : items)
 		{
-			Entity *entAtI = _entities[i]->GetEntity();
+			Entity *entity = item.entity;
 
-			if (!entAtI)
+			if (pendingInsertions.contains(entity))
 				continue;
 
-			if (entAtI->IsRemoved())
-				continue;
+			const SceneContents::SceneEntity *sceneEntity = GetSceneEntity(entity);
+			if (sceneEntity && sceneEntity->includeInTree)
+			{
+				if (!ApplyEntityMove(entity, item.bounds))
+				{
+					ErrMsgF("Failed to sync entity '{}' with the tree!", entity->GetName());
+					return false;
+				}
+			}
 
-			if (entAtI->GetID() != id)
-				continue;
-			
-			ent = entAtI;
-			break;
+			entity->GetTransform()->CleanScenePos();
 		}
 	}
 
-	// If found, add to hash to speed up future searches
-	if (ent)
+	return true;
+}
+
+bool SceneHolder::ApplyEntityMove(Entity *entity, const BoundingOrientedBox &entityBounds)
+{
+	if (_staticTree.Contains(entity))
 	{
-		if (_entIDSearchHash.size() < EntityIDHashMaxSize)
+		// Still within its baked node, only the culling bounds need updating.
+		if (_staticTree.FitsBakedBounds(entity, entityBounds))
 		{
-			_entIDSearchHash.emplace(id, ent);
-			auto &newHash = _entIDSearchHash[id];
-
-			newHash.entRef.AddDestructCallback([this, id](Ref<Entity> *entRef) {
-				// If this entity is destructed, mark the hash entry as not found
-				auto hashIter = _entIDSearchHash.find(id);
-				if (hashIter == _entIDSearchHash.end())
-					return;
-
-				hashIter->second.found = false;
-				hashIter->second.entRef = nullptr;
-			});
+			entity->UpdateCullingBounds();
+			return true;
 		}
 
-		return ent;
+		// Moved out of its baked bounds, it is dynamic from now on.
+		if (!_staticTree.Remove(entity))
+		{
+			ErrMsg("Failed to remove entity from static tree!");
+			return false;
+		}
+
+		_volumeTree.Insert(entity, entityBounds);
+		return true;
 	}
 
-	// Not found, add to hash to avoid future lookups
-	_entIDSearchHash.emplace(id, nullptr);
-	return nullptr;
+	if (!_volumeTree.Move(entity, entityBounds))
+	{
+		ErrMsg("Failed to move entity in volume tree!");
+		return false;
+	}
+
+	return true;
 }
-Entity *SceneHolder::GetEntityByName(const std::string &name)
+
+const dx::BoundingBox &SceneHolder::GetBounds() const
 {
-	ZoneScopedXC(RandomUniqueColor());
+	return _bounds;
+}
 
-	// Try to find in hash first
-	if (auto hashIter = _entNameSearchHash.find(name); hashIter != _entNameSearchHash.end())
-	{
-		if (!hashIter->second.found)
-		{
-			// Hash says entity is not found
-			hashIter->second.age = 0;
-			return nullptr;
-		}
+CellGraph *SceneHolder::GetCellGraph()
+{
+	return &_cellGraph;
+}
+const CellGraph *SceneHolder::GetCellGraph() const
+{
+	return &_cellGraph;
+}
 
-		Entity *ent = nullptr;
-		if (hashIter->second.entRef.TryGet(ent))
-			hashIter->second.age = 0;
+Entity *SceneHolder::GetEntity(const UINT i) const
+{
+	if (i < 0)
+		return nullptr;
 
-		return ent;
-	}
+	if (i >= _entities.size())
+		return nullptr;
 
-	// Not found in hash, search all entities for name
-	const UINT entityCount = GetEntityCount();
-	for (UINT i = 0; i < entityCount; i++)
-	{
-		Entity *ent = _entities[i]->GetEntity();
+	if (!_entities[i])
+		return nullptr;
 
-		if (!ent)
-			continue;
+	return _entities[i]->GetEntity();
+}
+Entity *SceneHolder::GetEntityByID(const UINT id)
+{
+	ZoneScopedXC(RandomUniqueColor());
+
+	const UINT index = GetEntityIndex(id);
+	if (index == CONTENT_NULL || !_entities[index])
+		return nullptr;
+
+	Entity *ent = _entities[index]->GetEntity();
+	if (ent->IsRemoved())
+		return nullptr;
+
+	return ent;
+}
+Entity *SceneHolder::GetEntityByName(const std::string &name)
+{
+	ZoneScopedXC(RandomUniqueColor());
 
+	auto lookupIt = _entityNameLookup.find(name);
+	if (lookupIt == _entityNameLookup.end())
+		return nullptr;
+
+	// Names are not unique, return the first match in scene order.
+	Entity *first = nullptr;
+	for (Entity *ent : lookupIt->second)
+	{
 		if (ent->IsRemoved())
 			continue;
 
-		if (ent->GetName() == name)
-		{
-			if (_entNameSearchHash.size() < EntityNameHashMaxSize)
-			{
-				_entNameSearchHash.emplace(name, ent);
-				auto &newHash = _entNameSearchHash[name];
-
-				newHash.entRef.AddDestructCallback([this, name](Ref<Entity> *entRef) {
-					// If this entity is destructed, mark the hash entry as not found
-					auto hashIter = _entNameSearchHash.find(name);
-					if (hashIter == _entNameSearchHash.end())
-						return;
-
-					hashIter->second.found = false;
-					hashIter->second.entRef = nullptr;
-				});
-			}
-
-			return ent;
-		}
+		if (!first || ent->GetSceneIndex() < first->GetSceneIndex())
+			first = ent;
 	}
 
-	// Not found, add to hash to avoid future lookups
-	_entNameSearchHash.emplace(name, nullptr);
-	return nullptr;
+	return first;
 }
 Entity *SceneHolder::GetEntityByDeserializedID(UINT id) const
 {
@@ -658,6 +732,9 @@ Entity *SceneHolder::GetEntityByDeserializedID(UINT id) const
 	const UINT entityCount = GetEntityCount();
 	for (UINT i = 0; i < entityCount; i++)
 	{
+		if (!_entities[i])
+			continue;
+
 		Entity *ent = _entities[i]->GetEntity();
 
 		if (!ent)
@@ -680,121 +757,73 @@ SceneContents::SceneIterator SceneHolder::GetEntities()
 	return it;
 }
 
-void SceneHolder::HashEntityName(Entity *ent)
+void SceneHolder::RenameEntity(Entity *ent, const std::string &oldName)
 {
 	ZoneScopedXC(RandomUniqueColor());
 
-	if (!ent)
+	if (!GetSceneEntity(ent))
 		return;
 
-	if (_entNameSearchHash.find(ent->GetName()) != _entNameSearchHash.end())
-		return;
-
-	if (_entNameSearchHash.size() < EntityNameHashMaxSize)
-		_entNameSearchHash.emplace(ent->GetName(), ent);
+	RemoveNameLookup(ent, oldName);
+	AddNameLookup(ent, ent->GetName());
 }
-void SceneHolder::RemoveNameFromHash(const std::string &name)
+void SceneHolder::AddNameLookup(Entity *ent, const std::string &name)
 {
-	ZoneScopedXC(RandomUniqueColor());
-
-	if (_entNameSearchHash.find(name) == _entNameSearchHash.end())
+	// Unnamed entities are never looked up, and every entity is unnamed until it is initialized.
+	if (name.empty())
 		return;
 
-	_entNameSearchHash.erase(name);
+	_entityNameLookup[name].emplace_back(ent);
 }
-void SceneHolder::RemoveNameFromHashIfNull(const std::string &name)
+void SceneHolder::RemoveNameLookup(Entity *ent, const std::string &name)
 {
-	ZoneScopedXC(RandomUniqueColor());
-
-	auto hashIter = _entNameSearchHash.find(name);
-	if (hashIter == _entNameSearchHash.end())
+	if (name.empty())
 		return;
 
-	if (hashIter->second.found)
+	auto lookupIt = _entityNameLookup.find(name);
+	if (lookupIt == _entityNameLookup.end())
 		return;
 
-	_entNameSearchHash.erase(hashIter);
-}
-void SceneHolder::ResetNameHash()
-{
-	ZoneScopedXC(RandomUniqueColor());
-
-	_entNameSearchHash.clear();
-}
-
-void SceneHolder::HashEntityID(Entity *ent)
-{
-	ZoneScopedXC(RandomUniqueColor());
-
-	if (!ent)
-		return;
-
-	for (UINT i = 0; i < (UINT)(_entIDSearchHash.size()); i++)
+	std::vector<Entity *> &named = lookupIt->second;
+	auto it = std::find(named.begin(), named.end(), ent);
+	if (it != named.end())
 	{
-		if (_entIDSearchHash[i].entRef == ent)
-			return;
+		*it = named.back();
+		named.pop_back();
 	}
 
-	if (_entIDSearchHash.size() < EntityIDHashMaxSize)
-		_entIDSearchHash.emplace(ent->GetID(), ent);
+	if (named.empty())
+		_entityNameLookup.erase(lookupIt);
 }
-void SceneHolder::RemoveIDFromHash(UINT id)
-{
-	ZoneScopedXC(RandomUniqueColor());
-
-	if (_entIDSearchHash.find(id) == _entIDSearchHash.end())
-		return;
 
-	_entIDSearchHash.erase(id);
-}
-void SceneHolder::RemoveIDFromHashIfNull(UINT id)
+SceneContents::SceneEntity *SceneHolder::GetSceneEntity(const Entity *entity) const
 {
-	ZoneScopedXC(RandomUniqueColor());
-
-	auto hashIter = _entIDSearchHash.find(id);
-	if (hashIter == _entIDSearchHash.end())
-		return;
+	if (!entity)
+		return nullptr;
 
-	if (hashIter->second.found)
-		return;
+	const UINT index = entity->GetSceneIndex();
+	if (index >= _entities.size())
+		return nullptr;
 
-	_entIDSearchHash.erase(hashIter);
-}
-void SceneHolder::ResetIDHash()
-{
-	ZoneScopedXC(RandomUniqueColor());
+	SceneContents::SceneEntity *sceneEntity = _entities[index];
+	if (!sceneEntity || sceneEntity->GetEntity() != entity)
+		return nullptr;
 
-	_entIDSearchHash.clear();
+	return sceneEntity;
 }
-
 UINT SceneHolder::GetEntityIndex(const Entity *entity) const
 {
-	ZoneScopedXC(RandomUniqueColor());
-
-	if (!entity)
+	if (!GetSceneEntity(entity))
 		return -1;
 
-	const UINT entityCount = GetEntityCount();
-	for (UINT i = 0; i < entityCount; i++)
-	{
-		if (entity == _entities[i]->GetEntity())
-			return i;
-	}
-
-	return -1;
+	return entity->GetSceneIndex();
 }
 UINT SceneHolder::GetEntityIndex(UINT id) const
 {
-	ZoneScopedXC(RandomUniqueColor());
-
-	const UINT entityCount = GetEntityCount();
-	for (UINT i = 0; i < entityCount; i++)
-	{
-		if (id == _entities[i]->GetEntity()->GetID())
-			return i;
-	}
+	if (id >= _entityIndexByID.size())
+		return -1;
 
-	return -1;
+	return _entityIndexByID[id];
 }
 UINT SceneHolder::GetEntityCount() const
 {
@@ -808,7 +837,7 @@ void SceneHolder::ReorderEntity(Entity *entity, UINT newIndex)
 	if (!entity)
 		return;
 
-	_entityReorderQueue.emplace_back(*entity, newIndex);
+	_entityReorderQueue.emplace_back(entity->AsHandle(), newIndex);
 }
 void SceneHolder::ReorderEntity(Entity *entity, const Entity *after)
 {
@@ -837,22 +866,28 @@ void SceneHolder::ReorderEntity(Entity *entity, const Entity *after)
 	if (currIndex > newIndex)
 		newIndex++;
 
-	_entityReorderQueue.emplace_back(*entity, newIndex);
+	_entityReorderQueue.emplace_back(entity->AsHandle(), newIndex);
 }
 
-bool SceneHolder::FrustumCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems) const
+bool SceneHolder::FrustumCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems, const FrustumCullOptions &options) const
 {
 	ZoneScopedC(RandomUniqueColor());
 
 	std::vector<Entity *> containingInterfaces;
 	containingInterfaces.reserve(_entities.capacity());
 
-	if (!_volumeTree.FrustumCull(frustum, containingInterfaces))
+	if (!_volumeTree.FrustumCull(frustum, containingInterfaces, options))
 	{
 		ErrMsg("Failed to frustum cull volume tree!");
 		return false;
 	}
 
+	if (!_staticTree.FrustumCull(frustum, containingInterfaces))
+	{
+		ErrMsg("Failed to frustum cull static tree!");
+		return false;
+	}
+
 	for (Entity *iEnt : containingInterfaces)
 		containingItems.emplace_back(iEnt);
 
@@ -871,6 +906,12 @@ bool SceneHolder::BoxCull(const dx::BoundingOrientedBox &box, std::vector<Entity
 		return false;
 	}
 
+	if (!_staticTree.BoxCull(box, containingInterfaces))
+	{
+		ErrMsg("Failed to box cull static tree!");
+		return false;
+	}
+
 	for (Entity *iEnt : containingInterfaces)
 		containingItems.emplace_back(iEnt);
 
@@ -889,32 +930,257 @@ bool SceneHolder::BoxCull(const dx::BoundingBox &box, std::vector<Entity *> &con
 		return false;
 	}
 
+	if (!_staticTree.BoxCull(box, containingInterfaces))
+	{
+		ErrMsg("Failed to box cull static tree!");
+		return false;
+	}
+
 	for (Entity *iEnt : containingInterfaces)
 		containingItems.emplace_back(iEnt);
 
 	return true;
 }
+bool SceneHolder::SphereCull(const dx::XMFLOAT3 &center, float radius, std::vector<Entity *> &containingItems) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	const dx::BoundingSphere sphere(center, radius);
+
+	std::vector<Entity *> containingInterfaces;
+
+	if (!_volumeTree.SphereCull(sphere, containingInterfaces))
+	{
+		ErrMsg("Failed to sphere cull volume tree!");
+		return false;
+	}
+
+	if (!_staticTree.SphereCull(sphere, containingInterfaces))
+	{
+		ErrMsg("Failed to sphere cull static tree!");
+		return false;
+	}
+
+	// Tree nodes are coarser than the sphere, keep only entities that actually overlap it.
+	for (Entity *iEnt : containingInterfaces)
+	{
+		if (sphere.Intersects(iEnt->GetLastCullingBounds()))
+			containingItems.emplace_back(iEnt);
+	}
+
+	return true;
+}
+bool SceneHolder::FindNearest(const dx::XMFLOAT3 &point, UINT count, const NearestQuery::Filter &filter,
+	std::vector<Entity *> &nearest, float maxDistance) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	// Both trees share one query, so the static tree only searches closer than the dynamic results.
+	NearestQuery query(point, count, filter, maxDistance);
+
+	if (!_volumeTree.FindNearest(query))
+	{
+		ErrMsg("Failed to search volume tree!");
+		return false;
+	}
+
+	if (!_staticTree.FindNearest(query))
+	{
+		ErrMsg("Failed to search static tree!");
+		return false;
+	}
+
+	query.GetResults(nearest);
+	return true;
+}
+bool SceneHolder::PortalCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems, const FrustumCullOptions &options) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	std::vector<CellGraph::CellView> visibleCells;
+	if (!_cellGraph.IsEnabled() || !_cellGraph.GetVisibleCells(frustum, visibleCells))
+		return FrustumCull(frustum, containingItems, options);
+
+	const size_t firstItem = containingItems.size();
+
+	std::vector<Entity *> containingInterfaces;
+	containingInterfaces.reserve(_entities.capacity());
+
+	for (const CellGraph::CellView &view : visibleCells)
+	{
+		containingInterfaces.clear();
+
+		const dx::BoundingBox &cellBounds = _cellGraph.GetCell(view.cell).bounds;
+
+		if (!_volumeTree.BoxCull(cellBounds, containingInterfaces) ||
+			!_staticTree.BoxCull(cellBounds, containingInterfaces))
+		{
+			ErrMsg("Failed to box cull cell!");
+			return false;
+		}
+
+		for (Entity *iEnt : containingInterfaces)
+		{
+			if (view.Intersects(iEnt->GetLastCullingBounds()))
+				containingItems.emplace_back(iEnt);
+		}
+	}
+
+	// Cells seen through several portals, or entities overlapping several cells, produce duplicates.
+	std::sort(containingItems.begin() + firstItem, containingItems.end());
+	containingItems.erase(std::unique(containingItems.begin() + firstItem, containingItems.end()), containingItems.end());
+
+	return true;
+}
+bool SceneHolder::MultiCull(const std::vector<CullView> &views, std::vector<std::vector<Entity *>> &containingItems) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	const UINT viewCount = static_cast<UINT>(views.size());
+	containingItems.resize(viewCount);
+
+	// Each traversal can track a limited number of views, split larger requests into batches.
+	for (UINT batchStart = 0; batchStart < viewCount; batchStart += CullView::MAX_BATCH_SIZE)
+	{
+		const UINT batchSize = std::min<UINT>(viewCount - batchStart, CullView::MAX_BATCH_SIZE);
+
+		if (!_volumeTree.MultiCull(&views[batchStart], batchSize, &containingItems[batchStart]))
+		{
+			ErrMsg("Failed to multi-cull volume tree!");
+			return false;
+		}
+
+		if (!_staticTree.MultiCull(&views[batchStart], batchSize, &containingItems[batchStart]))
+		{
+			ErrMsg("Failed to multi-cull static tree!");
+			return false;
+		}
+	}
+
+	return true;
+}
 bool SceneHolder::RaycastScene(const dx::XMFLOAT3A &origin, const dx::XMFLOAT3A &direction, RaycastOut &result, bool cheap) const
 {
 	ZoneScopedC(RandomUniqueColor());
 
-	return _volumeTree.RaycastTree(origin, direction, result.distance, result.entity, cheap);
+	if (!_volumeTree.RaycastTree(origin, direction, result.distance, result.entity, cheap))
+	{
+		result.distance = FLT_MAX;
+		result.entity = nullptr;
+	}
+
+	// The static tree only overwrites the result with closer hits.
+	(void)_staticTree.RaycastTree(origin, direction, result.distance, result.entity, cheap);
+	return result.entity != nullptr;
 }
 
 bool SceneHolder::RaycastScene(const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent) const
 {
 	ZoneScopedC(RandomUniqueColor());
 
-	return _volumeTree.RaycastTree(ray, hit, ent);
+	if (!_volumeTree.RaycastTree(ray, hit, ent))
+	{
+		hit.length = ray.length > 0.0f ? ray.length : FLT_MAX;
+		ent = nullptr;
+	}
+
+	(void)_staticTree.RaycastTree(ray, hit, ent);
+	return ent != nullptr;
+}
+
+UINT SceneHolder::RaycastScene(const std::vector<Shape::Ray> &rays, std::vector<Shape::RayHit> &hits, std::vector<Entity *> &ents) const
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	const UINT rayCount = static_cast<UINT>(rays.size());
+	hits.assign(rayCount, Shape::RayHit());
+	ents.assign(rayCount, nullptr);
+
+	// Rays in the same direction octant visit tree nodes in a similar order, so they make coherent packets.
+	std::vector<UINT> order(rayCount);
+	for (UINT i = 0; i < rayCount; i++)
+		order[i] = i;
+
+	std::stable_sort(order.begin(), order.end(), [&rays](UINT a, UINT b) {
+		return RayPacket::GetOctant(rays[a]) < RayPacket::GetOctant(rays[b]);
+	});
+
+	UINT hitCount = 0;
+	UINT first = 0;
+	while (first < rayCount)
+	{
+		const UINT octant = RayPacket::GetOctant(rays[order[first]]);
+
+		Shape::Ray packetRays[RAY_PACKET_SIZE];
+		UINT count = 0;
+		while (count < RAY_PACKET_SIZE && first + count < rayCount && RayPacket::GetOctant(rays[order[first + count]]) == octant)
+		{
+			packetRays[count] = rays[order[first + count]];
+			count++;
+		}
+
+		Shape::RayHit packetHits[RAY_PACKET_SIZE];
+		Entity *packetEnts[RAY_PACKET_SIZE] = { };
+
+		if (count < RAY_PACKET_MIN_LANES)
+		{
+			for (UINT lane = 0; lane < count; lane++)
+				(void)RaycastScene(packetRays[lane], packetHits[lane], packetEnts[lane]);
+		}
+		else
+		{
+			for (UINT lane = 0; lane < RAY_PACKET_SIZE; lane++)
+				packetHits[lane].length = (lane < count && packetRays[lane].length > 0.0f) ? packetRays[lane].length : FLT_MAX;
+
+			const RayPacket packet(packetRays, count);
+
+#if defined QUADTREE_CULLING
+			(void)_volumeTree.RaycastTree(packet, packetHits, packetEnts);
+#else
+			// Only the quadtree supports packets, trace the dynamic tree one ray at a time.
+			for (UINT lane = 0; lane < count; lane++)
+			{
+				Shape::RayHit treeHit;
+				Entity *treeEnt = nullptr;
+				if (!_volumeTree.RaycastTree(packetRays[lane], treeHit, treeEnt))
+					continue;
+
+				if (treeHit.length >= packetHits[lane].length)
+					continue;
+
+				packetHits[lane] = treeHit;
+				packetEnts[lane] = treeEnt;
+			}
+#endif
+
+			(void)_staticTree.RaycastTree(packet, packetHits, packetEnts);
+		}
+
+		for (UINT lane = 0; lane < count; lane++)
+		{
+			const UINT index = order[first + lane];
+			hits[index] = packetHits[lane];
+			ents[index] = packetEnts[lane];
+
+			if (packetEnts[lane])
+				hitCount++;
+		}
+
+		first += count;
+	}
+
+	return hitCount;
 }
 
 void SceneHolder::DebugGetTreeStructure(std::vector<dx::BoundingBox> &boxCollection, bool full, bool culling) const
 {
 	_volumeTree.DebugGetStructure(boxCollection, full, culling);
+	_staticTree.DebugGetStructure(boxCollection, full, culling);
 }
 void SceneHolder::DebugGetTreeStructure(std::vector<dx::BoundingBox> &boxCollection, const dx::BoundingFrustum &frustum, bool full, bool culling) const
 {
 	_volumeTree.DebugGetStructure(boxCollection, frustum, full, culling);
+	_staticTree.DebugGetStructure(boxCollection, frustum, full, culling);
 }
 
 void SceneHolder::ResetSceneHolder()
@@ -930,14 +1196,22 @@ void SceneHolder::ResetSceneHolder()
 	_entities = {};
 	_recalculateColliders = false;
 
-#ifdef QUADTREE_CULLING
+#if defined QUADTREE_CULLING || defined LINEAR_QUADTREE_CULLING || defined AABB_TREE_CULLING
 	_volumeTree = {};
 #elif defined OCTREE_CULLING
 	Octree _volumeTree;
 #endif
 
+	_staticTree = {};
+	_staticTreeBakeQueued = false;
+
+	_cellGraph.Clear();
+
 	_treeInsertionQueue = {};
 	_entityRemovalQueue = {};
+	_treeSyncQueue = {};
+	_entityIndexByID = {};
+	_entityNameLookup = {};
 }
 
 void SceneHolder::SetRecalculateColliders()
@@ -956,55 +1230,145 @@ void SceneHolder::RecalculateTreeCullingBounds()
 	_volumeTree.RecalculateCullingBounds();
 }
 
-#ifdef USE_IMGUI
-bool SceneHolder::RenderUI()
+void SceneHolder::QueueStaticTreeBake()
 {
-	// TODO: Set bounds
+	_staticTreeBakeQueued = true;
+}
+bool SceneHolder::BakeStaticTree()
+{
+	ZoneScopedC(RandomUniqueColor());
 
-	ImGui::Separator();
+	_staticTreeBakeQueued = false;
 
-	ImGui::Text("Scene Entities: %d", GetEntityCount());
+	// Entities still waiting for insertion would otherwise end up in the volume tree after baking.
+	// Static ones are found through _entities below and go straight into the static tree.
+	FlushTreeInsertionQueue(true);
 
-	ImGuiChildFlags hashChildFlags = ImGuiChildFlags_None;
-	hashChildFlags |= ImGuiChildFlags_Borders;
-	hashChildFlags |= ImGuiChildFlags_ResizeY;
+	std::vector<Entity *> staticEntities;
+	staticEntities.reserve(_entities.size());
 
-	ImGuiWindowFlags hashWindowFlags = ImGuiWindowFlags_None;
-	
-	ImGui::Text("Name Hash Size: %d / %d", _entNameSearchHash.size(), EntityNameHashMaxSize);
-	if (ImGui::TreeNode("Hashed Names"))
+	for (SceneContents::SceneEntity *sceneEntity : _entities)
 	{
-		ImGui::BeginChild("NameHashChild", { ImGui::GetContentRegionAvail().x, 100 }, hashChildFlags, hashWindowFlags );
-		for (auto it = _entNameSearchHash.begin(); it != _entNameSearchHash.end(); it++)
-		{
-			std::string_view name = it->first;
-			SceneContents::HashedEntity &hashedEnt = it->second;
+		if (!sceneEntity)
+			continue;
+
+		Entity *entity = sceneEntity->GetEntity();
+
+		if (!sceneEntity->includeInTree)
+			continue;
+
+		if (entity->IsRemoved())
+			continue;
 
-			if (ImGui::Button(std::format("\"{}\": {} (age:{})", name.data(), hashedEnt.found ? "Found" : "Not Found", hashedEnt.age).c_str()))
+		if (!entity->IsStatic())
+		{
+			// Previously baked entities that are no longer static move back to the volume tree.
+			if (_staticTree.Contains(entity))
 			{
-				if (Entity *ent = hashedEnt.entRef.Get())
-				{
-					Scene *scene = ent->GetScene();
-					scene->SetSelection(ent, ImGui::GetIO().KeyShift);
-				}
+				dx::BoundingOrientedBox entityBounds;
+				entity->StoreEntityBounds(entityBounds);
+
+				_volumeTree.Insert(entity, entityBounds);
 			}
+			continue;
 		}
-		ImGui::EndChild();
-		ImGui::TreePop();
+
+		if (!_volumeTree.Remove(entity))
+		{
+			ErrMsgF("Failed to remove static entity '{}' from volume tree!", entity->GetName());
+			return false;
+		}
+
+		staticEntities.emplace_back(entity);
 	}
 
-	ImGui::Text("ID Hash Size: %d / %d", _entIDSearchHash.size(), EntityIDHashMaxSize);
-	if (ImGui::TreeNode("Hashed IDs"))
+	if (!_staticTree.Build(staticEntities))
 	{
-		ImGui::BeginChild("IDHashChild", { ImGui::GetContentRegionAvail().x, 100 }, hashChildFlags, hashWindowFlags);
-		for (auto it = _entIDSearchHash.begin(); it != _entIDSearchHash.end(); it++)
+		ErrMsg("Failed to build static tree!");
+		return false;
+	}
+
+	return true;
+}
+
+void SceneHolder::FlushTreeInsertionQueue(bool skipStatic)
+{
+	ZoneScopedC(RandomUniqueColor());
+
+#ifdef QUADTREE_CULLING
+	// After a scene is loaded or reset, every entity arrives at once. Building the tree top-down
+	// avoids repeatedly splitting leaves and redistributing their items as it fills up.
+	if (_treeInsertionQueue.size() >= TreeBulkBuildMinEntities && _volumeTree.IsEmpty())
+	{
+		std::vector<Quadtree::BuildItem> buildItems;
+		buildItems.reserve(_treeInsertionQueue.size());
+
+		for (Handle<Entity> &entHandle : _treeInsertionQueue)
 		{
-			UINT id = it->first;
-			SceneContents::HashedEntity &hashedEnt = it->second;
+			Entity *entity;
+			if (!entHandle.TryGet(entity))
+				continue;
+
+			if (skipStatic && entity->IsStatic())
+				continue;
+
+			Quadtree::BuildItem &item = buildItems.emplace_back();
+			item.entity = entity;
+			entity->StoreEntityBounds(item.bounds);
+		}
+		_treeInsertionQueue.clear();
+
+		_volumeTree.Build(buildItems);
+		return;
+	}
+#endif
+
+	for (Handle<Entity> &entHandle : _treeInsertionQueue)
+	{
+		ZoneNamedXNC(insertEntZone, "Insert Entity", RandomUniqueColor(), true);
+
+		Entity *entity;
+		if (!entHandle.TryGet(entity))
+			continue;
+
+		if (skipStatic && entity->IsStatic())
+			continue;
+
+		dx::BoundingOrientedBox entityBounds;
+		entity->StoreEntityBounds(entityBounds);
 
-			if (ImGui::Button(std::format("{}: {} (age:{})", id, hashedEnt.found ? "Found" : "Not Found", hashedEnt.age).c_str()))
+		_volumeTree.Insert(entity, entityBounds);
+	}
+	_treeInsertionQueue.clear();
+}
+
+#ifdef USE_IMGUI
+bool SceneHolder::RenderUI()
+{
+	// TODO: Set bounds
+
+	ImGui::Separator();
+
+	ImGui::Text("Scene Entities: %d", GetEntityCount());
+
+	ImGuiChildFlags lookupChildFlags = ImGuiChildFlags_None;
+	lookupChildFlags |= ImGuiChildFlags_Borders;
+	lookupChildFlags |= ImGuiChildFlags_ResizeY;
+
+	ImGuiWindowFlags lookupWindowFlags = ImGuiWindowFlags_None;
+	
+	ImGui::Text("Unique Names: %d", _entityNameLookup.size());
+	if (ImGui::TreeNode("Named Entities"))
+	{
+		ImGui::BeginChild("NameLookupChild", { ImGui::GetContentRegionAvail().x, 100 }, lookupChildFlags, lookupWindowFlags);
+		for (auto it = _entityNameLookup.begin(); it != _entityNameLookup.end(); it++)
+		{
+			std::string_view name = it->first;
+			const std::vector<Entity *> &named = it->second;
+
+			if (ImGui::Button(std::format("\"{}\": {}", name.data(), named.size()).c_str()))
 			{
-				if (Entity *ent = hashedEnt.entRef.Get())
+				if (Entity *ent = GetEntityByName(it->first))
 				{
 					Scene *scene = ent->GetScene();
 					scene->SetSelection(ent, ImGui::GetIO().KeyShift);
@@ -1023,6 +1387,23 @@ bool SceneHolder::RenderUI()
 		return false;
 	}
 
+	ImGui::Separator();
+
+	if (ImGui::TreeNode("Static Tree"))
+	{
+		if (ImGui::Button("Rebake"))
+			QueueStaticTreeBake();
+
+		if (!_staticTree.RenderUI())
+		{
+			ImGui::TreePop();
+			ErrMsg("Failed to render static tree UI!");
+			return false;
+		}
+
+		ImGui::TreePop();
+	}
+
 	return true;
 }
 #endif
@@ -1,14 +1,23 @@
 #pragma once
 
+#include <unordered_map>
 #include "Entity.h"
 #include "Collision/Raycast.h"
 #include "Debug/DebugNew.h"
+#include "Rendering/Culling/CellGraph.h"
+#include "Rendering/Culling/StaticBVH.h"
 
 #define QUADTREE_CULLING
+//#define LINEAR_QUADTREE_CULLING
+//#define AABB_TREE_CULLING
 //#define OCTREE_CULLING
 
 #ifdef QUADTREE_CULLING
 #include "Rendering/Culling/Quadtree.h"
+#elif defined LINEAR_QUADTREE_CULLING
+#include "Rendering/Culling/LinearQuadtree.h"
+#elif defined AABB_TREE_CULLING
+#include "Rendering/Culling/AABBTree.h"
 #elif defined OCTREE_CULLING
 #include "Rendering/Culling/Octree.h"
 #endif
@@ -17,19 +26,6 @@ namespace SceneContents
 {
 	struct SceneEntity;
 
-	struct HashedEntity
-	{
-		Ref<Entity> entRef = nullptr;
-		UINT age = 0;
-		bool found = false;
-
-		HashedEntity() = default;
-		HashedEntity(Entity *ent) : found(ent != nullptr), age(0)
-		{
-			entRef.Set(ent);
-		}
-	};
-
 	class SceneIterator
 	{
 	private:
@@ -98,21 +94,62 @@ private:
 	UINT _entityCounter = 0;
 
 	dx::BoundingBox _bounds;
-	std::vector<SceneContents::SceneEntity *> _entities; 
 	bool _recalculateColliders = false;
 
+	// Dense list of entities in scene order. Every entity stores its own index in it.
+	std::vector<SceneContents::SceneEntity *> _entities; 
+
+	// Sparse map from entity ID to index in _entities, CONTENT_NULL where no entity has the ID.
+	std::vector<UINT> _entityIndexByID;
+
+	// Named entities grouped by name, in no particular order.
+	std::unordered_map<std::string, std::vector<Entity *>> _entityNameLookup;
+
 #ifdef QUADTREE_CULLING
 	Quadtree _volumeTree;
+#elif defined LINEAR_QUADTREE_CULLING
+	LinearQuadtree _volumeTree;
+#elif defined AABB_TREE_CULLING
+	AABBTree _volumeTree;
 #elif defined OCTREE_CULLING
 	Octree _volumeTree;
 #endif
 
-	std::vector<Ref<Entity>> _treeInsertionQueue;
-	std::vector<Ref<Entity>> _entityRemovalQueue;
-	std::vector<std::pair<Ref<Entity>, UINT>> _entityReorderQueue;
+	// Static entities are moved out of _volumeTree into a read-only tree when it is baked.
+	StaticBVH _staticTree;
+	bool _staticTreeBakeQueued = false;
+
+	CellGraph _cellGraph;
+
+	// Queued entities are held by handle, so queueing and flushing cost no reference bookkeeping.
+	std::vector<Handle<Entity>> _treeInsertionQueue;
+	std::vector<Handle<Entity>> _entityRemovalQueue;
+	std::vector<std::pair<Handle<Entity>, UINT>> _entityReorderQueue;
+
+	// Entities whose transform or bounds changed since the last tree sync, each listed once.
+	std::vector<Entity *> _treeSyncQueue;
+	std::mutex _treeSyncQueueMutex;
+
+	// Inserts the queued entities into the volume tree, or builds it from them all at once if it is empty.
+	void FlushTreeInsertionQueue(bool skipStatic);
 
-	std::map<const UINT, SceneContents::HashedEntity> _entIDSearchHash;
-	std::map<const std::string, SceneContents::HashedEntity> _entNameSearchHash;
+	// Moves an entity already placed in a tree to match its new bounds.
+	[[nodiscard]] bool ApplyEntityMove(Entity *entity, const dx::BoundingOrientedBox &entityBounds);
+
+	// Null if the entity is not stored in this holder.
+	[[nodiscard]] SceneContents::SceneEntity *GetSceneEntity(const Entity *entity) const;
+
+	// Removes an entity and its children from the trees and lookups and deletes them, leaving null slots behind.
+	[[nodiscard]] bool DetachEntity(Entity *entity);
+
+	// Closes the slots left by DetachEntity and updates the stored indices of the entities after them.
+	void CompactEntities();
+
+	// Updates the stored indices of the entities in [first, last].
+	void ReindexEntities(UINT first, UINT last);
+
+	void AddNameLookup(Entity *ent, const std::string &name);
+	void RemoveNameLookup(Entity *ent, const std::string &name);
 
 public:
 	enum BoundsType {
@@ -148,25 +185,28 @@ public:
 	[[nodiscard]] bool IsEntityIncludedInTree(const Entity *entity) const;
 	[[nodiscard]] bool IsEntityIncludedInTree(UINT index) const;
 
+	// Updates the tree placement of an entity and its children immediately. Prefer letting SyncTree() handle it.
 	[[nodiscard]] bool UpdateEntityPosition(Entity *entity);
 
+	// Queues an entity for the next tree sync. Safe to call from parallel updates.
+	void QueueTreeSync(Entity *entity);
+
+	// Updates the tree placement of every entity queued since the last sync in one pass.
+	[[nodiscard]] bool SyncTree();
+
 	[[nodiscard]] const dx::BoundingBox &GetBounds() const;
 
+	[[nodiscard]] CellGraph *GetCellGraph();
+	[[nodiscard]] const CellGraph *GetCellGraph() const;
+
 	[[nodiscard]] Entity *GetEntity(UINT i) const;
 	[[nodiscard]] Entity *GetEntityByID(UINT id);
 	[[nodiscard]] Entity *GetEntityByName(const std::string &name);
 	[[nodiscard]] Entity *GetEntityByDeserializedID(UINT id) const;
 	[[nodiscard]] SceneContents::SceneIterator GetEntities();
 
-	void HashEntityName(Entity *ent);
-	void RemoveNameFromHash(const std::string &name);
-	void RemoveNameFromHashIfNull(const std::string &name);
-	void ResetNameHash();
-
-	void HashEntityID(Entity *ent);
-	void RemoveIDFromHash(UINT id);
-	void RemoveIDFromHashIfNull(UINT id);
-	void ResetIDHash();
+	// Moves an entity in the name lookup, called by the entity after its name changes.
+	void RenameEntity(Entity *ent, const std::string &oldName);
 
 	[[nodiscard]] UINT GetEntityIndex(const Entity *entity) const;
 	[[nodiscard]] UINT GetEntityIndex(UINT id) const;
@@ -175,13 +215,32 @@ public:
 	void ReorderEntity(Entity *entity, UINT newIndex);
 	void ReorderEntity(Entity *entity, const Entity *after);
 
-	[[nodiscard]] bool FrustumCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems) const;
+	[[nodiscard]] bool FrustumCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems, const FrustumCullOptions &options = {}) const;
 	[[nodiscard]] bool BoxCull(const dx::BoundingOrientedBox &box, std::vector<Entity *> &containingItems) const;
 	[[nodiscard]] bool BoxCull(const dx::BoundingBox &box, std::vector<Entity *> &containingItems) const;
 
+	// Entities whose culling bounds intersect the sphere.
+	[[nodiscard]] bool SphereCull(const dx::XMFLOAT3 &center, float radius, std::vector<Entity *> &containingItems) const;
+
+	// Appends up to count enabled entities closest to the point, nearest first. Distances are measured to the
+	// culling bounds of each entity. Entities rejected by filter are skipped, an empty filter accepts all.
+	[[nodiscard]] bool FindNearest(const dx::XMFLOAT3 &point, UINT count, const NearestQuery::Filter &filter,
+		std::vector<Entity *> &nearest, float maxDistance = FLT_MAX) const;
+
+	// Culls only the cells visible through portals from the frustum origin. Falls back to a
+	// regular frustum cull if room culling is disabled or the origin is outside every cell.
+	[[nodiscard]] bool PortalCull(const dx::BoundingFrustum &frustum, std::vector<Entity *> &containingItems, const FrustumCullOptions &options = {}) const;
+
+	// Culls all views with as few tree traversals as possible. containingItems receives one list per view.
+	[[nodiscard]] bool MultiCull(const std::vector<CullView> &views, std::vector<std::vector<Entity *>> &containingItems) const;
+
 	bool RaycastScene(const dx::XMFLOAT3A &origin, const dx::XMFLOAT3A &direction, RaycastOut &result, bool cheap = true) const;
 	bool RaycastScene(const Shape::Ray &ray, Shape::RayHit &hit, Entity *&ent) const;
 
+	// Traces many rays at once, grouped into SIMD packets of rays pointing the same way. hits and
+	// ents are resized to match rays, ents[i] is null where rays[i] hit nothing. Returns the hit count.
+	UINT RaycastScene(const std::vector<Shape::Ray> &rays, std::vector<Shape::RayHit> &hits, std::vector<Entity *> &ents) const;
+
 	void DebugGetTreeStructure(std::vector<dx::BoundingBox> &boxCollection, bool full = false, bool culling = false) const;
 	void DebugGetTreeStructure(std::vector<dx::BoundingBox> &boxCollection, const dx::BoundingFrustum &frustum, bool full = false, bool culling = false) const;
 
@@ -192,6 +251,10 @@ public:
 
 	void RecalculateTreeCullingBounds();
 
+	// Rebuilds the static tree from every static entity in the volume tree during the next Update.
+	void QueueStaticTreeBake();
+	[[nodiscard]] bool BakeStaticTree();
+
 #ifdef USE_IMGUI
 	[[nodiscard]] bool RenderUI();
 #endif
@@ -102,6 +102,37 @@ bool Scene::Serialize(bool asSaveFile)
 			}
 			sceneSettingsObj.AddMember("Bounds", sceneBoundsObj, docAlloc);
 
+			const CellGraph *cellGraph = _sceneHolder.GetCellGraph();
+			if (cellGraph->GetCellCount() > 0)
+			{
+				json::Value sceneCellsArr(json::kArrayType);
+				for (UINT i = 0; i < cellGraph->GetCellCount(); i++)
+				{
+					const CellGraph::Cell &cell = cellGraph->GetCell(i);
+
+					json::Value cellObj(json::kObjectType);
+					cellObj.AddMember("Name", SerializerUtils::SerializeString(cell.name, docAlloc), docAlloc);
+					cellObj.AddMember("Center", SerializerUtils::SerializeVec(cell.bounds.Center, docAlloc), docAlloc);
+					cellObj.AddMember("Extents", SerializerUtils::SerializeVec(cell.bounds.Extents, docAlloc), docAlloc);
+					sceneCellsArr.PushBack(cellObj, docAlloc);
+				}
+				sceneSettingsObj.AddMember("Cells", sceneCellsArr, docAlloc);
+
+				json::Value scenePortalsArr(json::kArrayType);
+				for (UINT i = 0; i < cellGraph->GetPortalCount(); i++)
+				{
+					const CellGraph::Portal &portal = cellGraph->GetPortal(i);
+
+					json::Value portalObj(json::kObjectType);
+					portalObj.AddMember("Center", SerializerUtils::SerializeVec(portal.center, docAlloc), docAlloc);
+					portalObj.AddMember("Extents", SerializerUtils::SerializeVec(portal.extents, docAlloc), docAlloc);
+					portalObj.AddMember("Rotation", SerializerUtils::SerializeVec(portal.rotation, docAlloc), docAlloc);
+					portalObj.AddMember("Cells", SerializerUtils::SerializeVec(dx::XMUINT2(portal.cells[0], portal.cells[1]), docAlloc), docAlloc);
+					scenePortalsArr.PushBack(portalObj, docAlloc);
+				}
+				sceneSettingsObj.AddMember("Portals", scenePortalsArr, docAlloc);
+			}
+
 			json::Value sceneGraphicsObj(json::kObjectType);
 			{
 				sceneGraphicsObj.AddMember("Spotlight Resolution", _spotlights->GetShadowResolution(), docAlloc);
@@ -398,6 +429,42 @@ bool Scene::Deserialize(bool sceneReload)
 			return false;
 		}
 
+		CellGraph *cellGraph = _sceneHolder.GetCellGraph();
+		cellGraph->Clear();
+
+		if (sceneSettingsObj.HasMember("Cells"))
+		{
+			for (const auto &cellObj : sceneSettingsObj["Cells"].GetArray())
+			{
+				dx::BoundingBox cellBounds{};
+				SerializerUtils::DeserializeVec(cellBounds.Center, cellObj["Center"]);
+				SerializerUtils::DeserializeVec(cellBounds.Extents, cellObj["Extents"]);
+
+				std::string cellName = cellObj.HasMember("Name") ? cellObj["Name"].GetString() : "";
+				cellGraph->AddCell(cellName, cellBounds);
+			}
+		}
+
+		if (sceneSettingsObj.HasMember("Portals"))
+		{
+			for (const auto &portalObj : sceneSettingsObj["Portals"].GetArray())
+			{
+				CellGraph::Portal portal;
+				SerializerUtils::DeserializeVec(portal.center, portalObj["Center"]);
+				SerializerUtils::DeserializeVec(portal.extents, portalObj["Extents"]);
+
+				if (portalObj.HasMember("Rotation"))
+					SerializerUtils::DeserializeVec(portal.rotation, portalObj["Rotation"]);
+
+				dx::XMUINT2 portalCells(CellGraph::NO_CELL, CellGraph::NO_CELL);
+				SerializerUtils::DeserializeVec(portalCells, portalObj["Cells"]);
+				portal.cells[0] = portalCells.x;
+				portal.cells[1] = portalCells.y;
+
+				cellGraph->AddPortal(portal);
+			}
+		}
+
 		if (sceneSettingsObj.HasMember("Graphics"))
 		{
 			json::Value &sceneGraphicsObj = sceneSettingsObj["Graphics"];
@@ -471,6 +538,9 @@ bool Scene::Deserialize(bool sceneReload)
 
 	PostDeserialize();
 
+	// Static entities are moved into their own tree once everything loaded so far has been inserted.
+	_sceneHolder.QueueStaticTreeBake();
+
 	if (!_timelineManager.Deserialize())
 	{
 		ErrMsg("Failed to deserialize timeline manager!");
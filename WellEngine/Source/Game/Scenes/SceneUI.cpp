@@ -1154,6 +1154,35 @@ bool Scene::RenderUI()
 			ImGui::TreePop();
 		}
 
+		if (ImGui::TreeNode("Occlusion Culling"))
+		{
+			ImGui::Checkbox("Enabled##OcclusionCulling", &_occlusionCulling);
+
+			ImGui::Text("Resolution: %d x %d", _occlusionBuffer.GetWidth(), _occlusionBuffer.GetHeight());
+			ImGui::Text("Occluders: %d (%d triangles)", _occlusionBuffer.GetOccluderCount(), _occlusionBuffer.GetOccluderTriangleCount());
+			ImGui::Text("Occluded Entities: %d", _lastOccludedCount);
+
+			ImGui::Separator();
+			ImGui::TreePop();
+		}
+
+		if (ImGui::TreeNode("Room Culling"))
+		{
+			dx::XMFLOAT3 spawnPoint = { 0.0f, 0.0f, 0.0f };
+			if (_viewCamera)
+				spawnPoint = To3(_viewCamera.Get()->GetTransform()->GetPosition(World));
+
+			if (!_sceneHolder.GetCellGraph()->RenderUI(spawnPoint))
+			{
+				ImGui::TreePop();
+				ErrMsg("Failed to render cell graph UI!");
+				return false;
+			}
+
+			ImGui::Separator();
+			ImGui::TreePop();
+		}
+
 		if (ImGui::TreeNode("Scene Holder"))
 		{
 			if (!_sceneHolder.RenderUI())
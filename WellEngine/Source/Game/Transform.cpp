@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "Transform.h"
+#include "TransformChangeLog.h"
 
 #ifdef LEAK_DETECTION
 #define new			DEBUG_NEW
@@ -25,6 +26,12 @@ Transform::~Transform()
 
 	if (_parent)
 		_parent->RemoveChild(this);
+
+	if (_hierarchy)
+		_hierarchy->Remove(this);
+
+	if (_changeLog && _isChangeLogged.load())
+		_changeLog->Forget(this);
 }
 
 Transform &Transform::operator=(Transform &&other) noexcept
@@ -46,7 +53,13 @@ Transform &Transform::operator=(Transform &&other) noexcept
 	_worldMatrix = std::move(other._worldMatrix);
 
 	_worldMatrixBuffer = std::move(other._worldMatrixBuffer);
-	_dirtyCallbacks = std::move(other._dirtyCallbacks);
+
+	_changeLog = other._changeLog; other._changeLog = nullptr;
+	_changeOwner = other._changeOwner; other._changeOwner = nullptr;
+	_isChangeLogged.store(other._isChangeLogged.exchange(false));
+
+	if (_changeLog && _isChangeLogged.load())
+		_changeLog->Replace(&other, this);
 
 	_isDirty = other._isDirty;
 	_isScenePosDirty = other._isScenePosDirty;
@@ -59,6 +72,12 @@ Transform &Transform::operator=(Transform &&other) noexcept
 	for (auto child : _children)
 		child->MoveParentMemory(this);
 
+	_hierarchy = other._hierarchy; other._hierarchy = nullptr;
+	_hierarchyIndex = other._hierarchyIndex; other._hierarchyIndex = TransformHierarchy::NULL_INDEX;
+
+	if (_hierarchy)
+		_hierarchy->MoveOwner(this);
+
 	return *this;
 }
 Transform::Transform(Transform &&other) noexcept
@@ -130,12 +149,11 @@ inline void Transform::RemoveChild(Transform *child)
 void Transform::SetWorldPositionDirty()
 {
 	_isWorldPositionDirty = true;
-	_isWorldMatrixDirty = true;
+	SetWorldMatrixDirty();
 	_isScenePosDirty = true;
 	_isDirty = true;
 
-	for (auto &callback : _dirtyCallbacks)
-		callback();
+	RecordChange();
 
 	for (auto child : _children)
 	{
@@ -145,12 +163,11 @@ void Transform::SetWorldPositionDirty()
 void Transform::SetWorldRotationDirty()
 {
 	_isWorldRotationDirty = true;
-	_isWorldMatrixDirty = true;
+	SetWorldMatrixDirty();
 	_isScenePosDirty = true;
 	_isDirty = true;
 
-	for (auto &callback : _dirtyCallbacks)
-		callback();
+	RecordChange();
 
 	for (auto child : _children)
 	{
@@ -162,12 +179,11 @@ void Transform::SetWorldRotationDirty()
 void Transform::SetWorldScaleDirty()
 {
 	_isWorldScaleDirty = true;
-	_isWorldMatrixDirty = true;
+	SetWorldMatrixDirty();
 	_isScenePosDirty = true;
 	_isDirty = true;
 
-	for (auto &callback : _dirtyCallbacks)
-		callback();
+	RecordChange();
 
 	for (auto child : _children)
 	{
@@ -180,26 +196,38 @@ void Transform::SetAllDirty()
 	_isWorldPositionDirty = true;
 	_isWorldRotationDirty = true;
 	_isWorldScaleDirty = true;
-	_isLocalMatrixDirty = true;
-	_isWorldMatrixDirty = true;
+	SetLocalDirty();
+	SetWorldMatrixDirty();
 	_isScenePosDirty = true;
 	_isDirty = true;
 
-	for (auto &callback : _dirtyCallbacks)
-		callback();
+	RecordChange();
 
 	for (auto child : _children)
 	{
 		child->SetAllDirty();
 	}
 }
+void Transform::SetWorldMatrixDirty()
+{
+	_isWorldMatrixDirty = true;
+
+	if (_hierarchy)
+		_hierarchy->SetDirty(_hierarchyIndex);
+}
+void Transform::SetLocalDirty()
+{
+	_isLocalMatrixDirty = true;
+
+	if (_hierarchy)
+		_hierarchy->SetLocal(_hierarchyIndex, _localPosition, _localRotation, _localScale);
+}
 void Transform::SetDirty()
 {
 	_isDirty = true;
 	_isScenePosDirty = true;
 
-	for (auto &callback : _dirtyCallbacks)
-		callback();
+	RecordChange();
 
 	for (auto child : _children)
 		child->SetDirty();
@@ -212,9 +240,33 @@ bool Transform::IsScenePosDirty() const
 {
 	return _isScenePosDirty;
 }
-void Transform::AddDirtyCallback(std::function<void(void)> callback)
+void Transform::RecordChange()
 {
-	_dirtyCallbacks.emplace_back(callback);
+	if (_changeLog)
+		_changeLog->Record(this);
+}
+void Transform::SetChangeLog(TransformChangeLog *log, Entity *owner)
+{
+	if (_changeLog != log && _changeLog && _isChangeLogged.load())
+	{
+		_changeLog->Forget(this);
+		_isChangeLogged.store(false);
+	}
+
+	_changeLog = log;
+	_changeOwner = owner;
+}
+TransformChangeLog *Transform::GetChangeLog() const
+{
+	return _changeLog;
+}
+Entity *Transform::GetChangeOwner() const
+{
+	return _changeOwner;
+}
+bool Transform::IsChangeLogged() const
+{
+	return _isChangeLogged.load();
 }
 
 void Transform::CleanScenePos()
@@ -306,6 +358,9 @@ XMFLOAT3A *Transform::WorldScale()
 }
 XMFLOAT4X4A *Transform::WorldMatrix()
 {
+	if (_hierarchy)
+		return _hierarchy->ResolveWorldMatrix(_hierarchyIndex);
+
 	if (!_isWorldMatrixDirty)
 		return &_worldMatrix;
 	
@@ -348,6 +403,11 @@ XMFLOAT4X4A *Transform::LocalMatrix()
 	return &_localMatrix;
 }
 
+TransformHierarchy *Transform::GetHierarchy() const
+{
+	return _hierarchy;
+}
+
 Transform *Transform::GetParent() const
 {
 	return _parent;
@@ -375,6 +435,9 @@ void Transform::SetParent(Transform *newParent, bool keepWorldTransform)
     if (newParent)
         newParent->AddChild(this);
 
+	if (_hierarchy)
+		_hierarchy->SetParent(_hierarchyIndex, newParent);
+
     if (keepWorldTransform)
 	{
 		SetPosition(oldPos, World);
@@ -677,7 +740,7 @@ void Transform::SetPosition(const XMFLOAT3A &position, ReferenceSpace space)
 	}
 
 	SetWorldPositionDirty();
-	_isLocalMatrixDirty = true;
+	SetLocalDirty();
 }
 void Transform::SetPosition(const XMFLOAT4A &position, ReferenceSpace space)
 {
@@ -710,7 +773,7 @@ void Transform::SetRotation(const XMFLOAT4A &rotation, ReferenceSpace space)
 
 	VerifyRotation();
 	SetWorldRotationDirty();
-	_isLocalMatrixDirty = true;
+	SetLocalDirty();
 }
 void Transform::SetScale(const XMFLOAT3A &scale, ReferenceSpace space)
 {
@@ -759,7 +822,7 @@ void Transform::SetScale(const XMFLOAT3A &scale, ReferenceSpace space)
 
 	VerifyScale();
 	SetWorldScaleDirty();
-	_isLocalMatrixDirty = true;
+	SetLocalDirty();
 }
 void Transform::SetScale(const XMFLOAT4A &scale, ReferenceSpace space)
 {
@@ -806,7 +869,7 @@ void Transform::SetMatrix(const XMFLOAT4X4A &mat, ReferenceSpace space)
 	SetWorldRotationDirty();
 	_isWorldPositionDirty = true;
 	_isWorldScaleDirty = true;
-	_isLocalMatrixDirty = true;
+	SetLocalDirty();
 }
 
 void Transform::Move(const XMFLOAT3A &direction, ReferenceSpace space)
@@ -834,7 +897,7 @@ void Transform::Move(const XMFLOAT3A &direction, ReferenceSpace space)
 	}
 
 	SetWorldPositionDirty();
-	_isLocalMatrixDirty = true;
+	SetLocalDirty();
 }
 void Transform::Move(const XMFLOAT4A &direction, ReferenceSpace space)
 {
@@ -866,7 +929,7 @@ void Transform::Rotate(const XMFLOAT3A &euler, ReferenceSpace space)
 
 	VerifyRotation();
 	SetWorldRotationDirty();
-	_isLocalMatrixDirty = true;
+	SetLocalDirty();
 }
 void Transform::Rotate(const XMFLOAT4A &euler, ReferenceSpace space)
 {
@@ -897,7 +960,7 @@ void Transform::Scale(const XMFLOAT3A &scale, ReferenceSpace space, bool additiv
 	}
 
 	SetWorldScaleDirty();
-	_isLocalMatrixDirty = true;
+	SetLocalDirty();
 }
 void Transform::Scale(const XMFLOAT4A &scale, ReferenceSpace space, bool additive)
 {
@@ -976,7 +1039,7 @@ void Transform::RotateQuaternion(const XMFLOAT4A &quaternion, ReferenceSpace spa
 
 	VerifyRotation();
 	SetWorldRotationDirty();
-	_isLocalMatrixDirty = true;
+	SetLocalDirty();
 }
 
 const XMFLOAT3A Transform::GetEuler(ReferenceSpace space)
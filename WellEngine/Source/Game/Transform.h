@@ -2,10 +2,15 @@
 
 #include <vector>
 #include <memory>
+#include <atomic>
 #include <DirectXMath.h>
 #include <functional>
 #include "D3D/ConstantBufferD3D11.h"
 #include "Utils/ReferenceHelper.h"
+#include "TransformHierarchy.h"
+
+class Entity;
+class TransformChangeLog;
 
 constexpr float MIN_SCALE = 0.0001f;
 
@@ -58,7 +63,11 @@ private:
 
 	ConstantBufferD3D11 _worldMatrixBuffer;
 
-	std::vector<std::function<void()>> _dirtyCallbacks;
+	// Set while the transform records its changes in a log, which notifies the owner when consumed.
+	TransformChangeLog *_changeLog = nullptr;
+	Entity *_changeOwner = nullptr;
+	std::atomic_bool _isChangeLogged = false;
+	friend class TransformChangeLog;
 
 	bool _isDirty = true;
 	bool _isScenePosDirty = true;
@@ -68,6 +77,11 @@ private:
 	bool _isWorldMatrixDirty = true;	// Dirtied by parent position, rotation and scale.
 	bool _isLocalMatrixDirty = true;	// Never dirtied by parent.
 
+	// Set while the transform is stored in a hierarchy, which then holds its world matrix.
+	TransformHierarchy *_hierarchy = nullptr;
+	UINT _hierarchyIndex = TransformHierarchy::NULL_INDEX;
+	friend class TransformHierarchy;
+
 	// Used if the parent is moved to a new memory address.
 	inline void MoveParentMemory(Transform *parent) noexcept { _parent = parent; }
 
@@ -78,6 +92,9 @@ private:
 	void SetWorldRotationDirty();
 	void SetWorldScaleDirty();
 	void SetAllDirty();
+	void SetWorldMatrixDirty();
+	void SetLocalDirty();
+	void RecordChange();
 
 	void VerifyRotation();
 	void VerifyScale();
@@ -109,9 +126,14 @@ public:
 	void SetDirty();
 	[[nodiscard]] bool IsDirty() const;
 	bool IsScenePosDirty() const;
-	void AddDirtyCallback(std::function<void(void)> callback);
+	void SetChangeLog(TransformChangeLog *log, Entity *owner);
+	[[nodiscard]] TransformChangeLog *GetChangeLog() const;
+	[[nodiscard]] Entity *GetChangeOwner() const;
+	[[nodiscard]] bool IsChangeLogged() const;
 	void CleanScenePos();
 
+	[[nodiscard]] TransformHierarchy *GetHierarchy() const;
+
 	[[nodiscard]] Transform *GetParent() const;
 	void SetParent(Transform *parent, bool worldPositionStays = false);
 
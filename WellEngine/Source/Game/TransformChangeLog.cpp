@@ -0,0 +1,66 @@
+#include "stdafx.h"
+#include "TransformChangeLog.h"
+#include "Transform.h"
+
+#ifdef LEAK_DETECTION
+#define new			DEBUG_NEW
+#endif
+
+using namespace DirectX;
+
+TransformChangeLog::~TransformChangeLog()
+{
+	for (Transform *transform : _changed)
+		transform->_isChangeLogged.store(false);
+
+	_changed.clear();
+}
+
+void TransformChangeLog::Record(Transform *transform)
+{
+	if (transform->_isChangeLogged.exchange(true))
+		return;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_changed.emplace_back(transform);
+}
+
+void TransformChangeLog::Forget(const Transform *transform)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto it = std::find(_changed.begin(), _changed.end(), transform);
+	if (it != _changed.end())
+	{
+		*it = _changed.back();
+		_changed.pop_back();
+	}
+}
+
+void TransformChangeLog::Replace(const Transform *oldTransform, Transform *newTransform)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto it = std::find(_changed.begin(), _changed.end(), oldTransform);
+	if (it != _changed.end())
+		*it = newTransform;
+}
+
+void TransformChangeLog::Consume(std::vector<Transform *> &changed)
+{
+	changed.clear();
+	std::swap(changed, _changed);
+
+	// Cleared before the owners are notified, so that any change they make is recorded again.
+	for (Transform *transform : changed)
+		transform->_isChangeLogged.store(false);
+}
+
+bool TransformChangeLog::IsEmpty() const
+{
+	return _changed.empty();
+}
+UINT TransformChangeLog::GetCount() const
+{
+	return static_cast<UINT>(_changed.size());
+}
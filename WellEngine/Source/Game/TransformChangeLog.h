@@ -0,0 +1,44 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+class Transform;
+
+// Collects the transforms that changed since it was last consumed. A transform is recorded once no matter how
+// many of its properties change or how often its parents move, and the owners of all recorded transforms are
+// notified together when the log is consumed, instead of once per change.
+//
+// Recording is safe from several threads at once. Consuming is not, and must not overlap with recording.
+class TransformChangeLog
+{
+private:
+	std::vector<Transform *> _changed;
+	std::mutex _mutex;
+
+public:
+	TransformChangeLog() = default;
+	~TransformChangeLog();
+	TransformChangeLog(const TransformChangeLog &other) = delete;
+	TransformChangeLog &operator=(const TransformChangeLog &other) = delete;
+	TransformChangeLog(TransformChangeLog &&other) = delete;
+	TransformChangeLog &operator=(TransformChangeLog &&other) = delete;
+
+	// Adds a transform unless it is already recorded.
+	void Record(Transform *transform);
+
+	// Drops a recorded transform, for when it is destroyed before the log is consumed.
+	void Forget(const Transform *transform);
+
+	// Points a recorded transform at its new memory address.
+	void Replace(const Transform *oldTransform, Transform *newTransform);
+
+	// Moves every recorded transform into changed and empties the log. Transforms changed while their owners
+	// are being notified are recorded again for the next consumer.
+	void Consume(std::vector<Transform *> &changed);
+
+	[[nodiscard]] bool IsEmpty() const;
+	[[nodiscard]] UINT GetCount() const;
+
+	TESTABLE()
+};
@@ -0,0 +1,269 @@
+#include "stdafx.h"
+#include "TransformHierarchy.h"
+#include "Transform.h"
+
+#ifdef LEAK_DETECTION
+#define new			DEBUG_NEW
+#endif
+
+using namespace DirectX;
+
+TransformHierarchy::~TransformHierarchy()
+{
+	for (Transform *owner : _owners)
+	{
+		if (!owner)
+			continue;
+
+		owner->_hierarchy = nullptr;
+		owner->_hierarchyIndex = NULL_INDEX;
+		owner->_isWorldMatrixDirty = true;
+	}
+}
+
+void TransformHierarchy::Add(Transform *transform)
+{
+	if (!transform || transform->_hierarchy == this)
+		return;
+
+	if (transform->_hierarchy)
+		transform->_hierarchy->Remove(transform);
+
+	const UINT index = static_cast<UINT>(_owners.size());
+	transform->_hierarchy = this;
+	transform->_hierarchyIndex = index;
+
+	_owners.emplace_back(transform);
+	_parents.emplace_back(NULL_INDEX);
+	_localPositions.emplace_back(transform->_localPosition);
+	_localRotations.emplace_back(transform->_localRotation);
+	_localScales.emplace_back(transform->_localScale);
+	_worldMatrices.emplace_back();
+	_isDirty.emplace_back(true);
+
+	SetParent(index, transform->_parent);
+
+	// Children added before their parent were placed as roots.
+	for (Transform *child : transform->_children)
+	{
+		if (child && child->_hierarchy == this)
+			SetParent(child->_hierarchyIndex, transform);
+	}
+
+	_isSorted = false;
+}
+void TransformHierarchy::Remove(Transform *transform)
+{
+	if (!transform || transform->_hierarchy != this)
+		return;
+
+	const UINT index = transform->_hierarchyIndex;
+
+	for (Transform *child : transform->_children)
+	{
+		if (child && child->_hierarchy == this)
+			SetParent(child->_hierarchyIndex, nullptr);
+	}
+
+	_owners[index] = nullptr;
+	_parents[index] = NULL_INDEX;
+	_isDirty[index] = false;
+
+	// The transform computes its own world matrix again from now on.
+	transform->_hierarchy = nullptr;
+	transform->_hierarchyIndex = NULL_INDEX;
+	transform->_isWorldMatrixDirty = true;
+
+	_isSorted = false;
+}
+
+void TransformHierarchy::MoveOwner(Transform *transform)
+{
+	if (!transform || transform->_hierarchy != this)
+		return;
+
+	_owners[transform->_hierarchyIndex] = transform;
+}
+
+void TransformHierarchy::SetParent(UINT index, const Transform *parent)
+{
+	_parents[index] = (parent && parent->_hierarchy == this) ? parent->_hierarchyIndex : NULL_INDEX;
+	_isDirty[index] = true;
+	_isSorted = false;
+}
+void TransformHierarchy::SetLocal(UINT index, const XMFLOAT3A &position, const XMFLOAT4A &rotation, const XMFLOAT3A &scale)
+{
+	_localPositions[index] = position;
+	_localRotations[index] = rotation;
+	_localScales[index] = scale;
+	_isDirty[index] = true;
+}
+
+void TransformHierarchy::UpdateSlot(UINT index)
+{
+	const XMMATRIX localMatrix = XMMatrixAffineTransformation(
+		Load(_localScales[index]),
+		XMVectorZero(),
+		Load(_localRotations[index]),
+		Load(_localPositions[index])
+	);
+
+	XMMATRIX worldMatrix = localMatrix;
+
+	const UINT parent = _parents[index];
+	if (parent != NULL_INDEX)
+		worldMatrix = XMMatrixMultiply(localMatrix, Load(_worldMatrices[parent]));
+	else if (Transform *externalParent = _owners[index]->GetParent())
+		worldMatrix = XMMatrixMultiply(localMatrix, Load(externalParent->GetWorldMatrix()));
+
+	Store(_worldMatrices[index], worldMatrix);
+	_isDirty[index] = false;
+}
+
+XMFLOAT4X4A *TransformHierarchy::ResolveWorldMatrix(UINT index)
+{
+	if (_isDirty[index])
+	{
+		if (_parents[index] != NULL_INDEX)
+			(void)ResolveWorldMatrix(_parents[index]);
+
+		UpdateSlot(index);
+	}
+
+	return &_worldMatrices[index];
+}
+
+void TransformHierarchy::Sort()
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	const UINT count = static_cast<UINT>(_owners.size());
+
+	// Depth of every slot in use, found by walking up to the closest ancestor with a known depth.
+	std::vector<UINT> depths(count, NULL_INDEX);
+	std::vector<UINT> chain;
+	UINT levelCount = 0;
+
+	for (UINT i = 0; i < count; i++)
+	{
+		if (!_owners[i] || depths[i] != NULL_INDEX)
+			continue;
+
+		chain.clear();
+		UINT slot = i;
+		while (slot != NULL_INDEX && depths[slot] == NULL_INDEX)
+		{
+			chain.emplace_back(slot);
+			slot = _parents[slot];
+		}
+
+		UINT depth = (slot == NULL_INDEX) ? 0 : depths[slot] + 1;
+		for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+			depths[*it] = depth++;
+
+		levelCount = std::max<UINT>(levelCount, depth);
+	}
+
+	// Counting sort by depth, keeping the current order within each level.
+	_levelStarts.assign(levelCount + 1, 0);
+	for (UINT i = 0; i < count; i++)
+	{
+		if (_owners[i])
+			_levelStarts[depths[i] + 1]++;
+	}
+
+	for (UINT level = 0; level < levelCount; level++)
+		_levelStarts[level + 1] += _levelStarts[level];
+
+	std::vector<UINT> nextSlot(_levelStarts.begin(), _levelStarts.end() - 1);
+	std::vector<UINT> newIndices(count, NULL_INDEX);
+	for (UINT i = 0; i < count; i++)
+	{
+		if (_owners[i])
+			newIndices[i] = nextSlot[depths[i]]++;
+	}
+
+	const UINT liveCount = _levelStarts.back();
+
+	std::vector<Transform *> owners(liveCount);
+	std::vector<UINT> parents(liveCount);
+	std::vector<XMFLOAT3A> localPositions(liveCount);
+	std::vector<XMFLOAT4A> localRotations(liveCount);
+	std::vector<XMFLOAT3A> localScales(liveCount);
+	std::vector<XMFLOAT4X4A> worldMatrices(liveCount);
+	std::vector<UINT8> isDirty(liveCount);
+
+	for (UINT i = 0; i < count; i++)
+	{
+		const UINT newIndex = newIndices[i];
+		if (newIndex == NULL_INDEX)
+			continue;
+
+		owners[newIndex] = _owners[i];
+		parents[newIndex] = (_parents[i] == NULL_INDEX) ? NULL_INDEX : newIndices[_parents[i]];
+		localPositions[newIndex] = _localPositions[i];
+		localRotations[newIndex] = _localRotations[i];
+		localScales[newIndex] = _localScales[i];
+		worldMatrices[newIndex] = _worldMatrices[i];
+		isDirty[newIndex] = _isDirty[i];
+
+		_owners[i]->_hierarchyIndex = newIndex;
+	}
+
+	_owners = std::move(owners);
+	_parents = std::move(parents);
+	_localPositions = std::move(localPositions);
+	_localRotations = std::move(localRotations);
+	_localScales = std::move(localScales);
+	_worldMatrices = std::move(worldMatrices);
+	_isDirty = std::move(isDirty);
+
+	_isSorted = true;
+}
+
+void TransformHierarchy::Update()
+{
+	ZoneScopedC(RandomUniqueColor());
+
+	if (!_isSorted)
+		Sort();
+
+	const UINT levelCount = GetLevelCount();
+	if (levelCount == 0)
+		return;
+
+	// Roots may have a parent outside the hierarchy. Its world matrix is computed lazily, so resolve it here
+	// rather than from several threads at once.
+	for (UINT i = _levelStarts[0]; i < _levelStarts[1]; i++)
+	{
+		if (!_isDirty[i])
+			continue;
+
+		if (Transform *externalParent = _owners[i]->GetParent())
+			(void)externalParent->GetWorldMatrix();
+	}
+
+	// Each level only reads the world matrices of the level above it.
+	for (UINT level = 0; level < levelCount; level++)
+	{
+		const UINT levelStart = _levelStarts[level];
+		const UINT levelEnd = _levelStarts[level + 1];
+
+		JobSystem::Instance().ParallelFor(levelEnd - levelStart, PARALLEL_MIN_LEVEL_SIZE, [&](UINT begin, UINT end) {
+			for (UINT i = levelStart + begin; i < levelStart + end; i++)
+			{
+				if (_isDirty[i])
+					UpdateSlot(i);
+			}
+		}, "Update Hierarchy Level");
+	}
+}
+
+UINT TransformHierarchy::GetCount() const
+{
+	return static_cast<UINT>(std::ranges::count_if(_owners, [](const Transform *owner) { return owner != nullptr; }));
+}
+UINT TransformHierarchy::GetLevelCount() const
+{
+	return _levelStarts.empty() ? 0 : static_cast<UINT>(_levelStarts.size()) - 1;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <DirectXMath.h>
+
+namespace dx = DirectX;
+
+class Transform;
+
+// Stores transforms in level-sorted arrays, where every transform comes after its parent. World matrices are
+// updated in bulk once per frame, one level at a time and in parallel within each level, instead of recursively
+// on access. Transforms mirror their local position, rotation and scale into the arrays when they change, and
+// read their world matrix from here. Anything changed after the update is still resolved lazily on access.
+//
+// Pointers to world matrices are invalidated when transforms are added or when the arrays are re-sorted.
+class TransformHierarchy
+{
+public:
+	static constexpr UINT NULL_INDEX = UINT_MAX;
+
+private:
+	// Levels with fewer transforms than this are updated on one thread.
+	static constexpr UINT PARALLEL_MIN_LEVEL_SIZE = 64;
+
+	std::vector<Transform *> _owners; // Null for slots removed since the last sort.
+	std::vector<UINT> _parents;
+	std::vector<dx::XMFLOAT3A> _localPositions;
+	std::vector<dx::XMFLOAT4A> _localRotations;
+	std::vector<dx::XMFLOAT3A> _localScales;
+	std::vector<dx::XMFLOAT4X4A> _worldMatrices;
+	std::vector<UINT8> _isDirty; // World matrix is out of date.
+
+	// Slot ranges of each level, level i covers [_levelStarts[i], _levelStarts[i + 1]).
+	std::vector<UINT> _levelStarts;
+	bool _isSorted = true;
+
+	void Sort();
+	void UpdateSlot(UINT index);
+
+public:
+	TransformHierarchy() = default;
+	~TransformHierarchy();
+	TransformHierarchy(const TransformHierarchy &other) = delete;
+	TransformHierarchy &operator=(const TransformHierarchy &other) = delete;
+	TransformHierarchy(TransformHierarchy &&other) = delete;
+	TransformHierarchy &operator=(TransformHierarchy &&other) = delete;
+
+	void Add(Transform *transform);
+	void Remove(Transform *transform);
+
+	// Points a slot at a transform that was moved to a new memory address.
+	void MoveOwner(Transform *transform);
+
+	void SetParent(UINT index, const Transform *parent);
+	void SetLocal(UINT index, const dx::XMFLOAT3A &position, const dx::XMFLOAT4A &rotation, const dx::XMFLOAT3A &scale);
+	inline void SetDirty(UINT index) { _isDirty[index] = true; }
+
+	// Returns the world matrix of a slot, first recomputing it and its ancestors if they are out of date.
+	[[nodiscard]] dx::XMFLOAT4X4A *ResolveWorldMatrix(UINT index);
+
+	// Recomputes every out of date world matrix.
+	void Update();
+
+	[[nodiscard]] UINT GetCount() const;
+	[[nodiscard]] UINT GetLevelCount() const;
+
+	TESTABLE()
+};
@@ -28,7 +28,6 @@
 #include <execution>
 #include <mutex>
 #include <semaphore>
-#include <omp.h>
 #include <cassert>
 #include <random>
 
@@ -88,6 +87,7 @@ namespace json = rapidjson;
 #include "Utils/ReferenceHelper.h"
 #include "Utils/StringUtils.h"
 #include "Utils/SerializerUtils.h"
+#include "Utils/JobSystem.h"
 #include "Transform.h"
 #include "Math/GameMath.h"
 #include "Math/ConstRand.h"